@@ -3,8 +3,12 @@
 #include <vector>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <span>
 #include <nlohmann/json.hpp>
 
+#include "foundation/gw2dattools/DatArchiveIndex.h"
+
 namespace fs = std::filesystem;
 
 // -------------------------------------------------------
@@ -16,6 +20,8 @@ struct FileEntry
     std::string path; // full path or dat-relative path
     uint64_t size = 0;
     bool isDir = false;
+    uint32_t archiveEntry = 0; // MFT entry when listed from a dat archive, 0 otherwise
+    uint32_t typeFourCC = 0;   // sniffed type of an archive entry, 0 if unknown
 };
 
 // -------------------------------------------------------
@@ -52,6 +58,14 @@ struct AppState
     bool hasJson = false;
     bool hasFile = false;
 
+    // --- Dat archive, mapped rather than read ---
+    std::shared_ptr<gw2dt::archive::DatArchive> archive;
+    // Sidecar index of the archive, null if it could not be written
+    std::shared_ptr<gw2dt::archive::DatArchiveIndex> archiveIndex;
+    std::string archiveIndexPath;
+    // Entries of the archive kept in memory when there is no sidecar index
+    std::vector<gw2dt::archive::DatArchiveIndexEntry> archiveEntries;
+
     // --- Browser ---
     std::vector<FileEntry> browserEntries;
     int selectedEntry = -1;
@@ -85,4 +99,25 @@ struct AppState
         previewMode = PreviewMode::Hex;
         selectedEntry = -1;
     }
+
+    // Entries of the open archive, from the sidecar index or from memory
+    std::span<const gw2dt::archive::DatArchiveIndexEntry> ArchiveEntries() const
+    {
+        if (archiveIndex)
+            return archiveIndex->entries();
+        return archiveEntries;
+    }
+
+    void CloseArchive()
+    {
+        if (!archive)
+            return;
+        archive.reset();
+        archiveIndex.reset();
+        archiveIndexPath.clear();
+        archiveEntries.clear();
+        browserEntries.clear();
+        browserRoot.clear();
+        selectedEntry = -1;
+    }
 };
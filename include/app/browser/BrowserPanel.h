@@ -1,8 +1,13 @@
 #pragma once
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 #include <nlohmann/json.hpp>
 
+#include "foundation/gw2dattools/DatArchiveIndex.h"
+
 struct AppState;
 
 namespace panels
@@ -12,6 +17,7 @@ namespace panels
     {
     public:
         explicit BrowserPanel(std::shared_ptr<AppState> state);
+        ~BrowserPanel();
         void Render();
 
     private:
@@ -21,10 +27,25 @@ namespace panels
         void RefreshDirectory(const std::string &path);
         void DetectPreviewMode(int index);
         void PopulateInspector(int index);
+        void UpdateArchiveScan();
+        void StopArchiveScan();
+        void SaveScanEntries();
 
         std::shared_ptr<AppState> m_State;
         char m_SearchBuf[256] = {};
         bool m_ShowOnlyFiles = false;
+        std::vector<int> m_VisibleEntries;
+
+        // Background type scan of the open archive, its entries are
+        // only read back once the scanning thread is over, finished or stopped
+        std::shared_ptr<gw2dt::archive::DatArchive> m_ScanArchive;
+        std::vector<gw2dt::archive::DatArchiveIndexEntry> m_ScanEntries;
+        std::string m_ScanIndexPath;
+        std::thread m_ScanThread;
+        std::atomic<uint32_t> m_ScannedEntries{0};
+        std::atomic<uint32_t> m_ScanEntriesNumber{0};
+        std::atomic<bool> m_StopScan{false};
+        std::atomic<bool> m_ScanFinished{false};
     };
 
 } // namespace panels
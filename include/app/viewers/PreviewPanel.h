@@ -40,6 +40,7 @@ namespace panels
         std::shared_ptr<AppState> m_State;
 
         void LoadTextureFromBytes(const std::vector<uint8_t> &bytes);
+        void UploadTexture(const unsigned char *rgba, int w, int h, bool isHalfFloat = false);
         void FreeTexture();
     };
 
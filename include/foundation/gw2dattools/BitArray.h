@@ -9,11 +9,57 @@ namespace gw2dt
     namespace utils
     {
 
-        template <typename IntType>
-        class BitArray
+        // Word skipping policies: the last word of every skipped_words() words of the buffer is skipped (0 to disable)
+
+        // The period is given to the BitArray constructor
+        class VariableSkippedWords
+        {
+        public:
+            explicit VariableSkippedWords(uint32_t iSkippedWords) : skipped_words_data(iSkippedWords > 1 ? iSkippedWords : 0) {}
+
+            uint32_t skipped_words() const { return skipped_words_data; }
+
+        private:
+            uint32_t skipped_words_data;
+        };
+
+        // The period is known at compile time, the divisions by it are turned into multiplications
+        template <uint32_t SKIPPED_WORDS>
+        class FixedSkippedWords
         {
         public:
-            BitArray(const uint8_t *ipBuffer, uint32_t iSize, uint32_t iSkippedBytes = 0);
+            static_assert(SKIPPED_WORDS != 1, "Every word can not be skipped.");
+
+            // iSkippedWords has to be the period of the policy, or 0
+            explicit FixedSkippedWords(uint32_t iSkippedWords);
+
+            static constexpr uint32_t skipped_words() { return SKIPPED_WORDS; }
+        };
+
+        // Checking policies of read, drop and need
+
+        // Invalid numbers of bits and reads past the end of the input throw
+        struct CheckedBits
+        {
+            static constexpr bool is_checked = true;
+        };
+
+        // Nothing is checked, reads past the end of the input return zeros
+        // The caller is expected to test exhausted() once it is done
+        struct UncheckedBits
+        {
+            static constexpr bool is_checked = false;
+        };
+
+        // 64 bits reservoir reader, shared by the dat and texture decoders
+        // The input is read as 32 bits words, most significant bit first, and words are skipped as told by SkipPolicy.
+        // The reservoir is refilled byte by byte so that at least 56 bits are available after refill(); read_lazy and
+        // drop_lazy do not check anything, callers are expected to refill (or need) before consuming more than 56 bits.
+        template <typename SkipPolicy = VariableSkippedWords, typename CheckPolicy = CheckedBits>
+        class BitArray : private SkipPolicy
+        {
+        public:
+            BitArray(const uint8_t *ipBuffer, uint32_t iSize, uint32_t iSkippedWords = 0);
 
             template <typename OutputType>
             void read_lazy(uint8_t bits_number, OutputType &value_data) const;
@@ -24,26 +70,48 @@ namespace gw2dt
             template <typename OutputType>
             void read_lazy(OutputType &value_data) const;
 
+            // Refill if needed, then read_lazy or drop_lazy, with the checks of CheckPolicy
             template <typename OutputType>
-            void read(uint8_t bits_number, OutputType &value_data) const;
+            void read(uint8_t bits_number, OutputType &value_data);
             void drop(uint8_t bits_number);
+            void drop_lazy(uint8_t bits_number);
+
+            void refill();
+            // Refills only if less than bits_number bits are available
+            void need(uint8_t bits_number);
+
+            // Moves to bit_position, skipped words excluded
+            void seek(uint64_t bit_position);
+            // Moves to the start of the word at word_index in the buffer, skipped words included
+            void seek_word(uint64_t word_index);
+
+            // Number of bits consumed, skipped words excluded
+            uint64_t bit_position() const;
+            // Index in the buffer of the word following the last word a bit was consumed from, skipped words included
+            uint64_t next_word_index() const;
+            // True if more bits were consumed than the input contains
+            bool exhausted() const;
+
+            // Number of words of the buffer, skipped words included
+            uint32_t words_count() const { return words_number; }
 
             const uint8_t *const buffer_start_position;
-            const uint8_t *buffer_position;
-            uint64_t position_bits;
-            uint64_t input_data_size;
 
         private:
-            template <typename OutputType>
-            void read_impl(uint8_t bits_number, OutputType &value_data) const;
-            void drop_impl(uint8_t bits_number);
-            void pull(uint32_t &value_data, uint8_t &oNbPulledBits);
-
-            uint32_t bytes_available;
-            uint32_t skipped_bytes;
-            uint32_t head_data;
-            uint32_t buffer_data;
-            uint8_t bytes_available_data;
+            // Index in the buffer of the data word word_index
+            uint64_t buffer_word_index(uint64_t word_index) const;
+            uint32_t load_word(uint64_t word_index) const;
+            void refill_slow();
+
+            uint64_t head_data;
+            uint32_t bits_available;
+
+            uint32_t words_number;
+            uint64_t input_data_bits;
+
+            uint64_t load_position;
+            uint32_t load_word_index;
+            uint32_t load_word_limit;
         };
 
     }
@@ -1,151 +1,261 @@
 #ifndef GW2DATTOOLS_UTILS_BITARRAY_I
 #define GW2DATTOOLS_UTILS_BITARRAY_I
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace gw2dt
 {
     namespace utils
     {
 
-        template <typename IntType>
-        BitArray<IntType>::BitArray(const uint8_t *ipBuffer, uint32_t iSize, uint32_t iSkippedBytes) : buffer_start_position(ipBuffer),
-                                                                                                       buffer_position(ipBuffer),
-                                                                                                       bytes_available(iSize),
-                                                                                                       skipped_bytes(iSkippedBytes),
-                                                                                                       head_data(0),
-                                                                                                       buffer_data(0),
-                                                                                                       bytes_available_data(0)
+        template <uint32_t SKIPPED_WORDS>
+        FixedSkippedWords<SKIPPED_WORDS>::FixedSkippedWords(uint32_t iSkippedWords)
+        {
+            assert(iSkippedWords == 0 || iSkippedWords == SKIPPED_WORDS);
+            (void)iSkippedWords;
+        }
+
+        template <typename SkipPolicy, typename CheckPolicy>
+        BitArray<SkipPolicy, CheckPolicy>::BitArray(const uint8_t *ipBuffer, uint32_t iSize, uint32_t iSkippedWords) : SkipPolicy(iSkippedWords),
+                                                                                                                        buffer_start_position(ipBuffer),
+                                                                                                                        head_data(0),
+                                                                                                                        bits_available(0),
+                                                                                                                        words_number(iSize / sizeof(uint32_t)),
+                                                                                                                        load_position(0),
+                                                                                                                        load_word_index(0),
+                                                                                                                        load_word_limit(0)
         {
             assert(iSize % sizeof(uint32_t) == 0);
 
-            pull(head_data, bytes_available_data);
+            uint32_t data_words = words_number;
+            if (this->skipped_words() != 0)
+            {
+                data_words -= words_number / this->skipped_words();
+            }
+            input_data_bits = static_cast<uint64_t>(data_words) * 32;
+
+            refill();
         }
 
-        template <typename IntType>
-        void BitArray<IntType>::pull(uint32_t &head_data, uint8_t &bytes_available_data)
+        template <typename SkipPolicy, typename CheckPolicy>
+        inline uint64_t BitArray<SkipPolicy, CheckPolicy>::buffer_word_index(uint64_t word_index) const
         {
-            if (bytes_available >= sizeof(uint32_t))
+            if (this->skipped_words() != 0)
             {
-                head_data = *(reinterpret_cast<const uint32_t *>(buffer_position));
-                position_bits=position_bits+32;
-                bytes_available -= sizeof(uint32_t);
-                buffer_position += sizeof(uint32_t);
-                bytes_available_data = sizeof(uint32_t) * 8;
+                word_index += word_index / (this->skipped_words() - 1);
             }
-            else
+            return word_index;
+        }
+
+        template <typename SkipPolicy, typename CheckPolicy>
+        inline uint32_t BitArray<SkipPolicy, CheckPolicy>::load_word(uint64_t word_index) const
+        {
+            // word_index does not count skipped words
+            word_index = buffer_word_index(word_index);
+
+            uint32_t value_data = 0;
+            if (word_index < words_number)
             {
-                head_data = 0;
-                bytes_available_data = 0;
+                memcpy(&value_data, buffer_start_position + word_index * sizeof(uint32_t), sizeof(uint32_t));
             }
+            return value_data;
         }
 
-        template <typename IntType>
-        template <typename OutputType>
-        void BitArray<IntType>::read_impl(uint8_t bits_number, OutputType &value_data) const
+        template <typename SkipPolicy, typename CheckPolicy>
+        inline void BitArray<SkipPolicy, CheckPolicy>::refill()
+        {
+            if (load_word_index + 2 >= load_word_limit)
+            {
+                refill_slow();
+                return;
+            }
+
+            const uint8_t *word_position = buffer_start_position + static_cast<size_t>(load_word_index) * sizeof(uint32_t);
+            uint32_t words_data[3];
+            memcpy(words_data, word_position, sizeof(words_data));
+
+            // 64 bits of input starting at load_position
+            uint32_t shift_bits = static_cast<uint32_t>(load_position & 3) * 8;
+            uint64_t peek_data = ((static_cast<uint64_t>(words_data[0]) << 32) | words_data[1]) << shift_bits;
+            peek_data |= ((static_cast<uint64_t>(words_data[2]) << 31) >> (63 - shift_bits));
+
+            head_data |= peek_data >> bits_available;
+
+            uint32_t loaded_bytes = (63 - bits_available) >> 3;
+            load_word_index += static_cast<uint32_t>(((load_position & 3) + loaded_bytes) >> 2);
+            load_position += loaded_bytes;
+            bits_available |= 56;
+        }
+
+        template <typename SkipPolicy, typename CheckPolicy>
+        inline void BitArray<SkipPolicy, CheckPolicy>::need(uint8_t bits_number)
         {
-            value_data = (head_data >> ((sizeof(uint32_t) * 8) - bits_number));
+            if (bits_available < bits_number)
+            {
+                refill();
+            }
         }
 
-        template <typename IntType>
-        template <typename OutputType>
-        void BitArray<IntType>::read_lazy(uint8_t bits_number, OutputType &value_data) const
+        template <typename SkipPolicy, typename CheckPolicy>
+        void BitArray<SkipPolicy, CheckPolicy>::refill_slow()
         {
-            if (bits_number > sizeof(OutputType) * 8)
+            uint64_t word_index = load_position >> 2;
+
+            uint32_t shift_bits = static_cast<uint32_t>(load_position & 3) * 8;
+            uint64_t peek_data = ((static_cast<uint64_t>(load_word(word_index)) << 32) | load_word(word_index + 1)) << shift_bits;
+            peek_data |= ((static_cast<uint64_t>(load_word(word_index + 2)) << 31) >> (63 - shift_bits));
+
+            head_data |= peek_data >> bits_available;
+
+            load_position += (63 - bits_available) >> 3;
+            bits_available |= 56;
+
+            // Locating the next word in the buffer, and the next word we can not read without checks
+            word_index = buffer_word_index(load_position >> 2);
+            uint64_t next_limit = words_number;
+            if (this->skipped_words() != 0)
             {
-                throw std::runtime_error("Invalid number of bits requested.");
+                uint64_t next_skipped_word = (word_index / this->skipped_words() + 1) * this->skipped_words() - 1;
+                next_limit = std::min<uint64_t>(next_limit, next_skipped_word);
             }
-            if (bits_number > sizeof(uint32_t) * 8)
+
+            if (word_index >= words_number)
+            {
+                // End of input, everything is read through the slow path
+                load_word_index = 0;
+                load_word_limit = 0;
+            }
+            else
             {
-                throw std::runtime_error("Invalid number of bits requested.");
+                load_word_index = static_cast<uint32_t>(word_index);
+                load_word_limit = static_cast<uint32_t>(next_limit);
             }
+        }
+
+        template <typename SkipPolicy, typename CheckPolicy>
+        template <typename OutputType>
+        void BitArray<SkipPolicy, CheckPolicy>::read_lazy(uint8_t bits_number, OutputType &value_data) const
+        {
+            assert(bits_number > 0 && bits_number <= sizeof(OutputType) * 8 && bits_number <= 56);
 
-            read_impl(bits_number, value_data);
+            value_data = static_cast<OutputType>(head_data >> (64 - bits_number));
         }
 
-        template <typename IntType>
+        template <typename SkipPolicy, typename CheckPolicy>
         template <uint8_t bits_number, typename OutputType>
-        void BitArray<IntType>::read_lazy(OutputType &value_data) const
+        void BitArray<SkipPolicy, CheckPolicy>::read_lazy(OutputType &value_data) const
         {
+            static_assert(bits_number > 0, "bits_number must be positive.");
             static_assert(bits_number <= sizeof(OutputType) * 8, "bits_number must be inferior to the size of the requested type.");
-            static_assert(bits_number <= sizeof(uint32_t) * 8, "bits_number must be inferior to the size of the internal type.");
+            static_assert(bits_number <= 56, "bits_number must be inferior to the guaranteed size of the reservoir.");
 
-            read_impl(bits_number, value_data);
+            value_data = static_cast<OutputType>(head_data >> (64 - bits_number));
         }
 
-        template <typename IntType>
+        template <typename SkipPolicy, typename CheckPolicy>
         template <typename OutputType>
-        void BitArray<IntType>::read_lazy(OutputType &value_data) const
+        void BitArray<SkipPolicy, CheckPolicy>::read_lazy(OutputType &value_data) const
         {
             read_lazy<sizeof(OutputType) * 8>(value_data);
         }
 
-        template <typename IntType>
+        template <typename SkipPolicy, typename CheckPolicy>
         template <typename OutputType>
-        void BitArray<IntType>::read(uint8_t bits_number, OutputType &value_data) const
+        void BitArray<SkipPolicy, CheckPolicy>::read(uint8_t bits_number, OutputType &value_data)
         {
-            if (bytes_available_data < bits_number)
+            if constexpr (CheckPolicy::is_checked)
             {
-                throw std::runtime_error("Not enough bits available to read the value.");
+                if (bits_number == 0 || bits_number > sizeof(OutputType) * 8 || bits_number > 56)
+                {
+                    throw std::runtime_error("Invalid number of bits requested.");
+                }
+            }
+            need(bits_number);
+            if constexpr (CheckPolicy::is_checked)
+            {
+                if (bit_position() + bits_number > input_data_bits)
+                {
+                    throw std::runtime_error("Not enough bits available to read the value.");
+                }
             }
             read_lazy(bits_number, value_data);
         }
 
-        template <typename IntType>
-        void BitArray<IntType>::drop_impl(uint8_t bits_number)
+        template <typename SkipPolicy, typename CheckPolicy>
+        void BitArray<SkipPolicy, CheckPolicy>::drop(uint8_t bits_number)
         {
-            if (bytes_available_data < bits_number)
-            {
-                throw std::runtime_error("Too much bits were asked to be dropped.");
-            }
-
-            uint8_t new_bits_available = bytes_available_data - bits_number;
-            position_bits=position_bits+bits_number;
-            if (new_bits_available >= sizeof(uint32_t) * 8)
+            if constexpr (CheckPolicy::is_checked)
             {
-                if (bits_number == sizeof(uint32_t) * 8)
+                if (bits_number > 56)
                 {
-                    head_data = buffer_data;
-                    buffer_data = 0;
+                    throw std::runtime_error("Invalid number of bits to be dropped.");
                 }
-                else
-                {
-                    head_data = (head_data << bits_number) | (buffer_data >> ((sizeof(uint32_t) * 8) - bits_number));
-                    buffer_data = buffer_data << bits_number;
-                }
-                bytes_available_data = new_bits_available;
             }
-            else
+            need(bits_number);
+            if constexpr (CheckPolicy::is_checked)
             {
-                IntType new_value;
-                uint8_t pulled_bits;
-                pull(new_value, pulled_bits);
-
-                if (bits_number == sizeof(uint32_t) * 8)
+                if (bit_position() + bits_number > input_data_bits)
                 {
-                    head_data = 0;
+                    throw std::runtime_error("Too much bits were asked to be dropped.");
                 }
-                else
-                {
-                    head_data = head_data << bits_number;
-                }
-                head_data |= (buffer_data >> ((sizeof(uint32_t) * 8) - bits_number)) | (new_value >> (new_bits_available));
-                if (new_bits_available > 0)
-                {
-                    buffer_data = new_value << ((sizeof(uint32_t) * 8) - new_bits_available);
-                }
-                bytes_available_data = new_bits_available + pulled_bits;
             }
+            drop_lazy(bits_number);
+        }
+
+        template <typename SkipPolicy, typename CheckPolicy>
+        inline void BitArray<SkipPolicy, CheckPolicy>::drop_lazy(uint8_t bits_number)
+        {
+            assert(bits_number <= bits_available);
+
+            head_data <<= bits_number;
+            bits_available -= bits_number;
+        }
+
+        template <typename SkipPolicy, typename CheckPolicy>
+        void BitArray<SkipPolicy, CheckPolicy>::seek(uint64_t bit_position)
+        {
+            head_data = 0;
+            bits_available = 0;
+            load_position = bit_position >> 3;
+
+            refill_slow();
+            drop_lazy(static_cast<uint8_t>(bit_position & 7));
+        }
+
+        template <typename SkipPolicy, typename CheckPolicy>
+        void BitArray<SkipPolicy, CheckPolicy>::seek_word(uint64_t word_index)
+        {
+            // Skipped words before word_index
+            if (this->skipped_words() != 0)
+            {
+                word_index -= word_index / this->skipped_words();
+            }
+            seek(word_index * 32);
         }
 
-        template <typename IntType>
-        void BitArray<IntType>::drop(uint8_t bits_number)
+        template <typename SkipPolicy, typename CheckPolicy>
+        inline uint64_t BitArray<SkipPolicy, CheckPolicy>::bit_position() const
         {
-            if (bits_number > sizeof(uint32_t) * 8)
+            return load_position * 8 - bits_available;
+        }
+
+        template <typename SkipPolicy, typename CheckPolicy>
+        uint64_t BitArray<SkipPolicy, CheckPolicy>::next_word_index() const
+        {
+            const uint64_t consumed_bits = bit_position();
+            if (consumed_bits == 0)
             {
-                throw std::runtime_error("Invalid number of bits to be dropped.");
+                return 0;
             }
-            drop_impl(bits_number);
+            return buffer_word_index((consumed_bits - 1) / 32) + 1;
+        }
+
+        template <typename SkipPolicy, typename CheckPolicy>
+        inline bool BitArray<SkipPolicy, CheckPolicy>::exhausted() const
+        {
+            return bit_position() > input_data_bits;
         }
 
     }
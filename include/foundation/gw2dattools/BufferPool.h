@@ -0,0 +1,111 @@
+#ifndef GW2DATTOOLS_UTILS_BUFFERPOOL_H
+#define GW2DATTOOLS_UTILS_BUFFERPOOL_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace gw2dt
+{
+    namespace utils
+    {
+
+        class BufferPool;
+
+        // Owning handle on a buffer acquired from a BufferPool, the buffer goes back to its pool
+        // when the handle is destroyed or reset. The pool must outlive the buffers it hands out.
+        class PooledBuffer
+        {
+        public:
+            PooledBuffer() noexcept;
+            PooledBuffer(PooledBuffer &&other) noexcept;
+            PooledBuffer &operator=(PooledBuffer &&other) noexcept;
+            PooledBuffer(const PooledBuffer &) = delete;
+            PooledBuffer &operator=(const PooledBuffer &) = delete;
+            ~PooledBuffer();
+
+            uint8_t *data() noexcept { return buffer_data; }
+            const uint8_t *data() const noexcept { return buffer_data; }
+            uint32_t size() const noexcept { return buffer_size; }
+            uint32_t capacity() const noexcept { return buffer_capacity; }
+            bool empty() const noexcept { return buffer_size == 0; }
+            explicit operator bool() const noexcept { return buffer_data != nullptr; }
+
+            std::span<uint8_t> span() noexcept { return {buffer_data, buffer_size}; }
+            std::span<const uint8_t> span() const noexcept { return {buffer_data, buffer_size}; }
+
+            // Changes the size without reallocating, throws if bigger than the capacity
+            void resize(uint32_t new_size);
+            // Gives the buffer back to its pool
+            void reset() noexcept;
+
+        private:
+            friend class BufferPool;
+            PooledBuffer(BufferPool *ipPool, uint8_t *ipData, uint32_t iSize, uint32_t iCapacity, uint8_t iSizeClass) noexcept;
+
+            BufferPool *buffer_pool;
+            uint8_t *buffer_data;
+            uint32_t buffer_size;
+            uint32_t buffer_capacity;
+            uint8_t size_class;
+        };
+
+        // Thread safe pool of byte buffers sorted in power of two size classes, from 4KB to 1GB.
+        // Bigger requests are allocated and freed directly. At most iMaxCachedBuffers buffers
+        // are kept per size class, and at most iMaxCachedBytes bytes in total: a released buffer
+        // that does not fit in this budget is freed.
+        class BufferPool
+        {
+        public:
+            static constexpr uint8_t MIN_SIZE_CLASS_BITS = 12;
+            static constexpr uint8_t MAX_SIZE_CLASS_BITS = 30;
+            static constexpr uint8_t SIZE_CLASSES_NUMBER = MAX_SIZE_CLASS_BITS - MIN_SIZE_CLASS_BITS + 1;
+            static constexpr uint8_t NO_SIZE_CLASS = 0xFF;
+            static constexpr uint64_t DEFAULT_MAX_CACHED_BYTES = 256ull << 20;
+
+            explicit BufferPool(uint32_t iMaxCachedBuffers = 8, uint64_t iMaxCachedBytes = DEFAULT_MAX_CACHED_BYTES);
+            BufferPool(const BufferPool &) = delete;
+            BufferPool &operator=(const BufferPool &) = delete;
+            ~BufferPool();
+
+            // Pool shared by the application and the tools
+            static BufferPool &shared_pool();
+
+            // Returns a buffer of size bytes, its capacity is at least iMinCapacity bytes
+            PooledBuffer acquire(uint32_t size, uint32_t iMinCapacity = 0);
+
+            // Frees every cached buffer
+            void trim();
+
+            // Number of buffers allocated from the system
+            uint64_t allocation_count() const { return allocations_number.load(std::memory_order_relaxed); }
+            // Number of buffers served from the cache
+            uint64_t reuse_count() const { return reuses_number.load(std::memory_order_relaxed); }
+            // Number of bytes currently held by the cache
+            uint64_t cached_bytes() const { return cached_bytes_number.load(std::memory_order_relaxed); }
+            // Most bytes the cache may hold
+            uint64_t max_cached_bytes() const { return max_cached_bytes_number; }
+
+        private:
+            friend class PooledBuffer;
+            void release(uint8_t *ipData, uint32_t iCapacity, uint8_t iSizeClass) noexcept;
+
+            const uint32_t max_cached_buffers;
+            const uint64_t max_cached_bytes_number;
+
+            std::mutex free_buffers_mutex;
+            std::array<std::vector<uint8_t *>, SIZE_CLASSES_NUMBER> free_buffers;
+
+            std::atomic<uint64_t> allocations_number;
+            std::atomic<uint64_t> reuses_number;
+            std::atomic<uint64_t> cached_bytes_number;
+        };
+
+    }
+}
+
+#endif // GW2DATTOOLS_UTILS_BUFFERPOOL_H
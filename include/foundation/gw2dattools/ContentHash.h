@@ -0,0 +1,51 @@
+#ifndef GW2DATTOOLS_UTILS_CONTENTHASH_H
+#define GW2DATTOOLS_UTILS_CONTENTHASH_H
+
+#include <compare>
+#include <cstdint>
+#include <span>
+
+namespace gw2dt
+{
+    namespace utils
+    {
+
+        // 128 bits hash of some content
+        struct ContentHash
+        {
+            uint64_t low_data = 0;
+            uint64_t high_data = 0;
+
+            auto operator<=>(const ContentHash &) const = default;
+        };
+
+        // MurmurHash3 x64 128 bits, computed on content given in pieces of any size
+        class ContentHasher
+        {
+        public:
+            explicit ContentHasher(uint32_t seed_data = 0);
+
+            void update(std::span<const uint8_t> input_data);
+            // Hash of everything given so far
+            ContentHash digest() const;
+            // Number of bytes given so far
+            uint64_t size() const { return total_size; }
+
+        private:
+            void process_block(const uint8_t *block_data);
+
+            uint64_t hash_1;
+            uint64_t hash_2;
+            // Bytes waiting for a whole 16 bytes block
+            uint8_t tail_data[16];
+            uint32_t tail_size;
+            uint64_t total_size;
+        };
+
+        // Hash of content given at once
+        ContentHash hash_content(std::span<const uint8_t> input_data, uint32_t seed_data = 0);
+
+    }
+}
+
+#endif // GW2DATTOOLS_UTILS_CONTENTHASH_H
@@ -0,0 +1,167 @@
+#ifndef GW2DATTOOLS_ARCHIVE_DATARCHIVE_H
+#define GW2DATTOOLS_ARCHIVE_DATARCHIVE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "foundation/gw2dattools/BufferPool.h"
+#include "foundation/gw2dattools/FileIdIndex.h"
+#include "foundation/gw2dattools/MappedFile.h"
+
+namespace gw2dt
+{
+    namespace archive
+    {
+
+        // Size of the archive header, the first bytes of the archive
+        const uint32_t DAT_ARCHIVE_HEADER_SIZE = 40;
+        // Size of the MFT header and of every MFT entry
+        const uint32_t DAT_ARCHIVE_MFT_ENTRY_SIZE = 24;
+        // MFT entry of the table giving the entry of every file id
+        const uint32_t DAT_ARCHIVE_FILE_ID_TABLE_ENTRY = 2;
+
+        struct DatArchiveHeader
+        {
+            uint8_t version;
+            uint32_t header_size;
+            uint32_t chunk_size;
+            uint32_t crc_data;
+            uint64_t mft_offset;
+            uint32_t mft_size;
+            uint32_t flag_data;
+        };
+
+        struct DatArchiveEntry
+        {
+            // Position and size of the stored data in the archive
+            uint64_t offset;
+            uint32_t size;
+            uint16_t compression_flag;
+            uint16_t entry_flag;
+            uint32_t counter;
+            uint32_t crc_data;
+
+            // The stored data has to go through inflate_dat_file_buffer
+            bool is_compressed() const { return compression_flag != 0; }
+        };
+
+        // Ids of an entry, 0 if the entry has none
+        // An entry is listed under its base id and, once it has been updated, under a second bigger file id.
+        // file_id is base_id for the entries listed once.
+        struct DatArchiveFileIds
+        {
+            uint32_t base_id = 0;
+            uint32_t file_id = 0;
+        };
+
+        /** @Inputs:
+         *    - input_data: First bytes of a file, at least 4 of them
+         *  @Return:
+         *    - true if they are the beginning of a dat archive
+         */
+
+        bool is_dat_archive(std::span<const uint8_t> input_data);
+
+        // Gw2.dat archive, read through a mapping of the whole file
+        // Opening only reads the archive and MFT headers. The MFT is read in place when entries are asked for,
+        // and the file id table is parsed the first time an id is looked up. Only the touched pages are loaded.
+        // Every const member function can be called from several threads.
+        class DatArchive
+        {
+        public:
+            // Throws if the file can not be mapped or is not a dat archive
+            explicit DatArchive(const std::filesystem::path &archive_path);
+
+            DatArchive(const DatArchive &) = delete;
+            DatArchive &operator=(const DatArchive &) = delete;
+
+            const std::filesystem::path &path() const { return archive_path; }
+            const DatArchiveHeader &header() const { return archive_header; }
+            uint64_t archive_size() const { return mapped_file.size(); }
+
+            // Entries are numbered as in the MFT and the file id table, from 1 to entries_count() - 1
+            // Number 0 is the MFT header, it is not an entry
+            uint32_t entries_count() const { return entries_number; }
+
+            // Throws if entry_index is not an entry
+            DatArchiveEntry entry(uint32_t entry_index) const;
+
+            /** @Inputs:
+             *    - entry_index: Entry to read
+             *  @Return:
+             *    - The stored data of the entry, compressed or not, pointing into the mapping
+             *  @Throws:
+             *    - gw2dt::std::runtime_error or std::exception in case of error
+             */
+
+            std::span<const uint8_t> entry_data(uint32_t entry_index) const;
+
+            /** @Inputs:
+             *    - entry_index: Entry to read
+             *  @Return:
+             *    - Size of the entry once inflated, only the header of compressed entries is read
+             *  @Throws:
+             *    - gw2dt::std::runtime_error or std::exception in case of error
+             */
+
+            uint32_t uncompressed_size(uint32_t entry_index) const;
+
+            /** @Inputs:
+             *    - entry_index: Entry to read
+             *    - output_data: Caller provided buffer, we decode until it is full or the data ends.
+             *  @Return:
+             *    - Number of bytes written in output_data
+             *  @Throws:
+             *    - gw2dt::std::runtime_error or std::exception in case of error
+             */
+
+            uint32_t read_entry(uint32_t entry_index, std::span<uint8_t> output_data) const;
+
+            /** @Inputs:
+             *    - entry_index: Entry to read
+             *    - buffer_pool: Pool the output buffer is taken from
+             *    - output_data_size: if the value is 0 then we decode everything
+             *                    else we decode until we reach the output_data_size
+             *  @Return:
+             *    - The output buffer, its size is the number of bytes decoded
+             *  @Throws:
+             *    - gw2dt::std::runtime_error or std::exception in case of error
+             */
+
+            utils::PooledBuffer read_entry(uint32_t entry_index, utils::BufferPool &buffer_pool = utils::BufferPool::shared_pool(),
+                                           uint32_t output_data_size = 0) const;
+
+            // Entry listed under file_id, 0 if there is none
+            uint32_t find_entry(uint32_t file_id) const;
+            // Entries listed under file_ids, entry_indices must be as big as file_ids
+            void find_entries(std::span<const uint32_t> file_ids, std::span<uint32_t> entry_indices) const;
+            // Ids the entry is listed under
+            DatArchiveFileIds file_ids(uint32_t entry_index) const;
+            // Number of ids of the file id table
+            uint32_t file_ids_count() const;
+
+        private:
+            void check_entry(uint32_t entry_index) const;
+            // Parses the file id table, once
+            void load_file_ids() const;
+
+            std::filesystem::path archive_path;
+            utils::MappedFile mapped_file;
+
+            DatArchiveHeader archive_header;
+            const uint8_t *mft_data;
+            uint32_t entries_number;
+
+            mutable std::once_flag file_ids_flag;
+            mutable FileIdIndex entry_by_file_id;
+            mutable std::vector<DatArchiveFileIds> file_ids_by_entry;
+        };
+
+    }
+}
+
+#endif // GW2DATTOOLS_ARCHIVE_DATARCHIVE_H
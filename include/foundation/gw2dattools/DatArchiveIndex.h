@@ -0,0 +1,111 @@
+#ifndef GW2DATTOOLS_ARCHIVE_DATARCHIVEINDEX_H
+#define GW2DATTOOLS_ARCHIVE_DATARCHIVEINDEX_H
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "foundation/gw2dattools/DatArchive.h"
+#include "foundation/gw2dattools/MappedFile.h"
+
+namespace gw2dt
+{
+    namespace archive
+    {
+
+        // Changes with the layout of the index file, older files are rebuilt
+        const uint32_t DAT_ARCHIVE_INDEX_VERSION = 1;
+
+        // Flags of the index entries
+        // The uncompressed size has been read
+        const uint16_t DAT_ARCHIVE_INDEX_UNCOMPRESSED_SIZE = 0x1;
+        // The content has been sniffed, four_cc is its type
+        const uint16_t DAT_ARCHIVE_INDEX_FOUR_CC = 0x2;
+
+        // Entry as stored in the index file
+        struct DatArchiveIndexEntry
+        {
+            uint64_t offset;
+            uint32_t size;
+            uint32_t uncompressed_size;
+            uint32_t base_id;
+            uint32_t file_id;
+            uint32_t four_cc;
+            uint16_t compression_flag;
+            uint16_t flag_data;
+
+            bool has_uncompressed_size() const { return (flag_data & DAT_ARCHIVE_INDEX_UNCOMPRESSED_SIZE) != 0; }
+            bool has_four_cc() const { return (flag_data & DAT_ARCHIVE_INDEX_FOUR_CC) != 0; }
+        };
+        static_assert(sizeof(DatArchiveIndexEntry) == 32 && std::is_trivially_copyable_v<DatArchiveIndexEntry>);
+
+        // File id as stored in the index file
+        struct DatArchiveIndexFileId
+        {
+            uint32_t file_id;
+            uint32_t entry_index;
+        };
+
+        /** @Inputs:
+         *    - archive: Archive to index
+         *  @Return:
+         *    - One entry per MFT entry, numbered like them, read from the MFT and the file id table
+         *      Types and the uncompressed sizes of compressed entries are left unknown.
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        std::vector<DatArchiveIndexEntry> build_dat_archive_index_entries(const DatArchive &archive);
+
+        /** @Inputs:
+         *    - index_path: File to write, replaced if it exists
+         *    - archive: Indexed archive, its size, modification time and header identify the index
+         *    - entries: One entry per MFT entry of archive
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        void write_dat_archive_index(const std::filesystem::path &index_path, const DatArchive &archive,
+                                     std::span<const DatArchiveIndexEntry> entries);
+
+        // Index file of an archive, mapped read only and used in place
+        // The entries can be listed and the file ids looked up without reading the archive.
+        class DatArchiveIndex
+        {
+        public:
+            // Throws if the file can not be mapped or is not a valid index
+            explicit DatArchiveIndex(const std::filesystem::path &index_path);
+
+            // true if the index was written for archive as it is now
+            bool matches(const DatArchive &archive) const;
+
+            // Numbered like the MFT entries, entry 0 is empty
+            std::span<const DatArchiveIndexEntry> entries() const { return {entries_data, entries_number}; }
+            uint32_t entries_count() const { return entries_number; }
+
+            // Entry listed under file_id, 0 if there is none
+            uint32_t find_entry(uint32_t file_id) const;
+            uint32_t file_ids_count() const { return ids_number; }
+
+        private:
+            utils::MappedFile mapped_file;
+
+            uint64_t archive_size;
+            int64_t write_time;
+            uint64_t mft_offset;
+            uint32_t crc_data;
+
+            const DatArchiveIndexEntry *entries_data;
+            uint32_t entries_number;
+            // Sorted by file id
+            const DatArchiveIndexFileId *ids_data;
+            uint32_t ids_number;
+        };
+
+    }
+}
+
+#endif // GW2DATTOOLS_ARCHIVE_DATARCHIVEINDEX_H
@@ -0,0 +1,68 @@
+#ifndef GW2DATTOOLS_ARCHIVE_FILEIDINDEX_H
+#define GW2DATTOOLS_ARCHIVE_FILEIDINDEX_H
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace gw2dt
+{
+    namespace archive
+    {
+
+        // Number of ids compared at once while probing
+        const uint32_t FILE_ID_INDEX_GROUP_SIZE = 4;
+
+        // File id to MFT entry, built once per archive
+        // Open addressing over groups of ids: a group holds its ids then their entries in 32 bytes,
+        // a lookup compares the ids of a group at once and stops at the first group with a free slot.
+        // The table is kept at most half full, so most lookups read a single group.
+        // Id 0 marks the free slots, it can not be inserted.
+        class FileIdIndex
+        {
+        public:
+            FileIdIndex();
+            // Room for ids_count ids without growing
+            explicit FileIdIndex(uint32_t ids_count);
+
+            // Lists file_id under entry_index, replaces its entry if it is already listed
+            void insert(uint32_t file_id, uint32_t entry_index);
+
+            // Entry listed under file_id, 0 if there is none
+            uint32_t find(uint32_t file_id) const;
+
+            /** @Inputs:
+             *    - file_ids: Ids to look up
+             *    - entry_indices: Caller provided buffer, as big as file_ids
+             *  @Return:
+             *    - entry_indices is filled with the entry of every id, 0 if there is none
+             *  @Throws:
+             *    - gw2dt::std::runtime_error or std::exception in case of error
+             */
+
+            void find(std::span<const uint32_t> file_ids, std::span<uint32_t> entry_indices) const;
+
+            uint32_t size() const { return ids_number; }
+            bool empty() const { return ids_number == 0; }
+
+        private:
+            struct alignas(32) Group
+            {
+                uint32_t file_ids[FILE_ID_INDEX_GROUP_SIZE];
+                uint32_t entry_indices[FILE_ID_INDEX_GROUP_SIZE];
+            };
+
+            uint32_t first_group(uint32_t file_id) const;
+            void grow();
+
+            std::vector<Group> groups_data;
+            uint32_t groups_mask;
+            uint32_t hash_shift;
+            uint32_t ids_number;
+        };
+
+    }
+}
+
+#endif // GW2DATTOOLS_ARCHIVE_FILEIDINDEX_H
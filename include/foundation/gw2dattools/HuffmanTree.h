@@ -17,30 +17,59 @@ namespace gw2dt
                   uint16_t MAX_SYMBOL_VALUE>
         class HuffmanTreeBuilder;
 
+        // Huffman tree of the dat and texture decoders
         // Assumption: code length <= 32
+        //
+        // Codes are resolved through a two level lookup table:
+        //  - the hash table is indexed by the next MAX_BITS_HASH bits and directly
+        //    gives the symbol of every code of MAX_BITS_HASH bits or less,
+        //  - for longer codes the hash entry points to a subhash table indexed by the
+        //    following bits (at most MAX_BITS_SUBHASH of them).
+        // Codes longer than MAX_BITS_HASH + MAX_BITS_SUBHASH fall back to the
+        // canonical code_comparison search.
         template <typename SymbolType,
                   uint8_t MAX_BITS_HASH,
                   uint8_t MAX_CODE_BITS_LENGTH,
-                  uint16_t MAX_SYMBOL_VALUE>
+                  uint16_t MAX_SYMBOL_VALUE,
+                  uint8_t MAX_BITS_SUBHASH = 16 - MAX_BITS_HASH>
         class HuffmanTree
         {
         public:
             friend class HuffmanTreeBuilder<SymbolType, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>;
 
-            template <typename IntType>
-            void read_code(utils::BitArray<IntType> &ioInputBitArray, SymbolType &symbol_data) const;
+            // At least 32 bits must be available in the BitArray (see BitArray::refill)
+            template <typename SkipPolicy, typename CheckPolicy>
+            void read_code(utils::BitArray<SkipPolicy, CheckPolicy> &ioInputBitArray, SymbolType &symbol_data) const;
 
         private:
-            void clear();
+            static_assert(sizeof(SymbolType) <= sizeof(uint16_t), "SymbolType must fit in 16 bits.");
+            static_assert(MAX_BITS_HASH + MAX_BITS_SUBHASH <= 32, "Lookup tables can not be wider than 32 bits.");
+
+            // code_bits != 0: value_data is the symbol and code_bits the full code length
+            // subhash_bits != 0: value_data is the offset of the subhash table
+            // both 0: code has to be searched in code_comparison
+            struct HashEntry
+            {
+                uint16_t value_data;
+                uint8_t code_bits;
+                uint8_t subhash_bits;
+            };
+
+            static const uint32_t SUBHASH_TABLES_SIZE = (MAX_SYMBOL_VALUE < (1 << MAX_BITS_HASH) ? MAX_SYMBOL_VALUE : (1 << MAX_BITS_HASH)) << MAX_BITS_SUBHASH;
+
+            template <typename SkipPolicy, typename CheckPolicy>
+            void read_code_slow(utils::BitArray<SkipPolicy, CheckPolicy> &ioInputBitArray, SymbolType &symbol_data) const;
+
+            constexpr void clear();
 
             std::array<uint32_t, MAX_CODE_BITS_LENGTH> code_comparison;
             std::array<uint16_t, MAX_CODE_BITS_LENGTH> symbol_value_offset;
             std::array<SymbolType, MAX_SYMBOL_VALUE> symbol_value;
             std::array<uint8_t, MAX_CODE_BITS_LENGTH> code_bits;
 
-            std::array<bool, (1 << MAX_BITS_HASH)> symbol_value_hash_exist;
-            std::array<SymbolType, (1 << MAX_BITS_HASH)> symbol_value_hash;
-            std::array<uint8_t, (1 << MAX_BITS_HASH)> code_bits_hash;
+            std::array<HashEntry, (1 << MAX_BITS_HASH)> hash_data;
+            std::array<HashEntry, SUBHASH_TABLES_SIZE> subhash_data;
+            uint32_t subhash_size;
         };
 
         template <typename SymbolType,
@@ -49,15 +78,16 @@ namespace gw2dt
         class HuffmanTreeBuilder
         {
         public:
-            void clear();
+            constexpr void clear();
 
-            void add_symbol(SymbolType symbol_type, uint8_t bits_data);
+            constexpr void add_symbol(SymbolType symbol_type, uint8_t bits_data);
 
-            template <uint8_t MAX_BITS_HASH>
-            bool build_huffmantree(HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE> &oHuffmanTree);
+            // Can be evaluated at compile time
+            template <uint8_t MAX_BITS_HASH, uint8_t MAX_BITS_SUBHASH>
+            constexpr bool build_huffmantree(HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE, MAX_BITS_SUBHASH> &oHuffmanTree);
 
         private:
-            bool empty() const;
+            constexpr bool empty() const;
 
             std::array<bool, MAX_CODE_BITS_LENGTH> bits_head_exist;
             std::array<SymbolType, MAX_CODE_BITS_LENGTH> bits_head;
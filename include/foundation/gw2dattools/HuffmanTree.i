@@ -11,60 +11,91 @@ namespace gw2dt
         template <typename SymbolType,
                   uint8_t MAX_BITS_HASH,
                   uint8_t MAX_CODE_BITS_LENGTH,
-                  uint16_t MAX_SYMBOL_VALUE>
-        void HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::clear()
+                  uint16_t MAX_SYMBOL_VALUE,
+                  uint8_t MAX_BITS_SUBHASH>
+        constexpr void HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE, MAX_BITS_SUBHASH>::clear()
         {
             code_comparison.fill(0);
             symbol_value_offset.fill(0);
             symbol_value.fill(0);
             code_bits.fill(0);
 
-            symbol_value_hash_exist.fill(false);
-            symbol_value_hash.fill(0);
-            code_bits_hash.fill(0);
+            hash_data.fill(HashEntry{0, 0, 0});
+            // subhash tables are cleared when they are allocated
+            subhash_size = 0;
         }
 
         template <typename SymbolType,
                   uint8_t MAX_BITS_HASH,
                   uint8_t MAX_CODE_BITS_LENGTH,
-                  uint16_t MAX_SYMBOL_VALUE>
-        template <typename IntType>
-        void HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::read_code(utils::BitArray<IntType> &ioInputBitArray, SymbolType &symbol_data) const
+                  uint16_t MAX_SYMBOL_VALUE,
+                  uint8_t MAX_BITS_SUBHASH>
+        template <typename SkipPolicy, typename CheckPolicy>
+        void HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE, MAX_BITS_SUBHASH>::read_code(utils::BitArray<SkipPolicy, CheckPolicy> &ioInputBitArray, SymbolType &symbol_data) const
         {
             uint32_t hash_value;
-            ioInputBitArray.read_lazy(MAX_BITS_HASH, hash_value);
+            ioInputBitArray.template read_lazy<MAX_BITS_HASH>(hash_value);
 
-            bool exist = symbol_value_hash_exist[hash_value];
+            HashEntry hash_entry = hash_data[hash_value];
 
-            if (exist)
+            if (hash_entry.code_bits != 0)
             {
-                symbol_data = symbol_value_hash[hash_value];
-                IntType code_bits_hash_data = code_bits_hash[hash_value];
-
-                ioInputBitArray.drop(code_bits_hash_data);
+                symbol_data = static_cast<SymbolType>(hash_entry.value_data);
+                ioInputBitArray.drop_lazy(hash_entry.code_bits);
+                return;
             }
-            else
+
+            if (hash_entry.subhash_bits != 0)
             {
-                ioInputBitArray.read_lazy(hash_value);
+                uint32_t subhash_value;
+                ioInputBitArray.read_lazy(MAX_BITS_HASH + hash_entry.subhash_bits, subhash_value);
 
-                uint16_t index_data = 0;
-                while (hash_value < code_comparison[index_data])
+                hash_entry = subhash_data[hash_entry.value_data + (subhash_value & ((1 << hash_entry.subhash_bits) - 1))];
+
+                if (hash_entry.code_bits != 0)
                 {
-                    ++index_data;
+                    symbol_data = static_cast<SymbolType>(hash_entry.value_data);
+                    ioInputBitArray.drop_lazy(hash_entry.code_bits);
+                    return;
                 }
+            }
 
-                uint8_t temp_bits = code_bits[index_data];
-                symbol_data = symbol_value[symbol_value_offset[index_data] -
-                                           ((hash_value - code_comparison[index_data]) >> (32 - temp_bits))];
+            read_code_slow(ioInputBitArray, symbol_data);
+        }
 
-                ioInputBitArray.drop(temp_bits);
+        template <typename SymbolType,
+                  uint8_t MAX_BITS_HASH,
+                  uint8_t MAX_CODE_BITS_LENGTH,
+                  uint16_t MAX_SYMBOL_VALUE,
+                  uint8_t MAX_BITS_SUBHASH>
+        template <typename SkipPolicy, typename CheckPolicy>
+        void HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE, MAX_BITS_SUBHASH>::read_code_slow(utils::BitArray<SkipPolicy, CheckPolicy> &ioInputBitArray, SymbolType &symbol_data) const
+        {
+            uint32_t hash_value;
+            ioInputBitArray.read_lazy(hash_value);
+
+            uint16_t index_data = 0;
+            while (hash_value < code_comparison[index_data])
+            {
+                ++index_data;
             }
+
+            uint8_t temp_bits = code_bits[index_data];
+            if (temp_bits == 0)
+            {
+                throw std::runtime_error("Invalid Huffman code.");
+            }
+
+            symbol_data = symbol_value[symbol_value_offset[index_data] -
+                                       ((hash_value - code_comparison[index_data]) >> (32 - temp_bits))];
+
+            ioInputBitArray.drop_lazy(temp_bits);
         }
 
         template <typename SymbolType,
                   uint8_t MAX_CODE_BITS_LENGTH,
                   uint16_t MAX_SYMBOL_VALUE>
-        void HuffmanTreeBuilder<SymbolType, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::clear()
+        constexpr void HuffmanTreeBuilder<SymbolType, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::clear()
         {
             bits_head_exist.fill(false);
             bits_head.fill(0);
@@ -76,7 +107,7 @@ namespace gw2dt
         template <typename SymbolType,
                   uint8_t MAX_CODE_BITS_LENGTH,
                   uint16_t MAX_SYMBOL_VALUE>
-        void HuffmanTreeBuilder<SymbolType, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::add_symbol(SymbolType symbol_type, uint8_t bits_data)
+        constexpr void HuffmanTreeBuilder<SymbolType, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::add_symbol(SymbolType symbol_type, uint8_t bits_data)
         {
 
             if (bits_head_exist[bits_data])
@@ -95,7 +126,7 @@ namespace gw2dt
         template <typename SymbolType,
                   uint8_t MAX_CODE_BITS_LENGTH,
                   uint16_t MAX_SYMBOL_VALUE>
-        bool HuffmanTreeBuilder<SymbolType, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::empty() const
+        constexpr bool HuffmanTreeBuilder<SymbolType, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::empty() const
         {
             for (auto &it : bits_head_exist)
             {
@@ -110,9 +141,13 @@ namespace gw2dt
         template <typename SymbolType,
                   uint8_t MAX_CODE_BITS_LENGTH,
                   uint16_t MAX_SYMBOL_VALUE>
-        template <uint8_t MAX_BITS_HASH>
-        bool HuffmanTreeBuilder<SymbolType, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::build_huffmantree(HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE> &oHuffmanTree)
+        template <uint8_t MAX_BITS_HASH, uint8_t MAX_BITS_SUBHASH>
+        constexpr bool HuffmanTreeBuilder<SymbolType, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE>::build_huffmantree(HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE, MAX_BITS_SUBHASH> &oHuffmanTree)
         {
+            typedef typename HuffmanTree<SymbolType, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE, MAX_BITS_SUBHASH>::HashEntry HashEntry;
+
+            const uint32_t hash_mask = (1 << MAX_BITS_HASH) - 1;
+
             if (empty())
             {
                 return false;
@@ -120,12 +155,14 @@ namespace gw2dt
 
             oHuffmanTree.clear();
 
-            // Building the HuffmanTree
+            // First part, finding for every hash value the longest code starting with it
+            std::array<uint8_t, (1 << MAX_BITS_HASH)> subhash_bits;
+            subhash_bits.fill(0);
+
             uint32_t temp_code = 0;
             uint8_t temp_bits = 0;
 
-            // First part, filling hashTable for codes that are of less than 8 bits
-            while (temp_bits <= MAX_BITS_HASH)
+            while (temp_bits < MAX_CODE_BITS_LENGTH)
             {
                 bool data_exist = bits_head_exist[temp_bits];
 
@@ -135,16 +172,18 @@ namespace gw2dt
 
                     while (data_exist)
                     {
-                        // Processing hash values
-                        uint16_t hash_value = static_cast<uint16_t>(temp_code << (MAX_BITS_HASH - temp_bits));
-                        uint16_t next_hash_value = static_cast<uint16_t>((temp_code + 1) << (MAX_BITS_HASH - temp_bits));
-
-                        while (hash_value < next_hash_value)
+                        if (temp_bits > MAX_BITS_HASH)
                         {
-                            oHuffmanTree.symbol_value_hash_exist[hash_value] = true;
-                            oHuffmanTree.symbol_value_hash[hash_value] = current_symbol;
-                            oHuffmanTree.code_bits_hash[hash_value] = temp_bits;
-                            ++hash_value;
+                            uint32_t hash_value = (temp_code >> (temp_bits - MAX_BITS_HASH)) & hash_mask;
+                            uint8_t extra_bits = temp_bits - MAX_BITS_HASH;
+                            if (extra_bits > MAX_BITS_SUBHASH)
+                            {
+                                extra_bits = MAX_BITS_SUBHASH;
+                            }
+                            if (extra_bits > subhash_bits[hash_value])
+                            {
+                                subhash_bits[hash_value] = extra_bits;
+                            }
                         }
 
                         data_exist = bits_body_exist[current_symbol];
@@ -157,10 +196,14 @@ namespace gw2dt
                 ++temp_bits;
             }
 
+            // Second part, filling the hash and subhash tables, and the classical structure
+            // for codes longer than the hash
             uint16_t temp_code_comparison_index = 0;
             uint16_t symbol_offset = 0;
 
-            // Second part, filling classical structure for other codes
+            temp_code = 0;
+            temp_bits = 0;
+
             while (temp_bits < MAX_CODE_BITS_LENGTH)
             {
                 bool data_exist = bits_head_exist[temp_bits];
@@ -171,26 +214,76 @@ namespace gw2dt
 
                     while (data_exist)
                     {
-                        // Registering the code
-                        oHuffmanTree.symbol_value[symbol_offset] = current_symbol;
+                        if (temp_bits <= MAX_BITS_HASH)
+                        {
+                            // Processing hash values
+                            uint32_t hash_value = (temp_code << (MAX_BITS_HASH - temp_bits)) & hash_mask;
+                            uint32_t next_hash_value = hash_value + (1 << (MAX_BITS_HASH - temp_bits));
+                            if (next_hash_value > hash_mask + 1)
+                            {
+                                next_hash_value = hash_mask + 1;
+                            }
+
+                            while (hash_value < next_hash_value)
+                            {
+                                oHuffmanTree.hash_data[hash_value] = HashEntry{static_cast<uint16_t>(current_symbol), temp_bits, 0};
+                                ++hash_value;
+                            }
+                        }
+                        else
+                        {
+                            uint8_t extra_bits = temp_bits - MAX_BITS_HASH;
+                            uint32_t hash_value = (temp_code >> extra_bits) & hash_mask;
+                            uint8_t table_bits = subhash_bits[hash_value];
+
+                            HashEntry &hash_entry = oHuffmanTree.hash_data[hash_value];
+                            if (hash_entry.subhash_bits == 0)
+                            {
+                                // Allocating the subhash table of this hash value
+                                hash_entry = HashEntry{static_cast<uint16_t>(oHuffmanTree.subhash_size), 0, table_bits};
+                                for (uint32_t index_data = 0; index_data < (1u << table_bits); ++index_data)
+                                {
+                                    oHuffmanTree.subhash_data[oHuffmanTree.subhash_size + index_data] = HashEntry{0, 0, 0};
+                                }
+                                oHuffmanTree.subhash_size += (1 << table_bits);
+                            }
+
+                            // Codes too long for the subhash table are left to the code_comparison search
+                            if (extra_bits <= table_bits)
+                            {
+                                uint32_t subhash_value = (temp_code << (table_bits - extra_bits)) & ((1 << table_bits) - 1);
+                                uint32_t next_subhash_value = subhash_value + (1 << (table_bits - extra_bits));
+
+                                while (subhash_value < next_subhash_value)
+                                {
+                                    oHuffmanTree.subhash_data[hash_entry.value_data + subhash_value] = HashEntry{static_cast<uint16_t>(current_symbol), temp_bits, 0};
+                                    ++subhash_value;
+                                }
+                            }
+
+                            // Registering the code
+                            oHuffmanTree.symbol_value[symbol_offset] = current_symbol;
+                            ++symbol_offset;
+                        }
 
-                        ++symbol_offset;
                         data_exist = bits_body_exist[current_symbol];
                         current_symbol = bits_body[current_symbol];
-
                         --temp_code;
                     }
 
-                    // Minimum code value for temp_bits bits
-                    oHuffmanTree.code_comparison[temp_code_comparison_index] = ((temp_code + 1) << (32 - temp_bits));
+                    if (temp_bits > MAX_BITS_HASH)
+                    {
+                        // Minimum code value for temp_bits bits
+                        oHuffmanTree.code_comparison[temp_code_comparison_index] = ((temp_code + 1) << (32 - temp_bits));
 
-                    // Number of bits for l_codeCompIndex index
-                    oHuffmanTree.code_bits[temp_code_comparison_index] = temp_bits;
+                        // Number of bits for l_codeCompIndex index
+                        oHuffmanTree.code_bits[temp_code_comparison_index] = temp_bits;
 
-                    // Offset in symbol_value table to reach the value
-                    oHuffmanTree.symbol_value_offset[temp_code_comparison_index] = symbol_offset - 1;
+                        // Offset in symbol_value table to reach the value
+                        oHuffmanTree.symbol_value_offset[temp_code_comparison_index] = symbol_offset - 1;
 
-                    ++temp_code_comparison_index;
+                        ++temp_code_comparison_index;
+                    }
                 }
 
                 temp_code = (temp_code << 1) + 1;
@@ -0,0 +1,45 @@
+#ifndef GW2DATTOOLS_UTILS_MAPPEDFILE_H
+#define GW2DATTOOLS_UTILS_MAPPEDFILE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+
+namespace gw2dt
+{
+    namespace utils
+    {
+
+        // Read only mapping of a whole file
+        // Nothing is read when the file is opened, pages are loaded by the system when they are first touched.
+        class MappedFile
+        {
+        public:
+            MappedFile() noexcept;
+            // Throws if the file can not be opened or mapped
+            explicit MappedFile(const std::filesystem::path &file_path);
+            MappedFile(MappedFile &&other) noexcept;
+            MappedFile &operator=(MappedFile &&other) noexcept;
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+            ~MappedFile();
+
+            const uint8_t *data() const noexcept { return mapped_data; }
+            uint64_t size() const noexcept { return mapped_size; }
+            std::span<const uint8_t> span() const noexcept { return {mapped_data, static_cast<size_t>(mapped_size)}; }
+
+            // Bytes from offset to offset + size, throws if they are not all in the file
+            std::span<const uint8_t> range(uint64_t offset, uint64_t size) const;
+
+            void close() noexcept;
+
+        private:
+            const uint8_t *mapped_data;
+            uint64_t mapped_size;
+        };
+
+    }
+}
+
+#endif // GW2DATTOOLS_UTILS_MAPPEDFILE_H
@@ -0,0 +1,60 @@
+#ifndef GW2DATTOOLS_UTILS_WORKERPOOL_H
+#define GW2DATTOOLS_UTILS_WORKERPOOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gw2dt
+{
+    namespace utils
+    {
+
+        // Fixed set of worker threads started once and reused by every run.
+        // A run hands the same task to every worker and waits for all of them, runs are done one at a time.
+        class WorkerPool
+        {
+        public:
+            // Called once per worker thread, worker_index is below threads_number
+            typedef std::function<void(uint32_t worker_index)> Task;
+
+            // threads_number: 0 to use one thread per hardware thread
+            explicit WorkerPool(uint32_t threads_number = 0);
+            ~WorkerPool();
+
+            WorkerPool(const WorkerPool &) = delete;
+            WorkerPool &operator=(const WorkerPool &) = delete;
+
+            uint32_t threads_number() const { return static_cast<uint32_t>(worker_threads.size()); }
+
+            // Runs task_function on every worker and returns once they are all done
+            // The first exception thrown by the task is rethrown once the run is over
+            void run(const Task &task_function);
+
+        private:
+            void worker_loop(uint32_t worker_index);
+
+            std::vector<std::thread> worker_threads;
+
+            // Only one run at a time
+            std::mutex run_mutex;
+
+            std::mutex state_mutex;
+            std::condition_variable work_condition;
+            std::condition_variable done_condition;
+            const Task *current_task;
+            // Workers that did not finish the current run yet
+            uint32_t active_workers;
+            uint64_t run_generation;
+            std::exception_ptr task_error;
+            bool is_stopping;
+        };
+
+    }
+}
+
+#endif // GW2DATTOOLS_UTILS_WORKERPOOL_H
@@ -0,0 +1,137 @@
+#ifndef GW2DATTOOLS_COMPRESSION_DECODETEXTUREBLOCKS_H
+#define GW2DATTOOLS_COMPRESSION_DECODETEXTUREBLOCKS_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <stdexcept>
+
+#include "foundation/gw2dattools/BufferPool.h"
+#include "foundation/gw2dattools/inflateTextureFileBuffer.h"
+
+namespace gw2dt
+{
+    namespace compression
+    {
+        // Software decoding of the blocks returned by inflate_texture_file_buffer to RGBA pixels, 8 bits per channel.
+        // Supported formats: DXT1 to DXT5 (BC1 to BC3), DXTA and DXTL (BC4, expanded to gray),
+        // DXTN and 3DCX (BC5 normal maps, the blue channel holds the reconstructed Z) and BC7X (BC7).
+        // BC6H is decoded to RGBA half floats, 16 bits per channel with an alpha of 1.
+        // DXT2 and DXT4 are converted from premultiplied alpha to straight alpha.
+        // Nothing is allocated while decoding, the blocks crossing the right or bottom edge
+        // go through a 4x4 pixels tile on the stack, so any number of threads can decode at once,
+        // each one on its own rows of blocks of the same image.
+
+        enum class TextureDecodeKernel : uint8_t
+        {
+            Automatic, // Fastest kernel supported by the CPU
+            Scalar,
+            SSE2,
+            AVX2
+        };
+
+        // Every kernel gives exactly the same pixels
+        bool is_texture_decode_kernel_supported(TextureDecodeKernel kernel);
+        // Kernel used by TextureDecodeKernel::Automatic
+        TextureDecodeKernel get_texture_decode_kernel();
+
+        bool is_texture_format_decodable(uint32_t format_four_cc);
+
+        // Bytes of a decoded pixel: 8 for the half floats of BC6H, 4 otherwise
+        uint32_t get_decoded_pixel_size(uint32_t format_four_cc);
+
+        // Size of the decoded image, get_decoded_pixel_size bytes per pixel, rows of width pixels without padding
+        uint64_t get_decoded_texture_size(const AnetImage &anet_image);
+
+        /** @Inputs:
+         *    - anet_image: header of the image, as returned by inflate_texture_file_buffer
+         *    - block_data: Blocks of the image, as returned by inflate_texture_file_buffer
+         *    - output_data: Caller provided buffer of at least get_decoded_texture_size bytes
+         *    - kernel: Implementation to use
+         *  @Return:
+         *    - Number of bytes written in output_data
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        uint32_t decode_texture_blocks(const AnetImage &anet_image, std::span<const uint8_t> block_data, std::span<uint8_t> output_data,
+                                       TextureDecodeKernel kernel = TextureDecodeKernel::Automatic);
+
+        // Number of rows of 4x4 blocks of the image
+        uint32_t get_texture_block_rows(const AnetImage &anet_image);
+
+        /** @Inputs:
+         *    - anet_image: header of the image, as returned by inflate_texture_file_buffer
+         *    - block_data: Blocks of the whole image, as returned by inflate_texture_file_buffer
+         *    - first_block_row: First row of blocks to decode
+         *    - block_rows_number: Number of rows of blocks to decode
+         *    - output_data: Buffer of the whole image, of at least get_decoded_texture_size bytes,
+         *                   only the pixels of the decoded rows are written
+         *    - kernel: Implementation to use
+         *  @Return:
+         *    - Size of the whole decoded image
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        uint32_t decode_texture_block_rows(const AnetImage &anet_image, std::span<const uint8_t> block_data, uint32_t first_block_row, uint32_t block_rows_number,
+                                           std::span<uint8_t> output_data, TextureDecodeKernel kernel = TextureDecodeKernel::Automatic);
+
+        /** @Inputs:
+         *    - anet_image: header of the image, as returned by inflate_texture_file_buffer
+         *    - block_data: Blocks of the image, as returned by inflate_texture_file_buffer
+         *    - buffer_pool: Pool the output buffer is taken from
+         *    - kernel: Implementation to use
+         *  @Return:
+         *    - The output buffer, its size is get_decoded_texture_size
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        utils::PooledBuffer decode_texture_blocks(const AnetImage &anet_image, std::span<const uint8_t> block_data, utils::BufferPool &buffer_pool,
+                                                  TextureDecodeKernel kernel = TextureDecodeKernel::Automatic);
+
+        // Thumbnails are approximated from the endpoints of the blocks, the texels are never expanded:
+        // every block gives one pixel, the mean of its endpoints, and this 1/4 scale image is box filtered.
+        // BPTC blocks are the exception, their texels are decoded and averaged. Thumbnails are always RGBA 8 bits,
+        // the colors of BC6H are clamped to 1.
+
+        // Size of a thumbnail at most max_size pixels wide and high, keeping the aspect of the image
+        // Images smaller than max_size keep their size
+        void get_texture_thumbnail_dimensions(const AnetImage &anet_image, uint32_t max_size, uint32_t &thumbnail_width, uint32_t &thumbnail_height);
+
+        /** @Inputs:
+         *    - anet_image: header of the image, as returned by inflate_texture_file_buffer
+         *    - block_data: Blocks of the image, as returned by inflate_texture_file_buffer
+         *    - thumbnail_width: Width of the thumbnail
+         *    - thumbnail_height: Height of the thumbnail
+         *    - output_data: Caller provided buffer of at least thumbnail_width * thumbnail_height * 4 bytes
+         *  @Return:
+         *    - Number of bytes written in output_data
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        uint32_t make_texture_thumbnail(const AnetImage &anet_image, std::span<const uint8_t> block_data, uint32_t thumbnail_width, uint32_t thumbnail_height,
+                                        std::span<uint8_t> output_data);
+
+        /** @Inputs:
+         *    - anet_image: header of the image, as returned by inflate_texture_file_buffer
+         *    - block_data: Blocks of the image, as returned by inflate_texture_file_buffer
+         *    - max_size: Biggest width and height of the thumbnail
+         *    - buffer_pool: Pool the output buffer is taken from
+         *  @Outputs:
+         *    - thumbnail_width: Width of the thumbnail, see get_texture_thumbnail_dimensions
+         *    - thumbnail_height: Height of the thumbnail
+         *  @Return:
+         *    - The output buffer
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        utils::PooledBuffer make_texture_thumbnail(const AnetImage &anet_image, std::span<const uint8_t> block_data, uint32_t max_size, utils::BufferPool &buffer_pool,
+                                                   uint32_t &thumbnail_width, uint32_t &thumbnail_height);
+    }
+}
+
+#endif // GW2DATTOOLS_COMPRESSION_DECODETEXTUREBLOCKS_H
@@ -0,0 +1,87 @@
+#ifndef GW2DATTOOLS_COMPRESSION_DECODETEXTURETILES_H
+#define GW2DATTOOLS_COMPRESSION_DECODETEXTURETILES_H
+
+#include <cstdint>
+#include <span>
+
+#include "foundation/gw2dattools/BufferPool.h"
+#include "foundation/gw2dattools/WorkerPool.h"
+#include "foundation/gw2dattools/decodeTextureBlocks.h"
+
+namespace gw2dt
+{
+    namespace compression
+    {
+
+        // Blocks decoded by one worker at a time, 1 MB of pixels, rounded to whole rows of blocks
+        const uint32_t TEXTURE_TILE_STRIP_BLOCKS = 1 << 14;
+
+        struct TextureTileStatistics
+        {
+            uint32_t strips_number = 0;
+            // Threads that decoded at least one strip
+            uint32_t threads_number = 0;
+            uint64_t pixels_number = 0;
+            double elapsed_seconds = 0.0;
+
+            // Pixels per second
+            double throughput() const { return elapsed_seconds > 0.0 ? pixels_number / elapsed_seconds : 0.0; }
+        };
+
+        // Decodes the blocks of one big texture with decode_texture_block_rows on a pool of worker threads
+        // The image is split in strips of whole rows of blocks, each strip is written by one worker in the shared output.
+        // The threads are started once and reused by every image, images are decoded one at a time.
+        // Images of a single strip are decoded on the calling thread.
+        class TextureTileDecoder
+        {
+        public:
+            // threads_number: 0 to use one thread per hardware thread
+            explicit TextureTileDecoder(uint32_t threads_number = 0);
+
+            TextureTileDecoder(const TextureTileDecoder &) = delete;
+            TextureTileDecoder &operator=(const TextureTileDecoder &) = delete;
+
+            uint32_t threads_number() const { return worker_pool.threads_number(); }
+
+            /** @Inputs:
+             *    - anet_image: header of the image, as returned by inflate_texture_file_buffer
+             *    - block_data: Blocks of the image, as returned by inflate_texture_file_buffer or inflate_texture_block_buffer
+             *    - output_data: Caller provided buffer of at least get_decoded_texture_size bytes
+             *    - kernel: Implementation to use
+             *  @Outputs:
+             *    - statistics_data: if not null, statistics of the decoding
+             *  @Return:
+             *    - Number of bytes written in output_data
+             *  @Throws:
+             *    - gw2dt::std::runtime_error or std::exception in case of error
+             */
+
+            uint32_t decode(const AnetImage &anet_image, std::span<const uint8_t> block_data, std::span<uint8_t> output_data,
+                            TextureDecodeKernel kernel = TextureDecodeKernel::Automatic, TextureTileStatistics *statistics_data = nullptr);
+
+            /** @Inputs:
+             *    - anet_image: header of the image, as returned by inflate_texture_file_buffer
+             *    - block_data: Blocks of the image, as returned by inflate_texture_file_buffer or inflate_texture_block_buffer
+             *    - buffer_pool: Pool the output buffer is taken from
+             *    - kernel: Implementation to use
+             *  @Return:
+             *    - The output buffer, its size is get_decoded_texture_size
+             *  @Throws:
+             *    - gw2dt::std::runtime_error or std::exception in case of error
+             */
+
+            utils::PooledBuffer decode(const AnetImage &anet_image, std::span<const uint8_t> block_data, utils::BufferPool &buffer_pool,
+                                       TextureDecodeKernel kernel = TextureDecodeKernel::Automatic);
+
+        private:
+            struct Image;
+
+            void process_image(Image &image_data, uint32_t worker_index);
+
+            utils::WorkerPool worker_pool;
+        };
+
+    }
+}
+
+#endif // GW2DATTOOLS_COMPRESSION_DECODETEXTURETILES_H
@@ -0,0 +1,104 @@
+#ifndef GW2DATTOOLS_ARCHIVE_DEDUPEDATARCHIVEENTRIES_H
+#define GW2DATTOOLS_ARCHIVE_DEDUPEDATARCHIVEENTRIES_H
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "foundation/gw2dattools/ContentHash.h"
+#include "foundation/gw2dattools/DatArchive.h"
+#include "foundation/gw2dattools/inflateDatFileBatch.h"
+#include "foundation/gw2dattools/scanDatArchiveEntries.h"
+
+namespace gw2dt
+{
+    namespace archive
+    {
+
+        // Content of an entry once inflated
+        struct DatArchiveEntryContent
+        {
+            utils::ContentHash hash;
+            uint32_t size = 0;
+            // false for the unused slots and the entries that could not be inflated
+            bool is_hashed = false;
+        };
+
+        /** @Inputs:
+         *    - archive: Archive to hash
+         *    - batch_inflater: Threads the compressed entries are inflated and hashed on
+         *    - progress_callback: Told how far the pass is, can stop it
+         *  @Outputs:
+         *    - contents: One per MFT entry of archive, the hashed ones are skipped
+         *                and a stopped pass can be resumed
+         *  @Return:
+         *    - true if every entry has been hashed, false if progress_callback stopped the pass
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        bool hash_dat_archive_entries(const DatArchive &archive, std::span<DatArchiveEntryContent> contents,
+                                      compression::DatFileBatchInflater &batch_inflater,
+                                      const DatArchiveScanProgress &progress_callback = DatArchiveScanProgress());
+
+        struct DatArchiveDedupeStatistics
+        {
+            uint32_t hashed_entries = 0;
+            // Distinct contents among the hashed entries
+            uint32_t unique_contents = 0;
+            // Contents shared by several entries, and the entries sharing them
+            uint32_t shared_contents = 0;
+            uint32_t shared_entries = 0;
+            // Inflated bytes of the hashed entries, and once every content is counted once
+            uint64_t total_bytes = 0;
+            uint64_t unique_bytes = 0;
+            // Biggest content shared by several entries
+            uint32_t largest_shared_size = 0;
+
+            uint64_t duplicate_bytes() const { return total_bytes - unique_bytes; }
+        };
+
+        // Entries grouped by content, built from the result of hash_dat_archive_entries
+        // Entries are the same content when both their hash and their size match.
+        class DatArchiveDedupeIndex
+        {
+        public:
+            DatArchiveDedupeIndex() = default;
+            explicit DatArchiveDedupeIndex(std::span<const DatArchiveEntryContent> contents);
+
+            // Entries with the same content as entry_index, itself included, by increasing index
+            // Empty if the entry has not been hashed
+            std::span<const uint32_t> duplicates(uint32_t entry_index) const;
+            // First entry with the same content as entry_index, the only one an extractor has to write
+            // 0 if the entry has not been hashed
+            uint32_t canonical_entry(uint32_t entry_index) const;
+            // Entries with this content, empty if there is none
+            std::span<const uint32_t> find_entries(const utils::ContentHash &hash, uint32_t size) const;
+
+            uint32_t contents_count() const { return static_cast<uint32_t>(contents_data.size()); }
+            const DatArchiveDedupeStatistics &statistics() const { return statistics_data; }
+
+        private:
+            struct Content
+            {
+                utils::ContentHash hash;
+                uint32_t size;
+                // Range of the content in grouped_entries
+                uint32_t first_entry;
+                uint32_t entries_number;
+            };
+
+            // Sorted by hash then size
+            std::vector<Content> contents_data;
+            // Entries grouped by content
+            std::vector<uint32_t> grouped_entries;
+            // Content of every entry, UINT32_MAX if it has not been hashed
+            std::vector<uint32_t> entry_contents;
+            DatArchiveDedupeStatistics statistics_data;
+        };
+
+    }
+}
+
+#endif // GW2DATTOOLS_ARCHIVE_DEDUPEDATARCHIVEENTRIES_H
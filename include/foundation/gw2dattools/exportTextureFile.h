@@ -0,0 +1,56 @@
+#ifndef GW2DATTOOLS_COMPRESSION_EXPORTTEXTUREFILE_H
+#define GW2DATTOOLS_COMPRESSION_EXPORTTEXTUREFILE_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <stdexcept>
+
+#include "foundation/gw2dattools/BufferPool.h"
+#include "foundation/gw2dattools/inflateTextureFileBuffer.h"
+
+namespace gw2dt
+{
+    namespace compression
+    {
+        // The blocks returned by inflate_texture_file_buffer are standard BCn blocks,
+        // they are written as they are in DDS or KTX2 files, without decoding them.
+
+        enum class TextureFileContainer : uint8_t
+        {
+            DDS,
+            KTX2
+        };
+
+        bool is_texture_format_exportable(uint32_t format_four_cc);
+
+        /** @Inputs:
+         *    - output_stream: Stream the file is written to
+         *    - container: Type of file to write
+         *    - anet_image: header of the image, with its levels
+         *    - levels_data: Blocks of the first levels of the image, from the biggest,
+         *                   as returned by inflate_texture_file_level
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        void write_texture_file(std::ostream &output_stream, TextureFileContainer container, const AnetImage &anet_image,
+                                std::span<const std::span<const uint8_t>> levels_data);
+
+        /** @Inputs:
+         *    - input_data: Texture file to export
+         *    - output_stream: Stream the file is written to
+         *    - container: Type of file to write
+         *    - levels_number: Number of levels to export, 0 for every level of the file
+         *    - buffer_pool: Pool the inflated levels are taken from, one level is inflated at a time
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        void export_texture_file(std::span<const uint8_t> input_data, std::ostream &output_stream, TextureFileContainer container,
+                                 uint32_t levels_number = 0, utils::BufferPool &buffer_pool = utils::BufferPool::shared_pool());
+    }
+}
+
+#endif // GW2DATTOOLS_COMPRESSION_EXPORTTEXTUREFILE_H
@@ -0,0 +1,82 @@
+#ifndef GW2DATTOOLS_COMPRESSION_INFLATEDATFILEBATCH_H
+#define GW2DATTOOLS_COMPRESSION_INFLATEDATFILEBATCH_H
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "foundation/gw2dattools/BufferPool.h"
+#include "foundation/gw2dattools/WorkerPool.h"
+
+namespace gw2dt
+{
+    namespace compression
+    {
+
+        struct DatFileBatchJob
+        {
+            std::span<const uint8_t> input_data;
+            // if the value is 0 then we decode everything
+            // else we decode until we reach the output_data_size
+            uint32_t output_data_size = 0;
+        };
+
+        struct DatFileBatchResult
+        {
+            // Empty if the job failed
+            utils::PooledBuffer output_data;
+            // Exception thrown by the decoder, null if the job succeeded
+            std::exception_ptr error_data;
+        };
+
+        struct DatFileBatchStatistics
+        {
+            uint64_t jobs_number = 0;
+            uint64_t failed_jobs_number = 0;
+            uint64_t input_bytes = 0;
+            uint64_t output_bytes = 0;
+            double elapsed_seconds = 0.0;
+
+            // Bytes per second
+            double input_throughput() const { return elapsed_seconds > 0.0 ? input_bytes / elapsed_seconds : 0.0; }
+            double output_throughput() const { return elapsed_seconds > 0.0 ? output_bytes / elapsed_seconds : 0.0; }
+        };
+
+        // Decodes many dat entries with inflate_dat_file_buffer on a pool of worker threads
+        // The threads are started once and reused by every batch, batches are run one at a time.
+        class DatFileBatchInflater
+        {
+        public:
+            // Called from the worker threads, possibly concurrently, once per job
+            typedef std::function<void(size_t job_index, DatFileBatchResult &&result_data)> Completion;
+
+            // threads_number: 0 to use one thread per hardware thread
+            explicit DatFileBatchInflater(uint32_t threads_number = 0, utils::BufferPool &buffer_pool = utils::BufferPool::shared_pool());
+
+            DatFileBatchInflater(const DatFileBatchInflater &) = delete;
+            DatFileBatchInflater &operator=(const DatFileBatchInflater &) = delete;
+
+            uint32_t threads_number() const { return worker_pool.threads_number(); }
+
+            // Returns the results in the order of the jobs
+            std::vector<DatFileBatchResult> inflate(std::span<const DatFileBatchJob> jobs, DatFileBatchStatistics *statistics_data = nullptr);
+
+            // Hands every result to completion_callback as soon as it is decoded
+            // An exception thrown by the callback is rethrown once the batch is over
+            DatFileBatchStatistics inflate(std::span<const DatFileBatchJob> jobs, const Completion &completion_callback);
+
+        private:
+            struct Batch;
+
+            void process_batch(Batch &batch_data, uint32_t worker_index);
+
+            utils::BufferPool &buffer_pool;
+            utils::WorkerPool worker_pool;
+        };
+
+    }
+}
+
+#endif // GW2DATTOOLS_COMPRESSION_INFLATEDATFILEBATCH_H
@@ -2,8 +2,15 @@
 #define GW2DATTOOLS_COMPRESSION_INFLATEDATFILEBUFFER_H
 
 #include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <span>
 #include <string>
 #include <stdexcept>
+#include <vector>
+
+#include "foundation/gw2dattools/BufferPool.h"
 
 namespace gw2dt
 {
@@ -15,18 +22,175 @@ namespace gw2dt
          *    - input_data: Pointer to the buffer to inflate
          *    - output_data_size: if the value is 0 then we decode everything
          *                    else we decode until we reach the io_outputSize
-         *    - output_data: Optional output buffer, in case you provide this buffer,
-         *                   output_data_size shall be inferior or equal to the size of this buffer
          *  @Outputs:
          *    - output_data_size: actual size of the outputBuffer
          *  @Return:
-         *    - Pointer to the outputBuffer, nullptr if it failed
+         *    - Pointer to the outputBuffer, allocated with malloc and owned by the caller
          *  @Throws:
          *    - gw2dt::std::runtime_error or std::exception in case of error
          */
 
         uint8_t* inflate_dat_file_buffer(uint32_t input_size, const uint8_t* input_data, uint32_t& output_data_size);
 
+        /** @Inputs:
+         *    - input_data: Buffer to inflate
+         *    - output_data: Caller provided buffer, we decode until it is full or the data ends.
+         *                   Providing DAT_FILE_OUTPUT_SLACK_SIZE more bytes than needed speeds up the copies.
+         *  @Return:
+         *    - Number of bytes written in output_data
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        uint32_t inflate_dat_file_buffer(std::span<const uint8_t> input_data, std::span<uint8_t> output_data);
+
+        /** @Inputs:
+         *    - input_data: Buffer to inflate
+         *    - buffer_pool: Pool the output buffer is taken from
+         *    - output_data_size: if the value is 0 then we decode everything
+         *                    else we decode until we reach the output_data_size
+         *  @Return:
+         *    - The output buffer, its size is the number of bytes decoded
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        utils::PooledBuffer inflate_dat_file_buffer(std::span<const uint8_t> input_data, utils::BufferPool& buffer_pool, uint32_t output_data_size = 0);
+
+        /** @Inputs:
+         *    - input_data: Buffer to inflate
+         *  @Return:
+         *    - Size of the data once inflated, as written in its header
+         *  @Throws:
+         *    - gw2dt::std::runtime_error if the header is incomplete
+         */
+
+        uint32_t get_inflated_dat_file_size(std::span<const uint8_t> input_data);
+
+        // Extra bytes the decoder may use past the end of the output when they are available
+        const uint32_t DAT_FILE_OUTPUT_SLACK_SIZE = 32;
+
+        // Point where decoding can resume, always at the beginning of a block
+        struct DatFileCheckpoint
+        {
+            // Position of the block header in the input, in bits, skipped words excluded
+            uint64_t bit_position;
+            // Position in the output
+            uint32_t output_position;
+            // Output preceding output_position that copies may reach, at most 128KB
+            std::vector<uint8_t> window_data;
+        };
+
+        struct DatFileCheckpointIndex
+        {
+            uint32_t output_data_size = 0;
+            uint16_t write_size_const_addition = 0;
+            // Sorted by output_position, the first one is at the beginning of the output
+            std::vector<DatFileCheckpoint> checkpoints;
+        };
+
+        // Default minimum output size between two checkpoints
+        const uint32_t DAT_FILE_CHECKPOINT_INTERVAL = 1 << 20;
+
+        /** @Inputs:
+         *    - input_data: Buffer to inflate
+         *    - output_data: Caller provided buffer, we decode until it is full or the data ends.
+         *    - checkpoint_interval: a checkpoint is recorded at the first block starting at least
+         *                           checkpoint_interval bytes after the previous checkpoint
+         *  @Outputs:
+         *    - checkpoint_index: checkpoints of the decoded part of the data
+         *  @Return:
+         *    - Number of bytes written in output_data
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        uint32_t inflate_dat_file_buffer(std::span<const uint8_t> input_data, std::span<uint8_t> output_data,
+                                         DatFileCheckpointIndex &checkpoint_index, uint32_t checkpoint_interval = DAT_FILE_CHECKPOINT_INTERVAL);
+
+        /** @Inputs:
+         *    - input_data: Buffer to inflate
+         *    - checkpoint_index: Index recorded by a previous decode of input_data
+         *    - output_offset: Position in the inflated data of the first byte to decode
+         *    - output_data: Caller provided buffer, we decode until it is full or the indexed data ends.
+         *  @Return:
+         *    - Number of bytes written in output_data
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        uint32_t inflate_dat_file_range(std::span<const uint8_t> input_data, const DatFileCheckpointIndex &checkpoint_index,
+                                        uint32_t output_offset, std::span<uint8_t> output_data);
+
+        // Sidecar storage of a checkpoint index, read throws if the data is not a valid index
+        void write_dat_file_checkpoint_index(std::ostream &output_stream, const DatFileCheckpointIndex &checkpoint_index);
+        DatFileCheckpointIndex read_dat_file_checkpoint_index(std::istream &input_stream);
+
+        namespace dat
+        {
+            struct InflateState;
+        }
+
+        // Streaming version of inflate_dat_file_buffer
+        // The input can be given in pieces of any size, the output is handed to the sink as soon as it
+        // is decoded. Only the last 128KB of output, the farthest a copy can reach, are kept in memory.
+        class DatFileInflateStream
+        {
+        public:
+            typedef std::function<void(std::span<const uint8_t>)> Sink;
+
+            // output_data_size: if the value is 0 then we decode everything
+            //                   else we decode until we reach the output_data_size
+            explicit DatFileInflateStream(Sink sink, uint32_t output_data_size = 0);
+            ~DatFileInflateStream();
+
+            DatFileInflateStream(const DatFileInflateStream &) = delete;
+            DatFileInflateStream &operator=(const DatFileInflateStream &) = delete;
+
+            // Decodes as much as possible of the input received so far
+            void feed(std::span<const uint8_t> input_data);
+            // Decodes the rest of the input, throws if it ends before the output
+            void finish();
+
+            bool is_done() const { return stream_step == STEP_DONE; }
+            // Size of the whole output, known once the header has been read
+            uint32_t output_size() const { return output_data_size; }
+            // Number of bytes handed to the sink so far
+            uint64_t output_position() const { return window_base + window_emitted_position; }
+
+        private:
+            enum StreamStep
+            {
+                STEP_HEADER,
+                STEP_BLOCK_HEADER,
+                STEP_CODES,
+                STEP_DONE
+            };
+
+            void append_input(const uint8_t *input_data, size_t input_size);
+            void decode(bool is_last_input);
+            void emit();
+
+            Sink sink_callback;
+            std::unique_ptr<dat::InflateState> inflate_state;
+            StreamStep stream_step;
+
+            // Input words not consumed yet, without the skipped ones
+            std::vector<uint8_t> input_buffer;
+            uint32_t input_bit_offset;
+            uint64_t input_words_received;
+            uint8_t partial_word[4];
+            uint8_t partial_word_size;
+
+            // Decoded data, the beginning of the window is at window_base in the output
+            std::vector<uint8_t> window_data;
+            uint32_t window_position;
+            uint32_t window_emitted_position;
+            uint64_t window_base;
+
+            uint32_t output_data_size;
+        };
+
     }
 }
 
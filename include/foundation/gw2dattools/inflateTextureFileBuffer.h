@@ -2,37 +2,136 @@
 #define GW2DATTOOLS_COMPRESSION_INFLATETEXTUREFILEBUFFER_H
 
 #include <cstdint>
+#include <span>
 #include <string>
 #include <stdexcept>
 
+#include "foundation/gw2dattools/BufferPool.h"
+
 namespace gw2dt
 {
     namespace compression
     {
+        // The texture decoders only share immutable tables, they can be called from several threads at once
+
+        // Mip level of an image, the levels follow each other in the file from the biggest to the smallest
+        // Each one starts with the size of the rest of the level in bytes, then its compression flags
+        struct AnetImageLevel {
+            // Position of the level in the file, in bytes
+            uint32_t offset;
+            // Size of the level in the file, in bytes, its size field included
+            uint32_t size;
+            uint16_t width;
+            uint16_t height;
+        };
+
+        // 65535 pixels wide images have 16 levels down to 1 pixel
+        const uint32_t ANET_IMAGE_MAX_LEVELS = 16;
+
         struct AnetImage {
             uint32_t identifier;
             uint32_t format;
             uint16_t width;
             uint16_t height;
+
+            // Levels found in the file, the first one is the full image
+            uint32_t levels_number;
+            AnetImageLevel levels[ANET_IMAGE_MAX_LEVELS];
         };
 
+        // Header describing only one level of an image, as if it was the full image
+        AnetImage get_anet_image_level(const AnetImage& anet_image, uint32_t level_index);
+
+        // Smallest level at least max_width wide and max_height high, the first level if there is none
+        uint32_t find_anet_image_level(const AnetImage& anet_image, uint16_t max_width, uint16_t max_height);
+
+        // Identifiers of the texture files, they all start with the same header:
+        // the identifier, the format FourCC, then the width and the height on 16 bits each
+        bool is_anet_image_identifier(uint32_t identifier);
+
+        // Only the header and the size fields of the levels are read, nothing is inflated or allocated
+        /** @Inputs:
+         *    - input_data: Beginning of the texture file, at least its header of 12 bytes
+         *                  The levels are only listed as far as input_data goes
+         *  @Outputs:
+         *    - anet_image: header of the image, with its levels
+         *  @Return:
+         *    - Size of the data inflate_texture_file_buffer returns for this file
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        uint32_t probe_texture_file(std::span<const uint8_t> input_data, AnetImage& anet_image);
+
         /** @Inputs:
          *    - iinput_size: Size of the input buffer
          *    - input_data: Pointer to the buffer to inflate
-         *    - output_data_size: if the value is 0 then we decode everything
-         *                    else we decode until we reach the io_outputSize
-         *    - output_data: Optional output buffer, in case you provide this buffer,
-         *                   output_data_size shall be inferior or equal to the size of this buffer
+         *    - output_data_size: if the value is not 0, the size of the whole output must not be bigger
          *  @Outputs:
          *    - output_data_size: actual size of the outputBuffer
+         *    - anet_image: header of the image
          *  @Return:
-         *    - Pointer to the outputBuffer, nullptr if it failed
+         *    - Pointer to the outputBuffer, allocated with malloc and owned by the caller
          *  @Throws:
          *    - gw2dt::std::runtime_error or std::exception in case of error
          */
 
         uint8_t* inflate_texture_file_buffer(uint32_t iinput_size, const uint8_t* input_data, uint32_t& output_data_size, AnetImage& anet_image);
 
+        /** @Inputs:
+         *    - input_data: Buffer to inflate
+         *    - output_data: Caller provided buffer, big enough for the whole image
+         *  @Outputs:
+         *    - anet_image: header of the image
+         *  @Return:
+         *    - Number of bytes written in output_data
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        uint32_t inflate_texture_file_buffer(std::span<const uint8_t> input_data, std::span<uint8_t> output_data, AnetImage& anet_image);
+
+        /** @Inputs:
+         *    - input_data: Buffer to inflate
+         *    - buffer_pool: Pool the output buffer is taken from
+         *  @Outputs:
+         *    - anet_image: header of the image
+         *  @Return:
+         *    - The output buffer, its size is the size of the image
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        utils::PooledBuffer inflate_texture_file_buffer(std::span<const uint8_t> input_data, utils::BufferPool& buffer_pool, AnetImage& anet_image);
+
+        /** @Inputs:
+         *    - input_data: Buffer to inflate
+         *    - level_index: Level to inflate, the bigger levels are skipped without being decoded
+         *    - output_data: Caller provided buffer, big enough for the level
+         *  @Outputs:
+         *    - anet_image: header of the image, with all its levels
+         *  @Return:
+         *    - Number of bytes written in output_data
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        uint32_t inflate_texture_file_level(std::span<const uint8_t> input_data, uint32_t level_index, std::span<uint8_t> output_data, AnetImage& anet_image);
+
+        /** @Inputs:
+         *    - input_data: Buffer to inflate
+         *    - level_index: Level to inflate, the bigger levels are skipped without being decoded
+         *    - buffer_pool: Pool the output buffer is taken from
+         *  @Outputs:
+         *    - anet_image: header of the image, with all its levels
+         *  @Return:
+         *    - The output buffer, its size is the size of the level
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        utils::PooledBuffer inflate_texture_file_level(std::span<const uint8_t> input_data, uint32_t level_index, utils::BufferPool& buffer_pool, AnetImage& anet_image);
+
         /** @Inputs:
          *    - iWidth: Width of the texture
          *    - iHeight: Height of the texture
@@ -0,0 +1,68 @@
+#ifndef GW2DATTOOLS_ARCHIVE_SCANDATARCHIVEENTRIES_H
+#define GW2DATTOOLS_ARCHIVE_SCANDATARCHIVEENTRIES_H
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+
+#include "foundation/gw2dattools/DatArchive.h"
+#include "foundation/gw2dattools/DatArchiveIndex.h"
+#include "foundation/gw2dattools/inflateDatFileBatch.h"
+
+namespace gw2dt
+{
+    namespace archive
+    {
+
+        // Bytes inflated from every entry to find its type
+        const uint32_t DAT_ENTRY_SNIFF_SIZE = 256;
+
+        // Types found by sniff_dat_entry_type
+        // Textures keep their identifier ("ATEX", "ATTX"...) and pack files their file type ("ABNK", "MODL"...).
+        const uint32_t DAT_ENTRY_TYPE_UNKNOWN = 0;
+        const uint32_t DAT_ENTRY_TYPE_PACK_FILE = 0x00004650;  // "PF", pack file without a file type
+        const uint32_t DAT_ENTRY_TYPE_STRINGS = 0x73727473;    // "strs"
+        const uint32_t DAT_ENTRY_TYPE_OGG = 0x5367674F;        // "OggS"
+        const uint32_t DAT_ENTRY_TYPE_MP3 = 0x2033504D;        // "MP3 "
+        const uint32_t DAT_ENTRY_TYPE_RIFF = 0x46464952;       // "RIFF"
+        const uint32_t DAT_ENTRY_TYPE_PNG = 0x20474E50;        // "PNG "
+        const uint32_t DAT_ENTRY_TYPE_JPEG = 0x4745504A;       // "JPEG"
+        const uint32_t DAT_ENTRY_TYPE_DDS = 0x20534444;        // "DDS "
+        const uint32_t DAT_ENTRY_TYPE_BINK = 0x4B4E4942;       // "BINK"
+        const uint32_t DAT_ENTRY_TYPE_FONT = 0x544E4F46;       // "FONT"
+        const uint32_t DAT_ENTRY_TYPE_EXECUTABLE = 0x20455845; // "EXE ", executables and libraries
+
+        /** @Inputs:
+         *    - input_data: First bytes of an entry once inflated, DAT_ENTRY_SNIFF_SIZE of them are enough
+         *  @Return:
+         *    - Type of the entry, DAT_ENTRY_TYPE_UNKNOWN if it is not recognized
+         */
+
+        uint32_t sniff_dat_entry_type(std::span<const uint8_t> input_data);
+
+        // Called from the scanning thread after every chunk of entries, the scan stops if it returns false
+        typedef std::function<bool(uint32_t scanned_entries, uint32_t entries_number)> DatArchiveScanProgress;
+
+        /** @Inputs:
+         *    - archive: Archive to scan
+         *    - batch_inflater: Threads the compressed entries are inflated on
+         *    - progress_callback: Told how far the scan is, can stop it
+         *  @Outputs:
+         *    - entries: One entry per MFT entry of archive, as built by build_dat_archive_index_entries
+         *               The type and the uncompressed size of every entry are filled. Entries already
+         *               typed are skipped, a stopped scan can be resumed.
+         *  @Return:
+         *    - true if every entry has been scanned, false if progress_callback stopped the scan
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        bool scan_dat_archive_entries(const DatArchive &archive, std::span<DatArchiveIndexEntry> entries,
+                                      compression::DatFileBatchInflater &batch_inflater,
+                                      const DatArchiveScanProgress &progress_callback = DatArchiveScanProgress());
+
+    }
+}
+
+#endif // GW2DATTOOLS_ARCHIVE_SCANDATARCHIVEENTRIES_H
@@ -15,6 +15,8 @@
 #include "app/inspector/InspectorPanel.h"
 #include "app/SettingsDialog.h"
 #include "app/AboutDialog.h"
+#include "foundation/gw2dattools/DatArchive.h"
+#include "foundation/gw2dattools/DatArchiveIndex.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -26,6 +28,8 @@
 
 #include <nlohmann/json.hpp>
 
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -54,6 +58,112 @@ static std::string OpenFileDialog(const char *filter = nullptr)
     return {};
 }
 
+// -----------------------------------------------------------
+// Utility: per-user configuration directory
+// -----------------------------------------------------------
+static fs::path GetUserConfigDirectory()
+{
+#ifdef _WIN32
+    if (const char *appData = std::getenv("APPDATA"))
+        return fs::path(appData) / "gw2-viewer";
+#else
+    if (const char *configHome = std::getenv("XDG_CONFIG_HOME"))
+        return fs::path(configHome) / "gw2-viewer";
+    if (const char *home = std::getenv("HOME"))
+        return fs::path(home) / ".config" / "gw2-viewer";
+#endif
+    return fs::temp_directory_path() / "gw2-viewer";
+}
+
+// Sidecar index of an archive, one per archive path
+static fs::path GetArchiveIndexPath(const std::string &archivePath)
+{
+    // FNV-1a, stable between runs unlike std::hash
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (unsigned char c : fs::absolute(archivePath).string())
+        hash = (hash ^ c) * 0x100000001B3ull;
+
+    char name[17]{};
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+    return GetUserConfigDirectory() / "index" /
+           (fs::path(archivePath).stem().string() + "-" + name + ".idx");
+}
+
+// -----------------------------------------------------------
+// Utility: map a Gw2.dat and list its entries in the browser,
+// false if the file is not a dat archive
+// -----------------------------------------------------------
+static bool OpenDatArchive(AppState &state, const std::string &path)
+{
+    uint8_t magic[4]{};
+    std::ifstream f(path, std::ios::binary);
+    if (!f.read(reinterpret_cast<char *>(magic), sizeof(magic)) ||
+        !gw2dt::archive::is_dat_archive(magic))
+        return false;
+
+    try
+    {
+        state.archive = std::make_shared<gw2dt::archive::DatArchive>(path);
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+    const gw2dt::archive::DatArchive &archive = *state.archive;
+
+    // A warm start maps the index written last time, nothing is parsed.
+    // Otherwise the MFT and id table are read and the index rewritten.
+    const fs::path indexPath = GetArchiveIndexPath(path);
+    state.archiveIndexPath = indexPath.string();
+    try
+    {
+        state.archiveIndex = std::make_shared<gw2dt::archive::DatArchiveIndex>(indexPath);
+        if (!state.archiveIndex->matches(archive))
+            state.archiveIndex.reset();
+    }
+    catch (const std::exception &)
+    {
+        state.archiveIndex.reset();
+    }
+
+    state.archiveEntries.clear();
+    if (!state.archiveIndex)
+    {
+        std::vector<gw2dt::archive::DatArchiveIndexEntry> builtEntries = gw2dt::archive::build_dat_archive_index_entries(archive);
+        try
+        {
+            gw2dt::archive::write_dat_archive_index(indexPath, archive, builtEntries);
+            state.archiveIndex = std::make_shared<gw2dt::archive::DatArchiveIndex>(indexPath);
+        }
+        catch (const std::exception &)
+        {
+            // No cache this time, the archive is listed and scanned from memory
+            state.archiveEntries = std::move(builtEntries);
+        }
+    }
+    const std::span<const gw2dt::archive::DatArchiveIndexEntry> entries = state.ArchiveEntries();
+
+    state.browserRoot = path;
+    state.browserEntries.clear();
+    state.browserEntries.reserve(entries.size());
+    for (uint32_t i = 1; i < entries.size(); ++i)
+    {
+        // Unused MFT slots have no data
+        const gw2dt::archive::DatArchiveIndexEntry &entry = entries[i];
+        if (entry.size == 0)
+            continue;
+
+        FileEntry fe;
+        fe.name = entry.base_id != 0 ? std::to_string(entry.base_id) : "#" + std::to_string(i);
+        fe.path = path;
+        fe.size = entry.has_uncompressed_size() ? entry.uncompressed_size : entry.size;
+        fe.archiveEntry = i;
+        fe.typeFourCC = entry.has_four_cc() ? entry.four_cc : 0;
+        state.browserEntries.push_back(std::move(fe));
+    }
+    return true;
+}
+
 // -----------------------------------------------------------
 // GW2 custom theme
 // -----------------------------------------------------------
@@ -351,8 +461,14 @@ void Application::RenderMainMenuBar()
             if (!path.empty())
             {
                 m_State->ClearFile();
+                m_State->CloseArchive();
                 m_State->loadedFilePath = path;
+            }
 
+            // Dat archives are far too big to be read, they are mapped
+            // and their entries read one at a time from the browser
+            if (!path.empty() && !OpenDatArchive(*m_State, path))
+            {
                 // Read raw bytes
                 std::ifstream f(path, std::ios::binary);
                 if (f)
@@ -440,7 +556,10 @@ void Application::RenderMainMenuBar()
 
         ImGui::Separator();
         if (ImGui::MenuItem("Close File"))
+        {
             m_State->ClearFile();
+            m_State->CloseArchive();
+        }
 
         ImGui::Separator();
         if (ImGui::MenuItem("Exit", "Alt+F4"))
@@ -490,6 +609,12 @@ void Application::RenderMainMenuBar()
             status = "  " + p.filename().string() +
                      "  |  " + std::to_string(m_State->rawBytes.size()) + " bytes";
         }
+        else if (m_State->archive)
+        {
+            fs::path p(m_State->browserRoot);
+            status = "  " + p.filename().string() +
+                     "  |  " + std::to_string(m_State->browserEntries.size()) + " entries";
+        }
         else
         {
             status = "  No file loaded";
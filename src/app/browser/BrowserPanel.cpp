@@ -1,5 +1,9 @@
 #include "app/browser/BrowserPanel.h"
 #include "app/AppState.h"
+#include "foundation/gw2dattools/DatArchive.h"
+#include "foundation/gw2dattools/DatArchiveIndex.h"
+#include "foundation/gw2dattools/inflateTextureFileBuffer.h"
+#include "foundation/gw2dattools/scanDatArchiveEntries.h"
 
 #include <imgui.h>
 #include <nlohmann/json.hpp>
@@ -12,11 +16,84 @@
 
 namespace fs = std::filesystem;
 
+// Header of a game texture, false if the bytes are not one
+static bool ProbeAnetTexture(const std::vector<uint8_t> &bytes, gw2dt::compression::AnetImage &image)
+{
+    if (bytes.size() < 12)
+        return false;
+    uint32_t identifier;
+    std::memcpy(&identifier, bytes.data(), sizeof(identifier));
+    if (!gw2dt::compression::is_anet_image_identifier(identifier))
+        return false;
+    try
+    {
+        gw2dt::compression::probe_texture_file(bytes, image);
+        return true;
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+}
+
+// Pack file types played by the audio view
+static const uint32_t PACK_FILE_SOUND_BANK = 0x4B4E4241; // "ABNK"
+static const uint32_t PACK_FILE_SOUND = 0x444E5341;      // "ASND"
+
+// Archive entries have no extension, their sniffed type is used instead
+static bool IsArchiveAudioType(uint32_t type)
+{
+    using namespace gw2dt::archive;
+    return type == DAT_ENTRY_TYPE_OGG || type == DAT_ENTRY_TYPE_MP3 || type == DAT_ENTRY_TYPE_RIFF ||
+           type == PACK_FILE_SOUND_BANK || type == PACK_FILE_SOUND;
+}
+
+static const char *GetArchiveTypeIcon(uint32_t type)
+{
+    using namespace gw2dt::archive;
+    if (gw2dt::compression::is_anet_image_identifier(type))
+        return "[TEX]";
+    if (IsArchiveAudioType(type))
+        return "[AUD]";
+    switch (type)
+    {
+    case DAT_ENTRY_TYPE_UNKNOWN:
+        return "[BIN]";
+    case DAT_ENTRY_TYPE_PNG:
+    case DAT_ENTRY_TYPE_JPEG:
+    case DAT_ENTRY_TYPE_DDS:
+        return "[IMG]";
+    case DAT_ENTRY_TYPE_STRINGS:
+        return "[STR]";
+    case DAT_ENTRY_TYPE_BINK:
+        return "[VID]";
+    case DAT_ENTRY_TYPE_FONT:
+        return "[FNT]";
+    case DAT_ENTRY_TYPE_EXECUTABLE:
+        return "[EXE]";
+    default:
+        // Any other type is the file type of a pack file
+        return "[PF]";
+    }
+}
+
+static std::string FormatFourCC(uint32_t type)
+{
+    char fourCC[5]{};
+    std::memcpy(fourCC, &type, 4);
+    for (int i = 0; i < 4; ++i)
+        if (fourCC[i] == 0)
+            fourCC[i] = ' ';
+    return fourCC;
+}
+
 // File-type icons (unicode symbols rendered as ASCII fallback)
 static const char *GetFileIcon(const FileEntry &e)
 {
     if (e.isDir)
         return "[DIR]";
+    if (e.archiveEntry != 0)
+        return GetArchiveTypeIcon(e.typeFourCC);
     std::string n = e.name;
     auto ext = [&](const char *x)
     {
@@ -53,8 +130,15 @@ namespace panels
     {
     }
 
+    BrowserPanel::~BrowserPanel()
+    {
+        StopArchiveScan();
+    }
+
     void BrowserPanel::Render()
     {
+        UpdateArchiveScan();
+
         ImGui::Begin("Browser");
 
         RenderToolbar();
@@ -88,6 +172,16 @@ namespace panels
         ImGui::Checkbox("Files only", &m_ShowOnlyFiles);
         ImGui::SameLine();
         ImGui::TextDisabled("%zu entries", m_State->browserEntries.size());
+
+        // Type scan of the open archive
+        if (m_ScanThread.joinable() && !m_ScanFinished)
+        {
+            const uint32_t scanned = m_ScannedEntries;
+            const uint32_t total = std::max(1u, m_ScanEntriesNumber.load());
+            char overlay[64];
+            std::snprintf(overlay, sizeof(overlay), "Sniffing types %u / %u", scanned, total);
+            ImGui::ProgressBar((float)scanned / total, {-1, 0}, overlay);
+        }
     }
 
     void BrowserPanel::RenderEntryList()
@@ -107,6 +201,9 @@ namespace panels
             ImGui::TableSetupColumn("Size", ImGuiTableColumnFlags_WidthFixed, 60.f);
             ImGui::TableHeadersRow();
 
+            // Filtered entries, only the visible rows are drawn since
+            // archives list hundreds of thousands of entries
+            m_VisibleEntries.clear();
             for (int i = 0; i < (int)m_State->browserEntries.size(); ++i)
             {
                 const auto &e = m_State->browserEntries[i];
@@ -122,26 +219,39 @@ namespace panels
                         continue;
                 }
 
-                ImGui::TableNextRow();
-                ImGui::TableSetColumnIndex(0);
-                ImGui::TextDisabled("%s", GetFileIcon(e));
+                m_VisibleEntries.push_back(i);
+            }
 
-                ImGui::TableSetColumnIndex(1);
-                bool selected = (m_State->selectedEntry == i);
-                if (ImGui::Selectable(e.name.c_str(), selected,
-                                      ImGuiSelectableFlags_SpanAllColumns |
-                                          ImGuiSelectableFlags_AllowDoubleClick))
+            ImGuiListClipper clipper;
+            clipper.Begin((int)m_VisibleEntries.size());
+            while (clipper.Step())
+            {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
                 {
-                    m_State->selectedEntry = i;
-                    if (ImGui::IsMouseDoubleClicked(0))
-                        OpenEntry(i);
-                    else
-                        PopulateInspector(i);
+                    const int i = m_VisibleEntries[row];
+                    const auto &e = m_State->browserEntries[i];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::TextDisabled("%s", GetFileIcon(e));
+
+                    ImGui::TableSetColumnIndex(1);
+                    bool selected = (m_State->selectedEntry == i);
+                    if (ImGui::Selectable(e.name.c_str(), selected,
+                                          ImGuiSelectableFlags_SpanAllColumns |
+                                              ImGuiSelectableFlags_AllowDoubleClick))
+                    {
+                        m_State->selectedEntry = i;
+                        if (ImGui::IsMouseDoubleClicked(0))
+                            OpenEntry(i);
+                        else
+                            PopulateInspector(i);
+                    }
+
+                    ImGui::TableSetColumnIndex(2);
+                    if (!e.isDir)
+                        ImGui::TextDisabled("%s", FormatSize(e.size).c_str());
                 }
-
-                ImGui::TableSetColumnIndex(2);
-                if (!e.isDir)
-                    ImGui::TextDisabled("%s", FormatSize(e.size).c_str());
             }
 
             ImGui::EndTable();
@@ -166,6 +276,23 @@ namespace panels
         m_State->ClearFile();
         m_State->loadedFilePath = e.path;
 
+        // Archive entries are inflated from the mapping
+        if (e.archiveEntry != 0 && m_State->archive)
+        {
+            try
+            {
+                gw2dt::utils::PooledBuffer data = m_State->archive->read_entry(e.archiveEntry);
+                m_State->rawBytes.assign(data.data(), data.data() + data.size());
+                m_State->hasFile = true;
+            }
+            catch (const std::exception &)
+            {
+            }
+            DetectPreviewMode(index);
+            PopulateInspector(index);
+            return;
+        }
+
         std::ifstream f(e.path, std::ios::binary);
         if (f)
         {
@@ -259,7 +386,18 @@ namespace panels
             return nl.size() >= sl && nl.substr(nl.size() - sl) == suf;
         };
 
-        if (endsWith(".png") || endsWith(".jpg") || endsWith(".jpeg") ||
+        if (e.archiveEntry != 0)
+        {
+            if (gw2dt::compression::is_anet_image_identifier(e.typeFourCC) ||
+                e.typeFourCC == gw2dt::archive::DAT_ENTRY_TYPE_PNG ||
+                e.typeFourCC == gw2dt::archive::DAT_ENTRY_TYPE_JPEG)
+                m_State->previewMode = PreviewMode::Image;
+            else if (IsArchiveAudioType(e.typeFourCC))
+                m_State->previewMode = PreviewMode::Audio;
+            else
+                m_State->previewMode = PreviewMode::Hex;
+        }
+        else if (endsWith(".png") || endsWith(".jpg") || endsWith(".jpeg") ||
             endsWith(".bmp") || endsWith(".tga"))
             m_State->previewMode = PreviewMode::Image;
         else if (endsWith(".mp3") || endsWith(".ogg") || endsWith(".wav"))
@@ -284,9 +422,45 @@ namespace panels
         if (!e.isDir)
             m_State->inspectorProps.push_back({"Size", FormatSize(e.size)});
 
+        // Archive entry, from the listed entries when there are some
+        if (e.archiveEntry != 0 && m_State->archive)
+        {
+            try
+            {
+                const gw2dt::archive::DatArchive &archive = *m_State->archive;
+                gw2dt::archive::DatArchiveIndexEntry entry{};
+                const auto entries = m_State->ArchiveEntries();
+                if (e.archiveEntry < entries.size())
+                {
+                    entry = entries[e.archiveEntry];
+                }
+                else
+                {
+                    const gw2dt::archive::DatArchiveFileIds ids = archive.file_ids(e.archiveEntry);
+                    entry.base_id = ids.base_id;
+                    entry.file_id = ids.file_id;
+                    entry.compression_flag = archive.entry(e.archiveEntry).compression_flag;
+                }
+                // Otherwise read from the entry header
+                if (!entry.has_uncompressed_size())
+                    entry.uncompressed_size = archive.uncompressed_size(e.archiveEntry);
+
+                m_State->inspectorProps.push_back({"MFT Entry", std::to_string(e.archiveEntry)});
+                m_State->inspectorProps.push_back({"Base Id", std::to_string(entry.base_id)});
+                m_State->inspectorProps.push_back({"File Id", std::to_string(entry.file_id)});
+                m_State->inspectorProps.push_back({"Compressed", entry.compression_flag != 0 ? "Yes" : "No"});
+                m_State->inspectorProps.push_back({"Uncompressed Size", FormatSize(entry.uncompressed_size)});
+                if (entry.has_four_cc())
+                    m_State->inspectorProps.push_back({"Content Type", entry.four_cc != 0 ? FormatFourCC(entry.four_cc) : "Unknown"});
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+
         // Extension
         fs::path fp(e.path);
-        if (fp.has_extension())
+        if (fp.has_extension() && e.archiveEntry == 0)
             m_State->inspectorProps.push_back({"Extension", fp.extension().string()});
 
         // Last write time
@@ -314,6 +488,128 @@ namespace panels
                           m_State->rawBytes[2], m_State->rawBytes[3]);
             m_State->inspectorProps.push_back({"Magic Bytes", std::string(magic)});
         }
+
+        // Texture header, read without inflating the texture
+        gw2dt::compression::AnetImage image;
+        if (ProbeAnetTexture(m_State->rawBytes, image))
+        {
+            char fourCC[5]{};
+            std::memcpy(fourCC, &image.format, 4);
+            m_State->inspectorProps.push_back({"Format", std::string(fourCC)});
+            m_State->inspectorProps.push_back({"Dimensions", std::to_string(image.width) + " x " + std::to_string(image.height)});
+            m_State->inspectorProps.push_back({"Mip Levels", std::to_string(image.levels_number)});
+        }
+    }
+
+    void BrowserPanel::UpdateArchiveScan()
+    {
+        // Another archive was opened or the archive was closed
+        if (m_ScanArchive != m_State->archive)
+        {
+            StopArchiveScan();
+            m_ScanArchive = m_State->archive;
+
+            // Types are kept in the entries, a warm start has nothing to scan
+            if (!m_ScanArchive)
+                return;
+            const auto entries = m_State->ArchiveEntries();
+            if (std::all_of(entries.begin() + std::min<size_t>(1, entries.size()), entries.end(),
+                            [](const gw2dt::archive::DatArchiveIndexEntry &entry)
+                            { return entry.has_four_cc(); }))
+                return;
+
+            m_ScanEntries.assign(entries.begin(), entries.end());
+            m_ScanIndexPath = m_State->archiveIndexPath;
+            m_ScannedEntries = 0;
+            m_ScanEntriesNumber = entries.empty() ? 0 : (uint32_t)entries.size() - 1;
+            m_StopScan = false;
+            m_ScanFinished = false;
+
+            m_ScanThread = std::thread([this, archive = m_ScanArchive]()
+                                       {
+                try
+                {
+                    // One inflating thread per core
+                    gw2dt::compression::DatFileBatchInflater inflater;
+                    gw2dt::archive::scan_dat_archive_entries(
+                        *archive, m_ScanEntries, inflater,
+                        [this](uint32_t scanned, uint32_t)
+                        {
+                            m_ScannedEntries = scanned;
+                            return !m_StopScan;
+                        });
+                }
+                catch (const std::exception &)
+                {
+                }
+                m_ScanFinished = true; });
+            return;
+        }
+
+        if (!m_ScanFinished || !m_ScanThread.joinable())
+            return;
+        m_ScanThread.join();
+        SaveScanEntries();
+    }
+
+    void BrowserPanel::StopArchiveScan()
+    {
+        m_StopScan = true;
+        if (m_ScanThread.joinable())
+            m_ScanThread.join();
+        // A stopped scan keeps what it sniffed, the next one goes on from there
+        SaveScanEntries();
+        m_ScanArchive.reset();
+    }
+
+    void BrowserPanel::SaveScanEntries()
+    {
+        if (m_ScanEntries.empty() || !m_ScanArchive)
+            return;
+
+        // The archive was closed or replaced, only its sidecar is updated
+        if (m_ScanArchive != m_State->archive)
+        {
+            try
+            {
+                gw2dt::archive::write_dat_archive_index(m_ScanIndexPath, *m_ScanArchive, m_ScanEntries);
+            }
+            catch (const std::exception &)
+            {
+            }
+            m_ScanEntries = {};
+            return;
+        }
+
+        // The index is mapped, it is released before being replaced.
+        // Entries not sniffed yet have no type flag, the next scan picks them up.
+        try
+        {
+            m_State->archiveIndex.reset();
+            gw2dt::archive::write_dat_archive_index(m_ScanIndexPath, *m_ScanArchive, m_ScanEntries);
+            m_State->archiveIndex = std::make_shared<gw2dt::archive::DatArchiveIndex>(m_ScanIndexPath);
+            m_State->archiveEntries = {};
+        }
+        catch (const std::exception &)
+        {
+            // No sidecar, the scanned entries stay in memory
+            m_State->archiveIndex.reset();
+            m_State->archiveEntries = std::move(m_ScanEntries);
+        }
+        m_ScanEntries = {};
+
+        // Listed sizes become the inflated ones
+        const auto entries = m_State->ArchiveEntries();
+        for (FileEntry &e : m_State->browserEntries)
+        {
+            if (e.archiveEntry == 0 || e.archiveEntry >= entries.size())
+                continue;
+            const gw2dt::archive::DatArchiveIndexEntry &entry = entries[e.archiveEntry];
+            if (entry.has_uncompressed_size())
+                e.size = entry.uncompressed_size;
+            if (entry.has_four_cc())
+                e.typeFourCC = entry.four_cc;
+        }
     }
 
 } // namespace panels
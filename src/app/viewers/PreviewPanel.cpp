@@ -1,5 +1,7 @@
 #include "app/viewers/PreviewPanel.h"
 #include "app/AppState.h"
+#include "foundation/gw2dattools/decodeTextureBlocks.h"
+#include "foundation/gw2dattools/inflateTextureFileBuffer.h"
 
 #include <imgui.h>
 #include <imgui_internal.h>
@@ -40,6 +42,40 @@ namespace panels
         }
     }
 
+    // Textures of the game are not understood by stb, their blocks are inflated and decoded on the CPU
+    static bool IsAnetTexture(const std::vector<uint8_t> &bytes)
+    {
+        if (bytes.size() < 4)
+            return false;
+        uint32_t identifier;
+        std::memcpy(&identifier, bytes.data(), sizeof(identifier));
+        return gw2dt::compression::is_anet_image_identifier(identifier);
+    }
+
+    // BC6H textures are decoded to half floats, uploaded as they are
+    static gw2dt::utils::PooledBuffer DecodeAnetTexture(const std::vector<uint8_t> &bytes, int &w, int &h, bool &isHalfFloat)
+    {
+        using namespace gw2dt;
+        try
+        {
+            utils::BufferPool &pool = utils::BufferPool::shared_pool();
+            compression::AnetImage image;
+            utils::PooledBuffer blocks = compression::inflate_texture_file_buffer(bytes, pool, image);
+            if (!compression::is_texture_format_decodable(image.format) || image.width == 0 || image.height == 0)
+                return {};
+
+            utils::PooledBuffer pixels = compression::decode_texture_blocks(image, blocks.span(), pool);
+            w = image.width;
+            h = image.height;
+            isHalfFloat = compression::get_decoded_pixel_size(image.format) == 8;
+            return pixels;
+        }
+        catch (const std::exception &)
+        {
+            return {};
+        }
+    }
+
     void PreviewPanel::LoadTextureFromBytes(const std::vector<uint8_t> &bytes)
     {
         if (bytes.empty())
@@ -52,20 +88,40 @@ namespace panels
         int w, h, ch;
         unsigned char *data = stbi_load_from_memory(
             bytes.data(), (int)bytes.size(), &w, &h, &ch, 4);
-        if (!data)
+        if (data)
+        {
+            UploadTexture(data, w, h);
+            stbi_image_free(data);
+        }
+        else if (IsAnetTexture(bytes))
+        {
+            bool isHalfFloat = false;
+            gw2dt::utils::PooledBuffer pixels = DecodeAnetTexture(bytes, w, h, isHalfFloat);
+            if (!pixels)
+                return;
+            UploadTexture(pixels.data(), w, h, isHalfFloat);
+        }
+        else
+        {
             return;
+        }
 
+        m_TexW = w;
+        m_TexH = h;
+        m_TexSource = m_State->loadedFilePath;
+    }
+
+    void PreviewPanel::UploadTexture(const unsigned char *rgba, int w, int h, bool isHalfFloat)
+    {
         glGenTextures(1, &m_TexId);
         glBindTexture(GL_TEXTURE_2D, m_TexId);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        if (isHalfFloat)
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, w, h, 0, GL_RGBA, GL_HALF_FLOAT, rgba);
+        else
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
         glGenerateMipmap(GL_TEXTURE_2D);
-        stbi_image_free(data);
-
-        m_TexW = w;
-        m_TexH = h;
-        m_TexSource = m_State->loadedFilePath;
     }
 
     // -----------------------------------------------------------
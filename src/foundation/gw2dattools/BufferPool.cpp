@@ -0,0 +1,189 @@
+#include "foundation/gw2dattools/BufferPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <new>
+
+namespace gw2dt
+{
+	namespace utils
+	{
+
+		PooledBuffer::PooledBuffer() noexcept : buffer_pool(nullptr),
+												buffer_data(nullptr),
+												buffer_size(0),
+												buffer_capacity(0),
+												size_class(BufferPool::NO_SIZE_CLASS)
+		{
+		}
+
+		PooledBuffer::PooledBuffer(BufferPool *ipPool, uint8_t *ipData, uint32_t iSize, uint32_t iCapacity, uint8_t iSizeClass) noexcept : buffer_pool(ipPool),
+																																		   buffer_data(ipData),
+																																		   buffer_size(iSize),
+																																		   buffer_capacity(iCapacity),
+																																		   size_class(iSizeClass)
+		{
+		}
+
+		PooledBuffer::PooledBuffer(PooledBuffer &&other) noexcept : buffer_pool(other.buffer_pool),
+																	buffer_data(other.buffer_data),
+																	buffer_size(other.buffer_size),
+																	buffer_capacity(other.buffer_capacity),
+																	size_class(other.size_class)
+		{
+			other.buffer_pool = nullptr;
+			other.buffer_data = nullptr;
+			other.buffer_size = 0;
+			other.buffer_capacity = 0;
+		}
+
+		PooledBuffer &PooledBuffer::operator=(PooledBuffer &&other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+
+				buffer_pool = other.buffer_pool;
+				buffer_data = other.buffer_data;
+				buffer_size = other.buffer_size;
+				buffer_capacity = other.buffer_capacity;
+				size_class = other.size_class;
+
+				other.buffer_pool = nullptr;
+				other.buffer_data = nullptr;
+				other.buffer_size = 0;
+				other.buffer_capacity = 0;
+			}
+			return *this;
+		}
+
+		PooledBuffer::~PooledBuffer()
+		{
+			reset();
+		}
+
+		void PooledBuffer::resize(uint32_t new_size)
+		{
+			if (new_size > buffer_capacity)
+			{
+				throw std::runtime_error("Requested size is bigger than the buffer capacity.");
+			}
+			buffer_size = new_size;
+		}
+
+		void PooledBuffer::reset() noexcept
+		{
+			if (buffer_data != nullptr)
+			{
+				buffer_pool->release(buffer_data, buffer_capacity, size_class);
+			}
+
+			buffer_pool = nullptr;
+			buffer_data = nullptr;
+			buffer_size = 0;
+			buffer_capacity = 0;
+		}
+
+		BufferPool::BufferPool(uint32_t iMaxCachedBuffers, uint64_t iMaxCachedBytes) : max_cached_buffers(iMaxCachedBuffers),
+																					   max_cached_bytes_number(iMaxCachedBytes),
+																					   allocations_number(0),
+																					   reuses_number(0),
+																					   cached_bytes_number(0)
+		{
+		}
+
+		BufferPool::~BufferPool()
+		{
+			trim();
+		}
+
+		BufferPool &BufferPool::shared_pool()
+		{
+			static BufferPool buffer_pool;
+			return buffer_pool;
+		}
+
+		PooledBuffer BufferPool::acquire(uint32_t size, uint32_t iMinCapacity)
+		{
+			const uint32_t required_capacity = std::max(std::max(size, iMinCapacity), 1u);
+			const uint8_t capacity_bits = std::max<uint8_t>(static_cast<uint8_t>(std::bit_width(required_capacity - 1)), MIN_SIZE_CLASS_BITS);
+
+			if (capacity_bits > MAX_SIZE_CLASS_BITS)
+			{
+				// Too big to be pooled
+				uint8_t *buffer_data = static_cast<uint8_t *>(malloc(required_capacity));
+				if (buffer_data == nullptr)
+				{
+					throw std::bad_alloc();
+				}
+				allocations_number.fetch_add(1, std::memory_order_relaxed);
+				return PooledBuffer(this, buffer_data, size, required_capacity, NO_SIZE_CLASS);
+			}
+
+			const uint8_t size_class = capacity_bits - MIN_SIZE_CLASS_BITS;
+			const uint32_t capacity = 1u << capacity_bits;
+
+			{
+				std::lock_guard<std::mutex> lock(free_buffers_mutex);
+				std::vector<uint8_t *> &class_buffers = free_buffers[size_class];
+				if (!class_buffers.empty())
+				{
+					uint8_t *buffer_data = class_buffers.back();
+					class_buffers.pop_back();
+					cached_bytes_number.fetch_sub(capacity, std::memory_order_relaxed);
+					reuses_number.fetch_add(1, std::memory_order_relaxed);
+					return PooledBuffer(this, buffer_data, size, capacity, size_class);
+				}
+			}
+
+			uint8_t *buffer_data = static_cast<uint8_t *>(malloc(capacity));
+			if (buffer_data == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+			allocations_number.fetch_add(1, std::memory_order_relaxed);
+			return PooledBuffer(this, buffer_data, size, capacity, size_class);
+		}
+
+		void BufferPool::trim()
+		{
+			std::lock_guard<std::mutex> lock(free_buffers_mutex);
+			for (std::vector<uint8_t *> &class_buffers : free_buffers)
+			{
+				for (uint8_t *buffer_data : class_buffers)
+				{
+					free(buffer_data);
+				}
+				class_buffers.clear();
+			}
+			cached_bytes_number.store(0, std::memory_order_relaxed);
+		}
+
+		void BufferPool::release(uint8_t *ipData, uint32_t iCapacity, uint8_t iSizeClass) noexcept
+		{
+			if (iSizeClass != NO_SIZE_CLASS)
+			{
+				std::lock_guard<std::mutex> lock(free_buffers_mutex);
+				std::vector<uint8_t *> &class_buffers = free_buffers[iSizeClass];
+				// Cached bytes only change under the lock
+				if (class_buffers.size() < max_cached_buffers &&
+					cached_bytes_number.load(std::memory_order_relaxed) + iCapacity <= max_cached_bytes_number)
+				{
+					try
+					{
+						class_buffers.push_back(ipData);
+						cached_bytes_number.fetch_add(iCapacity, std::memory_order_relaxed);
+						return;
+					}
+					catch (std::bad_alloc &)
+					{
+					}
+				}
+			}
+
+			free(ipData);
+		}
+
+	}
+}
@@ -0,0 +1,129 @@
+#include "foundation/gw2dattools/ContentHash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace gw2dt
+{
+	namespace utils
+	{
+		namespace
+		{
+			constexpr uint64_t MURMUR_C1 = 0x87C37B91114253D5ull;
+			constexpr uint64_t MURMUR_C2 = 0x4CF5AD432745937Full;
+
+			uint64_t load_word(const uint8_t *input_data, uint32_t input_size = 8)
+			{
+				uint64_t word_data = 0;
+				memcpy(&word_data, input_data, input_size);
+				return word_data;
+			}
+
+			uint64_t mix_key_1(uint64_t key_data)
+			{
+				return std::rotl(key_data * MURMUR_C1, 31) * MURMUR_C2;
+			}
+
+			uint64_t mix_key_2(uint64_t key_data)
+			{
+				return std::rotl(key_data * MURMUR_C2, 33) * MURMUR_C1;
+			}
+
+			uint64_t final_mix(uint64_t key_data)
+			{
+				key_data ^= key_data >> 33;
+				key_data *= 0xFF51AFD7ED558CCDull;
+				key_data ^= key_data >> 33;
+				key_data *= 0xC4CEB9FE1A85EC53ull;
+				key_data ^= key_data >> 33;
+				return key_data;
+			}
+		}
+
+		ContentHasher::ContentHasher(uint32_t seed_data) : hash_1(seed_data),
+														   hash_2(seed_data),
+														   tail_data{},
+														   tail_size(0),
+														   total_size(0)
+		{
+		}
+
+		void ContentHasher::process_block(const uint8_t *block_data)
+		{
+			hash_1 ^= mix_key_1(load_word(block_data));
+			hash_1 = std::rotl(hash_1, 27) + hash_2;
+			hash_1 = hash_1 * 5 + 0x52DCE729;
+
+			hash_2 ^= mix_key_2(load_word(block_data + 8));
+			hash_2 = std::rotl(hash_2, 31) + hash_1;
+			hash_2 = hash_2 * 5 + 0x38495AB5;
+		}
+
+		void ContentHasher::update(std::span<const uint8_t> input_data)
+		{
+			const uint8_t *input_position = input_data.data();
+			size_t input_size = input_data.size();
+			total_size += input_size;
+
+			// Completes the block started by the previous piece
+			if (tail_size != 0)
+			{
+				const uint32_t copy_size = static_cast<uint32_t>(std::min<size_t>(input_size, sizeof(tail_data) - tail_size));
+				memcpy(tail_data + tail_size, input_position, copy_size);
+				tail_size += copy_size;
+				input_position += copy_size;
+				input_size -= copy_size;
+
+				if (tail_size < sizeof(tail_data))
+				{
+					return;
+				}
+				process_block(tail_data);
+				tail_size = 0;
+			}
+
+			for (; input_size >= sizeof(tail_data); input_position += sizeof(tail_data), input_size -= sizeof(tail_data))
+			{
+				process_block(input_position);
+			}
+
+			memcpy(tail_data, input_position, input_size);
+			tail_size = static_cast<uint32_t>(input_size);
+		}
+
+		ContentHash ContentHasher::digest() const
+		{
+			uint64_t digest_1 = hash_1;
+			uint64_t digest_2 = hash_2;
+
+			if (tail_size > 8)
+			{
+				digest_2 ^= mix_key_2(load_word(tail_data + 8, tail_size - 8));
+			}
+			if (tail_size > 0)
+			{
+				digest_1 ^= mix_key_1(load_word(tail_data, std::min<uint32_t>(tail_size, 8)));
+			}
+
+			digest_1 ^= total_size;
+			digest_2 ^= total_size;
+			digest_1 += digest_2;
+			digest_2 += digest_1;
+			digest_1 = final_mix(digest_1);
+			digest_2 = final_mix(digest_2);
+			digest_1 += digest_2;
+			digest_2 += digest_1;
+
+			return {digest_1, digest_2};
+		}
+
+		ContentHash hash_content(std::span<const uint8_t> input_data, uint32_t seed_data)
+		{
+			ContentHasher content_hasher(seed_data);
+			content_hasher.update(input_data);
+			return content_hasher.digest();
+		}
+
+	}
+}
@@ -0,0 +1,216 @@
+#include "foundation/gw2dattools/DatArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "foundation/gw2dattools/inflateDatFileBuffer.h"
+
+namespace gw2dt
+{
+	namespace archive
+	{
+		namespace
+		{
+			// Fields are little endian and not aligned
+			template <typename ValueType>
+			ValueType load_value(const uint8_t *input_data)
+			{
+				ValueType value_data;
+				memcpy(&value_data, input_data, sizeof(ValueType));
+				return value_data;
+			}
+
+			constexpr uint8_t DAT_ARCHIVE_IDENTIFIER[3] = {'A', 'N', 0x1A};
+			constexpr uint8_t DAT_ARCHIVE_MFT_IDENTIFIER[4] = {'M', 'f', 't', 0x1A};
+		}
+
+		bool is_dat_archive(std::span<const uint8_t> input_data)
+		{
+			// The first byte is the version
+			return input_data.size() >= 4 && memcmp(input_data.data() + 1, DAT_ARCHIVE_IDENTIFIER, sizeof(DAT_ARCHIVE_IDENTIFIER)) == 0;
+		}
+
+		DatArchive::DatArchive(const std::filesystem::path &archive_path) : archive_path(archive_path),
+																			 mapped_file(archive_path),
+																			 archive_header{},
+																			 mft_data(nullptr),
+																			 entries_number(0)
+		{
+			if (mapped_file.size() < DAT_ARCHIVE_HEADER_SIZE || !is_dat_archive(mapped_file.span()))
+			{
+				throw std::runtime_error(archive_path.string() + " is not a dat archive.");
+			}
+
+			// Archive header
+			const uint8_t *header_data = mapped_file.data();
+			archive_header.version = header_data[0];
+			archive_header.header_size = load_value<uint32_t>(header_data + 4);
+			archive_header.chunk_size = load_value<uint32_t>(header_data + 12);
+			archive_header.crc_data = load_value<uint32_t>(header_data + 16);
+			archive_header.mft_offset = load_value<uint64_t>(header_data + 24);
+			archive_header.mft_size = load_value<uint32_t>(header_data + 32);
+			archive_header.flag_data = load_value<uint32_t>(header_data + 36);
+
+			// MFT header, the entries follow it and are read in place
+			const std::span<const uint8_t> mft_span = mapped_file.range(archive_header.mft_offset, archive_header.mft_size);
+			if (mft_span.size() < DAT_ARCHIVE_MFT_ENTRY_SIZE || memcmp(mft_span.data(), DAT_ARCHIVE_MFT_IDENTIFIER, sizeof(DAT_ARCHIVE_MFT_IDENTIFIER)) != 0)
+			{
+				throw std::runtime_error("Invalid MFT header.");
+			}
+
+			mft_data = mft_span.data();
+			entries_number = load_value<uint32_t>(mft_data + 12);
+			if (entries_number > mft_span.size() / DAT_ARCHIVE_MFT_ENTRY_SIZE)
+			{
+				throw std::runtime_error("MFT is truncated.");
+			}
+		}
+
+		void DatArchive::check_entry(uint32_t entry_index) const
+		{
+			if (entry_index == 0 || entry_index >= entries_number)
+			{
+				throw std::runtime_error("Entry " + std::to_string(entry_index) + " not found.");
+			}
+		}
+
+		DatArchiveEntry DatArchive::entry(uint32_t entry_index) const
+		{
+			check_entry(entry_index);
+
+			const uint8_t *entry_position = mft_data + static_cast<size_t>(entry_index) * DAT_ARCHIVE_MFT_ENTRY_SIZE;
+
+			DatArchiveEntry entry_data;
+			entry_data.offset = load_value<uint64_t>(entry_position);
+			entry_data.size = load_value<uint32_t>(entry_position + 8);
+			entry_data.compression_flag = load_value<uint16_t>(entry_position + 12);
+			entry_data.entry_flag = load_value<uint16_t>(entry_position + 14);
+			entry_data.counter = load_value<uint32_t>(entry_position + 16);
+			entry_data.crc_data = load_value<uint32_t>(entry_position + 20);
+			return entry_data;
+		}
+
+		std::span<const uint8_t> DatArchive::entry_data(uint32_t entry_index) const
+		{
+			const DatArchiveEntry entry_info = entry(entry_index);
+			return mapped_file.range(entry_info.offset, entry_info.size);
+		}
+
+		uint32_t DatArchive::uncompressed_size(uint32_t entry_index) const
+		{
+			const DatArchiveEntry entry_info = entry(entry_index);
+			if (!entry_info.is_compressed())
+			{
+				return entry_info.size;
+			}
+			return compression::get_inflated_dat_file_size(mapped_file.range(entry_info.offset, entry_info.size));
+		}
+
+		uint32_t DatArchive::read_entry(uint32_t entry_index, std::span<uint8_t> output_data) const
+		{
+			const DatArchiveEntry entry_info = entry(entry_index);
+			const std::span<const uint8_t> input_data = mapped_file.range(entry_info.offset, entry_info.size);
+
+			if (entry_info.is_compressed())
+			{
+				return compression::inflate_dat_file_buffer(input_data, output_data);
+			}
+
+			const size_t output_size = std::min(input_data.size(), output_data.size());
+			memcpy(output_data.data(), input_data.data(), output_size);
+			return static_cast<uint32_t>(output_size);
+		}
+
+		utils::PooledBuffer DatArchive::read_entry(uint32_t entry_index, utils::BufferPool &buffer_pool, uint32_t output_data_size) const
+		{
+			const DatArchiveEntry entry_info = entry(entry_index);
+			const std::span<const uint8_t> input_data = mapped_file.range(entry_info.offset, entry_info.size);
+
+			if (entry_info.is_compressed())
+			{
+				return compression::inflate_dat_file_buffer(input_data, buffer_pool, output_data_size);
+			}
+
+			uint32_t output_size = entry_info.size;
+			if (output_data_size != 0)
+			{
+				output_size = std::min(output_size, output_data_size);
+			}
+
+			utils::PooledBuffer output_data = buffer_pool.acquire(output_size);
+			memcpy(output_data.data(), input_data.data(), output_size);
+			return output_data;
+		}
+
+		void DatArchive::load_file_ids() const
+		{
+			std::call_once(file_ids_flag, [this]()
+			{
+				// Pairs of file id and entry, both 0 for the unused ones
+				const std::span<const uint8_t> table_data = entry_data(DAT_ARCHIVE_FILE_ID_TABLE_ENTRY);
+				const size_t pairs_number = table_data.size() / 8;
+
+				std::vector<DatArchiveFileIds> entry_file_ids(entries_number);
+				FileIdIndex file_id_entries(static_cast<uint32_t>(pairs_number));
+
+				for (size_t pair_index = 0; pair_index < pairs_number; ++pair_index)
+				{
+					const uint32_t file_id = load_value<uint32_t>(table_data.data() + pair_index * 8);
+					const uint32_t entry_index = load_value<uint32_t>(table_data.data() + pair_index * 8 + 4);
+					if (file_id == 0 || entry_index == 0 || entry_index >= entries_number)
+					{
+						continue;
+					}
+
+					file_id_entries.insert(file_id, entry_index);
+
+					DatArchiveFileIds &file_ids_data = entry_file_ids[entry_index];
+					if (file_ids_data.base_id == 0)
+					{
+						file_ids_data.base_id = file_id;
+						file_ids_data.file_id = file_id;
+					}
+					else
+					{
+						file_ids_data.base_id = std::min(file_ids_data.base_id, file_id);
+						file_ids_data.file_id = std::max(file_ids_data.file_id, file_id);
+					}
+				}
+
+				entry_by_file_id = std::move(file_id_entries);
+				file_ids_by_entry = std::move(entry_file_ids);
+			});
+		}
+
+		uint32_t DatArchive::find_entry(uint32_t file_id) const
+		{
+			load_file_ids();
+
+			return entry_by_file_id.find(file_id);
+		}
+
+		void DatArchive::find_entries(std::span<const uint32_t> file_ids, std::span<uint32_t> entry_indices) const
+		{
+			load_file_ids();
+
+			entry_by_file_id.find(file_ids, entry_indices);
+		}
+
+		DatArchiveFileIds DatArchive::file_ids(uint32_t entry_index) const
+		{
+			check_entry(entry_index);
+			load_file_ids();
+
+			return file_ids_by_entry[entry_index];
+		}
+
+		uint32_t DatArchive::file_ids_count() const
+		{
+			load_file_ids();
+
+			return entry_by_file_id.size();
+		}
+
+	}
+}
@@ -0,0 +1,176 @@
+#include "foundation/gw2dattools/DatArchiveIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace gw2dt
+{
+	namespace archive
+	{
+		namespace
+		{
+			const uint32_t DAT_ARCHIVE_INDEX_MAGIC = 0x58494144; // "DAIX"
+
+			// Beginning of the index file, followed by the entries then the file ids
+			struct IndexHeader
+			{
+				uint32_t magic_data;
+				uint32_t version;
+				// Identify the archive the index was written for
+				uint64_t archive_size;
+				int64_t write_time;
+				uint64_t mft_offset;
+				uint32_t crc_data;
+
+				uint32_t entries_number;
+				uint32_t ids_number;
+				uint32_t reserved_data;
+				uint64_t entries_position;
+				uint64_t ids_position;
+			};
+			static_assert(sizeof(IndexHeader) == 64);
+
+			int64_t archive_write_time(const DatArchive &archive)
+			{
+				return static_cast<int64_t>(std::filesystem::last_write_time(archive.path()).time_since_epoch().count());
+			}
+		}
+
+		std::vector<DatArchiveIndexEntry> build_dat_archive_index_entries(const DatArchive &archive)
+		{
+			std::vector<DatArchiveIndexEntry> entries(archive.entries_count(), DatArchiveIndexEntry{});
+			for (uint32_t entry_index = 1; entry_index < archive.entries_count(); ++entry_index)
+			{
+				const DatArchiveEntry entry_info = archive.entry(entry_index);
+				const DatArchiveFileIds file_ids = archive.file_ids(entry_index);
+
+				DatArchiveIndexEntry &index_entry = entries[entry_index];
+				index_entry.offset = entry_info.offset;
+				index_entry.size = entry_info.size;
+				index_entry.base_id = file_ids.base_id;
+				index_entry.file_id = file_ids.file_id;
+				index_entry.compression_flag = entry_info.compression_flag;
+
+				// Nothing to read to know the size of the stored entries
+				if (!entry_info.is_compressed())
+				{
+					index_entry.uncompressed_size = entry_info.size;
+					index_entry.flag_data = DAT_ARCHIVE_INDEX_UNCOMPRESSED_SIZE;
+				}
+			}
+			return entries;
+		}
+
+		void write_dat_archive_index(const std::filesystem::path &index_path, const DatArchive &archive,
+									 std::span<const DatArchiveIndexEntry> entries)
+		{
+			if (entries.size() != archive.entries_count())
+			{
+				throw std::runtime_error("Index entries do not match the archive.");
+			}
+
+			std::vector<DatArchiveIndexFileId> file_ids;
+			for (uint32_t entry_index = 1; entry_index < entries.size(); ++entry_index)
+			{
+				const DatArchiveIndexEntry &index_entry = entries[entry_index];
+				if (index_entry.base_id != 0)
+				{
+					file_ids.push_back({index_entry.base_id, entry_index});
+				}
+				if (index_entry.file_id != 0 && index_entry.file_id != index_entry.base_id)
+				{
+					file_ids.push_back({index_entry.file_id, entry_index});
+				}
+			}
+			std::sort(file_ids.begin(), file_ids.end(), [](const DatArchiveIndexFileId &left, const DatArchiveIndexFileId &right)
+					  { return left.file_id < right.file_id; });
+
+			IndexHeader index_header{};
+			index_header.magic_data = DAT_ARCHIVE_INDEX_MAGIC;
+			index_header.version = DAT_ARCHIVE_INDEX_VERSION;
+			index_header.archive_size = archive.archive_size();
+			index_header.write_time = archive_write_time(archive);
+			index_header.mft_offset = archive.header().mft_offset;
+			index_header.crc_data = archive.header().crc_data;
+			index_header.entries_number = static_cast<uint32_t>(entries.size());
+			index_header.ids_number = static_cast<uint32_t>(file_ids.size());
+			index_header.entries_position = sizeof(IndexHeader);
+			index_header.ids_position = index_header.entries_position + entries.size_bytes();
+
+			// Written aside then renamed, a reader never maps a partial index
+			std::filesystem::path temporary_path = index_path;
+			temporary_path += ".tmp";
+			if (index_path.has_parent_path())
+			{
+				std::filesystem::create_directories(index_path.parent_path());
+			}
+
+			{
+				std::ofstream output_stream(temporary_path, std::ios::binary | std::ios::trunc);
+				output_stream.write(reinterpret_cast<const char *>(&index_header), sizeof(index_header));
+				output_stream.write(reinterpret_cast<const char *>(entries.data()), entries.size_bytes());
+				output_stream.write(reinterpret_cast<const char *>(file_ids.data()), file_ids.size() * sizeof(DatArchiveIndexFileId));
+				if (!output_stream.flush())
+				{
+					throw std::runtime_error("Failed to write the archive index.");
+				}
+			}
+
+			std::filesystem::rename(temporary_path, index_path);
+		}
+
+		DatArchiveIndex::DatArchiveIndex(const std::filesystem::path &index_path) : mapped_file(index_path)
+		{
+			if (mapped_file.size() < sizeof(IndexHeader))
+			{
+				throw std::runtime_error("Invalid archive index header.");
+			}
+
+			IndexHeader index_header;
+			memcpy(&index_header, mapped_file.data(), sizeof(index_header));
+			if (index_header.magic_data != DAT_ARCHIVE_INDEX_MAGIC || index_header.version != DAT_ARCHIVE_INDEX_VERSION)
+			{
+				throw std::runtime_error("Invalid archive index header.");
+			}
+
+			// Used in place, both tables have to be aligned and in the file
+			if (index_header.entries_position % alignof(DatArchiveIndexEntry) != 0 || index_header.ids_position % alignof(DatArchiveIndexFileId) != 0)
+			{
+				throw std::runtime_error("Invalid archive index header.");
+			}
+			const std::span<const uint8_t> entries_span = mapped_file.range(index_header.entries_position,
+																			uint64_t(index_header.entries_number) * sizeof(DatArchiveIndexEntry));
+			const std::span<const uint8_t> ids_span = mapped_file.range(index_header.ids_position,
+																		uint64_t(index_header.ids_number) * sizeof(DatArchiveIndexFileId));
+
+			archive_size = index_header.archive_size;
+			write_time = index_header.write_time;
+			mft_offset = index_header.mft_offset;
+			crc_data = index_header.crc_data;
+
+			entries_data = reinterpret_cast<const DatArchiveIndexEntry *>(entries_span.data());
+			entries_number = index_header.entries_number;
+			ids_data = reinterpret_cast<const DatArchiveIndexFileId *>(ids_span.data());
+			ids_number = index_header.ids_number;
+		}
+
+		bool DatArchiveIndex::matches(const DatArchive &archive) const
+		{
+			return archive_size == archive.archive_size() &&
+				   crc_data == archive.header().crc_data &&
+				   mft_offset == archive.header().mft_offset &&
+				   entries_number == archive.entries_count() &&
+				   write_time == archive_write_time(archive);
+		}
+
+		uint32_t DatArchiveIndex::find_entry(uint32_t file_id) const
+		{
+			const DatArchiveIndexFileId *ids_end = ids_data + ids_number;
+			const DatArchiveIndexFileId *id_position = std::lower_bound(ids_data, ids_end, file_id, [](const DatArchiveIndexFileId &id_entry, uint32_t value_data)
+															  { return id_entry.file_id < value_data; });
+			return id_position != ids_end && id_position->file_id == file_id ? id_position->entry_index : 0;
+		}
+
+	}
+}
@@ -0,0 +1,168 @@
+#include "foundation/gw2dattools/FileIdIndex.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GW2DATTOOLS_X86_64
+#include <immintrin.h>
+#endif
+
+namespace gw2dt
+{
+	namespace archive
+	{
+		namespace
+		{
+			// Smallest table, 64 ids
+			constexpr uint32_t MIN_GROUPS_BITS = 4;
+			// Lookups ahead whose group is prefetched by the batch lookup
+			constexpr size_t PREFETCH_DISTANCE = 8;
+
+			uint32_t groups_bits(uint32_t ids_count)
+			{
+				// At most half full
+				const uint64_t slots_count = static_cast<uint64_t>(ids_count) * 2;
+				const uint64_t groups_count = (slots_count + FILE_ID_INDEX_GROUP_SIZE - 1) / FILE_ID_INDEX_GROUP_SIZE;
+				return std::max<uint32_t>(MIN_GROUPS_BITS, static_cast<uint32_t>(std::bit_width(groups_count - (groups_count != 0))));
+			}
+
+			// Bit i set if slot i holds value_data
+			template <typename Group>
+			uint32_t match_slots(const Group &group_data, uint32_t value_data)
+			{
+#ifdef GW2DATTOOLS_X86_64
+				const __m128i ids_data = _mm_load_si128(reinterpret_cast<const __m128i *>(group_data.file_ids));
+				const __m128i matches_data = _mm_cmpeq_epi32(ids_data, _mm_set1_epi32(static_cast<int>(value_data)));
+				return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(matches_data)));
+#else
+				uint32_t slots_data = 0;
+				for (uint32_t slot_index = 0; slot_index < FILE_ID_INDEX_GROUP_SIZE; ++slot_index)
+				{
+					slots_data |= static_cast<uint32_t>(group_data.file_ids[slot_index] == value_data) << slot_index;
+				}
+				return slots_data;
+#endif
+			}
+		}
+
+		FileIdIndex::FileIdIndex() : FileIdIndex(0)
+		{
+		}
+
+		FileIdIndex::FileIdIndex(uint32_t ids_count) : ids_number(0)
+		{
+			const uint32_t bits_count = groups_bits(ids_count);
+			groups_data.assign(size_t(1) << bits_count, Group{});
+			groups_mask = (uint32_t(1) << bits_count) - 1;
+			hash_shift = 64 - bits_count;
+		}
+
+		uint32_t FileIdIndex::first_group(uint32_t file_id) const
+		{
+			// Ids are mostly consecutive, the multiplication spreads them over the groups
+			return static_cast<uint32_t>((file_id * 0x9E3779B97F4A7C15ull) >> hash_shift);
+		}
+
+		void FileIdIndex::insert(uint32_t file_id, uint32_t entry_index)
+		{
+			if (file_id == 0)
+			{
+				throw std::runtime_error("File id 0 can not be indexed.");
+			}
+
+			if ((static_cast<uint64_t>(ids_number) + 1) * 2 > groups_data.size() * FILE_ID_INDEX_GROUP_SIZE)
+			{
+				grow();
+			}
+
+			// Nothing is ever removed, an id is always before the first free slot of its probe sequence
+			for (uint32_t group_index = first_group(file_id);; group_index = (group_index + 1) & groups_mask)
+			{
+				Group &group_data = groups_data[group_index];
+
+				const uint32_t found_slots = match_slots(group_data, file_id);
+				if (found_slots != 0)
+				{
+					group_data.entry_indices[std::countr_zero(found_slots)] = entry_index;
+					return;
+				}
+
+				const uint32_t free_slots = match_slots(group_data, 0);
+				if (free_slots != 0)
+				{
+					const int slot_index = std::countr_zero(free_slots);
+					group_data.file_ids[slot_index] = file_id;
+					group_data.entry_indices[slot_index] = entry_index;
+					++ids_number;
+					return;
+				}
+			}
+		}
+
+		uint32_t FileIdIndex::find(uint32_t file_id) const
+		{
+			if (file_id == 0)
+			{
+				return 0;
+			}
+
+			for (uint32_t group_index = first_group(file_id);; group_index = (group_index + 1) & groups_mask)
+			{
+				const Group &group_data = groups_data[group_index];
+
+				const uint32_t found_slots = match_slots(group_data, file_id);
+				if (found_slots != 0)
+				{
+					return group_data.entry_indices[std::countr_zero(found_slots)];
+				}
+				if (match_slots(group_data, 0) != 0)
+				{
+					return 0;
+				}
+			}
+		}
+
+		void FileIdIndex::find(std::span<const uint32_t> file_ids, std::span<uint32_t> entry_indices) const
+		{
+			if (entry_indices.size() < file_ids.size())
+			{
+				throw std::runtime_error("Output buffer is too small.");
+			}
+
+			for (size_t id_index = 0; id_index < file_ids.size(); ++id_index)
+			{
+				// Ids of a batch are unrelated, loading the next groups early hides the cache misses
+				if (id_index + PREFETCH_DISTANCE < file_ids.size())
+				{
+					const Group *next_group = &groups_data[first_group(file_ids[id_index + PREFETCH_DISTANCE])];
+#ifdef GW2DATTOOLS_X86_64
+					_mm_prefetch(reinterpret_cast<const char *>(next_group), _MM_HINT_T0);
+#elif defined(__GNUC__)
+					__builtin_prefetch(next_group);
+#endif
+				}
+				entry_indices[id_index] = find(file_ids[id_index]);
+			}
+		}
+
+		void FileIdIndex::grow()
+		{
+			std::vector<Group> old_groups;
+			old_groups.swap(groups_data);
+
+			*this = FileIdIndex(static_cast<uint32_t>(old_groups.size() * FILE_ID_INDEX_GROUP_SIZE));
+			for (const Group &group_data : old_groups)
+			{
+				for (uint32_t slot_index = 0; slot_index < FILE_ID_INDEX_GROUP_SIZE; ++slot_index)
+				{
+					if (group_data.file_ids[slot_index] != 0)
+					{
+						insert(group_data.file_ids[slot_index], group_data.entry_indices[slot_index]);
+					}
+				}
+			}
+		}
+
+	}
+}
@@ -0,0 +1,147 @@
+#include "foundation/gw2dattools/MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+
+namespace gw2dt
+{
+	namespace utils
+	{
+
+		MappedFile::MappedFile() noexcept : mapped_data(nullptr),
+											mapped_size(0)
+		{
+		}
+
+		MappedFile::MappedFile(const std::filesystem::path &file_path) : mapped_data(nullptr),
+																		 mapped_size(0)
+		{
+#ifdef _WIN32
+			HANDLE file_handle = CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+											 FILE_FLAG_RANDOM_ACCESS, nullptr);
+			if (file_handle == INVALID_HANDLE_VALUE)
+			{
+				throw std::runtime_error("Can not open " + file_path.string() + ".");
+			}
+
+			LARGE_INTEGER file_size;
+			if (!GetFileSizeEx(file_handle, &file_size))
+			{
+				CloseHandle(file_handle);
+				throw std::runtime_error("Can not read the size of " + file_path.string() + ".");
+			}
+
+			// Empty files can not be mapped, they are left empty
+			if (file_size.QuadPart != 0)
+			{
+				HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping_handle != nullptr)
+				{
+					mapped_data = static_cast<const uint8_t *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+					// The view keeps the mapping alive
+					CloseHandle(mapping_handle);
+				}
+				if (mapped_data == nullptr)
+				{
+					CloseHandle(file_handle);
+					throw std::runtime_error("Can not map " + file_path.string() + ".");
+				}
+				mapped_size = static_cast<uint64_t>(file_size.QuadPart);
+			}
+			CloseHandle(file_handle);
+#else
+			const int file_descriptor = ::open(file_path.c_str(), O_RDONLY);
+			if (file_descriptor < 0)
+			{
+				throw std::runtime_error("Can not open " + file_path.string() + ".");
+			}
+
+			struct stat file_status;
+			if (fstat(file_descriptor, &file_status) != 0)
+			{
+				::close(file_descriptor);
+				throw std::runtime_error("Can not read the size of " + file_path.string() + ".");
+			}
+
+			// Empty files can not be mapped, they are left empty
+			if (file_status.st_size != 0)
+			{
+				void *map_data = mmap(nullptr, static_cast<size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+				if (map_data == MAP_FAILED)
+				{
+					::close(file_descriptor);
+					throw std::runtime_error("Can not map " + file_path.string() + ".");
+				}
+				// Entries are read here and there, reading ahead would load pages nobody asked for
+				madvise(map_data, static_cast<size_t>(file_status.st_size), MADV_RANDOM);
+
+				mapped_data = static_cast<const uint8_t *>(map_data);
+				mapped_size = static_cast<uint64_t>(file_status.st_size);
+			}
+			// The mapping stays valid once the file is closed
+			::close(file_descriptor);
+#endif
+		}
+
+		MappedFile::MappedFile(MappedFile &&other) noexcept : mapped_data(other.mapped_data),
+															  mapped_size(other.mapped_size)
+		{
+			other.mapped_data = nullptr;
+			other.mapped_size = 0;
+		}
+
+		MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+		{
+			if (this != &other)
+			{
+				close();
+
+				mapped_data = other.mapped_data;
+				mapped_size = other.mapped_size;
+
+				other.mapped_data = nullptr;
+				other.mapped_size = 0;
+			}
+			return *this;
+		}
+
+		MappedFile::~MappedFile()
+		{
+			close();
+		}
+
+		std::span<const uint8_t> MappedFile::range(uint64_t offset, uint64_t size) const
+		{
+			if (offset > mapped_size || size > mapped_size - offset)
+			{
+				throw std::runtime_error("Range " + std::to_string(offset) + "+" + std::to_string(size) + " is out of the file.");
+			}
+			return {mapped_data + offset, static_cast<size_t>(size)};
+		}
+
+		void MappedFile::close() noexcept
+		{
+			if (mapped_data != nullptr)
+			{
+#ifdef _WIN32
+				UnmapViewOfFile(mapped_data);
+#else
+				munmap(const_cast<uint8_t *>(mapped_data), static_cast<size_t>(mapped_size));
+#endif
+			}
+			mapped_data = nullptr;
+			mapped_size = 0;
+		}
+
+	}
+}
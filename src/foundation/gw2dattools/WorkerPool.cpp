@@ -0,0 +1,129 @@
+#include "foundation/gw2dattools/WorkerPool.h"
+
+#include <algorithm>
+
+namespace gw2dt
+{
+	namespace utils
+	{
+
+		WorkerPool::WorkerPool(uint32_t threads_number) : current_task(nullptr),
+														  active_workers(0),
+														  run_generation(0),
+														  is_stopping(false)
+		{
+			if (threads_number == 0)
+			{
+				threads_number = std::max(1u, std::thread::hardware_concurrency());
+			}
+
+			worker_threads.reserve(threads_number);
+			try
+			{
+				for (uint32_t thread_index = 0; thread_index < threads_number; ++thread_index)
+				{
+					worker_threads.emplace_back(&WorkerPool::worker_loop, this, thread_index);
+				}
+			}
+			catch (...)
+			{
+				// The destructor is not called, the started threads are stopped here
+				{
+					std::lock_guard<std::mutex> lock(state_mutex);
+					is_stopping = true;
+				}
+				work_condition.notify_all();
+				for (std::thread &worker_thread : worker_threads)
+				{
+					worker_thread.join();
+				}
+				throw;
+			}
+		}
+
+		WorkerPool::~WorkerPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				is_stopping = true;
+			}
+			work_condition.notify_all();
+
+			for (std::thread &worker_thread : worker_threads)
+			{
+				worker_thread.join();
+			}
+		}
+
+		void WorkerPool::run(const Task &task_function)
+		{
+			std::lock_guard<std::mutex> run_lock(run_mutex);
+
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				current_task = &task_function;
+				active_workers = threads_number();
+				task_error = nullptr;
+				++run_generation;
+			}
+			work_condition.notify_all();
+
+			std::exception_ptr run_error;
+			{
+				std::unique_lock<std::mutex> lock(state_mutex);
+				done_condition.wait(lock, [this]()
+									{ return active_workers == 0; });
+				current_task = nullptr;
+				run_error = std::move(task_error);
+				task_error = nullptr;
+			}
+
+			if (run_error)
+			{
+				std::rethrow_exception(run_error);
+			}
+		}
+
+		void WorkerPool::worker_loop(uint32_t worker_index)
+		{
+			uint64_t processed_generation = 0;
+
+			while (true)
+			{
+				const Task *task_function;
+				{
+					std::unique_lock<std::mutex> lock(state_mutex);
+					work_condition.wait(lock, [this, processed_generation]()
+										{ return is_stopping || run_generation != processed_generation; });
+					if (is_stopping)
+					{
+						return;
+					}
+					processed_generation = run_generation;
+					task_function = current_task;
+				}
+
+				std::exception_ptr worker_error;
+				try
+				{
+					(*task_function)(worker_index);
+				}
+				catch (...)
+				{
+					worker_error = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock(state_mutex);
+				if (worker_error && !task_error)
+				{
+					task_error = worker_error;
+				}
+				if (--active_workers == 0)
+				{
+					done_condition.notify_all();
+				}
+			}
+		}
+
+	}
+}
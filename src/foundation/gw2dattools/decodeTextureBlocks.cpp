@@ -0,0 +1,1978 @@
+#include "foundation/gw2dattools/decodeTextureBlocks.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GW2DATTOOLS_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define GW2DATTOOLS_TARGET_AVX2
+#else
+#define GW2DATTOOLS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace gw2dt
+{
+	namespace compression
+	{
+
+		namespace bcn
+		{
+
+			enum BlockLayout
+			{
+				BL_BC1, // Color, 1 bit alpha
+				BL_BC2, // Explicit 4 bits alpha, color
+				BL_BC3, // Interpolated alpha, color
+				BL_BC4, // One interpolated channel
+				BL_BC5, // Two interpolated channels
+				BL_BC6H, // HDR color, decoded to half floats
+				BL_BC7	 // Color and alpha in 8 modes
+			};
+
+			struct BlockFormat
+			{
+				BlockLayout layout;
+				uint32_t bytes_block;
+				bool premultiplied_alpha;
+				uint32_t bytes_pixel = 4;
+			};
+
+			bool find_block_format(uint32_t four_cc_data, BlockFormat &block_format)
+			{
+				switch (four_cc_data)
+				{
+				case 0x31545844: // "DXT1"
+					block_format = {BL_BC1, 8, false};
+					return true;
+
+				case 0x32545844: // "DXT2"
+					block_format = {BL_BC2, 16, true};
+					return true;
+
+				case 0x33545844: // "DXT3"
+					block_format = {BL_BC2, 16, false};
+					return true;
+
+				case 0x34545844: // "DXT4"
+					block_format = {BL_BC3, 16, true};
+					return true;
+
+				case 0x35545844: // "DXT5"
+					block_format = {BL_BC3, 16, false};
+					return true;
+
+				case 0x41545844: // "DXTA"
+				case 0x4C545844: // "DXTL"
+					block_format = {BL_BC4, 8, false};
+					return true;
+
+				case 0x4E545844: // "DXTN"
+				case 0x58434433: // "3DCX"
+					block_format = {BL_BC5, 16, false};
+					return true;
+
+				case 0x48364342: // "BC6H"
+					block_format = {BL_BC6H, 16, false, 8};
+					return true;
+
+				case 0x58374342: // "BC7X"
+					block_format = {BL_BC7, 16, false};
+					return true;
+
+				default:
+					return false;
+				}
+			}
+
+			// Pixels are handled as little endian uint32, red in the low byte and alpha in the high byte
+			const uint32_t ALPHA_MASK = 0xFF000000;
+			const uint32_t COLOR_MASK = 0x00FFFFFF;
+
+			inline uint16_t load_uint16(const uint8_t *input_data)
+			{
+				uint16_t value_data;
+				memcpy(&value_data, input_data, sizeof(value_data));
+				return value_data;
+			}
+
+			inline uint32_t load_uint32(const uint8_t *input_data)
+			{
+				uint32_t value_data;
+				memcpy(&value_data, input_data, sizeof(value_data));
+				return value_data;
+			}
+
+			inline uint64_t load_uint64(const uint8_t *input_data)
+			{
+				uint64_t value_data;
+				memcpy(&value_data, input_data, sizeof(value_data));
+				return value_data;
+			}
+
+			inline void store_pixel(uint8_t *output_data, uint32_t pixel_data)
+			{
+				memcpy(output_data, &pixel_data, sizeof(pixel_data));
+			}
+
+			inline uint32_t make_pixel(uint32_t red, uint32_t green, uint32_t blue, uint32_t alpha)
+			{
+				return red | (green << 8) | (blue << 16) | (alpha << 24);
+			}
+
+			// The 4 colors of a color block, in the 3 colors mode of BC1 the last one is transparent black
+			// The palettes are built here for every kernel, only the expansion of the indices differs
+			void build_color_palette(const uint8_t *color_block, bool has_three_colors_mode, uint32_t palette_data[4])
+			{
+				const uint16_t color_0 = load_uint16(color_block);
+				const uint16_t color_1 = load_uint16(color_block + 2);
+
+				const uint32_t red_0 = ((color_0 >> 11) << 3) | (color_0 >> 13);
+				const uint32_t green_0 = (((color_0 >> 5) & 0x3F) << 2) | ((color_0 >> 9) & 0x03);
+				const uint32_t blue_0 = ((color_0 & 0x1F) << 3) | ((color_0 >> 2) & 0x07);
+				const uint32_t red_1 = ((color_1 >> 11) << 3) | (color_1 >> 13);
+				const uint32_t green_1 = (((color_1 >> 5) & 0x3F) << 2) | ((color_1 >> 9) & 0x03);
+				const uint32_t blue_1 = ((color_1 & 0x1F) << 3) | ((color_1 >> 2) & 0x07);
+
+				palette_data[0] = make_pixel(red_0, green_0, blue_0, 0xFF);
+				palette_data[1] = make_pixel(red_1, green_1, blue_1, 0xFF);
+
+				if (color_0 > color_1 || !has_three_colors_mode)
+				{
+					palette_data[2] = make_pixel((2 * red_0 + red_1) / 3, (2 * green_0 + green_1) / 3, (2 * blue_0 + blue_1) / 3, 0xFF);
+					palette_data[3] = make_pixel((red_0 + 2 * red_1) / 3, (green_0 + 2 * green_1) / 3, (blue_0 + 2 * blue_1) / 3, 0xFF);
+				}
+				else
+				{
+					palette_data[2] = make_pixel((red_0 + red_1) / 2, (green_0 + green_1) / 2, (blue_0 + blue_1) / 2, 0xFF);
+					palette_data[3] = 0;
+				}
+			}
+
+			// The 8 values of a BC4 block
+			void build_value_palette(const uint8_t *value_block, uint32_t palette_data[8])
+			{
+				const uint32_t value_0 = value_block[0];
+				const uint32_t value_1 = value_block[1];
+
+				palette_data[0] = value_0;
+				palette_data[1] = value_1;
+
+				if (value_0 > value_1)
+				{
+					for (uint32_t value_index = 1; value_index < 7; ++value_index)
+					{
+						palette_data[value_index + 1] = ((7 - value_index) * value_0 + value_index * value_1) / 7;
+					}
+				}
+				else
+				{
+					for (uint32_t value_index = 1; value_index < 5; ++value_index)
+					{
+						palette_data[value_index + 1] = ((5 - value_index) * value_0 + value_index * value_1) / 5;
+					}
+					palette_data[6] = 0;
+					palette_data[7] = 0xFF;
+				}
+			}
+
+			// The 16 indices of 3 bits of a BC4 block
+			inline uint64_t load_value_indices(const uint8_t *value_block)
+			{
+				return load_uint64(value_block) >> 16;
+			}
+
+			// The SIMD kernels do the same float operations in the same order, every operation is kept in its own
+			// statement so that none of them is fused and every kernel gives the same result
+			inline uint32_t unpremultiply_channel(uint32_t channel_data, float alpha_data)
+			{
+				float value_data = static_cast<float>(channel_data) * 255.0f;
+				value_data = value_data / alpha_data;
+				value_data = value_data + 0.5f;
+				return static_cast<uint32_t>(std::min(value_data, 255.0f));
+			}
+
+			inline uint32_t unpremultiply_pixel(uint32_t pixel_data)
+			{
+				const uint32_t alpha_data = pixel_data >> 24;
+				if (alpha_data == 0)
+				{
+					return pixel_data;
+				}
+
+				const float alpha_float = static_cast<float>(alpha_data);
+				return make_pixel(unpremultiply_channel(pixel_data & 0xFF, alpha_float),
+								  unpremultiply_channel((pixel_data >> 8) & 0xFF, alpha_float),
+								  unpremultiply_channel((pixel_data >> 16) & 0xFF, alpha_float),
+								  alpha_data);
+			}
+
+			inline float normal_component(uint32_t value_data)
+			{
+				float component_data = static_cast<float>(value_data) * (2.0f / 255.0f);
+				component_data = component_data - 1.0f;
+				return component_data;
+			}
+
+			// X and Y are stored, Z is deduced from the length of the normal
+			inline uint32_t normal_pixel(uint32_t x_data, uint32_t y_data)
+			{
+				const float x_component = normal_component(x_data);
+				const float y_component = normal_component(y_data);
+				const float x_square = x_component * x_component;
+				const float y_square = y_component * y_component;
+				float z_component = 1.0f - x_square;
+				z_component = z_component - y_square;
+				z_component = std::sqrt(std::max(z_component, 0.0f));
+				z_component = z_component * 127.5f;
+				z_component = z_component + 128.0f;
+				return make_pixel(x_data, y_data, static_cast<uint32_t>(std::min(z_component, 255.0f)), 0xFF);
+			}
+
+			// BPTC blocks are a little endian stream of 128 bits, read from the lowest bit of the first byte
+			class BlockBits
+			{
+			public:
+				explicit BlockBits(const uint8_t *block_data) : low_bits(load_uint64(block_data)),
+																high_bits(load_uint64(block_data + 8))
+				{
+				}
+
+				// bits_number: 0 to 32
+				uint32_t read(uint32_t bits_number)
+				{
+					const uint32_t value_data = static_cast<uint32_t>(low_bits & ((1ull << bits_number) - 1));
+					skip(bits_number);
+					return value_data;
+				}
+
+				void skip(uint32_t bits_number)
+				{
+					if (bits_number != 0)
+					{
+						low_bits = (low_bits >> bits_number) | (high_bits << (64 - bits_number));
+						high_bits >>= bits_number;
+					}
+				}
+
+			private:
+				uint64_t low_bits;
+				uint64_t high_bits;
+			};
+
+			// Subset of every texel in the partitions of 2 subsets, one bit per texel, texel 0 in the low bit
+			// BC6H uses the first 32 partitions
+			constexpr uint16_t partitions_2_data[64] = {
+				0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+				0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+				0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+				0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22};
+
+			// Partitions of 3 subsets, two bits per texel
+			constexpr uint32_t partitions_3_data[64] = {
+				0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+				0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+				0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+				0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+				0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+				0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+				0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+				0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254};
+
+			// Anchor texels: the index of the first texel of every subset has one bit less, it is texel 0 for the first subset
+			constexpr uint8_t anchors_2_data[64] = {
+				15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+				15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6, 6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15};
+
+			constexpr uint8_t anchors_3_second_data[64] = {
+				3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3, 3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+				8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15, 3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3};
+
+			constexpr uint8_t anchors_3_third_data[64] = {
+				15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8, 15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+				15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8, 15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8};
+
+			// Weight of the second endpoint, out of 64, for indices of 2, 3 and 4 bits
+			constexpr uint8_t weights_2_data[4] = {0, 21, 43, 64};
+			constexpr uint8_t weights_3_data[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+			constexpr uint8_t weights_4_data[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+			inline const uint8_t *get_weights(uint32_t index_bits)
+			{
+				return index_bits == 2 ? weights_2_data : (index_bits == 3 ? weights_3_data : weights_4_data);
+			}
+
+			// Same interpolation for both BPTC formats, the SIMD kernels give the same integer results
+			inline uint32_t interpolate_bptc(uint32_t endpoint_0, uint32_t endpoint_1, uint32_t weight_data)
+			{
+				return ((64 - weight_data) * endpoint_0 + weight_data * endpoint_1 + 32) >> 6;
+			}
+
+			struct Bc7Mode
+			{
+				uint8_t subsets;
+				uint8_t partition_bits;
+				uint8_t rotation_bits;
+				uint8_t index_selection_bits;
+				uint8_t color_bits;
+				uint8_t alpha_bits;
+				// One P-bit per endpoint or one per subset, the lowest bit of every channel
+				uint8_t endpoint_pbits;
+				uint8_t shared_pbits;
+				uint8_t index_bits;
+				uint8_t secondary_index_bits;
+			};
+
+			constexpr Bc7Mode bc7_modes_data[8] = {
+				{3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+				{2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+				{3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+				{2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+				{1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+				{1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+				{1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+				{2, 6, 0, 0, 5, 5, 1, 0, 2, 0}};
+
+			// The mode of a BPTC block is read once, the kernels only interpolate the texels
+			// Channels are packed like the pixels, red in the low byte
+			struct Bc7Texels
+			{
+				uint32_t endpoints_0[16];
+				uint32_t endpoints_1[16];
+				// Weight of the second endpoint in every channel, 0 to 64
+				uint32_t weights_data[16];
+			};
+
+			// The texels of the reserved mode are transparent black
+			void unpack_bc7(const uint8_t *block_data, Bc7Texels &texels_data)
+			{
+				// The mode is the number of 0 bits before the first 1 bit
+				const uint32_t mode_index = std::countr_zero(block_data[0] | 0x100u);
+				if (mode_index >= 8)
+				{
+					memset(&texels_data, 0, sizeof(texels_data));
+					return;
+				}
+
+				const Bc7Mode &mode_data = bc7_modes_data[mode_index];
+				BlockBits bits_data(block_data);
+				bits_data.skip(mode_index + 1);
+
+				const uint32_t partition_index = bits_data.read(mode_data.partition_bits);
+				const uint32_t rotation_index = bits_data.read(mode_data.rotation_bits);
+				const uint32_t index_selection = bits_data.read(mode_data.index_selection_bits);
+
+				// Every channel of every endpoint, then the alpha of every endpoint
+				const uint32_t endpoints_number = 2 * mode_data.subsets;
+				uint32_t endpoints_data[6][4];
+				for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+				{
+					for (uint32_t endpoint_index = 0; endpoint_index < endpoints_number; ++endpoint_index)
+					{
+						endpoints_data[endpoint_index][channel_index] = bits_data.read(mode_data.color_bits);
+					}
+				}
+				for (uint32_t endpoint_index = 0; endpoint_index < endpoints_number; ++endpoint_index)
+				{
+					endpoints_data[endpoint_index][3] = bits_data.read(mode_data.alpha_bits);
+				}
+
+				uint32_t color_precision = mode_data.color_bits;
+				uint32_t alpha_precision = mode_data.alpha_bits;
+				if (mode_data.endpoint_pbits || mode_data.shared_pbits)
+				{
+					uint32_t pbits_data[6];
+					for (uint32_t endpoint_index = 0; endpoint_index < endpoints_number; ++endpoint_index)
+					{
+						pbits_data[endpoint_index] = (mode_data.shared_pbits && (endpoint_index & 1)) ? pbits_data[endpoint_index - 1] : bits_data.read(1);
+						for (uint32_t channel_index = 0; channel_index < 4; ++channel_index)
+						{
+							endpoints_data[endpoint_index][channel_index] = (endpoints_data[endpoint_index][channel_index] << 1) | pbits_data[endpoint_index];
+						}
+					}
+					++color_precision;
+					alpha_precision += alpha_precision != 0;
+				}
+
+				// The high bits are copied in the low bits, modes without alpha are opaque
+				uint32_t colors_data[6];
+				for (uint32_t endpoint_index = 0; endpoint_index < endpoints_number; ++endpoint_index)
+				{
+					uint32_t *endpoint_data = endpoints_data[endpoint_index];
+					for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+					{
+						endpoint_data[channel_index] <<= 8 - color_precision;
+						endpoint_data[channel_index] |= endpoint_data[channel_index] >> color_precision;
+					}
+					if (alpha_precision == 0)
+					{
+						endpoint_data[3] = 0xFF;
+					}
+					else
+					{
+						endpoint_data[3] <<= 8 - alpha_precision;
+						endpoint_data[3] |= endpoint_data[3] >> alpha_precision;
+					}
+
+					// The rotation swaps the alpha with a color channel
+					if (rotation_index != 0)
+					{
+						std::swap(endpoint_data[rotation_index - 1], endpoint_data[3]);
+					}
+					colors_data[endpoint_index] = make_pixel(endpoint_data[0], endpoint_data[1], endpoint_data[2], endpoint_data[3]);
+				}
+
+				// Subset of every texel, two bits per texel
+				uint32_t partition_data = 0;
+				uint32_t second_anchor = 0;
+				uint32_t third_anchor = 0;
+				if (mode_data.subsets == 2)
+				{
+					for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+					{
+						partition_data |= ((partitions_2_data[partition_index] >> texel_index) & 1) << (2 * texel_index);
+					}
+					second_anchor = anchors_2_data[partition_index];
+				}
+				else if (mode_data.subsets == 3)
+				{
+					partition_data = partitions_3_data[partition_index];
+					second_anchor = anchors_3_second_data[partition_index];
+					third_anchor = anchors_3_third_data[partition_index];
+				}
+
+				uint32_t indices_data[16];
+				for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+				{
+					const bool is_anchor = texel_index == 0 || texel_index == second_anchor || texel_index == third_anchor;
+					indices_data[texel_index] = bits_data.read(mode_data.index_bits - is_anchor);
+				}
+
+				// Modes 4 and 5 have a second set of indices, for the alpha, or for the color with the index selection
+				const uint8_t *weights_data = get_weights(mode_data.index_bits);
+				const uint8_t *secondary_weights_data = get_weights(mode_data.secondary_index_bits);
+				const uint32_t alpha_shift = 8 * (rotation_index != 0 ? rotation_index - 1 : 3);
+				for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+				{
+					uint32_t color_weight = weights_data[indices_data[texel_index]];
+					uint32_t alpha_weight = color_weight;
+					if (mode_data.secondary_index_bits != 0)
+					{
+						alpha_weight = secondary_weights_data[bits_data.read(mode_data.secondary_index_bits - (texel_index == 0))];
+						if (index_selection)
+						{
+							std::swap(color_weight, alpha_weight);
+						}
+					}
+
+					const uint32_t subset_index = (partition_data >> (2 * texel_index)) & 0x03;
+					texels_data.endpoints_0[texel_index] = colors_data[2 * subset_index];
+					texels_data.endpoints_1[texel_index] = colors_data[2 * subset_index + 1];
+					texels_data.weights_data[texel_index] = (color_weight * 0x01010101 & ~(0xFFu << alpha_shift)) | (alpha_weight << alpha_shift);
+				}
+			}
+
+			// Endpoint channels of the BC6H headers, the w, x, y and z endpoints of the specification
+			// w and x are the endpoints of the first region, y and z the ones of the second region
+			enum Bc6hChannel : uint8_t
+			{
+				RW, GW, BW,
+				RX, GX, BX,
+				RY, GY, BY,
+				RZ, GZ, BZ
+			};
+
+			// bits_number bits of the stream go to the bits of endpoint_channel starting at bit_shift
+			struct Bc6hField
+			{
+				uint8_t endpoint_channel;
+				uint8_t bit_shift;
+				uint8_t bits_number;
+			};
+
+			struct Bc6hMode
+			{
+				uint8_t regions;
+				// The endpoints other than w are deltas from w
+				bool is_transformed;
+				uint8_t endpoint_bits;
+				uint8_t delta_bits[3];
+				// Fields of the header after the mode bits, in stream order, the unused ones are empty
+				Bc6hField fields_data[24];
+			};
+
+			constexpr Bc6hMode bc6h_modes_data[14] = {
+				{2, true, 10, {5, 5, 5}, {{GY, 4, 1}, {BY, 4, 1}, {BZ, 4, 1}, {RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 5}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5},
+										  {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}}},
+				{2, true, 7, {6, 6, 6}, {{GY, 5, 1}, {GZ, 4, 1}, {GZ, 5, 1}, {RW, 0, 7}, {BZ, 0, 1}, {BZ, 1, 1}, {BY, 4, 1}, {GW, 0, 7}, {BY, 5, 1}, {BZ, 2, 1}, {GY, 4, 1}, {BW, 0, 7},
+										 {BZ, 3, 1}, {BZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 6}, {GY, 0, 4}, {GX, 0, 6}, {GZ, 0, 4}, {BX, 0, 6}, {BY, 0, 4}, {RY, 0, 6}, {RZ, 0, 6}}},
+				{2, true, 11, {5, 4, 4}, {{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 5}, {RW, 10, 1}, {GY, 0, 4}, {GX, 0, 4}, {GW, 10, 1}, {BZ, 0, 1},
+										  {GZ, 0, 4}, {BX, 0, 4}, {BW, 10, 1}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}}},
+				{2, true, 11, {4, 5, 4}, {{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 4}, {RW, 10, 1}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5}, {GW, 10, 1}, {GZ, 0, 4},
+										  {BX, 0, 4}, {BW, 10, 1}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 4}, {BZ, 0, 1}, {BZ, 2, 1}, {RZ, 0, 4}, {GY, 4, 1}, {BZ, 3, 1}}},
+				{2, true, 11, {4, 4, 5}, {{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 4}, {RW, 10, 1}, {BY, 4, 1}, {GY, 0, 4}, {GX, 0, 4}, {GW, 10, 1}, {BZ, 0, 1},
+										  {GZ, 0, 4}, {BX, 0, 5}, {BW, 10, 1}, {BY, 0, 4}, {RY, 0, 4}, {BZ, 1, 1}, {BZ, 2, 1}, {RZ, 0, 4}, {BZ, 4, 1}, {BZ, 3, 1}}},
+				{2, true, 9, {5, 5, 5}, {{RW, 0, 9}, {BY, 4, 1}, {GW, 0, 9}, {GY, 4, 1}, {BW, 0, 9}, {BZ, 4, 1}, {RX, 0, 5}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5},
+										 {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}}},
+				{2, true, 8, {6, 5, 5}, {{RW, 0, 8}, {GZ, 4, 1}, {BY, 4, 1}, {GW, 0, 8}, {BZ, 2, 1}, {GY, 4, 1}, {BW, 0, 8}, {BZ, 3, 1}, {BZ, 4, 1}, {RX, 0, 6},
+										 {GY, 0, 4}, {GX, 0, 5}, {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 6}, {RZ, 0, 6}}},
+				{2, true, 8, {5, 6, 5}, {{RW, 0, 8}, {BZ, 0, 1}, {BY, 4, 1}, {GW, 0, 8}, {GY, 5, 1}, {GY, 4, 1}, {BW, 0, 8}, {GZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 5}, {GZ, 4, 1},
+										 {GY, 0, 4}, {GX, 0, 6}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}}},
+				{2, true, 8, {5, 5, 6}, {{RW, 0, 8}, {BZ, 1, 1}, {BY, 4, 1}, {GW, 0, 8}, {BY, 5, 1}, {GY, 4, 1}, {BW, 0, 8}, {BZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 5}, {GZ, 4, 1},
+										 {GY, 0, 4}, {GX, 0, 5}, {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 6}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}}},
+				{2, false, 6, {6, 6, 6}, {{RW, 0, 6}, {GZ, 4, 1}, {BZ, 0, 1}, {BZ, 1, 1}, {BY, 4, 1}, {GW, 0, 6}, {GY, 5, 1}, {BY, 5, 1}, {BZ, 2, 1}, {GY, 4, 1}, {BW, 0, 6}, {GZ, 5, 1},
+										  {BZ, 3, 1}, {BZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 6}, {GY, 0, 4}, {GX, 0, 6}, {GZ, 0, 4}, {BX, 0, 6}, {BY, 0, 4}, {RY, 0, 6}, {RZ, 0, 6}}},
+				{1, false, 10, {10, 10, 10}, {{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 10}, {GX, 0, 10}, {BX, 0, 10}}},
+				{1, true, 11, {9, 9, 9}, {{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 9}, {RW, 10, 1}, {GX, 0, 9}, {GW, 10, 1}, {BX, 0, 9}, {BW, 10, 1}}},
+				// The high bits of w are stored reversed, one field per bit
+				{1, true, 12, {8, 8, 8}, {{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 8}, {RW, 11, 1}, {RW, 10, 1}, {GX, 0, 8}, {GW, 11, 1}, {GW, 10, 1}, {BX, 0, 8}, {BW, 11, 1}, {BW, 10, 1}}},
+				{1, true, 16, {4, 4, 4}, {{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 4}, {RW, 15, 1}, {RW, 14, 1}, {RW, 13, 1}, {RW, 12, 1}, {RW, 11, 1}, {RW, 10, 1},
+										  {GX, 0, 4}, {GW, 15, 1}, {GW, 14, 1}, {GW, 13, 1}, {GW, 12, 1}, {GW, 11, 1}, {GW, 10, 1},
+										  {BX, 0, 4}, {BW, 15, 1}, {BW, 14, 1}, {BW, 13, 1}, {BW, 12, 1}, {BW, 11, 1}, {BW, 10, 1}}}};
+
+			const uint8_t BC6H_RESERVED_MODE = 0xFF;
+
+			// Index in bc6h_modes_data of the mode bits, 2 bits when they are below 2, 5 bits otherwise
+			constexpr uint8_t bc6h_mode_indices[32] = {
+				0, 1, 2, 10, BC6H_RESERVED_MODE, BC6H_RESERVED_MODE, 3, 11, BC6H_RESERVED_MODE, BC6H_RESERVED_MODE, 4, 12, BC6H_RESERVED_MODE, BC6H_RESERVED_MODE, 5, 13,
+				BC6H_RESERVED_MODE, BC6H_RESERVED_MODE, 6, BC6H_RESERVED_MODE, BC6H_RESERVED_MODE, BC6H_RESERVED_MODE, 7, BC6H_RESERVED_MODE,
+				BC6H_RESERVED_MODE, BC6H_RESERVED_MODE, 8, BC6H_RESERVED_MODE, BC6H_RESERVED_MODE, BC6H_RESERVED_MODE, 9, BC6H_RESERVED_MODE};
+
+			// Half float 1.0, the alpha of every BC6H pixel
+			const uint16_t HALF_ONE = 0x3C00;
+
+			// Endpoints of the unsigned format, scaled to 16 bits
+			inline int32_t unquantize_bc6h(int32_t value_data, uint32_t endpoint_bits)
+			{
+				if (endpoint_bits >= 15)
+				{
+					return value_data;
+				}
+				if (value_data == 0)
+				{
+					return 0;
+				}
+				if (value_data == (1 << endpoint_bits) - 1)
+				{
+					return 0xFFFF;
+				}
+				return ((value_data << 16) + 0x8000) >> endpoint_bits;
+			}
+
+			// Interpolated value to the bits of a positive half float, at most 0x7BFF
+			inline uint32_t finish_bc6h(uint32_t value_data)
+			{
+				return (value_data * 31) >> 6;
+			}
+
+			struct Bc6hTexels
+			{
+				// Unquantized endpoints w, x, y and z, red, green, blue and a null fourth channel
+				int32_t endpoints_data[4][4];
+				// Region and weight of the second endpoint of every texel
+				uint8_t regions_data[16];
+				uint8_t weights_data[16];
+			};
+
+			// The texels of the reserved modes are black
+			void unpack_bc6h(const uint8_t *block_data, Bc6hTexels &texels_data)
+			{
+				BlockBits bits_data(block_data);
+				uint32_t mode_value = bits_data.read(2);
+				if (mode_value >= 2)
+				{
+					mode_value |= bits_data.read(3) << 2;
+				}
+
+				const uint32_t mode_index = bc6h_mode_indices[mode_value];
+				if (mode_index == BC6H_RESERVED_MODE)
+				{
+					memset(&texels_data, 0, sizeof(texels_data));
+					return;
+				}
+
+				const Bc6hMode &mode_data = bc6h_modes_data[mode_index];
+				int32_t endpoints_data[12] = {};
+				for (const Bc6hField &field_data : mode_data.fields_data)
+				{
+					endpoints_data[field_data.endpoint_channel] |= bits_data.read(field_data.bits_number) << field_data.bit_shift;
+				}
+				const uint32_t partition_index = (mode_data.regions == 2) ? bits_data.read(5) : 0;
+
+				const uint32_t endpoints_number = 2 * mode_data.regions;
+				const uint32_t endpoint_bits = mode_data.endpoint_bits;
+				if (mode_data.is_transformed)
+				{
+					// The deltas are signed, the sums wrap around
+					const int32_t endpoint_mask = (1 << endpoint_bits) - 1;
+					for (uint32_t endpoint_index = 1; endpoint_index < endpoints_number; ++endpoint_index)
+					{
+						for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+						{
+							const uint32_t delta_bits = mode_data.delta_bits[channel_index];
+							int32_t delta_data = endpoints_data[3 * endpoint_index + channel_index];
+							if (delta_data & (1 << (delta_bits - 1)))
+							{
+								delta_data -= 1 << delta_bits;
+							}
+							endpoints_data[3 * endpoint_index + channel_index] = (endpoints_data[channel_index] + delta_data) & endpoint_mask;
+						}
+					}
+				}
+
+				memset(texels_data.endpoints_data, 0, sizeof(texels_data.endpoints_data));
+				for (uint32_t endpoint_index = 0; endpoint_index < endpoints_number; ++endpoint_index)
+				{
+					for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+					{
+						texels_data.endpoints_data[endpoint_index][channel_index] = unquantize_bc6h(endpoints_data[3 * endpoint_index + channel_index], endpoint_bits);
+					}
+				}
+
+				const uint32_t index_bits = (mode_data.regions == 2) ? 3 : 4;
+				const uint32_t partition_data = (mode_data.regions == 2) ? partitions_2_data[partition_index] : 0;
+				const uint32_t second_anchor = (mode_data.regions == 2) ? anchors_2_data[partition_index] : 0;
+				const uint8_t *weights_data = get_weights(index_bits);
+				for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+				{
+					const bool is_anchor = texel_index == 0 || texel_index == second_anchor;
+					texels_data.weights_data[texel_index] = weights_data[bits_data.read(index_bits - is_anchor)];
+					texels_data.regions_data[texel_index] = (partition_data >> texel_index) & 1;
+				}
+			}
+
+			// Decodes one block to 4 rows of 4 pixels, output_stride bytes apart
+			struct ScalarKernel
+			{
+				static void decode_bc1(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					uint32_t palette_data[4];
+					build_color_palette(block_data, true, palette_data);
+
+					uint32_t indices_data = load_uint32(block_data + 4);
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						uint8_t *row_data = output_data + row_index * output_stride;
+						for (uint32_t column_index = 0; column_index < 4; ++column_index)
+						{
+							store_pixel(row_data + 4 * column_index, palette_data[indices_data & 0x03]);
+							indices_data >>= 2;
+						}
+					}
+				}
+
+				static void decode_bc2(const uint8_t *block_data, uint8_t *output_data, size_t output_stride, bool premultiplied_alpha)
+				{
+					uint32_t palette_data[4];
+					build_color_palette(block_data + 8, false, palette_data);
+
+					uint64_t alpha_data = load_uint64(block_data);
+					uint32_t indices_data = load_uint32(block_data + 12);
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						uint8_t *row_data = output_data + row_index * output_stride;
+						for (uint32_t column_index = 0; column_index < 4; ++column_index)
+						{
+							uint32_t pixel_data = (palette_data[indices_data & 0x03] & COLOR_MASK) | (static_cast<uint32_t>(alpha_data & 0x0F) * 0x11) << 24;
+							if (premultiplied_alpha)
+							{
+								pixel_data = unpremultiply_pixel(pixel_data);
+							}
+							store_pixel(row_data + 4 * column_index, pixel_data);
+							indices_data >>= 2;
+							alpha_data >>= 4;
+						}
+					}
+				}
+
+				static void decode_bc3(const uint8_t *block_data, uint8_t *output_data, size_t output_stride, bool premultiplied_alpha)
+				{
+					uint32_t palette_data[4];
+					build_color_palette(block_data + 8, false, palette_data);
+					uint32_t alpha_palette_data[8];
+					build_value_palette(block_data, alpha_palette_data);
+
+					uint64_t alpha_indices_data = load_value_indices(block_data);
+					uint32_t indices_data = load_uint32(block_data + 12);
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						uint8_t *row_data = output_data + row_index * output_stride;
+						for (uint32_t column_index = 0; column_index < 4; ++column_index)
+						{
+							uint32_t pixel_data = (palette_data[indices_data & 0x03] & COLOR_MASK) | (alpha_palette_data[alpha_indices_data & 0x07] << 24);
+							if (premultiplied_alpha)
+							{
+								pixel_data = unpremultiply_pixel(pixel_data);
+							}
+							store_pixel(row_data + 4 * column_index, pixel_data);
+							indices_data >>= 2;
+							alpha_indices_data >>= 3;
+						}
+					}
+				}
+
+				static void decode_bc4(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					uint32_t palette_data[8];
+					build_value_palette(block_data, palette_data);
+
+					uint64_t indices_data = load_value_indices(block_data);
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						uint8_t *row_data = output_data + row_index * output_stride;
+						for (uint32_t column_index = 0; column_index < 4; ++column_index)
+						{
+							const uint32_t value_data = palette_data[indices_data & 0x07];
+							store_pixel(row_data + 4 * column_index, make_pixel(value_data, value_data, value_data, 0xFF));
+							indices_data >>= 3;
+						}
+					}
+				}
+
+				static void decode_bc5(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					uint32_t x_palette_data[8];
+					build_value_palette(block_data, x_palette_data);
+					uint32_t y_palette_data[8];
+					build_value_palette(block_data + 8, y_palette_data);
+
+					uint64_t x_indices_data = load_value_indices(block_data);
+					uint64_t y_indices_data = load_value_indices(block_data + 8);
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						uint8_t *row_data = output_data + row_index * output_stride;
+						for (uint32_t column_index = 0; column_index < 4; ++column_index)
+						{
+							store_pixel(row_data + 4 * column_index, normal_pixel(x_palette_data[x_indices_data & 0x07], y_palette_data[y_indices_data & 0x07]));
+							x_indices_data >>= 3;
+							y_indices_data >>= 3;
+						}
+					}
+				}
+
+				static void decode_bc6h(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					Bc6hTexels texels_data;
+					unpack_bc6h(block_data, texels_data);
+
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						uint8_t *row_data = output_data + row_index * output_stride;
+						for (uint32_t column_index = 0; column_index < 4; ++column_index)
+						{
+							const uint32_t texel_index = 4 * row_index + column_index;
+							const int32_t *endpoint_0 = texels_data.endpoints_data[2 * texels_data.regions_data[texel_index]];
+							const int32_t *endpoint_1 = texels_data.endpoints_data[2 * texels_data.regions_data[texel_index] + 1];
+							const uint32_t weight_data = texels_data.weights_data[texel_index];
+
+							uint16_t pixel_data[4];
+							for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+							{
+								pixel_data[channel_index] = static_cast<uint16_t>(finish_bc6h(interpolate_bptc(endpoint_0[channel_index], endpoint_1[channel_index], weight_data)));
+							}
+							pixel_data[3] = HALF_ONE;
+							memcpy(row_data + 8 * column_index, pixel_data, sizeof(pixel_data));
+						}
+					}
+				}
+
+				static void decode_bc7(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					Bc7Texels texels_data;
+					unpack_bc7(block_data, texels_data);
+
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						uint8_t *row_data = output_data + row_index * output_stride;
+						for (uint32_t column_index = 0; column_index < 4; ++column_index)
+						{
+							const uint32_t texel_index = 4 * row_index + column_index;
+							uint32_t pixel_data = 0;
+							for (uint32_t channel_shift = 0; channel_shift < 32; channel_shift += 8)
+							{
+								pixel_data |= interpolate_bptc((texels_data.endpoints_0[texel_index] >> channel_shift) & 0xFF, (texels_data.endpoints_1[texel_index] >> channel_shift) & 0xFF,
+															   (texels_data.weights_data[texel_index] >> channel_shift) & 0xFF)
+											  << channel_shift;
+							}
+							store_pixel(row_data + 4 * column_index, pixel_data);
+						}
+					}
+				}
+			};
+
+#ifdef GW2DATTOOLS_X86_64
+
+			// SSE2 is always available on x86-64, one register holds one row of 4 pixels
+			struct Sse2Kernel
+			{
+				// mask ? on_data : off_data
+				static inline __m128i select(__m128i mask_data, __m128i off_data, __m128i on_data)
+				{
+					return _mm_or_si128(_mm_and_si128(mask_data, on_data), _mm_andnot_si128(mask_data, off_data));
+				}
+
+				// All ones in the lanes where the bit of bits_data is set in value_data
+				static inline __m128i bit_mask(__m128i value_data, __m128i bits_data)
+				{
+					return _mm_cmpeq_epi32(_mm_and_si128(value_data, bits_data), bits_data);
+				}
+
+				static inline void decode_color_rows(const uint8_t *color_block, bool has_three_colors_mode, __m128i rows_data[4])
+				{
+					uint32_t palette_data[4];
+					build_color_palette(color_block, has_three_colors_mode, palette_data);
+					const __m128i color_0 = _mm_set1_epi32(static_cast<int>(palette_data[0]));
+					const __m128i color_1 = _mm_set1_epi32(static_cast<int>(palette_data[1]));
+					const __m128i color_2 = _mm_set1_epi32(static_cast<int>(palette_data[2]));
+					const __m128i color_3 = _mm_set1_epi32(static_cast<int>(palette_data[3]));
+
+					// Bits of the 2 bits index of each pixel of a row
+					const __m128i low_bits = _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+					const __m128i high_bits = _mm_setr_epi32(0x02, 0x08, 0x20, 0x80);
+
+					const uint32_t indices_data = load_uint32(color_block + 4);
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						const __m128i row_indices = _mm_set1_epi32(static_cast<int>((indices_data >> (8 * row_index)) & 0xFF));
+						const __m128i low_mask = bit_mask(row_indices, low_bits);
+						const __m128i high_mask = bit_mask(row_indices, high_bits);
+						rows_data[row_index] = select(high_mask, select(low_mask, color_0, color_1), select(low_mask, color_2, color_3));
+					}
+				}
+
+				// Values in the low byte of each pixel
+				// SSE2 has no lane permutation, the 16 values are looked up in the palette and then spread to the pixels
+				static inline void decode_value_rows(const uint8_t *value_block, __m128i rows_data[4])
+				{
+					uint32_t palette_data[8];
+					build_value_palette(value_block, palette_data);
+
+					const uint64_t indices_data = load_value_indices(value_block);
+					uint64_t low_values = 0;
+					uint64_t high_values = 0;
+					for (uint32_t pixel_index = 0; pixel_index < 8; ++pixel_index)
+					{
+						low_values |= static_cast<uint64_t>(palette_data[(indices_data >> (3 * pixel_index)) & 0x07]) << (8 * pixel_index);
+						high_values |= static_cast<uint64_t>(palette_data[(indices_data >> (3 * pixel_index + 24)) & 0x07]) << (8 * pixel_index);
+					}
+
+					const __m128i zero_data = _mm_setzero_si128();
+					const __m128i bytes_data = _mm_set_epi64x(static_cast<int64_t>(high_values), static_cast<int64_t>(low_values));
+					const __m128i words_0 = _mm_unpacklo_epi8(bytes_data, zero_data);
+					const __m128i words_1 = _mm_unpackhi_epi8(bytes_data, zero_data);
+					rows_data[0] = _mm_unpacklo_epi16(words_0, zero_data);
+					rows_data[1] = _mm_unpackhi_epi16(words_0, zero_data);
+					rows_data[2] = _mm_unpacklo_epi16(words_1, zero_data);
+					rows_data[3] = _mm_unpackhi_epi16(words_1, zero_data);
+				}
+
+				// Alpha in the high byte of each pixel
+				static inline void decode_explicit_alpha_rows(const uint8_t *alpha_block, __m128i rows_data[4])
+				{
+					const __m128i zero_data = _mm_setzero_si128();
+					const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+
+					// Each byte holds 2 pixels, the first one in the low nibble
+					const __m128i bytes_data = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(alpha_block));
+					const __m128i low_data = _mm_and_si128(bytes_data, nibble_mask);
+					const __m128i high_data = _mm_and_si128(_mm_srli_epi16(bytes_data, 4), nibble_mask);
+					__m128i alpha_data = _mm_unpacklo_epi8(low_data, high_data);
+					alpha_data = _mm_or_si128(alpha_data, _mm_slli_epi16(alpha_data, 4));
+
+					const __m128i words_0 = _mm_unpacklo_epi8(zero_data, alpha_data);
+					const __m128i words_1 = _mm_unpackhi_epi8(zero_data, alpha_data);
+					rows_data[0] = _mm_unpacklo_epi16(zero_data, words_0);
+					rows_data[1] = _mm_unpackhi_epi16(zero_data, words_0);
+					rows_data[2] = _mm_unpacklo_epi16(zero_data, words_1);
+					rows_data[3] = _mm_unpackhi_epi16(zero_data, words_1);
+				}
+
+				static inline __m128i unpremultiply(__m128i pixels_data)
+				{
+					const __m128i byte_mask = _mm_set1_epi32(0xFF);
+					const __m128 scale_data = _mm_set1_ps(255.0f);
+					const __m128 half_data = _mm_set1_ps(0.5f);
+
+					const __m128i alpha_data = _mm_srli_epi32(pixels_data, 24);
+					const __m128 alpha_float = _mm_cvtepi32_ps(alpha_data);
+
+					__m128 red_data = _mm_cvtepi32_ps(_mm_and_si128(pixels_data, byte_mask));
+					__m128 green_data = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels_data, 8), byte_mask));
+					__m128 blue_data = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels_data, 16), byte_mask));
+					red_data = _mm_min_ps(_mm_add_ps(_mm_div_ps(_mm_mul_ps(red_data, scale_data), alpha_float), half_data), scale_data);
+					green_data = _mm_min_ps(_mm_add_ps(_mm_div_ps(_mm_mul_ps(green_data, scale_data), alpha_float), half_data), scale_data);
+					blue_data = _mm_min_ps(_mm_add_ps(_mm_div_ps(_mm_mul_ps(blue_data, scale_data), alpha_float), half_data), scale_data);
+
+					__m128i result_data = _mm_and_si128(pixels_data, _mm_set1_epi32(static_cast<int>(ALPHA_MASK)));
+					result_data = _mm_or_si128(result_data, _mm_cvttps_epi32(red_data));
+					result_data = _mm_or_si128(result_data, _mm_slli_epi32(_mm_cvttps_epi32(green_data), 8));
+					result_data = _mm_or_si128(result_data, _mm_slli_epi32(_mm_cvttps_epi32(blue_data), 16));
+
+					// Fully transparent pixels are kept as they are
+					return select(_mm_cmpeq_epi32(alpha_data, _mm_setzero_si128()), result_data, pixels_data);
+				}
+
+				static inline __m128 normal_component(__m128i values_data)
+				{
+					return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(values_data), _mm_set1_ps(2.0f / 255.0f)), _mm_set1_ps(1.0f));
+				}
+
+				static inline __m128i normal_pixels(__m128i x_data, __m128i y_data)
+				{
+					const __m128 x_component = normal_component(x_data);
+					const __m128 y_component = normal_component(y_data);
+					__m128 z_component = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x_component, x_component)), _mm_mul_ps(y_component, y_component));
+					z_component = _mm_sqrt_ps(_mm_max_ps(z_component, _mm_setzero_ps()));
+					z_component = _mm_add_ps(_mm_mul_ps(z_component, _mm_set1_ps(127.5f)), _mm_set1_ps(128.0f));
+					const __m128i z_data = _mm_cvttps_epi32(_mm_min_ps(z_component, _mm_set1_ps(255.0f)));
+
+					__m128i result_data = _mm_or_si128(x_data, _mm_slli_epi32(y_data, 8));
+					result_data = _mm_or_si128(result_data, _mm_slli_epi32(z_data, 16));
+					return _mm_or_si128(result_data, _mm_set1_epi32(static_cast<int>(ALPHA_MASK)));
+				}
+
+				static inline void store_rows(const __m128i rows_data[4], uint8_t *output_data, size_t output_stride)
+				{
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						_mm_storeu_si128(reinterpret_cast<__m128i *>(output_data + row_index * output_stride), rows_data[row_index]);
+					}
+				}
+
+				static void decode_bc1(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					__m128i rows_data[4];
+					decode_color_rows(block_data, true, rows_data);
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				static void decode_bc2(const uint8_t *block_data, uint8_t *output_data, size_t output_stride, bool premultiplied_alpha)
+				{
+					__m128i rows_data[4];
+					decode_color_rows(block_data + 8, false, rows_data);
+					__m128i alpha_rows[4];
+					decode_explicit_alpha_rows(block_data, alpha_rows);
+
+					const __m128i color_mask = _mm_set1_epi32(COLOR_MASK);
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						rows_data[row_index] = _mm_or_si128(_mm_and_si128(rows_data[row_index], color_mask), alpha_rows[row_index]);
+						if (premultiplied_alpha)
+						{
+							rows_data[row_index] = unpremultiply(rows_data[row_index]);
+						}
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				static void decode_bc3(const uint8_t *block_data, uint8_t *output_data, size_t output_stride, bool premultiplied_alpha)
+				{
+					__m128i rows_data[4];
+					decode_color_rows(block_data + 8, false, rows_data);
+					__m128i alpha_rows[4];
+					decode_value_rows(block_data, alpha_rows);
+
+					const __m128i color_mask = _mm_set1_epi32(COLOR_MASK);
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						rows_data[row_index] = _mm_or_si128(_mm_and_si128(rows_data[row_index], color_mask), _mm_slli_epi32(alpha_rows[row_index], 24));
+						if (premultiplied_alpha)
+						{
+							rows_data[row_index] = unpremultiply(rows_data[row_index]);
+						}
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				static void decode_bc4(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					__m128i rows_data[4];
+					decode_value_rows(block_data, rows_data);
+
+					const __m128i alpha_data = _mm_set1_epi32(static_cast<int>(ALPHA_MASK));
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						const __m128i value_data = rows_data[row_index];
+						__m128i gray_data = _mm_or_si128(value_data, _mm_slli_epi32(value_data, 8));
+						gray_data = _mm_or_si128(gray_data, _mm_slli_epi32(value_data, 16));
+						rows_data[row_index] = _mm_or_si128(gray_data, alpha_data);
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				static void decode_bc5(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					__m128i rows_data[4];
+					decode_value_rows(block_data, rows_data);
+					__m128i y_rows[4];
+					decode_value_rows(block_data + 8, y_rows);
+
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						rows_data[row_index] = normal_pixels(rows_data[row_index], y_rows[row_index]);
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				// Channels of 16 bits, (64 - weight) * endpoint_0 + weight * endpoint_1 is at most 64 * 255
+				static inline __m128i interpolate_bptc_words(__m128i endpoints_0, __m128i endpoints_1, __m128i weights_data)
+				{
+					__m128i sum_data = _mm_mullo_epi16(_mm_sub_epi16(_mm_set1_epi16(64), weights_data), endpoints_0);
+					sum_data = _mm_add_epi16(sum_data, _mm_mullo_epi16(weights_data, endpoints_1));
+					return _mm_srli_epi16(_mm_add_epi16(sum_data, _mm_set1_epi16(32)), 6);
+				}
+
+				// The values are below 2^24, so the float operations are exact and give the integer results of the scalar kernel
+				static inline __m128i interpolate_bc6h_texel(const __m128 endpoints_data[4], uint32_t region_index, uint32_t weight_data)
+				{
+					__m128 sum_data = _mm_mul_ps(endpoints_data[2 * region_index], _mm_set1_ps(static_cast<float>(64 - weight_data)));
+					sum_data = _mm_add_ps(sum_data, _mm_mul_ps(endpoints_data[2 * region_index + 1], _mm_set1_ps(static_cast<float>(weight_data))));
+					sum_data = _mm_add_ps(sum_data, _mm_set1_ps(32.0f));
+					const __m128i value_data = _mm_cvttps_epi32(_mm_mul_ps(sum_data, _mm_set1_ps(1.0f / 64.0f)));
+
+					// finish_bc6h, value * 31 is (value << 5) - value
+					return _mm_srli_epi32(_mm_sub_epi32(_mm_slli_epi32(value_data, 5), value_data), 6);
+				}
+
+				static void decode_bc6h(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					Bc6hTexels texels_data;
+					unpack_bc6h(block_data, texels_data);
+
+					__m128 endpoints_data[4];
+					for (uint32_t endpoint_index = 0; endpoint_index < 4; ++endpoint_index)
+					{
+						endpoints_data[endpoint_index] = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(texels_data.endpoints_data[endpoint_index])));
+					}
+
+					// The fourth channel is null until the alpha is set
+					const __m128i alpha_data = _mm_setr_epi16(0, 0, 0, static_cast<short>(HALF_ONE), 0, 0, 0, static_cast<short>(HALF_ONE));
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						uint8_t *row_data = output_data + row_index * output_stride;
+						for (uint32_t column_index = 0; column_index < 4; column_index += 2)
+						{
+							const uint32_t texel_index = 4 * row_index + column_index;
+							const __m128i texel_0 = interpolate_bc6h_texel(endpoints_data, texels_data.regions_data[texel_index], texels_data.weights_data[texel_index]);
+							const __m128i texel_1 = interpolate_bc6h_texel(endpoints_data, texels_data.regions_data[texel_index + 1], texels_data.weights_data[texel_index + 1]);
+							_mm_storeu_si128(reinterpret_cast<__m128i *>(row_data + 8 * column_index), _mm_or_si128(_mm_packs_epi32(texel_0, texel_1), alpha_data));
+						}
+					}
+				}
+
+				static void decode_bc7(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					Bc7Texels texels_data;
+					unpack_bc7(block_data, texels_data);
+
+					const __m128i zero_data = _mm_setzero_si128();
+					__m128i rows_data[4];
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						const __m128i endpoints_0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&texels_data.endpoints_0[4 * row_index]));
+						const __m128i endpoints_1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&texels_data.endpoints_1[4 * row_index]));
+						const __m128i weights_data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&texels_data.weights_data[4 * row_index]));
+
+						const __m128i low_data = interpolate_bptc_words(_mm_unpacklo_epi8(endpoints_0, zero_data), _mm_unpacklo_epi8(endpoints_1, zero_data),
+																		_mm_unpacklo_epi8(weights_data, zero_data));
+						const __m128i high_data = interpolate_bptc_words(_mm_unpackhi_epi8(endpoints_0, zero_data), _mm_unpackhi_epi8(endpoints_1, zero_data),
+																		 _mm_unpackhi_epi8(weights_data, zero_data));
+						rows_data[row_index] = _mm_packus_epi16(low_data, high_data);
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+			};
+
+			// One register holds two rows, the indices are expanded with a variable shift
+			// and looked up in the palette with a lane permutation
+			struct Avx2Kernel
+			{
+				GW2DATTOOLS_TARGET_AVX2 static inline void decode_color_rows(const uint8_t *color_block, bool has_three_colors_mode, __m256i rows_data[2])
+				{
+					uint32_t palette_data[4];
+					build_color_palette(color_block, has_three_colors_mode, palette_data);
+					const __m256i colors_data = _mm256_setr_epi32(static_cast<int>(palette_data[0]), static_cast<int>(palette_data[1]),
+																  static_cast<int>(palette_data[2]), static_cast<int>(palette_data[3]),
+																  static_cast<int>(palette_data[0]), static_cast<int>(palette_data[1]),
+																  static_cast<int>(palette_data[2]), static_cast<int>(palette_data[3]));
+
+					const __m256i shifts_data = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+					const __m256i index_mask = _mm256_set1_epi32(0x03);
+
+					const uint32_t indices_data = load_uint32(color_block + 4);
+					for (uint32_t half_index = 0; half_index < 2; ++half_index)
+					{
+						const __m256i half_indices = _mm256_set1_epi32(static_cast<int>(indices_data >> (16 * half_index)));
+						rows_data[half_index] = _mm256_permutevar8x32_epi32(colors_data, _mm256_and_si256(_mm256_srlv_epi32(half_indices, shifts_data), index_mask));
+					}
+				}
+
+				// Same values as build_value_palette, the divisions by 7 and 5 are exact multiplications for these ranges
+				GW2DATTOOLS_TARGET_AVX2 static inline __m256i build_value_palette(const uint8_t *value_block)
+				{
+					const uint32_t value_0 = value_block[0];
+					const uint32_t value_1 = value_block[1];
+					const __m256i values_0 = _mm256_set1_epi32(static_cast<int>(value_0));
+					const __m256i values_1 = _mm256_set1_epi32(static_cast<int>(value_1));
+
+					if (value_0 > value_1)
+					{
+						const __m256i sum_data = _mm256_add_epi32(_mm256_mullo_epi32(values_0, _mm256_setr_epi32(7, 0, 6, 5, 4, 3, 2, 1)),
+																  _mm256_mullo_epi32(values_1, _mm256_setr_epi32(0, 7, 1, 2, 3, 4, 5, 6)));
+						return _mm256_srli_epi32(_mm256_mullo_epi32(sum_data, _mm256_set1_epi32(9363)), 16);
+					}
+
+					const __m256i sum_data = _mm256_add_epi32(_mm256_mullo_epi32(values_0, _mm256_setr_epi32(5, 0, 4, 3, 2, 1, 0, 0)),
+															  _mm256_mullo_epi32(values_1, _mm256_setr_epi32(0, 5, 1, 2, 3, 4, 0, 0)));
+					return _mm256_or_si256(_mm256_srli_epi32(_mm256_mullo_epi32(sum_data, _mm256_set1_epi32(13108)), 16),
+										   _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, 0xFF));
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static inline void decode_value_rows(const uint8_t *value_block, __m256i rows_data[2])
+				{
+					const __m256i values_data = build_value_palette(value_block);
+
+					const __m256i shifts_data = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+					const __m256i index_mask = _mm256_set1_epi32(0x07);
+
+					const uint64_t indices_data = load_value_indices(value_block);
+					for (uint32_t half_index = 0; half_index < 2; ++half_index)
+					{
+						const __m256i half_indices = _mm256_set1_epi32(static_cast<int>((indices_data >> (24 * half_index)) & 0xFFFFFF));
+						rows_data[half_index] = _mm256_permutevar8x32_epi32(values_data, _mm256_and_si256(_mm256_srlv_epi32(half_indices, shifts_data), index_mask));
+					}
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static inline void decode_explicit_alpha_rows(const uint8_t *alpha_block, __m256i rows_data[2])
+				{
+					const __m256i shifts_data = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+					const __m256i nibble_mask = _mm256_set1_epi32(0x0F);
+
+					for (uint32_t half_index = 0; half_index < 2; ++half_index)
+					{
+						const __m256i half_alpha = _mm256_set1_epi32(static_cast<int>(load_uint32(alpha_block + 4 * half_index)));
+						__m256i alpha_data = _mm256_and_si256(_mm256_srlv_epi32(half_alpha, shifts_data), nibble_mask);
+						alpha_data = _mm256_or_si256(alpha_data, _mm256_slli_epi32(alpha_data, 4));
+						rows_data[half_index] = _mm256_slli_epi32(alpha_data, 24);
+					}
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static inline __m256i unpremultiply(__m256i pixels_data)
+				{
+					const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+					const __m256 scale_data = _mm256_set1_ps(255.0f);
+					const __m256 half_data = _mm256_set1_ps(0.5f);
+
+					const __m256i alpha_data = _mm256_srli_epi32(pixels_data, 24);
+					const __m256 alpha_float = _mm256_cvtepi32_ps(alpha_data);
+
+					__m256 red_data = _mm256_cvtepi32_ps(_mm256_and_si256(pixels_data, byte_mask));
+					__m256 green_data = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels_data, 8), byte_mask));
+					__m256 blue_data = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels_data, 16), byte_mask));
+					red_data = _mm256_min_ps(_mm256_add_ps(_mm256_div_ps(_mm256_mul_ps(red_data, scale_data), alpha_float), half_data), scale_data);
+					green_data = _mm256_min_ps(_mm256_add_ps(_mm256_div_ps(_mm256_mul_ps(green_data, scale_data), alpha_float), half_data), scale_data);
+					blue_data = _mm256_min_ps(_mm256_add_ps(_mm256_div_ps(_mm256_mul_ps(blue_data, scale_data), alpha_float), half_data), scale_data);
+
+					__m256i result_data = _mm256_and_si256(pixels_data, _mm256_set1_epi32(static_cast<int>(ALPHA_MASK)));
+					result_data = _mm256_or_si256(result_data, _mm256_cvttps_epi32(red_data));
+					result_data = _mm256_or_si256(result_data, _mm256_slli_epi32(_mm256_cvttps_epi32(green_data), 8));
+					result_data = _mm256_or_si256(result_data, _mm256_slli_epi32(_mm256_cvttps_epi32(blue_data), 16));
+
+					// Fully transparent pixels are kept as they are
+					return _mm256_blendv_epi8(result_data, pixels_data, _mm256_cmpeq_epi32(alpha_data, _mm256_setzero_si256()));
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static inline __m256 normal_component(__m256i values_data)
+				{
+					return _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(values_data), _mm256_set1_ps(2.0f / 255.0f)), _mm256_set1_ps(1.0f));
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static inline __m256i normal_pixels(__m256i x_data, __m256i y_data)
+				{
+					const __m256 x_component = normal_component(x_data);
+					const __m256 y_component = normal_component(y_data);
+					__m256 z_component = _mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(x_component, x_component)), _mm256_mul_ps(y_component, y_component));
+					z_component = _mm256_sqrt_ps(_mm256_max_ps(z_component, _mm256_setzero_ps()));
+					z_component = _mm256_add_ps(_mm256_mul_ps(z_component, _mm256_set1_ps(127.5f)), _mm256_set1_ps(128.0f));
+					const __m256i z_data = _mm256_cvttps_epi32(_mm256_min_ps(z_component, _mm256_set1_ps(255.0f)));
+
+					__m256i result_data = _mm256_or_si256(x_data, _mm256_slli_epi32(y_data, 8));
+					result_data = _mm256_or_si256(result_data, _mm256_slli_epi32(z_data, 16));
+					return _mm256_or_si256(result_data, _mm256_set1_epi32(static_cast<int>(ALPHA_MASK)));
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static inline void store_rows(const __m256i rows_data[2], uint8_t *output_data, size_t output_stride)
+				{
+					for (uint32_t half_index = 0; half_index < 2; ++half_index)
+					{
+						uint8_t *row_data = output_data + 2 * half_index * output_stride;
+						_mm_storeu_si128(reinterpret_cast<__m128i *>(row_data), _mm256_castsi256_si128(rows_data[half_index]));
+						_mm_storeu_si128(reinterpret_cast<__m128i *>(row_data + output_stride), _mm256_extracti128_si256(rows_data[half_index], 1));
+					}
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static void decode_bc1(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					__m256i rows_data[2];
+					decode_color_rows(block_data, true, rows_data);
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static void decode_bc2(const uint8_t *block_data, uint8_t *output_data, size_t output_stride, bool premultiplied_alpha)
+				{
+					__m256i rows_data[2];
+					decode_color_rows(block_data + 8, false, rows_data);
+					__m256i alpha_rows[2];
+					decode_explicit_alpha_rows(block_data, alpha_rows);
+
+					const __m256i color_mask = _mm256_set1_epi32(COLOR_MASK);
+					for (uint32_t half_index = 0; half_index < 2; ++half_index)
+					{
+						rows_data[half_index] = _mm256_or_si256(_mm256_and_si256(rows_data[half_index], color_mask), alpha_rows[half_index]);
+						if (premultiplied_alpha)
+						{
+							rows_data[half_index] = unpremultiply(rows_data[half_index]);
+						}
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static void decode_bc3(const uint8_t *block_data, uint8_t *output_data, size_t output_stride, bool premultiplied_alpha)
+				{
+					__m256i rows_data[2];
+					decode_color_rows(block_data + 8, false, rows_data);
+					__m256i alpha_rows[2];
+					decode_value_rows(block_data, alpha_rows);
+
+					const __m256i color_mask = _mm256_set1_epi32(COLOR_MASK);
+					for (uint32_t half_index = 0; half_index < 2; ++half_index)
+					{
+						rows_data[half_index] = _mm256_or_si256(_mm256_and_si256(rows_data[half_index], color_mask), _mm256_slli_epi32(alpha_rows[half_index], 24));
+						if (premultiplied_alpha)
+						{
+							rows_data[half_index] = unpremultiply(rows_data[half_index]);
+						}
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static void decode_bc4(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					__m256i rows_data[2];
+					decode_value_rows(block_data, rows_data);
+
+					// value * 0x010101 spreads the value to the 3 color channels
+					const __m256i spread_data = _mm256_set1_epi32(0x010101);
+					const __m256i alpha_data = _mm256_set1_epi32(static_cast<int>(ALPHA_MASK));
+					for (uint32_t half_index = 0; half_index < 2; ++half_index)
+					{
+						rows_data[half_index] = _mm256_or_si256(_mm256_mullo_epi32(rows_data[half_index], spread_data), alpha_data);
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static void decode_bc5(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					__m256i rows_data[2];
+					decode_value_rows(block_data, rows_data);
+					__m256i y_rows[2];
+					decode_value_rows(block_data + 8, y_rows);
+
+					for (uint32_t half_index = 0; half_index < 2; ++half_index)
+					{
+						rows_data[half_index] = normal_pixels(rows_data[half_index], y_rows[half_index]);
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static inline __m256i interpolate_bptc_words(__m256i endpoints_0, __m256i endpoints_1, __m256i weights_data)
+				{
+					__m256i sum_data = _mm256_mullo_epi16(_mm256_sub_epi16(_mm256_set1_epi16(64), weights_data), endpoints_0);
+					sum_data = _mm256_add_epi16(sum_data, _mm256_mullo_epi16(weights_data, endpoints_1));
+					return _mm256_srli_epi16(_mm256_add_epi16(sum_data, _mm256_set1_epi16(32)), 6);
+				}
+
+				// One endpoint of the region of two neighbour texels, one per 128 bits lane
+				GW2DATTOOLS_TARGET_AVX2 static inline __m256i load_bc6h_endpoints(const Bc6hTexels &texels_data, uint32_t texel_index, uint32_t endpoint_index)
+				{
+					const __m128i endpoint_0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(texels_data.endpoints_data[2 * texels_data.regions_data[texel_index] + endpoint_index]));
+					const __m128i endpoint_1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(texels_data.endpoints_data[2 * texels_data.regions_data[texel_index + 1] + endpoint_index]));
+					return _mm256_inserti128_si256(_mm256_castsi128_si256(endpoint_0), endpoint_1, 1);
+				}
+
+				// Two texels, the products of 32 bits are computed exactly
+				GW2DATTOOLS_TARGET_AVX2 static inline __m256i interpolate_bc6h_texels(const Bc6hTexels &texels_data, uint32_t texel_index)
+				{
+					const uint32_t weight_0 = texels_data.weights_data[texel_index];
+					const uint32_t weight_1 = texels_data.weights_data[texel_index + 1];
+					const __m256i weights_data = _mm256_setr_epi32(weight_0, weight_0, weight_0, weight_0, weight_1, weight_1, weight_1, weight_1);
+
+					__m256i sum_data = _mm256_mullo_epi32(_mm256_sub_epi32(_mm256_set1_epi32(64), weights_data), load_bc6h_endpoints(texels_data, texel_index, 0));
+					sum_data = _mm256_add_epi32(sum_data, _mm256_mullo_epi32(weights_data, load_bc6h_endpoints(texels_data, texel_index, 1)));
+					const __m256i value_data = _mm256_srli_epi32(_mm256_add_epi32(sum_data, _mm256_set1_epi32(32)), 6);
+					return _mm256_srli_epi32(_mm256_mullo_epi32(value_data, _mm256_set1_epi32(31)), 6);
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static void decode_bc6h(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					Bc6hTexels texels_data;
+					unpack_bc6h(block_data, texels_data);
+
+					const __m256i alpha_data = _mm256_set1_epi64x(static_cast<int64_t>(HALF_ONE) << 48);
+					for (uint32_t row_index = 0; row_index < 4; ++row_index)
+					{
+						// The pack interleaves the lanes, texels 0 and 2 in the low lane, 1 and 3 in the high lane
+						const __m256i texels_0 = interpolate_bc6h_texels(texels_data, 4 * row_index);
+						const __m256i texels_1 = interpolate_bc6h_texels(texels_data, 4 * row_index + 2);
+						const __m256i row_data = _mm256_permute4x64_epi64(_mm256_packs_epi32(texels_0, texels_1), 0xD8);
+						_mm256_storeu_si256(reinterpret_cast<__m256i *>(output_data + row_index * output_stride), _mm256_or_si256(row_data, alpha_data));
+					}
+				}
+
+				GW2DATTOOLS_TARGET_AVX2 static void decode_bc7(const uint8_t *block_data, uint8_t *output_data, size_t output_stride)
+				{
+					Bc7Texels texels_data;
+					unpack_bc7(block_data, texels_data);
+
+					// The unpacks and the pack work in each lane, the texels keep their order
+					const __m256i zero_data = _mm256_setzero_si256();
+					__m256i rows_data[2];
+					for (uint32_t half_index = 0; half_index < 2; ++half_index)
+					{
+						const __m256i endpoints_0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&texels_data.endpoints_0[8 * half_index]));
+						const __m256i endpoints_1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&texels_data.endpoints_1[8 * half_index]));
+						const __m256i weights_data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&texels_data.weights_data[8 * half_index]));
+
+						const __m256i low_data = interpolate_bptc_words(_mm256_unpacklo_epi8(endpoints_0, zero_data), _mm256_unpacklo_epi8(endpoints_1, zero_data),
+																		_mm256_unpacklo_epi8(weights_data, zero_data));
+						const __m256i high_data = interpolate_bptc_words(_mm256_unpackhi_epi8(endpoints_0, zero_data), _mm256_unpackhi_epi8(endpoints_1, zero_data),
+																		 _mm256_unpackhi_epi8(weights_data, zero_data));
+						rows_data[half_index] = _mm256_packus_epi16(low_data, high_data);
+					}
+					store_rows(rows_data, output_data, output_stride);
+				}
+			};
+
+			bool is_avx2_supported()
+			{
+#if defined(_MSC_VER) && !defined(__clang__)
+				int cpu_info[4];
+				__cpuid(cpu_info, 0);
+				if (cpu_info[0] < 7)
+				{
+					return false;
+				}
+
+				// The OS must save the AVX registers
+				__cpuid(cpu_info, 1);
+				const bool has_osxsave = (cpu_info[2] & (1 << 27)) != 0;
+				const bool has_avx = (cpu_info[2] & (1 << 28)) != 0;
+				if (!has_osxsave || !has_avx || (_xgetbv(0) & 0x06) != 0x06)
+				{
+					return false;
+				}
+
+				__cpuidex(cpu_info, 7, 0);
+				return (cpu_info[1] & (1 << 5)) != 0;
+#else
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx2");
+#endif
+			}
+
+#endif // GW2DATTOOLS_X86_64
+
+			// decode_block(block_data, output_data, output_stride) is called on every block of the rows of blocks
+			// [begin_row, end_row), the other rows of the image are not touched
+			template <typename DecodeBlock>
+			void decode_image(const uint8_t *block_data, uint32_t bytes_block, uint32_t bytes_pixel, uint32_t width, uint32_t height, uint32_t begin_row, uint32_t end_row,
+							  uint8_t *output_data, DecodeBlock &&decode_block)
+			{
+				const size_t output_stride = static_cast<size_t>(width) * bytes_pixel;
+				const uint32_t blocks_width = (width + 3) / 4;
+
+				block_data += static_cast<size_t>(begin_row) * blocks_width * bytes_block;
+				for (uint32_t block_row = begin_row; block_row < end_row; ++block_row)
+				{
+					const uint32_t pixels_height = std::min(4u, height - 4 * block_row);
+					uint8_t *row_data = output_data + 4 * block_row * output_stride;
+
+					for (uint32_t block_column = 0; block_column < blocks_width; ++block_column)
+					{
+						const uint32_t pixels_width = std::min(4u, width - 4 * block_column);
+						uint8_t *pixel_data = row_data + 4 * bytes_pixel * block_column;
+
+						if (pixels_width == 4 && pixels_height == 4)
+						{
+							decode_block(block_data, pixel_data, output_stride);
+						}
+						else
+						{
+							uint8_t tile_data[4 * 4 * 8];
+							decode_block(block_data, tile_data, 4 * bytes_pixel);
+							for (uint32_t tile_row = 0; tile_row < pixels_height; ++tile_row)
+							{
+								memcpy(pixel_data + tile_row * output_stride, tile_data + 4 * bytes_pixel * tile_row, bytes_pixel * pixels_width);
+							}
+						}
+
+						block_data += bytes_block;
+					}
+				}
+			}
+
+			template <typename Kernel>
+			void decode_texture(const BlockFormat &block_format, const uint8_t *block_data, uint32_t width, uint32_t height, uint32_t begin_row, uint32_t end_row,
+								uint8_t *output_data)
+			{
+				const bool premultiplied_alpha = block_format.premultiplied_alpha;
+
+				switch (block_format.layout)
+				{
+				case BL_BC1:
+					decode_image(block_data, block_format.bytes_block, block_format.bytes_pixel, width, height, begin_row, end_row, output_data, [](const uint8_t *block_input, uint8_t *block_output, size_t output_stride)
+								 { Kernel::decode_bc1(block_input, block_output, output_stride); });
+					break;
+
+				case BL_BC2:
+					decode_image(block_data, block_format.bytes_block, block_format.bytes_pixel, width, height, begin_row, end_row, output_data, [premultiplied_alpha](const uint8_t *block_input, uint8_t *block_output, size_t output_stride)
+								 { Kernel::decode_bc2(block_input, block_output, output_stride, premultiplied_alpha); });
+					break;
+
+				case BL_BC3:
+					decode_image(block_data, block_format.bytes_block, block_format.bytes_pixel, width, height, begin_row, end_row, output_data, [premultiplied_alpha](const uint8_t *block_input, uint8_t *block_output, size_t output_stride)
+								 { Kernel::decode_bc3(block_input, block_output, output_stride, premultiplied_alpha); });
+					break;
+
+				case BL_BC4:
+					decode_image(block_data, block_format.bytes_block, block_format.bytes_pixel, width, height, begin_row, end_row, output_data, [](const uint8_t *block_input, uint8_t *block_output, size_t output_stride)
+								 { Kernel::decode_bc4(block_input, block_output, output_stride); });
+					break;
+
+				case BL_BC5:
+					decode_image(block_data, block_format.bytes_block, block_format.bytes_pixel, width, height, begin_row, end_row, output_data, [](const uint8_t *block_input, uint8_t *block_output, size_t output_stride)
+								 { Kernel::decode_bc5(block_input, block_output, output_stride); });
+					break;
+
+				case BL_BC6H:
+					decode_image(block_data, block_format.bytes_block, block_format.bytes_pixel, width, height, begin_row, end_row, output_data, [](const uint8_t *block_input, uint8_t *block_output, size_t output_stride)
+								 { Kernel::decode_bc6h(block_input, block_output, output_stride); });
+					break;
+
+				case BL_BC7:
+					decode_image(block_data, block_format.bytes_block, block_format.bytes_pixel, width, height, begin_row, end_row, output_data, [](const uint8_t *block_input, uint8_t *block_output, size_t output_stride)
+								 { Kernel::decode_bc7(block_input, block_output, output_stride); });
+					break;
+				}
+			}
+
+			// Thumbnails only read the endpoints of the blocks, one pixel stands for a whole block
+			// The pixels are kept as 4 lanes of 16 bits, red in the low lane and alpha in the high lane,
+			// up to 257 of them can be summed without carry between the lanes
+			const uint64_t LANES_MASK = 0x00FF00FF00FF00FF;
+			const uint64_t ALPHA_LANE = 0x00FF000000000000;
+
+			inline uint64_t spread_channels(uint32_t pixel_data)
+			{
+				uint64_t lanes_data = pixel_data;
+				lanes_data = (lanes_data | (lanes_data << 16)) & 0x0000FFFF0000FFFF;
+				lanes_data = (lanes_data | (lanes_data << 8)) & LANES_MASK;
+				return lanes_data;
+			}
+
+			inline uint32_t gather_channels(uint64_t lanes_data)
+			{
+				lanes_data = (lanes_data | (lanes_data >> 8)) & 0x0000FFFF0000FFFF;
+				lanes_data = lanes_data | (lanes_data >> 16);
+				return static_cast<uint32_t>(lanes_data);
+			}
+
+			// Mean of the two 565 colors of a color block, opaque
+			// The channels are summed before being expanded to 8 bits, 62 * 1053 and 126 * 518 still fit in a lane
+			inline uint64_t average_color_endpoints(const uint8_t *color_block)
+			{
+				const uint32_t color_0 = load_uint16(color_block);
+				const uint32_t color_1 = load_uint16(color_block + 2);
+
+				const uint64_t sums_data = (static_cast<uint64_t>((color_0 & 0x1F) + (color_1 & 0x1F)) << 32) | ((color_0 >> 11) + (color_1 >> 11));
+				const uint64_t green_sum = ((color_0 >> 5) & 0x3F) + ((color_1 >> 5) & 0x3F);
+
+				// Red and blue * 255 / 62, green * 255 / 126
+				return (((sums_data * 1053) >> 8) & 0x000000FF000000FF) | ((((green_sum * 518) >> 8) & 0xFF) << 16) | ALPHA_LANE;
+			}
+
+			inline uint64_t average_value_endpoints(const uint8_t *value_block)
+			{
+				return (static_cast<uint64_t>(value_block[0]) + value_block[1]) / 2;
+			}
+
+			// Positive half floats, as written by decode_bc6h
+			// The bits are moved to a float rather than going through std::ldexp, a library call per channel
+			inline float half_to_float(uint32_t half_data)
+			{
+				const uint32_t exponent_data = half_data >> 10;
+				const uint32_t mantissa_data = half_data & 0x3FF;
+				if (exponent_data == 0)
+				{
+					return static_cast<float>(mantissa_data) * (1.0f / 16777216.0f);
+				}
+				return std::bit_cast<float>(((exponent_data + 127 - 15) << 23) | (mantissa_data << 13));
+			}
+
+#ifdef GW2DATTOOLS_X86_64
+			// The BPTC texels of the thumbnails are expanded with SSE2, always there on x86-64
+			typedef Sse2Kernel ThumbnailKernel;
+#else
+			typedef ScalarKernel ThumbnailKernel;
+#endif
+
+			inline uint64_t unpremultiply_lanes(uint64_t lanes_data)
+			{
+				return spread_channels(unpremultiply_pixel(gather_channels(lanes_data)));
+			}
+
+			struct EndpointKernel
+			{
+				// In the 3 colors mode, the texels of index 3 are transparent, they are counted without expanding the block
+				static uint64_t block_bc1(const uint8_t *block_data)
+				{
+					// Without branch, the mode is not predictable from one block to the next
+					const uint32_t indices_data = load_uint32(block_data + 4);
+					const uint32_t three_colors_mask = 0u - static_cast<uint32_t>(load_uint16(block_data) <= load_uint16(block_data + 2));
+
+					// The indices 3 are counted inline, std::popcount is a library call without the POPCNT instruction
+					uint32_t transparent_bits = indices_data & (indices_data >> 1) & 0x55555555 & three_colors_mask;
+					transparent_bits = (transparent_bits & 0x33333333) + ((transparent_bits >> 2) & 0x33333333);
+					transparent_bits = (transparent_bits + (transparent_bits >> 4)) & 0x0F0F0F0F;
+					const uint64_t transparent_number = (transparent_bits * 0x01010101) >> 24;
+					return average_color_endpoints(block_data) - ((255 * transparent_number / 16) << 48);
+				}
+
+				// The explicit alpha has no endpoints, its 16 values of 4 bits are summed at once
+				static uint64_t block_bc2(const uint8_t *block_data, bool premultiplied_alpha)
+				{
+					const uint64_t alpha_data = load_uint64(block_data);
+					const uint64_t alpha_sums = (alpha_data & 0x0F0F0F0F0F0F0F0F) + ((alpha_data >> 4) & 0x0F0F0F0F0F0F0F0F);
+					const uint64_t alpha_sum = (alpha_sums * 0x0101010101010101) >> 56;
+
+					const uint64_t lanes_data = (average_color_endpoints(block_data + 8) & ~ALPHA_LANE) | ((alpha_sum * 0x11 / 16) << 48);
+					return premultiplied_alpha ? unpremultiply_lanes(lanes_data) : lanes_data;
+				}
+
+				static uint64_t block_bc3(const uint8_t *block_data, bool premultiplied_alpha)
+				{
+					const uint64_t lanes_data = (average_color_endpoints(block_data + 8) & ~ALPHA_LANE) | (average_value_endpoints(block_data) << 48);
+					return premultiplied_alpha ? unpremultiply_lanes(lanes_data) : lanes_data;
+				}
+
+				static uint64_t block_bc4(const uint8_t *block_data)
+				{
+					return average_value_endpoints(block_data) * 0x0000000100010001 | ALPHA_LANE;
+				}
+
+				// z_table holds the Z of every X and Y, see normal_z_table
+				static uint64_t block_bc5(const uint8_t *block_data, const uint8_t *z_table)
+				{
+					const uint64_t x_data = average_value_endpoints(block_data);
+					const uint64_t y_data = average_value_endpoints(block_data + 8);
+					return x_data | (y_data << 16) | (static_cast<uint64_t>(z_table[(x_data << 8) | y_data]) << 32) | ALPHA_LANE;
+				}
+
+				// The endpoints of a BPTC block depend on the subset of every texel, the block is decoded and its texels are averaged
+				// The HDR colors are clamped to 1
+				static uint64_t block_bc6h(const uint8_t *block_data)
+				{
+					uint16_t tile_data[4 * 4 * 4];
+					ThumbnailKernel::decode_bc6h(block_data, reinterpret_cast<uint8_t *>(tile_data), 4 * 8);
+
+					float sums_data[3] = {};
+					for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+					{
+						for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+						{
+							sums_data[channel_index] += half_to_float(tile_data[4 * texel_index + channel_index]);
+						}
+					}
+
+					uint64_t lanes_data = ALPHA_LANE;
+					for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+					{
+						lanes_data |= static_cast<uint64_t>(std::min(sums_data[channel_index] / 16.0f, 1.0f) * 255.0f + 0.5f) << (16 * channel_index);
+					}
+					return lanes_data;
+				}
+
+				// 16 channels of 8 bits fit in a lane, the bits moved to the lane below by the division are masked
+				static uint64_t block_bc7(const uint8_t *block_data)
+				{
+					uint8_t tile_data[4 * 4 * 4];
+					ThumbnailKernel::decode_bc7(block_data, tile_data, 4 * 4);
+
+					uint64_t lanes_data = 0;
+					for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+					{
+						lanes_data += spread_channels(load_uint32(tile_data + 4 * texel_index));
+					}
+					return ((lanes_data + 8 * 0x0001000100010001) >> 4) & LANES_MASK;
+				}
+			};
+
+			// Z of the normal_pixel of every X and Y, the square root is too slow for one pixel per block
+			const std::array<uint8_t, 256 * 256> &normal_z_table()
+			{
+				// Built once, the initialization of a local static is thread safe
+				static const std::array<uint8_t, 256 * 256> z_table = []()
+				{
+					std::array<uint8_t, 256 * 256> table_data;
+					for (uint32_t x_data = 0; x_data < 256; ++x_data)
+					{
+						for (uint32_t y_data = 0; y_data < 256; ++y_data)
+						{
+							table_data[(x_data << 8) | y_data] = static_cast<uint8_t>(normal_pixel(x_data, y_data) >> 16);
+						}
+					}
+					return table_data;
+				}();
+				return z_table;
+			}
+
+			const uint32_t MAX_LANES_SUM_PIXELS = 257;
+
+			// Box filter of the image of one pixel per block, block_lanes(block_data) gives the pixel of a block as lanes
+			// Every thumbnail pixel is the mean of the blocks it covers, at least one
+			template <typename BlockLanes>
+			void make_thumbnail(const uint8_t *block_data, uint32_t bytes_block, uint32_t width, uint32_t height,
+								uint32_t thumbnail_width, uint32_t thumbnail_height, uint8_t *output_data, BlockLanes &&block_lanes)
+			{
+				const uint32_t blocks_width = (width + 3) / 4;
+				const uint32_t blocks_height = (height + 3) / 4;
+
+				std::vector<uint32_t> column_ranges(thumbnail_width + 1);
+				for (uint32_t thumbnail_column = 0; thumbnail_column <= thumbnail_width; ++thumbnail_column)
+				{
+					column_ranges[thumbnail_column] = static_cast<uint32_t>(static_cast<uint64_t>(thumbnail_column) * blocks_width / thumbnail_width);
+				}
+
+				// The rows of blocks are summed per column of blocks in lanes, then the columns of a thumbnail pixel are summed
+				// in full integers, at least every MAX_LANES_SUM_PIXELS rows
+				std::vector<uint64_t> column_lanes(blocks_width);
+				std::vector<uint64_t> sums_data(static_cast<size_t>(thumbnail_width) * 4);
+
+				auto flush_columns = [&]()
+				{
+					for (uint32_t thumbnail_column = 0; thumbnail_column < thumbnail_width; ++thumbnail_column)
+					{
+						const uint32_t begin_column = column_ranges[thumbnail_column];
+						const uint32_t end_column = std::max(begin_column + 1, column_ranges[thumbnail_column + 1]);
+
+						uint64_t *sum_data = &sums_data[4 * thumbnail_column];
+						for (uint32_t block_column = begin_column; block_column < end_column; ++block_column)
+						{
+							const uint64_t lanes_data = column_lanes[block_column];
+							sum_data[0] += lanes_data & 0xFFFF;
+							sum_data[1] += (lanes_data >> 16) & 0xFFFF;
+							sum_data[2] += (lanes_data >> 32) & 0xFFFF;
+							sum_data[3] += lanes_data >> 48;
+						}
+					}
+					std::fill(column_lanes.begin(), column_lanes.end(), 0);
+				};
+
+				for (uint32_t thumbnail_row = 0; thumbnail_row < thumbnail_height; ++thumbnail_row)
+				{
+					const uint32_t begin_row = static_cast<uint32_t>(static_cast<uint64_t>(thumbnail_row) * blocks_height / thumbnail_height);
+					const uint32_t end_row = std::max(begin_row + 1, static_cast<uint32_t>(static_cast<uint64_t>(thumbnail_row + 1) * blocks_height / thumbnail_height));
+
+					std::fill(sums_data.begin(), sums_data.end(), 0);
+					for (uint32_t block_row = begin_row; block_row < end_row; ++block_row)
+					{
+						const uint8_t *row_data = block_data + static_cast<size_t>(block_row) * blocks_width * bytes_block;
+						for (uint32_t block_column = 0; block_column < blocks_width; ++block_column)
+						{
+							column_lanes[block_column] += block_lanes(row_data);
+							row_data += bytes_block;
+						}
+
+						if ((block_row - begin_row + 1) % MAX_LANES_SUM_PIXELS == 0 || block_row + 1 == end_row)
+						{
+							flush_columns();
+						}
+					}
+
+					uint8_t *pixel_data = output_data + static_cast<size_t>(thumbnail_row) * thumbnail_width * 4;
+					for (uint32_t thumbnail_column = 0; thumbnail_column < thumbnail_width; ++thumbnail_column)
+					{
+						const uint32_t begin_column = column_ranges[thumbnail_column];
+						const uint64_t blocks_number = static_cast<uint64_t>(end_row - begin_row) * (std::max(begin_column + 1, column_ranges[thumbnail_column + 1]) - begin_column);
+						const uint64_t *sum_data = &sums_data[4 * thumbnail_column];
+						// The blocks of a pixel are usually a power of two, the 64 bits division costs as much as the blocks of BC1
+						if (std::has_single_bit(blocks_number))
+						{
+							const int blocks_shift = std::countr_zero(blocks_number);
+							for (uint32_t channel_index = 0; channel_index < 4; ++channel_index)
+							{
+								pixel_data[4 * thumbnail_column + channel_index] = static_cast<uint8_t>((sum_data[channel_index] + blocks_number / 2) >> blocks_shift);
+							}
+						}
+						else
+						{
+							for (uint32_t channel_index = 0; channel_index < 4; ++channel_index)
+							{
+								pixel_data[4 * thumbnail_column + channel_index] = static_cast<uint8_t>((sum_data[channel_index] + blocks_number / 2) / blocks_number);
+							}
+						}
+					}
+				}
+			}
+
+			TextureDecodeKernel detect_kernel()
+			{
+#ifdef GW2DATTOOLS_X86_64
+				return is_avx2_supported() ? TextureDecodeKernel::AVX2 : TextureDecodeKernel::SSE2;
+#else
+				return TextureDecodeKernel::Scalar;
+#endif
+			}
+		}
+
+		bool is_texture_decode_kernel_supported(TextureDecodeKernel kernel)
+		{
+			switch (kernel)
+			{
+			case TextureDecodeKernel::Automatic:
+			case TextureDecodeKernel::Scalar:
+				return true;
+
+#ifdef GW2DATTOOLS_X86_64
+			case TextureDecodeKernel::SSE2:
+				return true;
+
+			case TextureDecodeKernel::AVX2:
+				return get_texture_decode_kernel() == TextureDecodeKernel::AVX2;
+#endif
+
+			default:
+				return false;
+			}
+		}
+
+		TextureDecodeKernel get_texture_decode_kernel()
+		{
+			// Detected once, the initialization of a local static is thread safe
+			static const TextureDecodeKernel detected_kernel = bcn::detect_kernel();
+			return detected_kernel;
+		}
+
+		bool is_texture_format_decodable(uint32_t format_four_cc)
+		{
+			bcn::BlockFormat block_format;
+			return bcn::find_block_format(format_four_cc, block_format);
+		}
+
+		uint32_t get_decoded_pixel_size(uint32_t format_four_cc)
+		{
+			bcn::BlockFormat block_format;
+			return bcn::find_block_format(format_four_cc, block_format) ? block_format.bytes_pixel : 4;
+		}
+
+		uint64_t get_decoded_texture_size(const AnetImage &anet_image)
+		{
+			return static_cast<uint64_t>(anet_image.width) * anet_image.height * get_decoded_pixel_size(anet_image.format);
+		}
+
+		uint32_t get_texture_block_rows(const AnetImage &anet_image)
+		{
+			return (anet_image.height + 3) / 4;
+		}
+
+		uint32_t decode_texture_block_rows(const AnetImage &anet_image, std::span<const uint8_t> block_data, uint32_t first_block_row, uint32_t block_rows_number,
+										   std::span<uint8_t> output_data, TextureDecodeKernel kernel)
+		{
+			bcn::BlockFormat block_format;
+			if (!bcn::find_block_format(anet_image.format, block_format))
+			{
+				throw std::runtime_error("Unsupported texture format: " + std::to_string(anet_image.format));
+			}
+
+			const uint32_t blocks_height = get_texture_block_rows(anet_image);
+			if (first_block_row > blocks_height || block_rows_number > blocks_height - first_block_row)
+			{
+				throw std::runtime_error("Texture block rows out of the image.");
+			}
+
+			const uint64_t blocks_number = static_cast<uint64_t>((anet_image.width + 3) / 4) * blocks_height;
+			if (block_data.size() < blocks_number * block_format.bytes_block)
+			{
+				throw std::runtime_error("Texture data is too small.");
+			}
+
+			const uint64_t output_size = get_decoded_texture_size(anet_image);
+			if (output_data.size() < output_size)
+			{
+				throw std::runtime_error("Output buffer is too small.");
+			}
+
+			if (kernel == TextureDecodeKernel::Automatic)
+			{
+				kernel = get_texture_decode_kernel();
+			}
+			else if (!is_texture_decode_kernel_supported(kernel))
+			{
+				throw std::runtime_error("Texture decode kernel not supported by this CPU.");
+			}
+
+			const uint32_t end_block_row = first_block_row + block_rows_number;
+			switch (kernel)
+			{
+#ifdef GW2DATTOOLS_X86_64
+			case TextureDecodeKernel::AVX2:
+				bcn::decode_texture<bcn::Avx2Kernel>(block_format, block_data.data(), anet_image.width, anet_image.height, first_block_row, end_block_row, output_data.data());
+				break;
+
+			case TextureDecodeKernel::SSE2:
+				bcn::decode_texture<bcn::Sse2Kernel>(block_format, block_data.data(), anet_image.width, anet_image.height, first_block_row, end_block_row, output_data.data());
+				break;
+#endif
+
+			default:
+				bcn::decode_texture<bcn::ScalarKernel>(block_format, block_data.data(), anet_image.width, anet_image.height, first_block_row, end_block_row, output_data.data());
+				break;
+			}
+
+			return static_cast<uint32_t>(output_size);
+		}
+
+		uint32_t decode_texture_blocks(const AnetImage &anet_image, std::span<const uint8_t> block_data, std::span<uint8_t> output_data,
+									   TextureDecodeKernel kernel)
+		{
+			return decode_texture_block_rows(anet_image, block_data, 0, get_texture_block_rows(anet_image), output_data, kernel);
+		}
+
+		void get_texture_thumbnail_dimensions(const AnetImage &anet_image, uint32_t max_size, uint32_t &thumbnail_width, uint32_t &thumbnail_height)
+		{
+			const uint32_t image_size = std::max<uint32_t>(anet_image.width, anet_image.height);
+			if (image_size <= max_size || image_size == 0)
+			{
+				thumbnail_width = anet_image.width;
+				thumbnail_height = anet_image.height;
+				return;
+			}
+
+			thumbnail_width = std::max(1u, static_cast<uint32_t>(static_cast<uint64_t>(anet_image.width) * max_size / image_size));
+			thumbnail_height = std::max(1u, static_cast<uint32_t>(static_cast<uint64_t>(anet_image.height) * max_size / image_size));
+		}
+
+		uint32_t make_texture_thumbnail(const AnetImage &anet_image, std::span<const uint8_t> block_data, uint32_t thumbnail_width, uint32_t thumbnail_height,
+										std::span<uint8_t> output_data)
+		{
+			bcn::BlockFormat block_format;
+			if (!bcn::find_block_format(anet_image.format, block_format))
+			{
+				throw std::runtime_error("Unsupported texture format: " + std::to_string(anet_image.format));
+			}
+
+			const uint64_t blocks_number = static_cast<uint64_t>((anet_image.width + 3) / 4) * get_texture_block_rows(anet_image);
+			if (block_data.size() < blocks_number * block_format.bytes_block)
+			{
+				throw std::runtime_error("Texture data is too small.");
+			}
+
+			if (thumbnail_width == 0 || thumbnail_height == 0 || anet_image.width == 0 || anet_image.height == 0)
+			{
+				throw std::runtime_error("Invalid thumbnail size.");
+			}
+
+			const uint64_t output_size = static_cast<uint64_t>(thumbnail_width) * thumbnail_height * 4;
+			if (output_data.size() < output_size)
+			{
+				throw std::runtime_error("Output buffer is too small.");
+			}
+
+			const bool premultiplied_alpha = block_format.premultiplied_alpha;
+			const uint32_t width = anet_image.width;
+			const uint32_t height = anet_image.height;
+
+			switch (block_format.layout)
+			{
+			case bcn::BL_BC1:
+				bcn::make_thumbnail(block_data.data(), block_format.bytes_block, width, height, thumbnail_width, thumbnail_height, output_data.data(), [](const uint8_t *block_input)
+									{ return bcn::EndpointKernel::block_bc1(block_input); });
+				break;
+
+			case bcn::BL_BC2:
+				bcn::make_thumbnail(block_data.data(), block_format.bytes_block, width, height, thumbnail_width, thumbnail_height, output_data.data(), [premultiplied_alpha](const uint8_t *block_input)
+									{ return bcn::EndpointKernel::block_bc2(block_input, premultiplied_alpha); });
+				break;
+
+			case bcn::BL_BC3:
+				bcn::make_thumbnail(block_data.data(), block_format.bytes_block, width, height, thumbnail_width, thumbnail_height, output_data.data(), [premultiplied_alpha](const uint8_t *block_input)
+									{ return bcn::EndpointKernel::block_bc3(block_input, premultiplied_alpha); });
+				break;
+
+			case bcn::BL_BC4:
+				bcn::make_thumbnail(block_data.data(), block_format.bytes_block, width, height, thumbnail_width, thumbnail_height, output_data.data(), [](const uint8_t *block_input)
+									{ return bcn::EndpointKernel::block_bc4(block_input); });
+				break;
+
+			case bcn::BL_BC5:
+			{
+				const uint8_t *z_table = bcn::normal_z_table().data();
+				bcn::make_thumbnail(block_data.data(), block_format.bytes_block, width, height, thumbnail_width, thumbnail_height, output_data.data(), [z_table](const uint8_t *block_input)
+									{ return bcn::EndpointKernel::block_bc5(block_input, z_table); });
+				break;
+			}
+
+			case bcn::BL_BC6H:
+				bcn::make_thumbnail(block_data.data(), block_format.bytes_block, width, height, thumbnail_width, thumbnail_height, output_data.data(), [](const uint8_t *block_input)
+									{ return bcn::EndpointKernel::block_bc6h(block_input); });
+				break;
+
+			case bcn::BL_BC7:
+				bcn::make_thumbnail(block_data.data(), block_format.bytes_block, width, height, thumbnail_width, thumbnail_height, output_data.data(), [](const uint8_t *block_input)
+									{ return bcn::EndpointKernel::block_bc7(block_input); });
+				break;
+			}
+
+			return static_cast<uint32_t>(output_size);
+		}
+
+		utils::PooledBuffer make_texture_thumbnail(const AnetImage &anet_image, std::span<const uint8_t> block_data, uint32_t max_size, utils::BufferPool &buffer_pool,
+												   uint32_t &thumbnail_width, uint32_t &thumbnail_height)
+		{
+			get_texture_thumbnail_dimensions(anet_image, max_size, thumbnail_width, thumbnail_height);
+
+			const uint64_t output_size = static_cast<uint64_t>(thumbnail_width) * thumbnail_height * 4;
+			if (output_size > UINT32_MAX)
+			{
+				throw std::runtime_error("Thumbnail is too big.");
+			}
+
+			utils::PooledBuffer output_data = buffer_pool.acquire(static_cast<uint32_t>(output_size));
+			make_texture_thumbnail(anet_image, block_data, thumbnail_width, thumbnail_height, output_data.span());
+
+			return output_data;
+		}
+
+		utils::PooledBuffer decode_texture_blocks(const AnetImage &anet_image, std::span<const uint8_t> block_data, utils::BufferPool &buffer_pool,
+												  TextureDecodeKernel kernel)
+		{
+			const uint64_t output_size = get_decoded_texture_size(anet_image);
+			if (output_size > UINT32_MAX)
+			{
+				throw std::runtime_error("Texture is too big.");
+			}
+
+			utils::PooledBuffer output_data = buffer_pool.acquire(static_cast<uint32_t>(output_size));
+			decode_texture_blocks(anet_image, block_data, output_data.span(), kernel);
+
+			return output_data;
+		}
+	}
+}
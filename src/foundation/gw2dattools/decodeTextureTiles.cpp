@@ -0,0 +1,136 @@
+#include "foundation/gw2dattools/decodeTextureTiles.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <vector>
+
+namespace gw2dt
+{
+	namespace compression
+	{
+
+		struct TextureTileDecoder::Image
+		{
+			const AnetImage *anet_image;
+			std::span<const uint8_t> block_data;
+			std::span<uint8_t> output_data;
+			TextureDecodeKernel kernel;
+
+			uint32_t strip_rows;
+			uint32_t strips_number;
+
+			// Next strip to hand to a worker
+			std::atomic<uint32_t> next_strip;
+
+			// One slot per worker, merged once the image is done
+			std::vector<uint8_t> has_decoded;
+			std::vector<std::exception_ptr> worker_errors;
+		};
+
+		TextureTileDecoder::TextureTileDecoder(uint32_t threads_number) : worker_pool(threads_number)
+		{
+		}
+
+		uint32_t TextureTileDecoder::decode(const AnetImage &anet_image, std::span<const uint8_t> block_data, std::span<uint8_t> output_data,
+											TextureDecodeKernel kernel, TextureTileStatistics *statistics_data)
+		{
+			const uint32_t blocks_width = (anet_image.width + 3) / 4;
+			const uint32_t blocks_height = get_texture_block_rows(anet_image);
+
+			const uint32_t strip_rows = std::max(1u, TEXTURE_TILE_STRIP_BLOCKS / std::max(1u, blocks_width));
+			const uint32_t strips_number = (blocks_height + strip_rows - 1) / strip_rows;
+
+			const auto start_time = std::chrono::steady_clock::now();
+
+			uint32_t output_size;
+			uint32_t used_threads = 1;
+			if (strips_number <= 1)
+			{
+				output_size = decode_texture_block_rows(anet_image, block_data, 0, blocks_height, output_data, kernel);
+			}
+			else
+			{
+				Image image_data;
+				image_data.anet_image = &anet_image;
+				image_data.block_data = block_data;
+				image_data.output_data = output_data;
+				image_data.kernel = kernel;
+				image_data.strip_rows = strip_rows;
+				image_data.strips_number = strips_number;
+				image_data.next_strip.store(0, std::memory_order_relaxed);
+				image_data.has_decoded.resize(threads_number(), 0);
+				image_data.worker_errors.resize(threads_number());
+
+				worker_pool.run([this, &image_data](uint32_t worker_index)
+								{ process_image(image_data, worker_index); });
+
+				for (const std::exception_ptr &worker_error : image_data.worker_errors)
+				{
+					if (worker_error)
+					{
+						std::rethrow_exception(worker_error);
+					}
+				}
+
+				output_size = static_cast<uint32_t>(get_decoded_texture_size(anet_image));
+				used_threads = static_cast<uint32_t>(std::count(image_data.has_decoded.begin(), image_data.has_decoded.end(), 1));
+			}
+
+			if (statistics_data != nullptr)
+			{
+				statistics_data->strips_number = std::max(1u, strips_number);
+				statistics_data->threads_number = used_threads;
+				statistics_data->pixels_number = static_cast<uint64_t>(anet_image.width) * anet_image.height;
+				statistics_data->elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+			}
+			return output_size;
+		}
+
+		utils::PooledBuffer TextureTileDecoder::decode(const AnetImage &anet_image, std::span<const uint8_t> block_data, utils::BufferPool &buffer_pool,
+													   TextureDecodeKernel kernel)
+		{
+			const uint64_t output_size = get_decoded_texture_size(anet_image);
+			if (output_size > UINT32_MAX)
+			{
+				throw std::runtime_error("Texture is too big.");
+			}
+
+			utils::PooledBuffer output_data = buffer_pool.acquire(static_cast<uint32_t>(output_size));
+			decode(anet_image, block_data, output_data.span(), kernel);
+
+			return output_data;
+		}
+
+		void TextureTileDecoder::process_image(Image &image_data, uint32_t worker_index)
+		{
+			const uint32_t blocks_height = get_texture_block_rows(*image_data.anet_image);
+
+			while (true)
+			{
+				const uint32_t strip_index = image_data.next_strip.fetch_add(1, std::memory_order_relaxed);
+				if (strip_index >= image_data.strips_number)
+				{
+					break;
+				}
+
+				const uint32_t first_block_row = strip_index * image_data.strip_rows;
+				try
+				{
+					decode_texture_block_rows(*image_data.anet_image, image_data.block_data, first_block_row,
+											  std::min(image_data.strip_rows, blocks_height - first_block_row), image_data.output_data, image_data.kernel);
+					image_data.has_decoded[worker_index] = 1;
+				}
+				catch (...)
+				{
+					// Every strip would fail the same way, the remaining ones are skipped
+					image_data.worker_errors[worker_index] = std::current_exception();
+					image_data.next_strip.store(image_data.strips_number, std::memory_order_relaxed);
+					break;
+				}
+			}
+		}
+
+	}
+}
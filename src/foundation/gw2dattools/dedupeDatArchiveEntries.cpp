@@ -0,0 +1,175 @@
+#include "foundation/gw2dattools/dedupeDatArchiveEntries.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace gw2dt
+{
+	namespace archive
+	{
+		namespace
+		{
+			// Entries handed to the batch inflater at once, the progress is reported between them
+			constexpr uint32_t HASH_CHUNK_SIZE = 4096;
+
+			constexpr uint32_t NO_CONTENT = std::numeric_limits<uint32_t>::max();
+		}
+
+		bool hash_dat_archive_entries(const DatArchive &archive, std::span<DatArchiveEntryContent> contents,
+									  compression::DatFileBatchInflater &batch_inflater,
+									  const DatArchiveScanProgress &progress_callback)
+		{
+			if (contents.size() != archive.entries_count())
+			{
+				throw std::runtime_error("Entry contents do not match the archive.");
+			}
+
+			const uint32_t entries_number = contents.empty() ? 0 : static_cast<uint32_t>(contents.size() - 1);
+
+			std::vector<compression::DatFileBatchJob> jobs;
+			std::vector<uint32_t> job_entries;
+			for (uint32_t chunk_start = 1; chunk_start < contents.size(); chunk_start += HASH_CHUNK_SIZE)
+			{
+				const uint32_t chunk_end = static_cast<uint32_t>(std::min<size_t>(contents.size(), chunk_start + HASH_CHUNK_SIZE));
+
+				jobs.clear();
+				job_entries.clear();
+				for (uint32_t entry_index = chunk_start; entry_index < chunk_end; ++entry_index)
+				{
+					DatArchiveEntryContent &entry_content = contents[entry_index];
+					if (entry_content.is_hashed)
+					{
+						continue;
+					}
+
+					// Unused slots and entries out of the archive have no content
+					std::span<const uint8_t> input_data;
+					DatArchiveEntry entry_info{};
+					try
+					{
+						entry_info = archive.entry(entry_index);
+						input_data = archive.entry_data(entry_index);
+					}
+					catch (const std::exception &)
+					{
+					}
+					if (input_data.empty())
+					{
+						continue;
+					}
+
+					// Stored entries are hashed in place
+					if (!entry_info.is_compressed())
+					{
+						entry_content.hash = utils::hash_content(input_data);
+						entry_content.size = static_cast<uint32_t>(input_data.size());
+						entry_content.is_hashed = true;
+						continue;
+					}
+
+					jobs.push_back({input_data, 0});
+					job_entries.push_back(entry_index);
+				}
+
+				// Every job writes in its own content, the output buffer goes back to the pool once hashed
+				batch_inflater.inflate(jobs, [&](size_t job_index, compression::DatFileBatchResult &&result_data)
+									   {
+					if (result_data.error_data)
+					{
+						return;
+					}
+					DatArchiveEntryContent &entry_content = contents[job_entries[job_index]];
+					entry_content.hash = utils::hash_content(result_data.output_data.span());
+					entry_content.size = result_data.output_data.size();
+					entry_content.is_hashed = true; });
+
+				if (progress_callback && !progress_callback(chunk_end - 1, entries_number))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		DatArchiveDedupeIndex::DatArchiveDedupeIndex(std::span<const DatArchiveEntryContent> contents) : entry_contents(contents.size(), NO_CONTENT)
+		{
+			for (uint32_t entry_index = 0; entry_index < contents.size(); ++entry_index)
+			{
+				if (contents[entry_index].is_hashed)
+				{
+					grouped_entries.push_back(entry_index);
+				}
+			}
+
+			// Same contents end up next to each other, by increasing entry
+			std::sort(grouped_entries.begin(), grouped_entries.end(), [&contents](uint32_t left_entry, uint32_t right_entry)
+					  { return std::tie(contents[left_entry].hash, contents[left_entry].size, left_entry) <
+							   std::tie(contents[right_entry].hash, contents[right_entry].size, right_entry); });
+
+			for (uint32_t group_start = 0; group_start < grouped_entries.size();)
+			{
+				const DatArchiveEntryContent &entry_content = contents[grouped_entries[group_start]];
+
+				uint32_t group_end = group_start + 1;
+				while (group_end < grouped_entries.size() &&
+					   contents[grouped_entries[group_end]].hash == entry_content.hash &&
+					   contents[grouped_entries[group_end]].size == entry_content.size)
+				{
+					++group_end;
+				}
+
+				const uint32_t content_index = static_cast<uint32_t>(contents_data.size());
+				const uint32_t group_size = group_end - group_start;
+				contents_data.push_back({entry_content.hash, entry_content.size, group_start, group_size});
+				for (uint32_t group_position = group_start; group_position < group_end; ++group_position)
+				{
+					entry_contents[grouped_entries[group_position]] = content_index;
+				}
+
+				statistics_data.hashed_entries += group_size;
+				statistics_data.total_bytes += static_cast<uint64_t>(entry_content.size) * group_size;
+				statistics_data.unique_bytes += entry_content.size;
+				if (group_size > 1)
+				{
+					++statistics_data.shared_contents;
+					statistics_data.shared_entries += group_size;
+					statistics_data.largest_shared_size = std::max(statistics_data.largest_shared_size, entry_content.size);
+				}
+
+				group_start = group_end;
+			}
+			statistics_data.unique_contents = static_cast<uint32_t>(contents_data.size());
+		}
+
+		std::span<const uint32_t> DatArchiveDedupeIndex::duplicates(uint32_t entry_index) const
+		{
+			if (entry_index >= entry_contents.size() || entry_contents[entry_index] == NO_CONTENT)
+			{
+				return {};
+			}
+
+			const Content &content_data = contents_data[entry_contents[entry_index]];
+			return std::span<const uint32_t>(grouped_entries).subspan(content_data.first_entry, content_data.entries_number);
+		}
+
+		uint32_t DatArchiveDedupeIndex::canonical_entry(uint32_t entry_index) const
+		{
+			const std::span<const uint32_t> same_entries = duplicates(entry_index);
+			return same_entries.empty() ? 0 : same_entries.front();
+		}
+
+		std::span<const uint32_t> DatArchiveDedupeIndex::find_entries(const utils::ContentHash &hash, uint32_t size) const
+		{
+			const auto content_position = std::partition_point(contents_data.begin(), contents_data.end(), [&](const Content &content_data)
+															   { return std::tie(content_data.hash, content_data.size) < std::tie(hash, size); });
+			if (content_position == contents_data.end() || content_position->hash != hash || content_position->size != size)
+			{
+				return {};
+			}
+			return std::span<const uint32_t>(grouped_entries).subspan(content_position->first_entry, content_position->entries_number);
+		}
+
+	}
+}
@@ -0,0 +1,335 @@
+#include "foundation/gw2dattools/exportTextureFile.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+namespace gw2dt
+{
+	namespace compression
+	{
+
+		namespace container
+		{
+
+			// Khronos data format descriptor color models and sample channels
+			enum DataFormatModel
+			{
+				DFM_BC1A = 128,
+				DFM_BC2 = 129,
+				DFM_BC3 = 130,
+				DFM_BC4 = 131,
+				DFM_BC5 = 132,
+				DFM_BC6H = 133,
+				DFM_BC7 = 134
+			};
+
+			const uint8_t DF_CHANNEL_ALPHA = 15;
+			const uint8_t DF_CHANNEL_FLOAT = 0x80;
+
+			struct DataFormatSample
+			{
+				uint8_t channel_data;
+				uint16_t bit_offset;
+				uint16_t bits_number;
+			};
+
+			struct ContainerFormat
+			{
+				uint32_t bytes_block;
+				// Legacy DDS pixel format, 0 if the format needs the DX10 header
+				uint32_t dds_four_cc;
+				uint32_t dxgi_format;
+				uint32_t vk_format;
+				DataFormatModel data_format_model;
+				bool premultiplied_alpha;
+				bool is_float;
+				uint32_t samples_number;
+				DataFormatSample samples[2];
+			};
+
+			bool find_container_format(uint32_t four_cc_data, ContainerFormat &container_format)
+			{
+				switch (four_cc_data)
+				{
+				case 0x31545844: // "DXT1"
+					container_format = {8, 0x31545844, 71, 133, DFM_BC1A, false, false, 1, {{1, 0, 64}}};
+					return true;
+
+				case 0x32545844: // "DXT2"
+				case 0x33545844: // "DXT3"
+					container_format = {16, four_cc_data, 74, 135, DFM_BC2, four_cc_data == 0x32545844, false, 2, {{DF_CHANNEL_ALPHA, 0, 64}, {0, 64, 64}}};
+					return true;
+
+				case 0x34545844: // "DXT4"
+				case 0x35545844: // "DXT5"
+					container_format = {16, four_cc_data, 77, 137, DFM_BC3, four_cc_data == 0x34545844, false, 2, {{DF_CHANNEL_ALPHA, 0, 64}, {0, 64, 64}}};
+					return true;
+
+				case 0x41545844: // "DXTA"
+				case 0x4C545844: // "DXTL"
+					container_format = {8, 0, 80, 139, DFM_BC4, false, false, 1, {{0, 0, 64}}};
+					return true;
+
+				case 0x4E545844: // "DXTN"
+				case 0x58434433: // "3DCX"
+					container_format = {16, 0, 83, 141, DFM_BC5, false, false, 2, {{0, 0, 64}, {1, 64, 64}}};
+					return true;
+
+				case 0x48364342: // "BC6H"
+					container_format = {16, 0, 95, 143, DFM_BC6H, false, true, 1, {{DF_CHANNEL_FLOAT, 0, 128}}};
+					return true;
+
+				case 0x58374342: // "BC7X"
+					container_format = {16, 0, 98, 145, DFM_BC7, false, false, 1, {{0, 0, 128}}};
+					return true;
+
+				default:
+					return false;
+				}
+			}
+
+			uint32_t get_level_size(const ContainerFormat &container_format, const AnetImageLevel &level_data)
+			{
+				return ((level_data.width + 3) / 4) * ((level_data.height + 3) / 4) * container_format.bytes_block;
+			}
+
+			template <typename ValueType>
+			void write_value(std::ostream &output_stream, ValueType value_data)
+			{
+				output_stream.write(reinterpret_cast<const char *>(&value_data), sizeof(ValueType));
+			}
+
+			// writeLevel(level_index) writes the blocks of a level, the levels are asked for in the order of the file
+			typedef std::function<void(uint32_t level_index)> LevelWriter;
+
+			const uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+			const uint32_t DDS_FOUR_CC_DX10 = 0x30315844;
+
+			enum DdsFlags
+			{
+				DDSD_CAPS = 0x1,
+				DDSD_HEIGHT = 0x2,
+				DDSD_WIDTH = 0x4,
+				DDSD_PIXELFORMAT = 0x1000,
+				DDSD_MIPMAPCOUNT = 0x20000,
+				DDSD_LINEARSIZE = 0x80000,
+				DDPF_FOURCC = 0x4,
+				DDSCAPS_COMPLEX = 0x8,
+				DDSCAPS_TEXTURE = 0x1000,
+				DDSCAPS_MIPMAP = 0x400000
+			};
+
+			void write_dds(std::ostream &output_stream, const ContainerFormat &container_format, const AnetImage &anet_image,
+						   uint32_t levels_number, const LevelWriter &write_level)
+			{
+				const bool has_levels = levels_number > 1;
+
+				write_value(output_stream, DDS_MAGIC);
+
+				// DDS_HEADER
+				write_value<uint32_t>(output_stream, 124);
+				write_value<uint32_t>(output_stream, DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE | (has_levels ? DDSD_MIPMAPCOUNT : 0));
+				write_value<uint32_t>(output_stream, anet_image.height);
+				write_value<uint32_t>(output_stream, anet_image.width);
+				write_value<uint32_t>(output_stream, get_level_size(container_format, anet_image.levels[0]));
+				write_value<uint32_t>(output_stream, 0);
+				write_value<uint32_t>(output_stream, levels_number);
+				for (uint32_t reserved_index = 0; reserved_index < 11; ++reserved_index)
+				{
+					write_value<uint32_t>(output_stream, 0);
+				}
+
+				// DDS_PIXELFORMAT, the formats without legacy code use the DX10 header
+				write_value<uint32_t>(output_stream, 32);
+				write_value<uint32_t>(output_stream, DDPF_FOURCC);
+				write_value<uint32_t>(output_stream, container_format.dds_four_cc != 0 ? container_format.dds_four_cc : DDS_FOUR_CC_DX10);
+				for (uint32_t mask_index = 0; mask_index < 5; ++mask_index)
+				{
+					write_value<uint32_t>(output_stream, 0);
+				}
+
+				write_value<uint32_t>(output_stream, DDSCAPS_TEXTURE | (has_levels ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0));
+				for (uint32_t caps_index = 0; caps_index < 4; ++caps_index)
+				{
+					write_value<uint32_t>(output_stream, 0);
+				}
+
+				if (container_format.dds_four_cc == 0)
+				{
+					// DDS_HEADER_DXT10: 2D texture, 1 element, straight alpha
+					write_value<uint32_t>(output_stream, container_format.dxgi_format);
+					write_value<uint32_t>(output_stream, 3);
+					write_value<uint32_t>(output_stream, 0);
+					write_value<uint32_t>(output_stream, 1);
+					write_value<uint32_t>(output_stream, container_format.premultiplied_alpha ? 2 : 1);
+				}
+
+				// From the biggest level
+				for (uint32_t level_index = 0; level_index < levels_number; ++level_index)
+				{
+					write_level(level_index);
+				}
+			}
+
+			const std::array<uint8_t, 12> KTX2_IDENTIFIER = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+			const uint32_t KTX2_HEADER_SIZE = 80;
+			const uint32_t KTX2_LEVEL_INDEX_ENTRY_SIZE = 24;
+
+			void write_ktx2(std::ostream &output_stream, const ContainerFormat &container_format, const AnetImage &anet_image,
+							uint32_t levels_number, const LevelWriter &write_level)
+			{
+				// Basic data format descriptor block: 24 bytes, then 16 bytes per sample
+				const uint32_t descriptor_block_size = 24 + 16 * container_format.samples_number;
+				const uint32_t dfd_offset = KTX2_HEADER_SIZE + KTX2_LEVEL_INDEX_ENTRY_SIZE * levels_number;
+				const uint32_t dfd_size = 4 + descriptor_block_size;
+
+				// The levels are stored from the smallest, each one aligned on a block
+				std::vector<uint64_t> level_offsets(levels_number);
+				uint64_t data_position = dfd_offset + dfd_size;
+				for (uint32_t level_index = levels_number; level_index-- > 0;)
+				{
+					data_position = (data_position + container_format.bytes_block - 1) / container_format.bytes_block * container_format.bytes_block;
+					level_offsets[level_index] = data_position;
+					data_position += get_level_size(container_format, anet_image.levels[level_index]);
+				}
+
+				output_stream.write(reinterpret_cast<const char *>(KTX2_IDENTIFIER.data()), KTX2_IDENTIFIER.size());
+				write_value<uint32_t>(output_stream, container_format.vk_format);
+				write_value<uint32_t>(output_stream, 1); // typeSize
+				write_value<uint32_t>(output_stream, anet_image.width);
+				write_value<uint32_t>(output_stream, anet_image.height);
+				write_value<uint32_t>(output_stream, 0); // pixelDepth
+				write_value<uint32_t>(output_stream, 0); // layerCount
+				write_value<uint32_t>(output_stream, 1); // faceCount
+				write_value<uint32_t>(output_stream, levels_number);
+				write_value<uint32_t>(output_stream, 0); // supercompressionScheme
+
+				write_value<uint32_t>(output_stream, dfd_offset);
+				write_value<uint32_t>(output_stream, dfd_size);
+				write_value<uint32_t>(output_stream, 0); // No key/value data
+				write_value<uint32_t>(output_stream, 0);
+				write_value<uint64_t>(output_stream, 0); // No supercompression global data
+				write_value<uint64_t>(output_stream, 0);
+
+				for (uint32_t level_index = 0; level_index < levels_number; ++level_index)
+				{
+					const uint64_t level_size = get_level_size(container_format, anet_image.levels[level_index]);
+					write_value<uint64_t>(output_stream, level_offsets[level_index]);
+					write_value<uint64_t>(output_stream, level_size);
+					write_value<uint64_t>(output_stream, level_size);
+				}
+
+				write_value<uint32_t>(output_stream, dfd_size);
+				write_value<uint32_t>(output_stream, 0); // Khronos vendor, basic descriptor type
+				write_value<uint32_t>(output_stream, 2 | (descriptor_block_size << 16));
+				// Color model, BT.709 primaries, linear transfer, alpha flag
+				write_value<uint32_t>(output_stream, container_format.data_format_model | (1 << 8) | (1 << 16) | ((container_format.premultiplied_alpha ? 1u : 0u) << 24));
+				write_value<uint32_t>(output_stream, 3 | (3 << 8)); // 4x4 texel blocks
+				write_value<uint32_t>(output_stream, container_format.bytes_block);
+				write_value<uint32_t>(output_stream, 0);
+				for (uint32_t sample_index = 0; sample_index < container_format.samples_number; ++sample_index)
+				{
+					const DataFormatSample &sample_data = container_format.samples[sample_index];
+					write_value<uint32_t>(output_stream, sample_data.bit_offset | ((sample_data.bits_number - 1) << 16) | (static_cast<uint32_t>(sample_data.channel_data) << 24));
+					write_value<uint32_t>(output_stream, 0);
+					if (container_format.is_float)
+					{
+						write_value<uint32_t>(output_stream, 0xBF800000); // -1.0f
+						write_value<uint32_t>(output_stream, 0x7F800000); // Infinity
+					}
+					else
+					{
+						write_value<uint32_t>(output_stream, 0);
+						write_value<uint32_t>(output_stream, 0xFFFFFFFF);
+					}
+				}
+
+				uint64_t file_position = dfd_offset + dfd_size;
+				for (uint32_t level_index = levels_number; level_index-- > 0;)
+				{
+					for (; file_position < level_offsets[level_index]; ++file_position)
+					{
+						output_stream.put(0);
+					}
+					write_level(level_index);
+					file_position += get_level_size(container_format, anet_image.levels[level_index]);
+				}
+			}
+
+			void write_container(std::ostream &output_stream, TextureFileContainer container, const AnetImage &anet_image,
+								 uint32_t levels_number, const LevelWriter &write_level)
+			{
+				ContainerFormat container_format;
+				if (!find_container_format(anet_image.format, container_format))
+				{
+					throw std::runtime_error("Texture format can not be exported: " + std::to_string(anet_image.format));
+				}
+
+				if (levels_number == 0 || levels_number > anet_image.levels_number)
+				{
+					throw std::runtime_error("Invalid number of texture levels to export.");
+				}
+
+				if (container == TextureFileContainer::DDS)
+				{
+					write_dds(output_stream, container_format, anet_image, levels_number, write_level);
+				}
+				else
+				{
+					write_ktx2(output_stream, container_format, anet_image, levels_number, write_level);
+				}
+
+				if (!output_stream)
+				{
+					throw std::runtime_error("Failed to write the texture file.");
+				}
+			}
+		}
+
+		bool is_texture_format_exportable(uint32_t format_four_cc)
+		{
+			container::ContainerFormat container_format;
+			return container::find_container_format(format_four_cc, container_format);
+		}
+
+		void write_texture_file(std::ostream &output_stream, TextureFileContainer container, const AnetImage &anet_image,
+								std::span<const std::span<const uint8_t>> levels_data)
+		{
+			container::ContainerFormat container_format;
+			const bool is_exportable = container::find_container_format(anet_image.format, container_format);
+			const uint32_t levels_number = static_cast<uint32_t>(std::min<size_t>(levels_data.size(), anet_image.levels_number));
+
+			for (uint32_t level_index = 0; is_exportable && level_index < levels_number; ++level_index)
+			{
+				if (levels_data[level_index].size() < container::get_level_size(container_format, anet_image.levels[level_index]))
+				{
+					throw std::runtime_error("Texture level " + std::to_string(level_index) + " is too small.");
+				}
+			}
+
+			container::write_container(output_stream, container, anet_image, levels_number, [&](uint32_t level_index)
+									   { output_stream.write(reinterpret_cast<const char *>(levels_data[level_index].data()),
+															 container::get_level_size(container_format, anet_image.levels[level_index])); });
+		}
+
+		void export_texture_file(std::span<const uint8_t> input_data, std::ostream &output_stream, TextureFileContainer container,
+								 uint32_t levels_number, utils::BufferPool &buffer_pool)
+		{
+			AnetImage anet_image;
+			probe_texture_file(input_data, anet_image);
+			if (levels_number == 0)
+			{
+				levels_number = anet_image.levels_number;
+			}
+
+			container::write_container(output_stream, container, anet_image, levels_number, [&](uint32_t level_index)
+									   {
+										   utils::PooledBuffer level_data = inflate_texture_file_level(input_data, level_index, buffer_pool, anet_image);
+										   output_stream.write(reinterpret_cast<const char *>(level_data.data()), level_data.size()); });
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#include "foundation/gw2dattools/inflateDatFileBatch.h"
+
+#include <atomic>
+#include <chrono>
+
+#include "foundation/gw2dattools/inflateDatFileBuffer.h"
+
+namespace gw2dt
+{
+	namespace compression
+	{
+
+		struct DatFileBatchInflater::Batch
+		{
+			std::span<const DatFileBatchJob> jobs;
+			const Completion *completion_callback;
+
+			// Next job to hand to a worker
+			std::atomic<size_t> next_job;
+
+			// One slot per worker, merged once the batch is over
+			std::vector<DatFileBatchStatistics> worker_statistics;
+			std::vector<std::exception_ptr> callback_errors;
+		};
+
+		DatFileBatchInflater::DatFileBatchInflater(uint32_t threads_number, utils::BufferPool &buffer_pool) : buffer_pool(buffer_pool),
+																											   worker_pool(threads_number)
+		{
+		}
+
+		std::vector<DatFileBatchResult> DatFileBatchInflater::inflate(std::span<const DatFileBatchJob> jobs, DatFileBatchStatistics *statistics_data)
+		{
+			std::vector<DatFileBatchResult> results(jobs.size());
+
+			// Every job writes in its own slot
+			DatFileBatchStatistics batch_statistics = inflate(jobs, [&results](size_t job_index, DatFileBatchResult &&result_data)
+															  { results[job_index] = std::move(result_data); });
+
+			if (statistics_data != nullptr)
+			{
+				*statistics_data = batch_statistics;
+			}
+			return results;
+		}
+
+		DatFileBatchStatistics DatFileBatchInflater::inflate(std::span<const DatFileBatchJob> jobs, const Completion &completion_callback)
+		{
+			Batch batch_data;
+			batch_data.jobs = jobs;
+			batch_data.completion_callback = &completion_callback;
+			batch_data.next_job.store(0, std::memory_order_relaxed);
+			batch_data.worker_statistics.resize(threads_number());
+			batch_data.callback_errors.resize(threads_number());
+
+			const auto start_time = std::chrono::steady_clock::now();
+
+			worker_pool.run([this, &batch_data](uint32_t worker_index)
+							{ process_batch(batch_data, worker_index); });
+
+			DatFileBatchStatistics statistics_data;
+			for (const DatFileBatchStatistics &worker_statistics : batch_data.worker_statistics)
+			{
+				statistics_data.failed_jobs_number += worker_statistics.failed_jobs_number;
+				statistics_data.input_bytes += worker_statistics.input_bytes;
+				statistics_data.output_bytes += worker_statistics.output_bytes;
+			}
+			statistics_data.jobs_number = jobs.size();
+			statistics_data.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+			for (const std::exception_ptr &callback_error : batch_data.callback_errors)
+			{
+				if (callback_error)
+				{
+					std::rethrow_exception(callback_error);
+				}
+			}
+			return statistics_data;
+		}
+
+		void DatFileBatchInflater::process_batch(Batch &batch_data, uint32_t worker_index)
+		{
+			// Statistics are kept per thread and merged once
+			DatFileBatchStatistics &thread_statistics = batch_data.worker_statistics[worker_index];
+			std::exception_ptr &callback_error = batch_data.callback_errors[worker_index];
+
+			while (true)
+			{
+				const size_t job_index = batch_data.next_job.fetch_add(1, std::memory_order_relaxed);
+				if (job_index >= batch_data.jobs.size() || callback_error)
+				{
+					break;
+				}
+
+				const DatFileBatchJob &job_data = batch_data.jobs[job_index];
+				DatFileBatchResult result_data;
+				try
+				{
+					result_data.output_data = inflate_dat_file_buffer(job_data.input_data, buffer_pool, job_data.output_data_size);
+					thread_statistics.output_bytes += result_data.output_data.size();
+				}
+				catch (...)
+				{
+					result_data.error_data = std::current_exception();
+					++thread_statistics.failed_jobs_number;
+				}
+				thread_statistics.input_bytes += job_data.input_data.size();
+
+				try
+				{
+					(*batch_data.completion_callback)(job_index, std::move(result_data));
+				}
+				catch (...)
+				{
+					callback_error = std::current_exception();
+				}
+			}
+		}
+
+	}
+}
@@ -1,9 +1,15 @@
 #include "foundation/gw2dattools/inflateDatFileBuffer.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdlib>
+#include <cstring>
 #include <memory.h>
 #include <iostream>
+#include <istream>
+#include <ostream>
 #include <stdio.h>
+#include <utility>
 
 #include "foundation/gw2dattools/HuffmanTree.h"
 #include "foundation/gw2dattools/BitArray.h"
@@ -15,15 +21,162 @@ namespace gw2dt
 		namespace dat
 		{
 
-			const uint32_t MAX_BITS_HASH = 8;
+			const uint32_t MAX_BITS_HASH = 11;
 			const uint32_t MAX_CODE_BITS_LENGTH = 32;
 			const uint32_t MAX_SYMBOL_VALUE = 285;
 
-			typedef utils::BitArray<uint32_t> DatFileBitArray;
+			// Whole entries skip one word every 16384, the stream removes them before decoding
+			typedef utils::BitArray<utils::VariableSkippedWords, utils::CheckedBits> DatFileBitArray;
 			typedef HuffmanTree<uint16_t, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE> DatFileHuffmanTree;
 			typedef HuffmanTreeBuilder<uint16_t, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE> DatFileHuffmanTreeBuilder;
 
-			static DatFileHuffmanTree dat_file_huffmantree_dict;
+			// Copies are done 32 bytes at a time and may write up to OUTPUT_SLACK_SIZE - 1 bytes past
+			// their end, they are only used when the output buffer has this many extra bytes
+			const uint32_t OUTPUT_SLACK_SIZE = DAT_FILE_OUTPUT_SLACK_SIZE;
+
+			struct DictionaryCode
+			{
+				uint8_t symbol_data;
+				uint8_t bits_data;
+			};
+
+			// Code lengths of the dictionary used to encode the HuffmanTrees, in the order they are added to the builder
+			constexpr DictionaryCode DAT_FILE_DICTIONARY_CODES[] = {
+				{0x0A, 3}, {0x09, 3}, {0x08, 3},
+
+				{0x0C, 4}, {0x0B, 4}, {0x07, 4}, {0x00, 4},
+
+				{0xE0, 5}, {0x2A, 5}, {0x29, 5}, {0x06, 5},
+
+				{0x4A, 6}, {0x40, 6}, {0x2C, 6}, {0x2B, 6}, {0x28, 6}, {0x20, 6}, {0x05, 6}, {0x04, 6},
+
+				{0x49, 7}, {0x48, 7}, {0x27, 7}, {0x26, 7}, {0x25, 7}, {0x0D, 7}, {0x03, 7},
+
+				{0x6A, 8}, {0x69, 8}, {0x4C, 8}, {0x4B, 8}, {0x47, 8}, {0x24, 8},
+
+				{0xE8, 9}, {0xA0, 9}, {0x89, 9}, {0x88, 9}, {0x68, 9}, {0x67, 9}, {0x63, 9}, {0x60, 9},
+				{0x46, 9}, {0x23, 9},
+
+				{0xE9, 10}, {0xC9, 10}, {0xC0, 10}, {0xA9, 10}, {0xA8, 10}, {0x8A, 10}, {0x87, 10}, {0x80, 10},
+				{0x66, 10}, {0x65, 10}, {0x45, 10}, {0x44, 10}, {0x43, 10}, {0x2D, 10}, {0x02, 10}, {0x01, 10},
+
+				{0xE5, 11}, {0xC8, 11}, {0xAA, 11}, {0xA5, 11}, {0xA4, 11}, {0x8B, 11}, {0x85, 11}, {0x84, 11},
+				{0x6C, 11}, {0x6B, 11}, {0x64, 11}, {0x4D, 11}, {0x0E, 11},
+
+				{0xE7, 12}, {0xCA, 12}, {0xC7, 12}, {0xA7, 12}, {0xA6, 12}, {0x86, 12}, {0x83, 12},
+
+				{0xE6, 13}, {0xE4, 13}, {0xC4, 13}, {0x8C, 13}, {0x2E, 13}, {0x22, 13},
+
+				{0xEC, 14}, {0xC6, 14}, {0x6D, 14}, {0x4E, 14},
+
+				{0xEA, 15}, {0xCC, 15}, {0xAC, 15}, {0xAB, 15}, {0x8D, 15}, {0x11, 15}, {0x10, 15}, {0x0F, 15},
+
+				{0xFF, 16}, {0xFE, 16}, {0xFD, 16}, {0xFC, 16}, {0xFB, 16}, {0xFA, 16}, {0xF9, 16}, {0xF8, 16},
+				{0xF7, 16}, {0xF6, 16}, {0xF5, 16}, {0xF4, 16}, {0xF3, 16}, {0xF2, 16}, {0xF1, 16}, {0xF0, 16},
+				{0xEF, 16}, {0xEE, 16}, {0xED, 16}, {0xEB, 16}, {0xE3, 16}, {0xE2, 16}, {0xE1, 16}, {0xDF, 16},
+				{0xDE, 16}, {0xDD, 16}, {0xDC, 16}, {0xDB, 16}, {0xDA, 16}, {0xD9, 16}, {0xD8, 16}, {0xD7, 16},
+				{0xD6, 16}, {0xD5, 16}, {0xD4, 16}, {0xD3, 16}, {0xD2, 16}, {0xD1, 16}, {0xD0, 16}, {0xCF, 16},
+				{0xCE, 16}, {0xCD, 16}, {0xCB, 16}, {0xC5, 16}, {0xC3, 16}, {0xC2, 16}, {0xC1, 16}, {0xBF, 16},
+				{0xBE, 16}, {0xBD, 16}, {0xBC, 16}, {0xBB, 16}, {0xBA, 16}, {0xB9, 16}, {0xB8, 16}, {0xB7, 16},
+				{0xB6, 16}, {0xB5, 16}, {0xB4, 16}, {0xB3, 16}, {0xB2, 16}, {0xB1, 16}, {0xB0, 16}, {0xAF, 16},
+				{0xAE, 16}, {0xAD, 16}, {0xA3, 16}, {0xA2, 16}, {0xA1, 16}, {0x9F, 16}, {0x9E, 16}, {0x9D, 16},
+				{0x9C, 16}, {0x9B, 16}, {0x9A, 16}, {0x99, 16}, {0x98, 16}, {0x97, 16}, {0x96, 16}, {0x95, 16},
+				{0x94, 16}, {0x93, 16}, {0x92, 16}, {0x91, 16}, {0x90, 16}, {0x8F, 16}, {0x8E, 16}, {0x82, 16},
+				{0x81, 16}, {0x7F, 16}, {0x7E, 16}, {0x7D, 16}, {0x7C, 16}, {0x7B, 16}, {0x7A, 16}, {0x79, 16},
+				{0x78, 16}, {0x77, 16}, {0x76, 16}, {0x75, 16}, {0x74, 16}, {0x73, 16}, {0x72, 16}, {0x71, 16},
+				{0x70, 16}, {0x6F, 16}, {0x6E, 16}, {0x62, 16}, {0x61, 16}, {0x5F, 16}, {0x5E, 16}, {0x5D, 16},
+				{0x5C, 16}, {0x5B, 16}, {0x5A, 16}, {0x59, 16}, {0x58, 16}, {0x57, 16}, {0x56, 16}, {0x55, 16},
+				{0x54, 16}, {0x53, 16}, {0x52, 16}, {0x51, 16}, {0x50, 16}, {0x4F, 16}, {0x42, 16}, {0x41, 16},
+				{0x3F, 16}, {0x3E, 16}, {0x3D, 16}, {0x3C, 16}, {0x3B, 16}, {0x3A, 16}, {0x39, 16}, {0x38, 16},
+				{0x37, 16}, {0x36, 16}, {0x35, 16}, {0x34, 16}, {0x33, 16}, {0x32, 16}, {0x31, 16}, {0x30, 16},
+				{0x2F, 16}, {0x21, 16}, {0x1F, 16}, {0x1E, 16}, {0x1D, 16}, {0x1C, 16}, {0x1B, 16}, {0x1A, 16},
+				{0x19, 16}, {0x18, 16}, {0x17, 16}, {0x16, 16}, {0x15, 16}, {0x14, 16}, {0x13, 16}, {0x12, 16},
+			};
+
+			constexpr DatFileHuffmanTree build_dat_file_huffmantree_dict()
+			{
+				DatFileHuffmanTreeBuilder dat_file_huffmantree_builder{};
+				dat_file_huffmantree_builder.clear();
+
+				for (const DictionaryCode &dictionary_code : DAT_FILE_DICTIONARY_CODES)
+				{
+					dat_file_huffmantree_builder.add_symbol(dictionary_code.symbol_data, dictionary_code.bits_data);
+				}
+
+				DatFileHuffmanTree huffman_tree_data{};
+				if (!dat_file_huffmantree_builder.build_huffmantree(huffman_tree_data))
+				{
+					throw std::logic_error("Invalid dictionary.");
+				}
+				return huffman_tree_data;
+			}
+
+			// Built at compile time, no static initialization is needed
+			constexpr DatFileHuffmanTree dat_file_huffmantree_dict = build_dat_file_huffmantree_dict();
+
+			inline void copy_16_bytes(uint8_t *destination_data, const uint8_t *source_data)
+			{
+				uint8_t temp_data[16];
+				memcpy(temp_data, source_data, 16);
+				memcpy(destination_data, temp_data, 16);
+			}
+
+			// Copy write_size bytes located write_offset bytes behind output_data
+			// Bytes between output_data + write_size and output_data + write_size + OUTPUT_SLACK_SIZE - 1
+			// may be overwritten
+			inline void copy_match(uint8_t *output_data, uint32_t write_offset, uint32_t write_size)
+			{
+				uint8_t *const output_end = output_data + write_size;
+
+				if (write_offset == 1)
+				{
+					memset(output_data, output_data[-1], write_size);
+					return;
+				}
+
+				if (write_offset == 2 || write_offset == 4 || write_offset == 8)
+				{
+					// Replicating the pattern over 8 bytes, 8 being a multiple of the offset
+					uint8_t pattern_data[8];
+					for (uint32_t i = 0; i < 8; ++i)
+					{
+						pattern_data[i] = output_data[static_cast<int32_t>(i % write_offset) - static_cast<int32_t>(write_offset)];
+					}
+
+					uint64_t pattern_value;
+					memcpy(&pattern_value, pattern_data, 8);
+					do
+					{
+						memcpy(output_data, &pattern_value, 8);
+						memcpy(output_data + 8, &pattern_value, 8);
+						output_data += 16;
+					} while (output_data < output_end);
+					return;
+				}
+
+				if (write_offset < 16)
+				{
+					// Writing bytes one by one until the pattern has been repeated over at least 16 bytes,
+					// the rest can then be copied with an offset multiple of the original one
+					const uint32_t wide_offset = write_offset * ((16 + write_offset - 1) / write_offset);
+					uint8_t *const pattern_end = output_data + std::min(wide_offset, write_size);
+					while (output_data < pattern_end)
+					{
+						*output_data = *(output_data - write_offset);
+						++output_data;
+					}
+					write_offset = wide_offset;
+				}
+
+				const uint8_t *source_data = output_data - write_offset;
+				while (output_data < output_end)
+				{
+					copy_16_bytes(output_data, source_data);
+					copy_16_bytes(output_data + 16, source_data + 16);
+					output_data += 32;
+					source_data += 32;
+				}
+			}
 
 			// Parse and build a huffmanTree
 			bool parse_huffmantree(DatFileBitArray &ioInputBitArray, DatFileHuffmanTree &huffman_tree_data, DatFileHuffmanTreeBuilder &ioHuffmanTreeBuilder)
@@ -47,6 +200,7 @@ namespace gw2dt
 				{
 					uint16_t temp_code;
 
+					ioInputBitArray.refill();
 					dat_file_huffmantree_dict.read_code(ioInputBitArray, temp_code);
 
 					uint8_t temp_code_number_bits = temp_code & 0x1F;
@@ -70,142 +224,289 @@ namespace gw2dt
 				return ioHuffmanTreeBuilder.build_huffmantree(huffman_tree_data);
 			}
 
-			void inflatedata(DatFileBitArray &ioInputBitArray, uint32_t output_data_size, uint8_t *output_data)
+			// Decoding state carried from one block, or one call, to the next
+			struct InflateState
+			{
+				DatFileHuffmanTree huffmantree_symbol;
+				DatFileHuffmanTree huffmantree_copy;
+				DatFileHuffmanTreeBuilder huffmantree_builder;
+
+				uint16_t write_size_const_addition;
+				// Codes left to read in the current block
+				uint32_t remaining_codes;
+			};
+
+			// Longest encoding of a block header, two trees of MAX_SYMBOL_VALUE 16 bits codes and the code count
+			const uint32_t MAX_BLOCK_HEADER_BITS = 2 * (16 + MAX_SYMBOL_VALUE * 16) + 4;
+			// Longest encoding of a code: symbol, write size bits, offset and offset bits
+			const uint32_t MAX_CODE_BITS = 31 + 5 + 31 + 15;
+			// Longest copy, and farthest copy source
+			const uint32_t MAX_WRITE_SIZE = 0xFF + 16;
+			const uint32_t MAX_WRITE_OFFSET = (1 << 15) * 3 + (1 << 15);
+
+			// Base value and number of additional bits of a copy code
+			// The base value is a multiple of 1 << extra_bits, the additional bits are its low bits
+			struct CopyCode
+			{
+				uint32_t base_value;
+				uint8_t extra_bits;
+			};
+
+			const uint32_t WRITE_SIZE_CODES_NUMBER = MAX_SYMBOL_VALUE - 0x100;
+			const uint32_t WRITE_OFFSET_CODES_NUMBER = 34;
+
+			// Write size codes, quot = code / 4 and rem = code % 4:
+			//  - quot == 0: the code itself
+			//  - quot < 7: (1 << (quot - 1)) * (4 + rem) and quot - 1 additional bits (none for quot == 1)
+			//  - 28: 0xFF
+			constexpr std::array<CopyCode, WRITE_SIZE_CODES_NUMBER> build_write_size_codes()
+			{
+				std::array<CopyCode, WRITE_SIZE_CODES_NUMBER> copy_codes{};
+				for (uint32_t code_data = 0; code_data < WRITE_SIZE_CODES_NUMBER; ++code_data)
+				{
+					const uint32_t code_quot = code_data / 4;
+					const uint32_t code_rem = code_data % 4;
+					if (code_quot == 0)
+					{
+						copy_codes[code_data] = CopyCode{code_data, 0};
+					}
+					else if (code_quot < 7)
+					{
+						copy_codes[code_data] = CopyCode{(1u << (code_quot - 1)) * (4 + code_rem), static_cast<uint8_t>(code_quot - 1)};
+					}
+					else
+					{
+						copy_codes[code_data] = CopyCode{0xFF, 0};
+					}
+				}
+				return copy_codes;
+			}
+
+			// Write offset codes, quot = code / 2 and rem = code % 2, the offset is one more than:
+			//  - quot == 0: the code itself
+			//  - quot < 17: (1 << (quot - 1)) * (2 + rem) and quot - 1 additional bits (none for quot == 1)
+			constexpr std::array<CopyCode, WRITE_OFFSET_CODES_NUMBER> build_write_offset_codes()
+			{
+				std::array<CopyCode, WRITE_OFFSET_CODES_NUMBER> copy_codes{};
+				for (uint32_t code_data = 0; code_data < WRITE_OFFSET_CODES_NUMBER; ++code_data)
+				{
+					const uint32_t code_quot = code_data / 2;
+					const uint32_t code_rem = code_data % 2;
+					if (code_quot == 0)
+					{
+						copy_codes[code_data] = CopyCode{code_data + 1, 0};
+					}
+					else
+					{
+						copy_codes[code_data] = CopyCode{(1u << (code_quot - 1)) * (2 + code_rem) + 1, static_cast<uint8_t>(code_quot - 1)};
+					}
+				}
+				return copy_codes;
+			}
+
+			constexpr std::array<CopyCode, WRITE_SIZE_CODES_NUMBER> WRITE_SIZE_CODES = build_write_size_codes();
+			constexpr std::array<CopyCode, WRITE_OFFSET_CODES_NUMBER> WRITE_OFFSET_CODES = build_write_offset_codes();
+
+			static_assert(WRITE_SIZE_CODES[WRITE_SIZE_CODES_NUMBER - 1].base_value == 0xFF && MAX_WRITE_SIZE == 0xFF + 16, "Unexpected longest copy.");
+			static_assert(WRITE_OFFSET_CODES[WRITE_OFFSET_CODES_NUMBER - 1].base_value + (1u << WRITE_OFFSET_CODES[WRITE_OFFSET_CODES_NUMBER - 1].extra_bits) - 1 == MAX_WRITE_OFFSET,
+						  "Unexpected farthest copy source.");
+
+			void read_write_size_const_addition(DatFileBitArray &ioInputBitArray, InflateState &state_data)
 			{
-				uint32_t output_position = 0;
-				uint64_t max_count_size = 0;
 				// Reading the const write size addition value
 				ioInputBitArray.drop(4);
 
-				uint16_t write_size_const_addition;
+				ioInputBitArray.read(4, state_data.write_size_const_addition);
+
+				state_data.write_size_const_addition += 1;
 
-				ioInputBitArray.read(4, write_size_const_addition);
+				ioInputBitArray.drop(4);
+
+				state_data.remaining_codes = 0;
+			}
+
+			// Reads the HuffmanTrees and the number of codes of the next block, false if there is no more block
+			bool read_block_header(DatFileBitArray &ioInputBitArray, InflateState &state_data)
+			{
+				// Reading HuffmanTrees
+				if (!parse_huffmantree(ioInputBitArray, state_data.huffmantree_symbol, state_data.huffmantree_builder) ||
+					!parse_huffmantree(ioInputBitArray, state_data.huffmantree_copy, state_data.huffmantree_builder))
+				{
+					return false;
+				}
 
-				write_size_const_addition += 1;
+				// Reading MaxCount
+				uint32_t max_count;
+				ioInputBitArray.read(4, max_count);
 
+				state_data.remaining_codes = (max_count + 1) << 12;
 				ioInputBitArray.drop(4);
 
-				// Declaring our HuffmanTrees
-				DatFileHuffmanTree huffmantree_symbol;
-				DatFileHuffmanTree huffmantree_copy;
+				return true;
+			}
 
-				DatFileHuffmanTreeBuilder huffmantree_builder;
+			// Decodes at most max_codes codes of the current block, stops once output_stop_position is reached
+			// Copies are cut at output_data_size, output_data_capacity is the size of the buffer
+			// Returns the new output position
+			uint32_t decode_codes(DatFileBitArray &ioInputBitArray, InflateState &state_data, uint8_t *output_data, uint32_t output_position,
+								  uint32_t output_stop_position, uint32_t output_data_size, uint32_t output_data_capacity, uint32_t max_codes)
+			{
+				const DatFileHuffmanTree &huffmantree_symbol = state_data.huffmantree_symbol;
+				const DatFileHuffmanTree &huffmantree_copy = state_data.huffmantree_copy;
+				const uint16_t write_size_const_addition = state_data.write_size_const_addition;
 
-				while (output_position < output_data_size)
+				const uint32_t codes_number = std::min(max_codes, state_data.remaining_codes);
+				uint32_t current_code_read_count = 0;
+
+				while ((current_code_read_count < codes_number) &&
+					   (output_position < output_stop_position))
 				{
-					// Reading HuffmanTrees
-					if (!parse_huffmantree(ioInputBitArray, huffmantree_symbol, huffmantree_builder) || !parse_huffmantree(ioInputBitArray, huffmantree_copy, huffmantree_builder))
+					++current_code_read_count;
+
+					// Reading next code, codes are at most 31 bits long and followed by at most 5 additional bits
+					uint16_t symbol_data = 0;
+					ioInputBitArray.need(36);
+					huffmantree_symbol.read_code(ioInputBitArray, symbol_data);
+
+					if (symbol_data < 0x100)
 					{
-						break;
+						output_data[output_position] = static_cast<uint8_t>(symbol_data);
+						++output_position;
+						continue;
+					}
+
+					// We are in copy mode !
+					// Reading the additional info to know the write size, copy symbols are below MAX_SYMBOL_VALUE
+					const CopyCode write_size_code = WRITE_SIZE_CODES[symbol_data - 0x100];
+					uint32_t write_size = write_size_code.base_value + write_size_const_addition;
+
+					// additional bits
+					if (write_size_code.extra_bits != 0)
+					{
+						uint32_t write_size_add;
+						ioInputBitArray.read_lazy(write_size_code.extra_bits, write_size_add);
+						write_size += write_size_add;
+						ioInputBitArray.drop_lazy(write_size_code.extra_bits);
 					}
 
-					// Reading MaxCount
-					uint32_t max_count;
-					ioInputBitArray.read(4, max_count);
+					// write offset
+					// Reading the write offset, at most 31 bits of code and 15 additional bits
+					ioInputBitArray.need(46);
+					huffmantree_copy.read_code(ioInputBitArray, symbol_data);
+
+					if (symbol_data >= WRITE_OFFSET_CODES_NUMBER)
+					{
+						throw std::runtime_error("Invalid value for writeOffset code.");
+					}
 
-					max_count = (max_count + 1) << 12;
-					ioInputBitArray.drop(4);
-					max_count_size = max_count_size = 1;
-					uint32_t current_code_read_count = 0;
+					const CopyCode write_offset_code = WRITE_OFFSET_CODES[symbol_data];
+					uint32_t write_offset = write_offset_code.base_value;
 
-					while ((current_code_read_count < max_count) &&
-						   (output_position < output_data_size))
+					// additional bits
+					if (write_offset_code.extra_bits != 0)
 					{
-						++current_code_read_count;
+						uint32_t write_offset_add;
+						ioInputBitArray.read_lazy(write_offset_code.extra_bits, write_offset_add);
+						write_offset += write_offset_add;
+						ioInputBitArray.drop_lazy(write_offset_code.extra_bits);
+					}
 
-						// Reading next code
-						uint16_t symbol_data = 0;
-						huffmantree_symbol.read_code(ioInputBitArray, symbol_data);
+					if (write_offset > output_position)
+					{
+						throw std::runtime_error("Invalid write offset, it goes before the beginning of the output.");
+					}
 
-						if (symbol_data < 0x100)
+					write_size = std::min(write_size, output_data_size - output_position);
+					if (output_data_capacity - output_position >= write_size + OUTPUT_SLACK_SIZE)
+					{
+						copy_match(output_data + output_position, write_offset, write_size);
+						output_position += write_size;
+					}
+					else
+					{
+						// Close to the end of a buffer without slack
+						const uint32_t write_end = output_position + write_size;
+						while (output_position < write_end)
 						{
-							output_data[output_position] = static_cast<uint8_t>(symbol_data);
+							output_data[output_position] = output_data[output_position - write_offset];
 							++output_position;
-							continue;
 						}
+					}
+				}
 
-						// We are in copy mode !
-						// Reading the additional info to know the write size
-						symbol_data -= 0x100;
+				state_data.remaining_codes -= current_code_read_count;
+				return output_position;
+			}
 
-						// write size
-						div_t temp_code_div4 = div(symbol_data, 4);
+			// Records a checkpoint at output_position if it is far enough from the previous one
+			void add_checkpoint(DatFileCheckpointIndex &checkpoint_index, uint32_t checkpoint_interval, uint64_t bit_position,
+								const uint8_t *output_data, uint32_t output_position)
+			{
+				std::vector<DatFileCheckpoint> &checkpoints = checkpoint_index.checkpoints;
+				if (!checkpoints.empty() && output_position - checkpoints.back().output_position < checkpoint_interval)
+				{
+					return;
+				}
 
-						uint32_t write_size = 0;
-						if (temp_code_div4.quot == 0)
-						{
-							write_size = symbol_data;
-						}
-						else if (temp_code_div4.quot < 7)
-						{
-							write_size = ((1 << (temp_code_div4.quot - 1)) * (4 + temp_code_div4.rem));
-						}
-						else if (symbol_data == 28)
-						{
-							write_size = 0xFF;
-						}
-						else
-						{
-							throw std::runtime_error("Invalid value for writeSize code.");
-						}
+				const uint32_t window_size = std::min(output_position, MAX_WRITE_OFFSET);
 
-						// additional bits
-						if (temp_code_div4.quot > 1 && symbol_data != 28)
-						{
-							uint8_t write_size_add_bits = static_cast<uint8_t>(temp_code_div4.quot - 1);
-							uint32_t write_size_add;
-							ioInputBitArray.read(write_size_add_bits, write_size_add);
-							write_size |= write_size_add;
-							ioInputBitArray.drop(write_size_add_bits);
-						}
-						write_size += write_size_const_addition;
+				DatFileCheckpoint &checkpoint = checkpoints.emplace_back();
+				checkpoint.bit_position = bit_position;
+				checkpoint.output_position = output_position;
+				checkpoint.window_data.assign(output_data + output_position - window_size, output_data + output_position);
+			}
 
-						// write offset
-						// Reading the write offset
-						huffmantree_copy.read_code(ioInputBitArray, symbol_data);
+			void inflatedata(DatFileBitArray &ioInputBitArray, uint32_t output_data_size, uint8_t *output_data, uint32_t output_data_capacity,
+							 DatFileCheckpointIndex *checkpoint_index = nullptr, uint32_t checkpoint_interval = 0)
+			{
+				InflateState state_data;
+				read_write_size_const_addition(ioInputBitArray, state_data);
 
-						div_t temp_code_div2 = div(symbol_data, 2);
+				if (checkpoint_index != nullptr)
+				{
+					checkpoint_index->output_data_size = output_data_size;
+					checkpoint_index->write_size_const_addition = state_data.write_size_const_addition;
+					checkpoint_index->checkpoints.clear();
+				}
 
-						uint32_t write_offset = 0;
-						if (temp_code_div2.quot == 0)
-						{
-							write_offset = symbol_data;
-						}
-						else if (temp_code_div2.quot < 17)
-						{
-							write_offset = ((1 << (temp_code_div2.quot - 1)) * (2 + temp_code_div2.rem));
-						}
-						else
-						{
-							throw std::runtime_error("Invalid value for writeOffset code.");
-						}
+				uint32_t output_position = 0;
+				while (output_position < output_data_size)
+				{
+					if (checkpoint_index != nullptr)
+					{
+						add_checkpoint(*checkpoint_index, checkpoint_interval, ioInputBitArray.bit_position(), output_data, output_position);
+					}
 
-						// additional bits
-						if (temp_code_div2.quot > 1)
-						{
-							uint8_t write_offsetAddBits = static_cast<uint8_t>(temp_code_div2.quot - 1);
-							uint32_t write_offsetAdd;
-							ioInputBitArray.read(write_offsetAddBits, write_offsetAdd);
-							write_offset |= write_offsetAdd;
-							ioInputBitArray.drop(write_offsetAddBits);
-						}
-						write_offset += 1;
+					if (!read_block_header(ioInputBitArray, state_data))
+					{
+						break;
+					}
 
-						uint32_t already_written = 0;
-						while ((already_written < write_size) &&
-							   (output_position < output_data_size))
-						{
-							output_data[output_position] = output_data[output_position - write_offset];
-							++output_position;
-							++already_written;
-						}
+					output_position = decode_codes(ioInputBitArray, state_data, output_data, output_position,
+												   output_data_size, output_data_size, output_data_capacity, state_data.remaining_codes);
+
+					if (ioInputBitArray.exhausted())
+					{
+						throw std::runtime_error("Reached end of input while decoding.");
 					}
 				}
-				uint64_t before_eof = 0;
-				if ((ioInputBitArray.input_data_size * 8) > ioInputBitArray.position_bits)
-				{
-					before_eof = (ioInputBitArray.input_data_size * 8) - ioInputBitArray.position_bits;
-				}
+			}
+		}
+
+		namespace dat
+		{
+			// Reads the header and returns the size of the inflated data
+			uint32_t read_header(DatFileBitArray &ioInputBitArray)
+			{
+				// Skipping header
+				ioInputBitArray.drop(32);
+
+				// Getting size of the uncompressed data
+				uint32_t output_size;
+				ioInputBitArray.read(32, output_size);
+				ioInputBitArray.drop(32);
+
+				return output_size;
 			}
 		}
 
@@ -222,28 +523,28 @@ namespace gw2dt
 			try
 			{
 				dat::DatFileBitArray input_bits_data(input_data, input_size, 16384); // Skipping four bytes every 65k chunk
-				// printf("\nBuffer position : %d\n", static_cast<uint32_t>(input_bits_data.buffer_position - input_bits_data.buffer_start_position));
-				input_bits_data.input_data_size = input_size;
-				// Skipping header & Getting size of the uncompressed data
-				input_bits_data.drop(32);
-
-				// Getting size of the uncompressed data
-				uint32_t output_size;
-
-				input_bits_data.read(32, output_size);
-
-				input_bits_data.drop(32);
+				uint32_t output_size = dat::read_header(input_bits_data);
 
 				if (output_data_size != 0)
 				{
 					output_size = std::min(output_size, output_data_size);
 				}
 
+				if (output_size > UINT32_MAX - dat::OUTPUT_SLACK_SIZE)
+				{
+					throw std::runtime_error("Output is too big.");
+				}
+
 				output_data_size = output_size;
 
-				temp_output_data = static_cast<uint8_t *>(malloc(sizeof(uint8_t) * output_size));
+				const uint32_t output_data_capacity = output_size + dat::OUTPUT_SLACK_SIZE;
+				temp_output_data = static_cast<uint8_t *>(malloc(sizeof(uint8_t) * static_cast<size_t>(output_data_capacity)));
+				if (temp_output_data == nullptr)
+				{
+					throw std::runtime_error("Failed to allocate the output buffer.");
+				}
 
-				dat::inflatedata(input_bits_data, output_size, temp_output_data);
+				dat::inflatedata(input_bits_data, output_size, temp_output_data, output_data_capacity);
 
 				return temp_output_data;
 			}
@@ -265,291 +566,452 @@ namespace gw2dt
 			}
 		}
 
-		class DatFileHuffmanTreeDictStaticInitializer
+		uint32_t inflate_dat_file_buffer(std::span<const uint8_t> input_data, std::span<uint8_t> output_data)
 		{
-		public:
-			DatFileHuffmanTreeDictStaticInitializer(dat::DatFileHuffmanTree &huffman_tree_data);
-		};
+			if (input_data.data() == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
+
+			dat::DatFileBitArray input_bits_data(input_data.data(), static_cast<uint32_t>(input_data.size()), 16384); // Skipping four bytes every 65k chunk
+			const uint32_t output_data_capacity = static_cast<uint32_t>(std::min<size_t>(output_data.size(), UINT32_MAX));
+			const uint32_t output_size = std::min(dat::read_header(input_bits_data), output_data_capacity);
+
+			dat::inflatedata(input_bits_data, output_size, output_data.data(), output_data_capacity);
+
+			return output_size;
+		}
 
-		DatFileHuffmanTreeDictStaticInitializer::DatFileHuffmanTreeDictStaticInitializer(dat::DatFileHuffmanTree &huffman_tree_data)
+		uint32_t inflate_dat_file_buffer(std::span<const uint8_t> input_data, std::span<uint8_t> output_data,
+										 DatFileCheckpointIndex &checkpoint_index, uint32_t checkpoint_interval)
 		{
-			dat::DatFileHuffmanTreeBuilder dat_file_huffmantree_builder{};
-			dat_file_huffmantree_builder.clear();
-
-			dat_file_huffmantree_builder.add_symbol(0x0A, 3);
-			dat_file_huffmantree_builder.add_symbol(0x09, 3);
-			dat_file_huffmantree_builder.add_symbol(0x08, 3);
-
-			dat_file_huffmantree_builder.add_symbol(0x0C, 4);
-			dat_file_huffmantree_builder.add_symbol(0x0B, 4);
-			dat_file_huffmantree_builder.add_symbol(0x07, 4);
-			dat_file_huffmantree_builder.add_symbol(0x00, 4);
-
-			dat_file_huffmantree_builder.add_symbol(0xE0, 5);
-			dat_file_huffmantree_builder.add_symbol(0x2A, 5);
-			dat_file_huffmantree_builder.add_symbol(0x29, 5);
-			dat_file_huffmantree_builder.add_symbol(0x06, 5);
-
-			dat_file_huffmantree_builder.add_symbol(0x4A, 6);
-			dat_file_huffmantree_builder.add_symbol(0x40, 6);
-			dat_file_huffmantree_builder.add_symbol(0x2C, 6);
-			dat_file_huffmantree_builder.add_symbol(0x2B, 6);
-			dat_file_huffmantree_builder.add_symbol(0x28, 6);
-			dat_file_huffmantree_builder.add_symbol(0x20, 6);
-			dat_file_huffmantree_builder.add_symbol(0x05, 6);
-			dat_file_huffmantree_builder.add_symbol(0x04, 6);
-
-			dat_file_huffmantree_builder.add_symbol(0x49, 7);
-			dat_file_huffmantree_builder.add_symbol(0x48, 7);
-			dat_file_huffmantree_builder.add_symbol(0x27, 7);
-			dat_file_huffmantree_builder.add_symbol(0x26, 7);
-			dat_file_huffmantree_builder.add_symbol(0x25, 7);
-			dat_file_huffmantree_builder.add_symbol(0x0D, 7);
-			dat_file_huffmantree_builder.add_symbol(0x03, 7);
-
-			dat_file_huffmantree_builder.add_symbol(0x6A, 8);
-			dat_file_huffmantree_builder.add_symbol(0x69, 8);
-			dat_file_huffmantree_builder.add_symbol(0x4C, 8);
-			dat_file_huffmantree_builder.add_symbol(0x4B, 8);
-			dat_file_huffmantree_builder.add_symbol(0x47, 8);
-			dat_file_huffmantree_builder.add_symbol(0x24, 8);
-
-			dat_file_huffmantree_builder.add_symbol(0xE8, 9);
-			dat_file_huffmantree_builder.add_symbol(0xA0, 9);
-			dat_file_huffmantree_builder.add_symbol(0x89, 9);
-			dat_file_huffmantree_builder.add_symbol(0x88, 9);
-			dat_file_huffmantree_builder.add_symbol(0x68, 9);
-			dat_file_huffmantree_builder.add_symbol(0x67, 9);
-			dat_file_huffmantree_builder.add_symbol(0x63, 9);
-			dat_file_huffmantree_builder.add_symbol(0x60, 9);
-			dat_file_huffmantree_builder.add_symbol(0x46, 9);
-			dat_file_huffmantree_builder.add_symbol(0x23, 9);
-
-			dat_file_huffmantree_builder.add_symbol(0xE9, 10);
-			dat_file_huffmantree_builder.add_symbol(0xC9, 10);
-			dat_file_huffmantree_builder.add_symbol(0xC0, 10);
-			dat_file_huffmantree_builder.add_symbol(0xA9, 10);
-			dat_file_huffmantree_builder.add_symbol(0xA8, 10);
-			dat_file_huffmantree_builder.add_symbol(0x8A, 10);
-			dat_file_huffmantree_builder.add_symbol(0x87, 10);
-			dat_file_huffmantree_builder.add_symbol(0x80, 10);
-			dat_file_huffmantree_builder.add_symbol(0x66, 10);
-			dat_file_huffmantree_builder.add_symbol(0x65, 10);
-			dat_file_huffmantree_builder.add_symbol(0x45, 10);
-			dat_file_huffmantree_builder.add_symbol(0x44, 10);
-			dat_file_huffmantree_builder.add_symbol(0x43, 10);
-			dat_file_huffmantree_builder.add_symbol(0x2D, 10);
-			dat_file_huffmantree_builder.add_symbol(0x02, 10);
-			dat_file_huffmantree_builder.add_symbol(0x01, 10);
-
-			dat_file_huffmantree_builder.add_symbol(0xE5, 11);
-			dat_file_huffmantree_builder.add_symbol(0xC8, 11);
-			dat_file_huffmantree_builder.add_symbol(0xAA, 11);
-			dat_file_huffmantree_builder.add_symbol(0xA5, 11);
-			dat_file_huffmantree_builder.add_symbol(0xA4, 11);
-			dat_file_huffmantree_builder.add_symbol(0x8B, 11);
-			dat_file_huffmantree_builder.add_symbol(0x85, 11);
-			dat_file_huffmantree_builder.add_symbol(0x84, 11);
-			dat_file_huffmantree_builder.add_symbol(0x6C, 11);
-			dat_file_huffmantree_builder.add_symbol(0x6B, 11);
-			dat_file_huffmantree_builder.add_symbol(0x64, 11);
-			dat_file_huffmantree_builder.add_symbol(0x4D, 11);
-			dat_file_huffmantree_builder.add_symbol(0x0E, 11);
-
-			dat_file_huffmantree_builder.add_symbol(0xE7, 12);
-			dat_file_huffmantree_builder.add_symbol(0xCA, 12);
-			dat_file_huffmantree_builder.add_symbol(0xC7, 12);
-			dat_file_huffmantree_builder.add_symbol(0xA7, 12);
-			dat_file_huffmantree_builder.add_symbol(0xA6, 12);
-			dat_file_huffmantree_builder.add_symbol(0x86, 12);
-			dat_file_huffmantree_builder.add_symbol(0x83, 12);
-
-			dat_file_huffmantree_builder.add_symbol(0xE6, 13);
-			dat_file_huffmantree_builder.add_symbol(0xE4, 13);
-			dat_file_huffmantree_builder.add_symbol(0xC4, 13);
-			dat_file_huffmantree_builder.add_symbol(0x8C, 13);
-			dat_file_huffmantree_builder.add_symbol(0x2E, 13);
-			dat_file_huffmantree_builder.add_symbol(0x22, 13);
-
-			dat_file_huffmantree_builder.add_symbol(0xEC, 14);
-			dat_file_huffmantree_builder.add_symbol(0xC6, 14);
-			dat_file_huffmantree_builder.add_symbol(0x6D, 14);
-			dat_file_huffmantree_builder.add_symbol(0x4E, 14);
-
-			dat_file_huffmantree_builder.add_symbol(0xEA, 15);
-			dat_file_huffmantree_builder.add_symbol(0xCC, 15);
-			dat_file_huffmantree_builder.add_symbol(0xAC, 15);
-			dat_file_huffmantree_builder.add_symbol(0xAB, 15);
-			dat_file_huffmantree_builder.add_symbol(0x8D, 15);
-			dat_file_huffmantree_builder.add_symbol(0x11, 15);
-			dat_file_huffmantree_builder.add_symbol(0x10, 15);
-			dat_file_huffmantree_builder.add_symbol(0x0F, 15);
-
-			dat_file_huffmantree_builder.add_symbol(0xFF, 16);
-			dat_file_huffmantree_builder.add_symbol(0xFE, 16);
-			dat_file_huffmantree_builder.add_symbol(0xFD, 16);
-			dat_file_huffmantree_builder.add_symbol(0xFC, 16);
-			dat_file_huffmantree_builder.add_symbol(0xFB, 16);
-			dat_file_huffmantree_builder.add_symbol(0xFA, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF9, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF8, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF7, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF6, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF5, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF4, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF3, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF2, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF1, 16);
-			dat_file_huffmantree_builder.add_symbol(0xF0, 16);
-			dat_file_huffmantree_builder.add_symbol(0xEF, 16);
-			dat_file_huffmantree_builder.add_symbol(0xEE, 16);
-			dat_file_huffmantree_builder.add_symbol(0xED, 16);
-			dat_file_huffmantree_builder.add_symbol(0xEB, 16);
-			dat_file_huffmantree_builder.add_symbol(0xE3, 16);
-			dat_file_huffmantree_builder.add_symbol(0xE2, 16);
-			dat_file_huffmantree_builder.add_symbol(0xE1, 16);
-			dat_file_huffmantree_builder.add_symbol(0xDF, 16);
-			dat_file_huffmantree_builder.add_symbol(0xDE, 16);
-			dat_file_huffmantree_builder.add_symbol(0xDD, 16);
-			dat_file_huffmantree_builder.add_symbol(0xDC, 16);
-			dat_file_huffmantree_builder.add_symbol(0xDB, 16);
-			dat_file_huffmantree_builder.add_symbol(0xDA, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD9, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD8, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD7, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD6, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD5, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD4, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD3, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD2, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD1, 16);
-			dat_file_huffmantree_builder.add_symbol(0xD0, 16);
-			dat_file_huffmantree_builder.add_symbol(0xCF, 16);
-			dat_file_huffmantree_builder.add_symbol(0xCE, 16);
-			dat_file_huffmantree_builder.add_symbol(0xCD, 16);
-			dat_file_huffmantree_builder.add_symbol(0xCB, 16);
-			dat_file_huffmantree_builder.add_symbol(0xC5, 16);
-			dat_file_huffmantree_builder.add_symbol(0xC3, 16);
-			dat_file_huffmantree_builder.add_symbol(0xC2, 16);
-			dat_file_huffmantree_builder.add_symbol(0xC1, 16);
-			dat_file_huffmantree_builder.add_symbol(0xBF, 16);
-			dat_file_huffmantree_builder.add_symbol(0xBE, 16);
-			dat_file_huffmantree_builder.add_symbol(0xBD, 16);
-			dat_file_huffmantree_builder.add_symbol(0xBC, 16);
-			dat_file_huffmantree_builder.add_symbol(0xBB, 16);
-			dat_file_huffmantree_builder.add_symbol(0xBA, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB9, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB8, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB7, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB6, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB5, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB4, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB3, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB2, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB1, 16);
-			dat_file_huffmantree_builder.add_symbol(0xB0, 16);
-			dat_file_huffmantree_builder.add_symbol(0xAF, 16);
-			dat_file_huffmantree_builder.add_symbol(0xAE, 16);
-			dat_file_huffmantree_builder.add_symbol(0xAD, 16);
-			dat_file_huffmantree_builder.add_symbol(0xA3, 16);
-			dat_file_huffmantree_builder.add_symbol(0xA2, 16);
-			dat_file_huffmantree_builder.add_symbol(0xA1, 16);
-			dat_file_huffmantree_builder.add_symbol(0x9F, 16);
-			dat_file_huffmantree_builder.add_symbol(0x9E, 16);
-			dat_file_huffmantree_builder.add_symbol(0x9D, 16);
-			dat_file_huffmantree_builder.add_symbol(0x9C, 16);
-			dat_file_huffmantree_builder.add_symbol(0x9B, 16);
-			dat_file_huffmantree_builder.add_symbol(0x9A, 16);
-			dat_file_huffmantree_builder.add_symbol(0x99, 16);
-			dat_file_huffmantree_builder.add_symbol(0x98, 16);
-			dat_file_huffmantree_builder.add_symbol(0x97, 16);
-			dat_file_huffmantree_builder.add_symbol(0x96, 16);
-			dat_file_huffmantree_builder.add_symbol(0x95, 16);
-			dat_file_huffmantree_builder.add_symbol(0x94, 16);
-			dat_file_huffmantree_builder.add_symbol(0x93, 16);
-			dat_file_huffmantree_builder.add_symbol(0x92, 16);
-			dat_file_huffmantree_builder.add_symbol(0x91, 16);
-			dat_file_huffmantree_builder.add_symbol(0x90, 16);
-			dat_file_huffmantree_builder.add_symbol(0x8F, 16);
-			dat_file_huffmantree_builder.add_symbol(0x8E, 16);
-			dat_file_huffmantree_builder.add_symbol(0x82, 16);
-			dat_file_huffmantree_builder.add_symbol(0x81, 16);
-			dat_file_huffmantree_builder.add_symbol(0x7F, 16);
-			dat_file_huffmantree_builder.add_symbol(0x7E, 16);
-			dat_file_huffmantree_builder.add_symbol(0x7D, 16);
-			dat_file_huffmantree_builder.add_symbol(0x7C, 16);
-			dat_file_huffmantree_builder.add_symbol(0x7B, 16);
-			dat_file_huffmantree_builder.add_symbol(0x7A, 16);
-			dat_file_huffmantree_builder.add_symbol(0x79, 16);
-			dat_file_huffmantree_builder.add_symbol(0x78, 16);
-			dat_file_huffmantree_builder.add_symbol(0x77, 16);
-			dat_file_huffmantree_builder.add_symbol(0x76, 16);
-			dat_file_huffmantree_builder.add_symbol(0x75, 16);
-			dat_file_huffmantree_builder.add_symbol(0x74, 16);
-			dat_file_huffmantree_builder.add_symbol(0x73, 16);
-			dat_file_huffmantree_builder.add_symbol(0x72, 16);
-			dat_file_huffmantree_builder.add_symbol(0x71, 16);
-			dat_file_huffmantree_builder.add_symbol(0x70, 16);
-			dat_file_huffmantree_builder.add_symbol(0x6F, 16);
-			dat_file_huffmantree_builder.add_symbol(0x6E, 16);
-			dat_file_huffmantree_builder.add_symbol(0x62, 16);
-			dat_file_huffmantree_builder.add_symbol(0x61, 16);
-			dat_file_huffmantree_builder.add_symbol(0x5F, 16);
-			dat_file_huffmantree_builder.add_symbol(0x5E, 16);
-			dat_file_huffmantree_builder.add_symbol(0x5D, 16);
-			dat_file_huffmantree_builder.add_symbol(0x5C, 16);
-			dat_file_huffmantree_builder.add_symbol(0x5B, 16);
-			dat_file_huffmantree_builder.add_symbol(0x5A, 16);
-			dat_file_huffmantree_builder.add_symbol(0x59, 16);
-			dat_file_huffmantree_builder.add_symbol(0x58, 16);
-			dat_file_huffmantree_builder.add_symbol(0x57, 16);
-			dat_file_huffmantree_builder.add_symbol(0x56, 16);
-			dat_file_huffmantree_builder.add_symbol(0x55, 16);
-			dat_file_huffmantree_builder.add_symbol(0x54, 16);
-			dat_file_huffmantree_builder.add_symbol(0x53, 16);
-			dat_file_huffmantree_builder.add_symbol(0x52, 16);
-			dat_file_huffmantree_builder.add_symbol(0x51, 16);
-			dat_file_huffmantree_builder.add_symbol(0x50, 16);
-			dat_file_huffmantree_builder.add_symbol(0x4F, 16);
-			dat_file_huffmantree_builder.add_symbol(0x42, 16);
-			dat_file_huffmantree_builder.add_symbol(0x41, 16);
-			dat_file_huffmantree_builder.add_symbol(0x3F, 16);
-			dat_file_huffmantree_builder.add_symbol(0x3E, 16);
-			dat_file_huffmantree_builder.add_symbol(0x3D, 16);
-			dat_file_huffmantree_builder.add_symbol(0x3C, 16);
-			dat_file_huffmantree_builder.add_symbol(0x3B, 16);
-			dat_file_huffmantree_builder.add_symbol(0x3A, 16);
-			dat_file_huffmantree_builder.add_symbol(0x39, 16);
-			dat_file_huffmantree_builder.add_symbol(0x38, 16);
-			dat_file_huffmantree_builder.add_symbol(0x37, 16);
-			dat_file_huffmantree_builder.add_symbol(0x36, 16);
-			dat_file_huffmantree_builder.add_symbol(0x35, 16);
-			dat_file_huffmantree_builder.add_symbol(0x34, 16);
-			dat_file_huffmantree_builder.add_symbol(0x33, 16);
-			dat_file_huffmantree_builder.add_symbol(0x32, 16);
-			dat_file_huffmantree_builder.add_symbol(0x31, 16);
-			dat_file_huffmantree_builder.add_symbol(0x30, 16);
-			dat_file_huffmantree_builder.add_symbol(0x2F, 16);
-			dat_file_huffmantree_builder.add_symbol(0x21, 16);
-			dat_file_huffmantree_builder.add_symbol(0x1F, 16);
-			dat_file_huffmantree_builder.add_symbol(0x1E, 16);
-			dat_file_huffmantree_builder.add_symbol(0x1D, 16);
-			dat_file_huffmantree_builder.add_symbol(0x1C, 16);
-			dat_file_huffmantree_builder.add_symbol(0x1B, 16);
-			dat_file_huffmantree_builder.add_symbol(0x1A, 16);
-			dat_file_huffmantree_builder.add_symbol(0x19, 16);
-			dat_file_huffmantree_builder.add_symbol(0x18, 16);
-			dat_file_huffmantree_builder.add_symbol(0x17, 16);
-			dat_file_huffmantree_builder.add_symbol(0x16, 16);
-			dat_file_huffmantree_builder.add_symbol(0x15, 16);
-			dat_file_huffmantree_builder.add_symbol(0x14, 16);
-			dat_file_huffmantree_builder.add_symbol(0x13, 16);
-			dat_file_huffmantree_builder.add_symbol(0x12, 16);
-
-			dat_file_huffmantree_builder.build_huffmantree(huffman_tree_data);
+			if (input_data.data() == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
+
+			dat::DatFileBitArray input_bits_data(input_data.data(), static_cast<uint32_t>(input_data.size()), 16384); // Skipping four bytes every 65k chunk
+			const uint32_t output_data_capacity = static_cast<uint32_t>(std::min<size_t>(output_data.size(), UINT32_MAX));
+			const uint32_t output_size = std::min(dat::read_header(input_bits_data), output_data_capacity);
+
+			dat::inflatedata(input_bits_data, output_size, output_data.data(), output_data_capacity, &checkpoint_index, checkpoint_interval);
+
+			return output_size;
+		}
+
+		uint32_t inflate_dat_file_range(std::span<const uint8_t> input_data, const DatFileCheckpointIndex &checkpoint_index,
+										uint32_t output_offset, std::span<uint8_t> output_data)
+		{
+			if (input_data.data() == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
+
+			if (output_offset >= checkpoint_index.output_data_size)
+			{
+				return 0;
+			}
+
+			const uint32_t range_size = static_cast<uint32_t>(std::min<size_t>(output_data.size(), checkpoint_index.output_data_size - output_offset));
+
+			// Nearest checkpoint before output_offset
+			const std::vector<DatFileCheckpoint> &checkpoints = checkpoint_index.checkpoints;
+			auto checkpoint_it = std::upper_bound(checkpoints.begin(), checkpoints.end(), output_offset,
+												  [](uint32_t position, const DatFileCheckpoint &checkpoint)
+												  { return position < checkpoint.output_position; });
+			if (checkpoint_it == checkpoints.begin())
+			{
+				throw std::runtime_error("No checkpoint before the requested output.");
+			}
+			const DatFileCheckpoint &checkpoint = *(--checkpoint_it);
+
+			if (checkpoint.window_data.size() > dat::MAX_WRITE_OFFSET)
+			{
+				throw std::runtime_error("Invalid checkpoint window.");
+			}
+
+			// Decoding after the window, from the checkpoint to the end of the range
+			const uint32_t window_size = static_cast<uint32_t>(checkpoint.window_data.size());
+			const uint32_t range_end_position = window_size + (output_offset - checkpoint.output_position) + range_size;
+			utils::PooledBuffer work_data = utils::BufferPool::shared_pool().acquire(range_end_position, range_end_position + dat::OUTPUT_SLACK_SIZE);
+			// The first checkpoint has no window
+			if (window_size != 0)
+			{
+				memcpy(work_data.data(), checkpoint.window_data.data(), window_size);
+			}
+
+			dat::DatFileBitArray input_bits_data(input_data.data(), static_cast<uint32_t>(input_data.size()), 16384); // Skipping four bytes every 65k chunk
+			input_bits_data.seek(checkpoint.bit_position);
+
+			dat::InflateState state_data;
+			state_data.write_size_const_addition = checkpoint_index.write_size_const_addition;
+			state_data.remaining_codes = 0;
+
+			uint32_t output_position = window_size;
+			while (output_position < range_end_position)
+			{
+				if (!dat::read_block_header(input_bits_data, state_data))
+				{
+					throw std::runtime_error("Reached end of data before the requested output.");
+				}
+
+				output_position = dat::decode_codes(input_bits_data, state_data, work_data.data(), output_position,
+													range_end_position, range_end_position, work_data.capacity(), state_data.remaining_codes);
+
+				if (input_bits_data.exhausted())
+				{
+					throw std::runtime_error("Reached end of input while decoding.");
+				}
+			}
+
+			memcpy(output_data.data(), work_data.data() + range_end_position - range_size, range_size);
+
+			return range_size;
+		}
+
+		namespace dat
+		{
+			const uint32_t CHECKPOINT_INDEX_MAGIC = 0x504B4344; // "DCKP"
+			const uint32_t CHECKPOINT_INDEX_VERSION = 1;
+
+			template <typename ValueType>
+			void write_value(std::ostream &output_stream, ValueType value_data)
+			{
+				output_stream.write(reinterpret_cast<const char *>(&value_data), sizeof(ValueType));
+			}
+
+			template <typename ValueType>
+			ValueType read_value(std::istream &input_stream)
+			{
+				ValueType value_data;
+				if (!input_stream.read(reinterpret_cast<char *>(&value_data), sizeof(ValueType)))
+				{
+					throw std::runtime_error("Checkpoint index is truncated.");
+				}
+				return value_data;
+			}
+		}
+
+		void write_dat_file_checkpoint_index(std::ostream &output_stream, const DatFileCheckpointIndex &checkpoint_index)
+		{
+			dat::write_value(output_stream, dat::CHECKPOINT_INDEX_MAGIC);
+			dat::write_value(output_stream, dat::CHECKPOINT_INDEX_VERSION);
+			dat::write_value(output_stream, checkpoint_index.output_data_size);
+			dat::write_value(output_stream, checkpoint_index.write_size_const_addition);
+			dat::write_value(output_stream, static_cast<uint32_t>(checkpoint_index.checkpoints.size()));
+
+			for (const DatFileCheckpoint &checkpoint : checkpoint_index.checkpoints)
+			{
+				dat::write_value(output_stream, checkpoint.bit_position);
+				dat::write_value(output_stream, checkpoint.output_position);
+				dat::write_value(output_stream, static_cast<uint32_t>(checkpoint.window_data.size()));
+				output_stream.write(reinterpret_cast<const char *>(checkpoint.window_data.data()), checkpoint.window_data.size());
+			}
+
+			if (!output_stream)
+			{
+				throw std::runtime_error("Failed to write the checkpoint index.");
+			}
+		}
+
+		DatFileCheckpointIndex read_dat_file_checkpoint_index(std::istream &input_stream)
+		{
+			if (dat::read_value<uint32_t>(input_stream) != dat::CHECKPOINT_INDEX_MAGIC ||
+				dat::read_value<uint32_t>(input_stream) != dat::CHECKPOINT_INDEX_VERSION)
+			{
+				throw std::runtime_error("Invalid checkpoint index header.");
+			}
+
+			DatFileCheckpointIndex checkpoint_index;
+			checkpoint_index.output_data_size = dat::read_value<uint32_t>(input_stream);
+			checkpoint_index.write_size_const_addition = dat::read_value<uint16_t>(input_stream);
+
+			const uint32_t checkpoints_number = dat::read_value<uint32_t>(input_stream);
+			for (uint32_t checkpoint_index_data = 0; checkpoint_index_data < checkpoints_number; ++checkpoint_index_data)
+			{
+				DatFileCheckpoint checkpoint;
+				checkpoint.bit_position = dat::read_value<uint64_t>(input_stream);
+				checkpoint.output_position = dat::read_value<uint32_t>(input_stream);
+
+				const uint32_t window_size = dat::read_value<uint32_t>(input_stream);
+				if (window_size > dat::MAX_WRITE_OFFSET || window_size > checkpoint.output_position ||
+					(!checkpoint_index.checkpoints.empty() && checkpoint.output_position <= checkpoint_index.checkpoints.back().output_position))
+				{
+					throw std::runtime_error("Invalid checkpoint in index.");
+				}
+
+				checkpoint.window_data.resize(window_size);
+				if (!input_stream.read(reinterpret_cast<char *>(checkpoint.window_data.data()), window_size))
+				{
+					throw std::runtime_error("Checkpoint index is truncated.");
+				}
+
+				checkpoint_index.checkpoints.push_back(std::move(checkpoint));
+			}
+
+			return checkpoint_index;
+		}
+
+		utils::PooledBuffer inflate_dat_file_buffer(std::span<const uint8_t> input_data, utils::BufferPool &buffer_pool, uint32_t output_data_size)
+		{
+			uint32_t output_size = get_inflated_dat_file_size(input_data);
+
+			if (output_data_size != 0)
+			{
+				output_size = std::min(output_size, output_data_size);
+			}
+
+			if (output_size > UINT32_MAX - dat::OUTPUT_SLACK_SIZE)
+			{
+				throw std::runtime_error("Output is too big.");
+			}
+
+			utils::PooledBuffer output_data = buffer_pool.acquire(output_size, output_size + dat::OUTPUT_SLACK_SIZE);
+
+			dat::DatFileBitArray input_bits_data(input_data.data(), static_cast<uint32_t>(input_data.size()), 16384); // Skipping four bytes every 65k chunk
+			dat::read_header(input_bits_data);
+			dat::inflatedata(input_bits_data, output_size, output_data.data(), output_data.capacity());
+
+			return output_data;
+		}
+
+		uint32_t get_inflated_dat_file_size(std::span<const uint8_t> input_data)
+		{
+			if (input_data.data() == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
+
+			dat::DatFileBitArray input_bits_data(input_data.data(), static_cast<uint32_t>(input_data.size()), 16384);
+			return dat::read_header(input_bits_data);
 		}
 
-		static DatFileHuffmanTreeDictStaticInitializer dat_file_huffmantree_dict_static_initializer(dat::dat_file_huffmantree_dict);
+		namespace dat
+		{
+			// The window holds the copy history, room for the next output chunk, and room for one copy past it
+			const uint32_t STREAM_WINDOW_STOP_POSITION = 2 * MAX_WRITE_OFFSET;
+			const uint32_t STREAM_WINDOW_SIZE = STREAM_WINDOW_STOP_POSITION + MAX_WRITE_SIZE + OUTPUT_SLACK_SIZE;
+
+			const uint32_t SKIPPED_WORDS_PERIOD = 16384;
+		}
+
+		DatFileInflateStream::DatFileInflateStream(Sink sink, uint32_t output_data_size) : sink_callback(std::move(sink)),
+																						   inflate_state(new dat::InflateState),
+																						   stream_step(STEP_HEADER),
+																						   input_bit_offset(0),
+																						   input_words_received(0),
+																						   partial_word_size(0),
+																						   window_position(0),
+																						   window_emitted_position(0),
+																						   window_base(0),
+																						   output_data_size(output_data_size)
+		{
+		}
+
+		DatFileInflateStream::~DatFileInflateStream()
+		{
+		}
+
+		void DatFileInflateStream::feed(std::span<const uint8_t> input_data)
+		{
+			if (stream_step == STEP_DONE)
+			{
+				return;
+			}
+
+			append_input(input_data.data(), input_data.size());
+			decode(false);
+		}
+
+		void DatFileInflateStream::finish()
+		{
+			if (stream_step == STEP_DONE)
+			{
+				return;
+			}
+
+			decode(true);
+
+			if (stream_step != STEP_DONE)
+			{
+				throw std::runtime_error("Reached end of input while decoding.");
+			}
+		}
+
+		void DatFileInflateStream::append_input(const uint8_t *input_data, size_t input_size)
+		{
+			const uint8_t *input_end = input_data + input_size;
+
+			// Removing the skipped words as they arrive, the decoder then sees contiguous data
+			while (input_data < input_end)
+			{
+				if (partial_word_size != 0 || input_end - input_data < 4)
+				{
+					const size_t copy_size = std::min<size_t>(4 - partial_word_size, input_end - input_data);
+					memcpy(partial_word + partial_word_size, input_data, copy_size);
+					partial_word_size += static_cast<uint8_t>(copy_size);
+					input_data += copy_size;
+
+					if (partial_word_size == 4)
+					{
+						if ((input_words_received + 1) % dat::SKIPPED_WORDS_PERIOD != 0)
+						{
+							input_buffer.insert(input_buffer.end(), partial_word, partial_word + 4);
+						}
+						++input_words_received;
+						partial_word_size = 0;
+					}
+					continue;
+				}
+
+				if ((input_words_received + 1) % dat::SKIPPED_WORDS_PERIOD == 0)
+				{
+					input_data += 4;
+					++input_words_received;
+					continue;
+				}
+
+				const uint64_t words_before_skip = dat::SKIPPED_WORDS_PERIOD - 1 - input_words_received % dat::SKIPPED_WORDS_PERIOD;
+				const size_t words_number = static_cast<size_t>(std::min<uint64_t>(words_before_skip, (input_end - input_data) / 4));
+				input_buffer.insert(input_buffer.end(), input_data, input_data + words_number * 4);
+				input_data += words_number * 4;
+				input_words_received += words_number;
+			}
+		}
+
+		void DatFileInflateStream::decode(bool is_last_input)
+		{
+			dat::DatFileBitArray input_bits_data(input_buffer.data(), static_cast<uint32_t>(input_buffer.size()));
+			if (input_bit_offset != 0)
+			{
+				input_bits_data.drop(static_cast<uint8_t>(input_bit_offset));
+			}
+
+			// Unless the input is complete, a step only starts when all the bits it may read are there
+			const uint64_t input_data_bits = static_cast<uint64_t>(input_buffer.size()) * 8;
+			auto bits_available = [&]()
+			{
+				return input_data_bits - std::min(input_bits_data.bit_position(), input_data_bits);
+			};
+
+			dat::InflateState &state_data = *inflate_state;
+			bool is_waiting_input = false;
+
+			while (stream_step != STEP_DONE && !is_waiting_input)
+			{
+				switch (stream_step)
+				{
+				case STEP_HEADER:
+				{
+					if (!is_last_input && bits_available() < 72)
+					{
+						is_waiting_input = true;
+						break;
+					}
+
+					uint32_t output_size = dat::read_header(input_bits_data);
+					if (output_data_size != 0)
+					{
+						output_size = std::min(output_size, output_data_size);
+					}
+					output_data_size = output_size;
+
+					dat::read_write_size_const_addition(input_bits_data, state_data);
+
+					window_data.resize(dat::STREAM_WINDOW_SIZE);
+					stream_step = (output_data_size == 0) ? STEP_DONE : STEP_BLOCK_HEADER;
+					break;
+				}
+				case STEP_BLOCK_HEADER:
+				{
+					if (!is_last_input && bits_available() < dat::MAX_BLOCK_HEADER_BITS)
+					{
+						is_waiting_input = true;
+						break;
+					}
+
+					stream_step = dat::read_block_header(input_bits_data, state_data) ? STEP_CODES : STEP_DONE;
+					break;
+				}
+				case STEP_CODES:
+				{
+					uint32_t max_codes = state_data.remaining_codes;
+					if (!is_last_input)
+					{
+						max_codes = static_cast<uint32_t>(std::min<uint64_t>(max_codes, bits_available() / dat::MAX_CODE_BITS));
+						if (max_codes == 0)
+						{
+							is_waiting_input = true;
+							break;
+						}
+					}
+
+					const uint32_t window_end_position = static_cast<uint32_t>(std::min<uint64_t>(output_data_size - window_base, dat::STREAM_WINDOW_SIZE - dat::OUTPUT_SLACK_SIZE));
+					window_position = dat::decode_codes(input_bits_data, state_data, window_data.data(), window_position,
+														std::min(dat::STREAM_WINDOW_STOP_POSITION, window_end_position), window_end_position,
+														dat::STREAM_WINDOW_SIZE, max_codes);
+
+					if (is_last_input && input_bits_data.exhausted())
+					{
+						throw std::runtime_error("Reached end of input while decoding.");
+					}
+
+					if (window_base + window_position >= output_data_size)
+					{
+						emit();
+						stream_step = STEP_DONE;
+						break;
+					}
+
+					if (window_position >= dat::STREAM_WINDOW_STOP_POSITION)
+					{
+						// Keeping only the copy history
+						emit();
+						const uint32_t kept_size = dat::MAX_WRITE_OFFSET;
+						memmove(window_data.data(), window_data.data() + window_position - kept_size, kept_size);
+						window_base += window_position - kept_size;
+						window_position = kept_size;
+						window_emitted_position = kept_size;
+					}
+
+					// The last code of a block may also be the one that filled the window
+					if (state_data.remaining_codes == 0)
+					{
+						stream_step = STEP_BLOCK_HEADER;
+					}
+					break;
+				}
+				case STEP_DONE:
+					break;
+				}
+			}
+
+			emit();
+
+			if (stream_step == STEP_DONE)
+			{
+				input_buffer.clear();
+				input_bit_offset = 0;
+				window_data.clear();
+				window_data.shrink_to_fit();
+				return;
+			}
+
+			// Forgetting the consumed words
+			const uint64_t consumed_bits = input_bits_data.bit_position();
+			const size_t consumed_words = static_cast<size_t>(consumed_bits / 32);
+			input_buffer.erase(input_buffer.begin(), input_buffer.begin() + consumed_words * 4);
+			input_bit_offset = static_cast<uint32_t>(consumed_bits % 32);
+		}
+
+		void DatFileInflateStream::emit()
+		{
+			if (window_position > window_emitted_position)
+			{
+				sink_callback(std::span<const uint8_t>(window_data.data() + window_emitted_position, window_position - window_emitted_position));
+				window_emitted_position = window_position;
+			}
+		}
 
 	}
 }
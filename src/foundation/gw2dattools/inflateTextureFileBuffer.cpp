@@ -1,9 +1,13 @@
 #include "foundation/gw2dattools/inflateTextureFileBuffer.h"
 
+#include <algorithm>
+#include <bit>
 #include <cstdlib>
 #include <memory.h>
+#include <span>
 
-#include "foundation/gw2dattools/huffmanTreeUtils.h"
+#include "foundation/gw2dattools/BitArray.h"
+#include "foundation/gw2dattools/HuffmanTree.h"
 
 #include <iostream>
 #include <vector>
@@ -55,94 +59,210 @@ namespace gw2dt
 				CF_DECODE_BPTC_UNORM = 0x20				   // For BC7 normalized decoding
 			};
 
-			// Static Values
-			HuffmanTree huffman_tree_dict;
-			Format format_data[11];
-			bool static_values_initialized(false);
+			// Formats, in the order of deduceFormat
+			constexpr Format format_data[11] = {
+				{FF_COLOR | FF_ALPHA | FF_DEDUCEDALPHACOMP, 4}, // DXT1 (S3TC - BC1)
+				{FF_COLOR | FF_ALPHA | FF_PLAINCOMP, 8},		// DXT2 (S3TC - BC2)
+				{FF_COLOR | FF_ALPHA | FF_PLAINCOMP, 8},		// DXT3 (same as DXT2)
+				{FF_COLOR | FF_ALPHA | FF_PLAINCOMP, 8},		// DXT4 (same as DXT2)
+				{FF_COLOR | FF_ALPHA | FF_PLAINCOMP, 8},		// DXT5 (S3TC - BC3)
+				{FF_ALPHA | FF_PLAINCOMP, 4},					// DXTA (BC4 - ATI1, single-channel)
+				{FF_ALPHA | FF_PLAINCOMP, 4},					// DXTL (BC4 - ATI1, single-channel grayscale)
+				{FF_BICOLORCOMP, 8},							// DXTN (BC5 - ATI2, normal maps)
+				{FF_BICOLORCOMP, 8},							// 3Dc (BC5 variant, normal maps)
+				{FF_COLOR | FF_HDR | FF_BPTC, 8},				// BC6H (HDR compressed, 16-bit floats internally)
+				{FF_COLOR | FF_ALPHA | FF_BPTC, 8}				// BC7 (High-quality compressed color format)
+			};
+
+			const uint32_t MAX_BITS_HASH = 8;
+			const uint32_t MAX_CODE_BITS_LENGTH = 32;
+			const uint32_t MAX_SYMBOL_VALUE = 0x13;
+
+			// The last word of every 64 KB chunk is skipped
+			// Reads are not checked, the end of the input is tested once per pass
+			typedef utils::BitArray<utils::FixedSkippedWords<0x4000>, utils::UncheckedBits> TextureBitArray;
+			typedef HuffmanTree<uint16_t, MAX_BITS_HASH, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE> TextureHuffmanTree;
+			typedef HuffmanTreeBuilder<uint16_t, MAX_CODE_BITS_LENGTH, MAX_SYMBOL_VALUE> TextureHuffmanTreeBuilder;
 
-			void initialize_static_values()
+			struct DictionaryCode
 			{
-				// Formats
-				{
-					// DXT1 (S3TC - BC1)
-					Format &format_dxt1_data = format_data[0];
-					format_dxt1_data.flag_data = FF_COLOR | FF_ALPHA | FF_DEDUCEDALPHACOMP;
-					format_dxt1_data.pixel_size_bits = 4;
+				uint8_t symbol_data;
+				uint8_t bits_data;
+			};
 
-					// DXT2, DXT3, DXT4 (S3TC - BC2)
-					Format &format_dxt2_data = format_data[1];
-					format_dxt2_data.flag_data = FF_COLOR | FF_ALPHA | FF_PLAINCOMP;
-					format_dxt2_data.pixel_size_bits = 8;
+			// Code lengths of the dictionary of the block counts, in the order they are added to the builder
+			constexpr DictionaryCode TEXTURE_DICTIONARY_CODES[] = {
+				{0x01, 1},
 
-					format_data[2] = format_data[1]; // DXT3 (same as DXT2)
-					format_data[3] = format_data[1]; // DXT4 (same as DXT2)
+				{0x12, 2},
 
-					// DXT5 (S3TC - BC3)
-					Format &format_dxt5_data = format_data[4];
-					format_dxt5_data.flag_data = FF_COLOR | FF_ALPHA | FF_PLAINCOMP;
-					format_dxt5_data.pixel_size_bits = 8;
+				{0x11, 6}, {0x10, 6}, {0x0F, 6}, {0x0E, 6}, {0x0D, 6}, {0x0C, 6}, {0x0B, 6}, {0x0A, 6},
+				{0x09, 6}, {0x08, 6}, {0x07, 6}, {0x06, 6}, {0x05, 6}, {0x04, 6}, {0x03, 6}, {0x02, 6},
+			};
 
-					// DXTA (BC4 - ATI1, single-channel)
-					Format &format_dxt_a_data = format_data[5];
-					format_dxt_a_data.flag_data = FF_ALPHA | FF_PLAINCOMP;
-					format_dxt_a_data.pixel_size_bits = 4;
+			constexpr TextureHuffmanTree build_huffman_tree_dict()
+			{
+				TextureHuffmanTreeBuilder huffman_tree_builder{};
+				huffman_tree_builder.clear();
 
-					// DXTL (BC4 - ATI1, single-channel grayscale)
-					Format &format_dxt_l_data = format_data[6];
-					format_dxt_l_data.flag_data = FF_ALPHA | FF_PLAINCOMP;
-					format_dxt_l_data.pixel_size_bits = 4;
+				for (const DictionaryCode &dictionary_code : TEXTURE_DICTIONARY_CODES)
+				{
+					huffman_tree_builder.add_symbol(dictionary_code.symbol_data, dictionary_code.bits_data);
+				}
 
-					// DXTN (BC5 - ATI2, normal maps)
-					Format &format_dxt_n_data = format_data[7];
-					format_dxt_n_data.flag_data = FF_BICOLORCOMP;
-					format_dxt_n_data.pixel_size_bits = 8;
+				TextureHuffmanTree huffman_tree_data{};
+				if (!huffman_tree_builder.build_huffmantree(huffman_tree_data))
+				{
+					throw std::logic_error("Invalid dictionary.");
+				}
+				return huffman_tree_data;
+			}
 
-					// 3Dc (BC5 variant, normal maps)
-					Format &format_3dcx_data = format_data[8];
-					format_3dcx_data.flag_data = FF_BICOLORCOMP;
-					format_3dcx_data.pixel_size_bits = 8;
+			// Built at compile time, shared by every decoding
+			constexpr TextureHuffmanTree huffman_tree_dict = build_huffman_tree_dict();
 
-					// BC6H (HDR compressed)
-					Format &format_bc6h_data = format_data[9];
-					format_bc6h_data.flag_data = FF_COLOR | FF_HDR | FF_BPTC;
-					format_bc6h_data.pixel_size_bits = 8; // BC6H uses 16-bit floats internally but compressed
+			// Trailing bytes of a partial word are ignored
+			TextureBitArray make_input_bits(const uint8_t *input_data, uint32_t input_size)
+			{
+				return TextureBitArray(input_data, input_size - input_size % 4);
+			}
 
-					// BC7 (High-quality compressed color format)
-					Format &format_bc7_data = format_data[10];
-					format_bc7_data.flag_data = FF_COLOR | FF_ALPHA | FF_BPTC;
-					format_bc7_data.pixel_size_bits = 8;
+			// Reading past the end of the input only returns zeros, it is tested once a pass is done
+			void check_input_end(const TextureBitArray &input_bits_data)
+			{
+				if (input_bits_data.exhausted())
+				{
+					throw std::runtime_error("Reached end of input while trying to fetch a new byte.");
 				}
+			}
 
-				int16_t bits_head_data[MAX_CODE_BITS_LENGTH];
-				int16_t bits_body_data[MAX_SYMBOL_VALUE];
+			// One bit per pixel block, set once the block has been decoded
+			// The bits past the last block are set so that they are never visited
+			class BlockBitmap
+			{
+			public:
+				void assign(uint32_t blocks_number)
+				{
+					blocks_count = blocks_number;
+					words_data.assign((blocks_number + 63) / 64, 0);
+					if (blocks_number % 64 != 0)
+					{
+						words_data.back() = ~0ull << (blocks_number % 64);
+					}
+				}
 
-				// Initialize our workingTabs
-				memset(&bits_head_data, 0xFF, MAX_CODE_BITS_LENGTH * sizeof(int16_t));
-				memset(&bits_body_data, 0xFF, MAX_SYMBOL_VALUE * sizeof(int16_t));
+				void set(uint32_t block_position)
+				{
+					words_data[block_position / 64] |= 1ull << (block_position % 64);
+				}
 
-				fill_working_tab(1, 0x01, &bits_head_data[0], &bits_body_data[0]);
+				// First block at or after block_position that is not set, blocks_count if there is none
+				uint32_t next_clear(uint32_t block_position) const
+				{
+					uint32_t word_index = block_position / 64;
+					if (word_index >= words_data.size())
+					{
+						return blocks_count;
+					}
 
-				fill_working_tab(2, 0x12, &bits_head_data[0], &bits_body_data[0]);
+					uint64_t clear_data = ~words_data[word_index] & (~0ull << (block_position % 64));
+					while (clear_data == 0)
+					{
+						if (++word_index == words_data.size())
+						{
+							return blocks_count;
+						}
+						clear_data = ~words_data[word_index];
+					}
+					return word_index * 64 + std::countr_zero(clear_data);
+				}
 
-				fill_working_tab(6, 0x11, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x10, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x0F, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x0E, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x0D, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x0C, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x0B, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x0A, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x09, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x08, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x07, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x06, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x05, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x04, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x03, &bits_head_data[0], &bits_body_data[0]);
-				fill_working_tab(6, 0x02, &bits_head_data[0], &bits_body_data[0]);
+				// Position after the blocks_number-th block not set from block_position
+				uint32_t skip_clear(uint32_t block_position, uint32_t blocks_number) const
+				{
+					if (blocks_number == 0)
+					{
+						return block_position;
+					}
 
-				return build_huffmantree(huffman_tree_dict, &bits_head_data[0], &bits_body_data[0]);
-			}
+					uint32_t word_index = block_position / 64;
+					uint64_t clear_data = word_index < words_data.size() ? ~words_data[word_index] & (~0ull << (block_position % 64)) : 0;
+					uint32_t clear_number = std::popcount(clear_data);
+					while (clear_number < blocks_number)
+					{
+						blocks_number -= clear_number;
+						if (++word_index >= words_data.size())
+						{
+							throw std::runtime_error("Block run goes past the end of the texture.");
+						}
+						clear_data = ~words_data[word_index];
+						clear_number = std::popcount(clear_data);
+					}
+
+					while (--blocks_number > 0)
+					{
+						clear_data &= clear_data - 1;
+					}
+					return word_index * 64 + std::countr_zero(clear_data) + 1;
+				}
+
+				// Calls fill_function on the next blocks_number blocks not set from block_position and sets them
+				// Returns the position after the last one
+				template <typename FillFunction>
+				uint32_t fill_clear(uint32_t block_position, uint32_t blocks_number, FillFunction &&fill_function)
+				{
+					while (blocks_number > 0)
+					{
+						block_position = next_clear(block_position);
+						if (block_position >= blocks_count)
+						{
+							throw std::runtime_error("Block run goes past the end of the texture.");
+						}
+						fill_function(block_position);
+						set(block_position);
+						++block_position;
+						--blocks_number;
+					}
+					return block_position;
+				}
+
+				// Number of blocks not set before each word, once every pass is done
+				void build_clear_prefix()
+				{
+					clear_prefix.resize(words_data.size() + 1);
+					clear_prefix[0] = 0;
+					for (size_t word_index = 0; word_index < words_data.size(); ++word_index)
+					{
+						clear_prefix[word_index + 1] = clear_prefix[word_index] + std::popcount(~words_data[word_index]);
+					}
+				}
+
+				uint32_t clear_count() const { return clear_prefix.back(); }
+				uint32_t words_count() const { return static_cast<uint32_t>(words_data.size()); }
+
+				// Calls visit_function(block_position, clear_index) on every block not set in [begin_word, end_word)
+				// clear_index is the number of blocks not set before block_position
+				template <typename VisitFunction>
+				void for_each_clear(uint32_t begin_word, uint32_t end_word, VisitFunction &&visit_function) const
+				{
+					uint32_t clear_index = clear_prefix[begin_word];
+					for (uint32_t word_index = begin_word; word_index < end_word; ++word_index)
+					{
+						uint64_t clear_data = ~words_data[word_index];
+						while (clear_data != 0)
+						{
+							visit_function(word_index * 64 + std::countr_zero(clear_data), clear_index);
+							++clear_index;
+							clear_data &= clear_data - 1;
+						}
+					}
+				}
+
+			private:
+				uint32_t blocks_count = 0;
+				std::vector<uint64_t> words_data;
+				std::vector<uint32_t> clear_prefix;
+			};
 
 			Format deduceFormat(uint32_t four_cc_data)
 			{
@@ -186,48 +306,72 @@ namespace gw2dt
 				}
 			}
 
-			void decode_white_color(State &state_data, std::vector<bool> &alpha_bit_map, std::vector<bool> &color_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
+			// Layout of the blocks of a format, fixed for a whole texture so that the per-block code tests no format flag
+			// Every format has components of 8 bytes, one per block, or two with the alpha one first
+			template <uint32_t BytesBlock, bool HasRawAlpha, bool HasRawColor, bool DeducedAlpha>
+			struct FormatLayout
+			{
+				static constexpr uint32_t bytes_block = BytesBlock;
+				static constexpr uint32_t bytes_component = 8;
+				static constexpr bool two_component = BytesBlock == 2 * bytes_component;
+				// Position of the color component in a block
+				static constexpr uint32_t color_offset = two_component ? bytes_component : 0;
+				// The blocks not decoded from the bitstream are copied from the raw words
+				static constexpr bool has_raw_alpha = HasRawAlpha;
+				static constexpr bool has_raw_color = HasRawColor;
+				// The alpha of DXT1 is deduced from the order of the colors
+				static constexpr bool deduced_alpha = DeducedAlpha;
+			};
+
+			typedef FormatLayout<8, false, true, true> LayoutBC1;	 // DXT1
+			typedef FormatLayout<16, true, true, false> LayoutBC3;	 // DXT2 to DXT5, DXTN, 3DCX and BC7X
+			typedef FormatLayout<8, true, false, false> LayoutBC4;	 // DXTA and DXTL
+			typedef FormatLayout<16, false, true, false> LayoutBC6H; // BC6H, without alpha
+
+			template <typename Layout>
+			void decode_white_color(TextureBitArray &input_bits_data, BlockBitmap &alpha_bit_map, BlockBitmap &color_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
 			{
+				const TextureHuffmanTree &huffman_tree_data = huffman_tree_dict;
+
 				uint32_t pixel_block_position = 0;
 
 				while (pixel_block_position < full_format_data.pixel_blocks)
 				{
 					// Reading next code
 					uint16_t temp_code = 0;
-					read_code(huffman_tree_dict, state_data, temp_code);
+					input_bits_data.need(32);
+					huffman_tree_data.read_code(input_bits_data, temp_code);
 
-					need_bits(state_data, 1);
-					uint32_t value_data = read_bits(state_data, 1);
-					drop_bits(state_data, 1);
+					uint32_t value_data;
+					input_bits_data.read(1, value_data);
+					input_bits_data.drop(1);
 
-					while (temp_code > 0)
+					if (value_data)
 					{
-						if (!color_bit_map[pixel_block_position])
+						pixel_block_position = color_bit_map.fill_clear(pixel_block_position, temp_code, [&](uint32_t block_position)
 						{
-							if (value_data)
-							{
-								*reinterpret_cast<int64_t *>(&(output_data[full_format_data.bytes_pixel_blocks * (pixel_block_position)])) = 0xFFFFFFFFFFFFFFFE;
-
-								alpha_bit_map[pixel_block_position] = true;
-								color_bit_map[pixel_block_position] = true;
-							}
-							--temp_code;
-						}
-						++pixel_block_position;
-					}
+							*reinterpret_cast<int64_t *>(&(output_data[Layout::bytes_block * block_position])) = 0xFFFFFFFFFFFFFFFE;
 
-					while (pixel_block_position < full_format_data.pixel_blocks && color_bit_map[pixel_block_position])
+							alpha_bit_map.set(block_position);
+						});
+					}
+					else
 					{
-						++pixel_block_position;
+						pixel_block_position = color_bit_map.skip_clear(pixel_block_position, temp_code);
 					}
+
+					pixel_block_position = color_bit_map.next_clear(pixel_block_position);
 				}
 			}
 
-			void decode_constant_alpha_from_4_bits(State &state_data, std::vector<bool> &alpha_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
+			template <typename Layout>
+			void decode_constant_alpha_from_4_bits(TextureBitArray &input_bits_data, BlockBitmap &alpha_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
 			{
-				need_bits(state_data, 4);
-				uint8_t alpha_value_byte = static_cast<uint8_t>(read_bits(state_data, 4));
-				drop_bits(state_data, 4);
+				const TextureHuffmanTree &huffman_tree_data = huffman_tree_dict;
+
+				uint8_t alpha_value_byte;
+				input_bits_data.read(4, alpha_value_byte);
+				input_bits_data.drop(4);
 
 				uint32_t pixel_block_position = 0;
 
@@ -241,43 +385,44 @@ namespace gw2dt
 				{
 					// Reading next code
 					uint16_t temp_code = 0;
-					read_code(huffman_tree_dict, state_data, temp_code);
+					input_bits_data.need(32);
+					huffman_tree_data.read_code(input_bits_data, temp_code);
 
-					need_bits(state_data, 2);
-					uint32_t value_data = read_bits(state_data, 1);
-					drop_bits(state_data, 1);
+					input_bits_data.need(2);
+					uint32_t value_data;
+					input_bits_data.read_lazy<1>(value_data);
+					input_bits_data.drop_lazy(1);
 
-					uint8_t isNotNull = static_cast<uint8_t>(read_bits(state_data, 1));
+					uint8_t isNotNull;
+					input_bits_data.read_lazy<1>(isNotNull);
 					if (value_data)
 					{
-						drop_bits(state_data, 1);
+						input_bits_data.drop_lazy(1);
 					}
-					while (temp_code > 0)
+					if (value_data)
 					{
-						if (!alpha_bit_map[pixel_block_position])
+						pixel_block_position = alpha_bit_map.fill_clear(pixel_block_position, temp_code, [&](uint32_t block_position)
 						{
-							if (value_data)
-							{
-								memcpy(&(output_data[full_format_data.bytes_pixel_blocks * (pixel_block_position)]), isNotNull ? &alpha_value : &zero_data, full_format_data.bytes_component);
-								alpha_bit_map[pixel_block_position] = true;
-							}
-							--temp_code;
-						}
-						++pixel_block_position;
+							memcpy(&(output_data[Layout::bytes_block * block_position]), isNotNull ? &alpha_value : &zero_data, Layout::bytes_component);
+						});
 					}
-
-					while (pixel_block_position < full_format_data.pixel_blocks && alpha_bit_map[pixel_block_position])
+					else
 					{
-						++pixel_block_position;
+						pixel_block_position = alpha_bit_map.skip_clear(pixel_block_position, temp_code);
 					}
+
+					pixel_block_position = alpha_bit_map.next_clear(pixel_block_position);
 				}
 			}
 
-			void decode_constant_alpha_from_8_bits(State &state_data, std::vector<bool> &alpha_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
+			template <typename Layout>
+			void decode_constant_alpha_from_8_bits(TextureBitArray &input_bits_data, BlockBitmap &alpha_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
 			{
-				need_bits(state_data, 8);
-				uint8_t alpha_value_byte = static_cast<uint8_t>(read_bits(state_data, 8));
-				drop_bits(state_data, 8);
+				const TextureHuffmanTree &huffman_tree_data = huffman_tree_dict;
+
+				uint8_t alpha_value_byte;
+				input_bits_data.read(8, alpha_value_byte);
+				input_bits_data.drop(8);
 
 				uint32_t pixel_block_position = 0;
 
@@ -288,47 +433,51 @@ namespace gw2dt
 				{
 					// Reading next code
 					uint16_t temp_code = 0;
-					read_code(huffman_tree_dict, state_data, temp_code);
+					input_bits_data.need(32);
+					huffman_tree_data.read_code(input_bits_data, temp_code);
 
-					need_bits(state_data, 2);
-					uint32_t value_data = read_bits(state_data, 1);
-					drop_bits(state_data, 1);
+					input_bits_data.need(2);
+					uint32_t value_data;
+					input_bits_data.read_lazy<1>(value_data);
+					input_bits_data.drop_lazy(1);
 
-					uint8_t isNotNull = static_cast<uint8_t>(read_bits(state_data, 1));
+					uint8_t isNotNull;
+					input_bits_data.read_lazy<1>(isNotNull);
 					if (value_data)
 					{
-						drop_bits(state_data, 1);
+						input_bits_data.drop_lazy(1);
 					}
-					while (temp_code > 0)
+					if (value_data)
 					{
-						if (!alpha_bit_map[pixel_block_position])
+						pixel_block_position = alpha_bit_map.fill_clear(pixel_block_position, temp_code, [&](uint32_t block_position)
 						{
-							if (value_data)
-							{
-								memcpy(&(output_data[full_format_data.bytes_pixel_blocks * (pixel_block_position)]), isNotNull ? &alpha_value : &zero_data, full_format_data.bytes_component);
-								alpha_bit_map[pixel_block_position] = true;
-							}
-							--temp_code;
-						}
-						++pixel_block_position;
+							memcpy(&(output_data[Layout::bytes_block * block_position]), isNotNull ? &alpha_value : &zero_data, Layout::bytes_component);
+						});
 					}
-
-					while (pixel_block_position < full_format_data.pixel_blocks && alpha_bit_map[pixel_block_position])
+					else
 					{
-						++pixel_block_position;
+						pixel_block_position = alpha_bit_map.skip_clear(pixel_block_position, temp_code);
 					}
+
+					pixel_block_position = alpha_bit_map.next_clear(pixel_block_position);
 				}
 			}
 
-			void decode_plain_color(State &state_data, std::vector<bool> &color_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
+			template <typename Layout>
+			void decode_plain_color(TextureBitArray &input_bits_data, BlockBitmap &color_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
 			{
-				need_bits(state_data, 24);
-				uint16_t blue_data = static_cast<uint16_t>(read_bits(state_data, 8));
-				drop_bits(state_data, 8);
-				uint16_t green_data = static_cast<uint16_t>(read_bits(state_data, 8));
-				drop_bits(state_data, 8);
-				uint16_t red_data = static_cast<uint16_t>(read_bits(state_data, 8));
-				drop_bits(state_data, 8);
+				const TextureHuffmanTree &huffman_tree_data = huffman_tree_dict;
+
+				input_bits_data.need(24);
+				uint16_t blue_data;
+				input_bits_data.read_lazy<8>(blue_data);
+				input_bits_data.drop_lazy(8);
+				uint16_t green_data;
+				input_bits_data.read_lazy<8>(green_data);
+				input_bits_data.drop_lazy(8);
+				uint16_t red_data;
+				input_bits_data.read_lazy<8>(red_data);
+				input_bits_data.drop_lazy(8);
 
 				// TEMP
 
@@ -480,7 +629,7 @@ namespace gw2dt
 					temp_value_1 = (temp_value_1 + (temp_value_2 / 2)) / temp_value_2;
 				}
 
-				bool special_case_dxt1 = (full_format_data.format.flag_data & FF_DEDUCEDALPHACOMP) && (temp_value_1 == 5 || temp_value_1 == 6 || temp_value_2 != 0);
+				bool special_case_dxt1 = Layout::deduced_alpha && (temp_value_1 == 5 || temp_value_1 == 6 || temp_value_2 != 0);
 
 				if (temp_value_2 > 0 && !special_case_dxt1)
 				{
@@ -543,281 +692,420 @@ namespace gw2dt
 				{
 					// Reading next code
 					uint16_t temp_code = 0;
-					read_code(huffman_tree_dict, state_data, temp_code);
+					input_bits_data.need(32);
+					huffman_tree_data.read_code(input_bits_data, temp_code);
 
-					need_bits(state_data, 1);
-					uint32_t value_data = read_bits(state_data, 1);
-					drop_bits(state_data, 1);
+					uint32_t value_data;
+					input_bits_data.read(1, value_data);
+					input_bits_data.drop(1);
 
-					while (temp_code > 0)
+					if (value_data)
 					{
-						if (!color_bit_map[pixel_block_position])
+						pixel_block_position = color_bit_map.fill_clear(pixel_block_position, temp_code, [&](uint32_t block_position)
 						{
-							if (value_data)
-							{
-								uint32_t aOffset = full_format_data.bytes_pixel_blocks * (pixel_block_position) + (full_format_data.two_component ? full_format_data.bytes_component : 0);
-								memcpy(&(output_data[aOffset]), &final_value, full_format_data.bytes_component);
-								color_bit_map[pixel_block_position] = true;
-							}
-							--temp_code;
-						}
-						++pixel_block_position;
+							memcpy(&(output_data[Layout::bytes_block * block_position + Layout::color_offset]), &final_value, Layout::bytes_component);
+						});
 					}
-
-					while (pixel_block_position < full_format_data.pixel_blocks && color_bit_map[pixel_block_position])
+					else
 					{
-						++pixel_block_position;
+						pixel_block_position = color_bit_map.skip_clear(pixel_block_position, temp_code);
 					}
+
+					pixel_block_position = color_bit_map.next_clear(pixel_block_position);
 				}
 			}
 
-			void decode_bptc_float(State &state_data, std::vector<bool> &alpha_bit_map, std::vector<bool> &color_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
+			// The BPTC blocks of these flags are white, stored as whole valid blocks
+			// Formats of 8 bytes blocks only get the first half, the flags are not expected for them
+			// BC6H mode 11, both endpoints 495 of 10 bits, every texel is the half float 1.0
+			constexpr uint8_t bc6h_white_block[16] = {0xE3, 0xBD, 0xF7, 0xDE, 0x7B, 0xEF, 0xBD, 0xF7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+			// BC7 mode 5, every color and alpha endpoint at its maximum, every texel is opaque white
+			constexpr uint8_t bc7_white_block[16] = {0x20, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+			template <typename Layout>
+			void decode_bptc_float(TextureBitArray &input_bits_data, BlockBitmap &alpha_bit_map, BlockBitmap &color_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
 			{
+				const TextureHuffmanTree &huffman_tree_data = huffman_tree_dict;
+
 				uint32_t pixel_block_position = 0;
 
 				while (pixel_block_position < full_format_data.pixel_blocks)
 				{
 					// Reading next code
 					uint16_t temp_code = 0;
-					read_code(huffman_tree_dict, state_data, temp_code);
+					input_bits_data.need(32);
+					huffman_tree_data.read_code(input_bits_data, temp_code);
 
-					need_bits(state_data, 1);
-					uint32_t value_data = read_bits(state_data, 1);
-					drop_bits(state_data, 1);
+					uint32_t value_data;
+					input_bits_data.read(1, value_data);
+					input_bits_data.drop(1);
 
-					while (temp_code > 0)
+					if (value_data)
 					{
-						if (!color_bit_map[pixel_block_position])
+						pixel_block_position = color_bit_map.fill_clear(pixel_block_position, temp_code, [&](uint32_t block_position)
 						{
-							if (value_data)
-							{
-								float max_float_value = 1.0f; // Adjust if necessary
-								memcpy(&(output_data[full_format_data.bytes_pixel_blocks * pixel_block_position]), &max_float_value, sizeof(float));
-
-								alpha_bit_map[pixel_block_position] = true;
-								color_bit_map[pixel_block_position] = true;
-							}
-							--temp_code;
-						}
-						++pixel_block_position;
-					}
+							memcpy(&(output_data[Layout::bytes_block * block_position]), bc6h_white_block, Layout::bytes_block);
 
-					while (pixel_block_position < full_format_data.pixel_blocks && color_bit_map[pixel_block_position])
+							alpha_bit_map.set(block_position);
+						});
+					}
+					else
 					{
-						++pixel_block_position;
+						pixel_block_position = color_bit_map.skip_clear(pixel_block_position, temp_code);
 					}
+
+					pixel_block_position = color_bit_map.next_clear(pixel_block_position);
 				}
 			}
 
-			void decode_bptc_unorm(State &state_data, std::vector<bool> &alpha_bit_map, std::vector<bool> &color_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
+			template <typename Layout>
+			void decode_bptc_unorm(TextureBitArray &input_bits_data, BlockBitmap &alpha_bit_map, BlockBitmap &color_bit_map, const FullFormat &full_format_data, uint8_t *output_data)
 			{
+				const TextureHuffmanTree &huffman_tree_data = huffman_tree_dict;
+
 				uint32_t pixel_block_position = 0;
 
 				while (pixel_block_position < full_format_data.pixel_blocks)
 				{
 					// Reading next code
 					uint16_t temp_code = 0;
-					read_code(huffman_tree_dict, state_data, temp_code);
+					input_bits_data.need(32);
+					huffman_tree_data.read_code(input_bits_data, temp_code);
 
-					need_bits(state_data, 1);
-					uint32_t value_data = read_bits(state_data, 1);
-					drop_bits(state_data, 1);
+					uint32_t value_data;
+					input_bits_data.read(1, value_data);
+					input_bits_data.drop(1);
 
-					while (temp_code > 0)
+					if (value_data)
 					{
-						if (!color_bit_map[pixel_block_position])
+						pixel_block_position = color_bit_map.fill_clear(pixel_block_position, temp_code, [&](uint32_t block_position)
 						{
-							if (value_data)
-							{
-								uint8_t max_unorm_value = 255; // Adjust for different bit depths
-								memset(&(output_data[full_format_data.bytes_pixel_blocks * pixel_block_position]), max_unorm_value, full_format_data.bytes_component);
-
-								alpha_bit_map[pixel_block_position] = true;
-								color_bit_map[pixel_block_position] = true;
-							}
-							--temp_code;
-						}
-						++pixel_block_position;
-					}
+							memcpy(&(output_data[Layout::bytes_block * block_position]), bc7_white_block, Layout::bytes_block);
 
-					while (pixel_block_position < full_format_data.pixel_blocks && color_bit_map[pixel_block_position])
+							alpha_bit_map.set(block_position);
+						});
+					}
+					else
 					{
-						++pixel_block_position;
+						pixel_block_position = color_bit_map.skip_clear(pixel_block_position, temp_code);
 					}
+
+					pixel_block_position = color_bit_map.next_clear(pixel_block_position);
 				}
 			}
 
-			void inflate_data(State &state_data, const FullFormat &full_format_data, uint32_t output_data_size, uint8_t *output_data)
+			template <typename Layout>
+			void inflate_blocks(TextureBitArray &input_bits_data, const FullFormat &full_format_data, uint32_t compression_flag_data, uint8_t *output_data)
 			{
 				// Bitmaps
-				std::vector<bool> color_bitmap_data;
-				std::vector<bool> alpha_bitmap_data;
-
-				uint32_t chunk_start_position = state_data.input_position;
-
-				state_data.input_position = chunk_start_position;
+				BlockBitmap color_bitmap_data;
+				BlockBitmap alpha_bitmap_data;
 
-				state_data.head = 0;
-				state_data.bits = 0;
-				state_data.buffer = 0;
-
-				// Getting size of compressed data
-				need_bits(state_data, 32);
-				uint32_t data_size = read_bits(state_data, 32);
-				drop_bits(state_data, 32);
-
-				// Compression Flags
-				need_bits(state_data, 32);
-				uint32_t compression_flag_data = read_bits(state_data, 32);
-				drop_bits(state_data, 32);
-
-				color_bitmap_data.assign(full_format_data.pixel_blocks, false);
-				alpha_bitmap_data.assign(full_format_data.pixel_blocks, false);
+				color_bitmap_data.assign(full_format_data.pixel_blocks);
+				alpha_bitmap_data.assign(full_format_data.pixel_blocks);
 
 				if (compression_flag_data & CF_DECODE_WHITE_COLOR)
 				{
-					decode_white_color(state_data, alpha_bitmap_data, color_bitmap_data, full_format_data, output_data);
+					decode_white_color<Layout>(input_bits_data, alpha_bitmap_data, color_bitmap_data, full_format_data, output_data);
 				}
 
 				if (compression_flag_data & CF_DECODE_CONSTANT_ALPHA_FROM4BITS)
 				{
-					decode_constant_alpha_from_4_bits(state_data, alpha_bitmap_data, full_format_data, output_data);
+					decode_constant_alpha_from_4_bits<Layout>(input_bits_data, alpha_bitmap_data, full_format_data, output_data);
 				}
 
 				if (compression_flag_data & CF_DECODE_CONSTANT_ALPHA_FROM8BITS)
 				{
-					decode_constant_alpha_from_8_bits(state_data, alpha_bitmap_data, full_format_data, output_data);
+					decode_constant_alpha_from_8_bits<Layout>(input_bits_data, alpha_bitmap_data, full_format_data, output_data);
 				}
 
 				if (compression_flag_data & CF_DECODE_PLAIN_COLOR)
 				{
-					decode_plain_color(state_data, color_bitmap_data, full_format_data, output_data);
+					decode_plain_color<Layout>(input_bits_data, color_bitmap_data, full_format_data, output_data);
 				}
 
 				if (compression_flag_data & CF_DECODE_BPTC_FLOAT)
 				{
-					decode_bptc_float(state_data, alpha_bitmap_data, color_bitmap_data, full_format_data, output_data);
+					decode_bptc_float<Layout>(input_bits_data, alpha_bitmap_data, color_bitmap_data, full_format_data, output_data);
 				}
 
 				if (compression_flag_data & CF_DECODE_BPTC_UNORM)
 				{
-					decode_bptc_unorm(state_data, alpha_bitmap_data, color_bitmap_data, full_format_data, output_data);
+					decode_bptc_unorm<Layout>(input_bits_data, alpha_bitmap_data, color_bitmap_data, full_format_data, output_data);
 				}
 
-				uint32_t loop_index_data;
+				check_input_end(input_bits_data);
 
-				if (state_data.bits >= 32)
+				// The remaining blocks are stored raw, in block order: the alpha words of every block not set in the alpha
+				// bitmap, then the first color word of every block not set in the color bitmap, then their second color word.
+				// The input position of a block only depends on the number of raw blocks before it.
+				// Texture decoding already runs on the batch and tile decoder threads, the copy stays on the calling thread.
+				if constexpr (Layout::has_raw_alpha)
 				{
-					--state_data.input_position;
+					alpha_bitmap_data.build_clear_prefix();
 				}
+				if constexpr (Layout::has_raw_color)
+				{
+					color_bitmap_data.build_clear_prefix();
+				}
+
+				// Every component is two words
+				const uint64_t alpha_input_position = input_bits_data.next_word_index();
+				const uint64_t color_input_position = alpha_input_position + (Layout::has_raw_alpha ? static_cast<uint64_t>(alpha_bitmap_data.clear_count()) * 2 : 0);
+				const uint64_t color_raw_blocks = Layout::has_raw_color ? color_bitmap_data.clear_count() : 0;
 
-				if ((((full_format_data.format.flag_data) & FF_ALPHA) && !((full_format_data.format.flag_data) & FF_DEDUCEDALPHACOMP)) || (full_format_data.format.flag_data) & FF_BICOLORCOMP)
+				// Data missing at the end of the input is left as is
+				const uint32_t *input_words = reinterpret_cast<const uint32_t *>(input_bits_data.buffer_start_position);
+				const uint64_t input_words_number = input_bits_data.words_count();
+				auto copy_raw_word = [input_words, input_words_number, output_data](uint32_t output_offset, uint64_t input_position)
 				{
-					for (loop_index_data = 0; loop_index_data < alpha_bitmap_data.size() && state_data.input_position < state_data.input_size; ++loop_index_data)
+					if (input_position < input_words_number)
 					{
-						if (!alpha_bitmap_data[loop_index_data])
-						{
-							(*reinterpret_cast<uint32_t *>(&(output_data[full_format_data.bytes_pixel_blocks * loop_index_data]))) = state_data.input[state_data.input_position];
-							++state_data.input_position;
-							if (full_format_data.bytes_component > 4)
-							{
-								(*reinterpret_cast<uint32_t *>(&(output_data[full_format_data.bytes_pixel_blocks * loop_index_data + 4]))) = state_data.input[state_data.input_position];
-								++state_data.input_position;
-							}
-						}
+						(*reinterpret_cast<uint32_t *>(&(output_data[output_offset]))) = input_words[input_position];
 					}
+				};
+
+				if constexpr (Layout::has_raw_alpha)
+				{
+					alpha_bitmap_data.for_each_clear(0, alpha_bitmap_data.words_count(), [&](uint32_t block_position, uint32_t clear_index)
+					{
+						const uint32_t output_offset = Layout::bytes_block * block_position;
+						const uint64_t input_position = alpha_input_position + static_cast<uint64_t>(clear_index) * 2;
+						copy_raw_word(output_offset, input_position);
+						copy_raw_word(output_offset + 4, input_position + 1);
+					});
 				}
 
-				if ((full_format_data.format.flag_data) & FF_COLOR || (full_format_data.format.flag_data) & FF_BICOLORCOMP)
+				if constexpr (Layout::has_raw_color)
 				{
-					for (loop_index_data = 0; loop_index_data < color_bitmap_data.size() && state_data.input_position < state_data.input_size; ++loop_index_data)
+					color_bitmap_data.for_each_clear(0, color_bitmap_data.words_count(), [&](uint32_t block_position, uint32_t clear_index)
 					{
-						if (!color_bitmap_data[loop_index_data])
-						{
-							uint32_t aOffset = full_format_data.bytes_pixel_blocks * loop_index_data + (full_format_data.two_component ? full_format_data.bytes_component : 0);
-							(*reinterpret_cast<uint32_t *>(&(output_data[aOffset]))) = state_data.input[state_data.input_position];
-							++state_data.input_position;
-						}
-					}
-					if (full_format_data.bytes_component > 4)
+						const uint32_t output_offset = Layout::bytes_block * block_position + Layout::color_offset;
+						copy_raw_word(output_offset, color_input_position + clear_index);
+						copy_raw_word(output_offset + 4, color_input_position + color_raw_blocks + clear_index);
+					});
+				}
+			}
+
+			void inflate_data(TextureBitArray &input_bits_data, const FullFormat &full_format_data, uint32_t output_data_size, uint8_t *output_data)
+			{
+				// Getting size of compressed data
+				uint32_t data_size;
+				input_bits_data.read(32, data_size);
+				input_bits_data.drop(32);
+
+				// Compression Flags
+				uint32_t compression_flag_data;
+				input_bits_data.read(32, compression_flag_data);
+				input_bits_data.drop(32);
+
+				// The format is only tested here, once per texture
+				const uint32_t flag_data = full_format_data.format.flag_data;
+				if (flag_data & FF_DEDUCEDALPHACOMP)
+				{
+					inflate_blocks<LayoutBC1>(input_bits_data, full_format_data, compression_flag_data, output_data);
+				}
+				else if (full_format_data.bytes_pixel_blocks == LayoutBC4::bytes_block)
+				{
+					inflate_blocks<LayoutBC4>(input_bits_data, full_format_data, compression_flag_data, output_data);
+				}
+				else if (!(flag_data & (FF_ALPHA | FF_BICOLORCOMP)))
+				{
+					inflate_blocks<LayoutBC6H>(input_bits_data, full_format_data, compression_flag_data, output_data);
+				}
+				else
+				{
+					inflate_blocks<LayoutBC3>(input_bits_data, full_format_data, compression_flag_data, output_data);
+				}
+			}
+
+			void initialize_full_format(FullFormat &full_format_data, uint32_t iFormatFourCc, uint16_t iWidth, uint16_t iHeight)
+			{
+				full_format_data.format = deduceFormat(iFormatFourCc);
+				full_format_data.width = iWidth;
+				full_format_data.height = iHeight;
+
+				full_format_data.pixel_blocks = ((full_format_data.width + 3) / 4) * ((full_format_data.height + 3) / 4);
+				full_format_data.bytes_pixel_blocks = (full_format_data.format.pixel_size_bits * 4 * 4) / 8;
+				full_format_data.two_component =
+					((full_format_data.format.flag_data & (FF_PLAINCOMP | FF_COLOR | FF_ALPHA)) == (FF_PLAINCOMP | FF_COLOR | FF_ALPHA)) ||
+					(full_format_data.format.flag_data & FF_BICOLORCOMP) ||
+					(full_format_data.format.flag_data & FF_BPTC);
+
+				full_format_data.bytes_component = full_format_data.bytes_pixel_blocks / (full_format_data.two_component ? 2 : 1);
+			}
+
+			// Walks the size fields of the levels, none of them is decoded
+			// The first level is always listed, the next ones only if the previous one fits in the input
+			void read_levels(const TextureBitArray &input_bits_data, AnetImage &anet_image)
+			{
+				const uint64_t input_words_number = input_bits_data.words_count();
+				uint64_t level_position = input_bits_data.next_word_index();
+				uint16_t level_width = anet_image.width;
+				uint16_t level_height = anet_image.height;
+
+				anet_image.levels_number = 0;
+				while (anet_image.levels_number < ANET_IMAGE_MAX_LEVELS && level_position < input_words_number)
+				{
+					uint32_t level_size;
+					memcpy(&level_size, input_bits_data.buffer_start_position + level_position * 4, sizeof(level_size));
+					const uint64_t level_words = 1 + (static_cast<uint64_t>(level_size) + 3) / 4;
+
+					AnetImageLevel &level_data = anet_image.levels[anet_image.levels_number];
+					level_data.offset = static_cast<uint32_t>(level_position * 4);
+					level_data.size = static_cast<uint32_t>(std::min<uint64_t>(level_words * 4, UINT32_MAX));
+					level_data.width = level_width;
+					level_data.height = level_height;
+					++anet_image.levels_number;
+
+					if (level_words > input_words_number - level_position || (level_width == 1 && level_height == 1))
 					{
-						for (loop_index_data = 0; loop_index_data < color_bitmap_data.size() && state_data.input_position < state_data.input_size; ++loop_index_data)
-						{
-							if (!color_bitmap_data[loop_index_data])
-							{
-								uint32_t aOffset = full_format_data.bytes_pixel_blocks * loop_index_data + 4 + (full_format_data.two_component ? full_format_data.bytes_component : 0);
-								(*reinterpret_cast<uint32_t *>(&(output_data[aOffset]))) = state_data.input[state_data.input_position];
-								++state_data.input_position;
-							}
-						}
+						break;
 					}
+
+					level_position += level_words;
+					level_width = std::max(1, level_width / 2);
+					level_height = std::max(1, level_height / 2);
 				}
 			}
+
+			// Reads the image header and returns the size of the inflated data
+			uint32_t read_header(TextureBitArray &input_bits_data, FullFormat &full_format_data, AnetImage &anet_image)
+			{
+				// Skipping header
+				input_bits_data.read(32, anet_image.identifier);
+				input_bits_data.drop(32);
+
+				// Format
+				uint32_t format_four_cc;
+				input_bits_data.read(32, format_four_cc);
+				input_bits_data.drop(32);
+				anet_image.format = format_four_cc;
+
+				// Getting width/height
+				input_bits_data.need(32);
+				uint16_t width;
+				input_bits_data.read_lazy<16>(width);
+				input_bits_data.drop_lazy(16);
+				uint16_t height;
+				input_bits_data.read_lazy<16>(height);
+				input_bits_data.drop_lazy(16);
+				anet_image.width = width;
+				anet_image.height = height;
+
+				if (input_bits_data.exhausted())
+				{
+					throw std::runtime_error("Texture header is truncated.");
+				}
+
+				initialize_full_format(full_format_data, format_four_cc, width, height);
+				read_levels(input_bits_data, anet_image);
+
+				return full_format_data.bytes_pixel_blocks * full_format_data.pixel_blocks;
+			}
+
+			// Prepares the decoding of one level and returns the size of its inflated data
+			uint32_t seek_level(TextureBitArray &input_bits_data, FullFormat &full_format_data, const AnetImage &anet_image, uint32_t level_index)
+			{
+				if (level_index >= anet_image.levels_number)
+				{
+					throw std::runtime_error("Texture level " + std::to_string(level_index) + " not found.");
+				}
+
+				const AnetImageLevel &level_data = anet_image.levels[level_index];
+				initialize_full_format(full_format_data, anet_image.format, level_data.width, level_data.height);
+
+				input_bits_data.seek_word(level_data.offset / 4);
+
+				return full_format_data.bytes_pixel_blocks * full_format_data.pixel_blocks;
+			}
 		}
 
-		uint8_t *inflate_texture_file_buffer(uint32_t iinput_size, const uint8_t *input_data, uint32_t &output_data_size, AnetImage &anet_image)
+		bool is_anet_image_identifier(uint32_t identifier)
 		{
-			if (input_data == nullptr)
+			switch (identifier)
 			{
-				throw std::runtime_error("Input buffer is null.");
+			case 0x58455441: // "ATEX"
+			case 0x58545441: // "ATTX"
+			case 0x50455441: // "ATEP"
+			case 0x55455441: // "ATEU"
+			case 0x43455441: // "ATEC"
+			case 0x54455441: // "ATET"
+				return true;
+
+			default:
+				return false;
 			}
+		}
 
-			uint8_t *temp_output_data(nullptr);
-			bool output_data_owned(true);
+		uint32_t probe_texture_file(std::span<const uint8_t> input_data, AnetImage &anet_image)
+		{
+			if (input_data.data() == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
 
-			try
+			if (input_data.size() < 12)
 			{
-				if (!texture::static_values_initialized)
-				{
-					texture::initialize_static_values();
-					texture::static_values_initialized = true;
-				}
+				throw std::runtime_error("Texture header is truncated.");
+			}
 
-				// Initialize state
-				State state_data;
-				state_data.input = reinterpret_cast<const uint32_t *>(input_data);
-				state_data.input_size = iinput_size / 4;
-				state_data.input_position = 0;
+			uint32_t identifier;
+			memcpy(&identifier, input_data.data(), sizeof(identifier));
+			if (!is_anet_image_identifier(identifier))
+			{
+				throw std::runtime_error("Unknown texture identifier: " + std::to_string(identifier));
+			}
 
-				state_data.head = 0;
-				state_data.bits = 0;
-				state_data.buffer = 0;
+			texture::TextureBitArray input_bits_data = texture::make_input_bits(input_data.data(), static_cast<uint32_t>(input_data.size()));
 
-				state_data.is_empty = false;
+			texture::FullFormat full_format_data;
+			return texture::read_header(input_bits_data, full_format_data, anet_image);
+		}
 
-				// Skipping header
-				need_bits(state_data, 32);
-				anet_image.identifier = read_bits(state_data, 32);
-				drop_bits(state_data, 32);
+		AnetImage get_anet_image_level(const AnetImage &anet_image, uint32_t level_index)
+		{
+			if (level_index >= anet_image.levels_number)
+			{
+				throw std::runtime_error("Texture level " + std::to_string(level_index) + " not found.");
+			}
 
-				// Format
-				need_bits(state_data, 32);
-				uint32_t format_four_cc = read_bits(state_data, 32);
-				drop_bits(state_data, 32);
-				anet_image.format = format_four_cc;
-				texture::FullFormat full_format_data;
+			AnetImage level_image = anet_image;
+			level_image.width = anet_image.levels[level_index].width;
+			level_image.height = anet_image.levels[level_index].height;
+			level_image.levels_number = 1;
+			level_image.levels[0] = anet_image.levels[level_index];
+			return level_image;
+		}
 
-				full_format_data.format = texture::deduceFormat(format_four_cc);
+		uint32_t find_anet_image_level(const AnetImage &anet_image, uint16_t max_width, uint16_t max_height)
+		{
+			uint32_t level_index = 0;
+			while (level_index + 1 < anet_image.levels_number &&
+				   anet_image.levels[level_index + 1].width >= max_width && anet_image.levels[level_index + 1].height >= max_height)
+			{
+				++level_index;
+			}
+			return level_index;
+		}
 
-				// Getting width/height
-				need_bits(state_data, 32);
-				full_format_data.width = static_cast<uint16_t>(read_bits(state_data, 16));
-				drop_bits(state_data, 16);
-				full_format_data.height = static_cast<uint16_t>(read_bits(state_data, 16));
-				drop_bits(state_data, 16);
-				anet_image.width = full_format_data.width;
-				anet_image.height = full_format_data.height;
+		uint8_t *inflate_texture_file_buffer(uint32_t iinput_size, const uint8_t *input_data, uint32_t &output_data_size, AnetImage &anet_image)
+		{
+			if (input_data == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
 
-				full_format_data.pixel_blocks = ((full_format_data.width + 3) / 4) * ((full_format_data.height + 3) / 4);
-				full_format_data.bytes_pixel_blocks = (full_format_data.format.pixel_size_bits * 4 * 4) / 8;
-				full_format_data.two_component =
-					((full_format_data.format.flag_data & (texture::FF_PLAINCOMP | texture::FF_COLOR | texture::FF_ALPHA)) == (texture::FF_PLAINCOMP | texture::FF_COLOR | texture::FF_ALPHA)) ||
-					(full_format_data.format.flag_data & texture::FF_BICOLORCOMP) ||
-					(full_format_data.format.flag_data & texture::FF_BPTC);
+			uint8_t *temp_output_data(nullptr);
+			bool output_data_owned(true);
 
-				full_format_data.bytes_component = full_format_data.bytes_pixel_blocks / (full_format_data.two_component ? 2 : 1);
+			try
+			{
+				// Initialize state
+				texture::TextureBitArray input_bits_data = texture::make_input_bits(input_data, iinput_size);
 
-				uint32_t output_size = full_format_data.bytes_pixel_blocks * full_format_data.pixel_blocks;
+				texture::FullFormat full_format_data;
+				uint32_t output_size = texture::read_header(input_bits_data, full_format_data, anet_image);
 
 				if (output_data_size != 0 && output_data_size < output_size)
 				{
@@ -828,7 +1116,7 @@ namespace gw2dt
 
 				temp_output_data = static_cast<uint8_t *>(malloc(sizeof(uint8_t) * output_size));
 
-				texture::inflate_data(state_data, full_format_data, output_data_size, temp_output_data);
+				texture::inflate_data(input_bits_data, full_format_data, output_data_size, temp_output_data);
 
 				return temp_output_data;
 			}
@@ -850,6 +1138,88 @@ namespace gw2dt
 			}
 		}
 
+		uint32_t inflate_texture_file_buffer(std::span<const uint8_t> input_data, std::span<uint8_t> output_data, AnetImage &anet_image)
+		{
+			if (input_data.data() == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
+
+			texture::TextureBitArray input_bits_data = texture::make_input_bits(input_data.data(), static_cast<uint32_t>(input_data.size()));
+
+			texture::FullFormat full_format_data;
+			uint32_t output_size = texture::read_header(input_bits_data, full_format_data, anet_image);
+
+			if (output_data.size() < output_size)
+			{
+				throw std::runtime_error("Output buffer is too small.");
+			}
+
+			texture::inflate_data(input_bits_data, full_format_data, output_size, output_data.data());
+
+			return output_size;
+		}
+
+		utils::PooledBuffer inflate_texture_file_buffer(std::span<const uint8_t> input_data, utils::BufferPool &buffer_pool, AnetImage &anet_image)
+		{
+			if (input_data.data() == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
+
+			texture::TextureBitArray input_bits_data = texture::make_input_bits(input_data.data(), static_cast<uint32_t>(input_data.size()));
+
+			texture::FullFormat full_format_data;
+			uint32_t output_size = texture::read_header(input_bits_data, full_format_data, anet_image);
+
+			utils::PooledBuffer output_data = buffer_pool.acquire(output_size);
+			texture::inflate_data(input_bits_data, full_format_data, output_size, output_data.data());
+
+			return output_data;
+		}
+
+		uint32_t inflate_texture_file_level(std::span<const uint8_t> input_data, uint32_t level_index, std::span<uint8_t> output_data, AnetImage &anet_image)
+		{
+			if (input_data.data() == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
+
+			texture::TextureBitArray input_bits_data = texture::make_input_bits(input_data.data(), static_cast<uint32_t>(input_data.size()));
+
+			texture::FullFormat full_format_data;
+			texture::read_header(input_bits_data, full_format_data, anet_image);
+			uint32_t output_size = texture::seek_level(input_bits_data, full_format_data, anet_image, level_index);
+
+			if (output_data.size() < output_size)
+			{
+				throw std::runtime_error("Output buffer is too small.");
+			}
+
+			texture::inflate_data(input_bits_data, full_format_data, output_size, output_data.data());
+
+			return output_size;
+		}
+
+		utils::PooledBuffer inflate_texture_file_level(std::span<const uint8_t> input_data, uint32_t level_index, utils::BufferPool &buffer_pool, AnetImage &anet_image)
+		{
+			if (input_data.data() == nullptr)
+			{
+				throw std::runtime_error("Input buffer is null.");
+			}
+
+			texture::TextureBitArray input_bits_data = texture::make_input_bits(input_data.data(), static_cast<uint32_t>(input_data.size()));
+
+			texture::FullFormat full_format_data;
+			texture::read_header(input_bits_data, full_format_data, anet_image);
+			uint32_t output_size = texture::seek_level(input_bits_data, full_format_data, anet_image, level_index);
+
+			utils::PooledBuffer output_data = buffer_pool.acquire(output_size);
+			texture::inflate_data(input_bits_data, full_format_data, output_size, output_data.data());
+
+			return output_data;
+		}
+
 		uint8_t *inflate_texture_block_buffer(uint16_t iWidth, uint16_t iHeight, uint32_t iFormatFourCc, uint32_t iinput_size, const uint8_t *input_data,
 											  uint32_t &output_data_size, uint8_t *output_data)
 		{
@@ -868,39 +1238,12 @@ namespace gw2dt
 
 			try
 			{
-				if (!texture::static_values_initialized)
-				{
-					texture::initialize_static_values();
-					texture::static_values_initialized = true;
-				}
-
 				// Initialize format
 				texture::FullFormat full_format_data;
-
-				full_format_data.format = texture::deduceFormat(iFormatFourCc);
-				full_format_data.width = iWidth;
-				full_format_data.height = iHeight;
-
-				full_format_data.pixel_blocks = ((full_format_data.width + 3) / 4) * ((full_format_data.height + 3) / 4);
-				full_format_data.bytes_pixel_blocks = (full_format_data.format.pixel_size_bits * 4 * 4) / 8;
-				full_format_data.two_component =
-					((full_format_data.format.flag_data & (texture::FF_PLAINCOMP | texture::FF_COLOR | texture::FF_ALPHA)) == (texture::FF_PLAINCOMP | texture::FF_COLOR | texture::FF_ALPHA)) ||
-					(full_format_data.format.flag_data & texture::FF_BICOLORCOMP) ||
-					(full_format_data.format.flag_data & texture::FF_BPTC);
-
-				full_format_data.bytes_component = full_format_data.bytes_pixel_blocks / (full_format_data.two_component ? 2 : 1);
+				texture::initialize_full_format(full_format_data, iFormatFourCc, iWidth, iHeight);
 
 				// Initialize state
-				State state_data;
-				state_data.input = reinterpret_cast<const uint32_t *>(input_data);
-				state_data.input_size = iinput_size / 4;
-				state_data.input_position = 0;
-
-				state_data.head = 0;
-				state_data.bits = 0;
-				state_data.buffer = 0;
-
-				state_data.is_empty = false;
+				texture::TextureBitArray input_bits_data = texture::make_input_bits(input_data, iinput_size);
 
 				// Allocate output buffer
 				uint32_t output_size = full_format_data.bytes_pixel_blocks * full_format_data.pixel_blocks;
@@ -922,7 +1265,7 @@ namespace gw2dt
 					temp_output_data = output_data;
 				}
 
-				texture::inflate_data(state_data, full_format_data, output_data_size, temp_output_data);
+				texture::inflate_data(input_bits_data, full_format_data, output_data_size, temp_output_data);
 
 				return temp_output_data;
 			}
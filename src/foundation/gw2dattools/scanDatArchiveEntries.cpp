@@ -0,0 +1,181 @@
+#include "foundation/gw2dattools/scanDatArchiveEntries.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "foundation/gw2dattools/inflateDatFileBuffer.h"
+#include "foundation/gw2dattools/inflateTextureFileBuffer.h"
+
+namespace gw2dt
+{
+	namespace archive
+	{
+		namespace
+		{
+			// Entries handed to the batch inflater at once, the progress is reported between them
+			constexpr uint32_t SCAN_CHUNK_SIZE = 16384;
+
+			bool starts_with(std::span<const uint8_t> input_data, const char *prefix_data, size_t prefix_size)
+			{
+				return input_data.size() >= prefix_size && memcmp(input_data.data(), prefix_data, prefix_size) == 0;
+			}
+
+			void set_uncompressed_size(DatArchiveIndexEntry &index_entry, uint32_t uncompressed_size)
+			{
+				index_entry.uncompressed_size = uncompressed_size;
+				index_entry.flag_data |= DAT_ARCHIVE_INDEX_UNCOMPRESSED_SIZE;
+			}
+
+			void set_type(DatArchiveIndexEntry &index_entry, uint32_t type_data)
+			{
+				index_entry.four_cc = type_data;
+				index_entry.flag_data |= DAT_ARCHIVE_INDEX_FOUR_CC;
+			}
+		}
+
+		uint32_t sniff_dat_entry_type(std::span<const uint8_t> input_data)
+		{
+			if (input_data.size() < 4)
+			{
+				return DAT_ENTRY_TYPE_UNKNOWN;
+			}
+
+			uint32_t identifier;
+			memcpy(&identifier, input_data.data(), sizeof(identifier));
+
+			if (compression::is_anet_image_identifier(identifier))
+			{
+				return identifier;
+			}
+
+			// Pack file header: "PF", flags, 0, header size, then the file type
+			if (starts_with(input_data, "PF", 2))
+			{
+				uint32_t file_type = 0;
+				if (input_data.size() >= 12)
+				{
+					memcpy(&file_type, input_data.data() + 8, sizeof(file_type));
+				}
+				return file_type != 0 ? file_type : DAT_ENTRY_TYPE_PACK_FILE;
+			}
+
+			switch (identifier)
+			{
+			case DAT_ENTRY_TYPE_STRINGS:
+			case DAT_ENTRY_TYPE_OGG:
+			case DAT_ENTRY_TYPE_RIFF:
+			case DAT_ENTRY_TYPE_DDS:
+				return identifier;
+
+			case 0x00000100: // TrueType
+			case 0x4F54544F: // "OTTO", OpenType
+				return DAT_ENTRY_TYPE_FONT;
+
+			default:
+				break;
+			}
+
+			if (starts_with(input_data, "\x89PNG", 4))
+			{
+				return DAT_ENTRY_TYPE_PNG;
+			}
+			if (starts_with(input_data, "\xFF\xD8\xFF", 3))
+			{
+				return DAT_ENTRY_TYPE_JPEG;
+			}
+			// ID3 tag or MPEG frame sync
+			if (starts_with(input_data, "ID3", 3) || (input_data[0] == 0xFF && (input_data[1] & 0xE0) == 0xE0))
+			{
+				return DAT_ENTRY_TYPE_MP3;
+			}
+			if (starts_with(input_data, "BIK", 3) || starts_with(input_data, "KB2", 3))
+			{
+				return DAT_ENTRY_TYPE_BINK;
+			}
+			if (starts_with(input_data, "MZ", 2))
+			{
+				return DAT_ENTRY_TYPE_EXECUTABLE;
+			}
+
+			return DAT_ENTRY_TYPE_UNKNOWN;
+		}
+
+		bool scan_dat_archive_entries(const DatArchive &archive, std::span<DatArchiveIndexEntry> entries,
+									  compression::DatFileBatchInflater &batch_inflater,
+									  const DatArchiveScanProgress &progress_callback)
+		{
+			if (entries.size() != archive.entries_count())
+			{
+				throw std::runtime_error("Index entries do not match the archive.");
+			}
+
+			const uint32_t entries_number = entries.empty() ? 0 : static_cast<uint32_t>(entries.size() - 1);
+
+			std::vector<compression::DatFileBatchJob> jobs;
+			std::vector<uint32_t> job_entries;
+			for (uint32_t chunk_start = 1; chunk_start < entries.size(); chunk_start += SCAN_CHUNK_SIZE)
+			{
+				const uint32_t chunk_end = static_cast<uint32_t>(std::min<size_t>(entries.size(), chunk_start + SCAN_CHUNK_SIZE));
+
+				jobs.clear();
+				job_entries.clear();
+				for (uint32_t entry_index = chunk_start; entry_index < chunk_end; ++entry_index)
+				{
+					DatArchiveIndexEntry &index_entry = entries[entry_index];
+					if (index_entry.has_four_cc())
+					{
+						continue;
+					}
+
+					// Unused slots and entries out of the archive have nothing to sniff
+					std::span<const uint8_t> input_data;
+					try
+					{
+						input_data = archive.entry_data(entry_index);
+					}
+					catch (const std::exception &)
+					{
+					}
+					if (input_data.empty())
+					{
+						set_type(index_entry, DAT_ENTRY_TYPE_UNKNOWN);
+						continue;
+					}
+
+					// Stored entries are read in place
+					if (index_entry.compression_flag == 0)
+					{
+						set_uncompressed_size(index_entry, index_entry.size);
+						set_type(index_entry, sniff_dat_entry_type(input_data.first(std::min<size_t>(input_data.size(), DAT_ENTRY_SNIFF_SIZE))));
+						continue;
+					}
+
+					jobs.push_back({input_data, DAT_ENTRY_SNIFF_SIZE});
+					job_entries.push_back(entry_index);
+				}
+
+				// Every job writes in its own entry
+				batch_inflater.inflate(jobs, [&](size_t job_index, compression::DatFileBatchResult &&result_data)
+									   {
+					DatArchiveIndexEntry &index_entry = entries[job_entries[job_index]];
+					try
+					{
+						set_uncompressed_size(index_entry, compression::get_inflated_dat_file_size(jobs[job_index].input_data));
+					}
+					catch (const std::exception &)
+					{
+					}
+					set_type(index_entry, result_data.error_data ? DAT_ENTRY_TYPE_UNKNOWN : sniff_dat_entry_type(result_data.output_data.span())); });
+
+				if (progress_callback && !progress_callback(chunk_end - 1, entries_number))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+	}
+}
@@ -0,0 +1,47 @@
+#include "foundation/gw2dattools/inflateDatFileBuffer.h"
+#include "foundation/gw2dattools/inflateTextureFileBuffer.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "benchSections.h"
+#include "encodeDatFile.h"
+#include "encodeTextureFile.h"
+#include "testCheck.h"
+
+namespace gw2dt
+{
+	namespace bench
+	{
+
+		void bench_bit_reader(const BenchOptions &options)
+		{
+			// Both decoders read their input through utils::BitArray, throughputs are given in input bytes
+			const std::vector<uint8_t> corpus_data = testing::make_dat_corpus(testing::DAT_CORPUS_TEXT, options.is_quick ? 1u << 18 : 1u << 24, 6);
+			const std::vector<uint8_t> dat_file = testing::encode_dat_file(corpus_data);
+			std::vector<uint8_t> dat_output(corpus_data.size() + compression::DAT_FILE_OUTPUT_SLACK_SIZE);
+
+			const uint16_t image_size = options.is_quick ? 256 : 4096;
+			const std::vector<uint8_t> texture_file = testing::encode_texture_file(0x35545844, image_size, image_size, 0x01 | 0x02 | 0x04 | 0x08, 6); // "DXT5"
+			compression::AnetImage anet_image;
+			std::vector<uint8_t> texture_output(compression::probe_texture_file(texture_file, anet_image));
+
+			auto inflate_dat = [&]()
+			{ compression::inflate_dat_file_buffer(dat_file, dat_output); };
+			auto inflate_texture = [&]()
+			{ compression::inflate_texture_file_buffer(texture_file, texture_output, anet_image); };
+
+			const double dat_seconds = measure_best_seconds(options, inflate_dat);
+			GW2DT_CHECK(std::equal(corpus_data.begin(), corpus_data.end(), dat_output.begin()));
+			const double texture_seconds = measure_best_seconds(options, inflate_texture);
+			const double both_seconds = measure_best_seconds(options, [&]()
+															 { inflate_dat(); inflate_texture(); });
+
+			std::printf("%-16s %8.2f MB in %9.1f MB/s in\n", "dat entry", dat_file.size() / 1e6, megabytes_per_second(dat_file.size(), dat_seconds));
+			std::printf("%-16s %8.2f MB in %9.1f MB/s in\n", "texture file", texture_file.size() / 1e6, megabytes_per_second(texture_file.size(), texture_seconds));
+			std::printf("%-16s %8.2f MB in %9.1f MB/s in\n", "both", (dat_file.size() + texture_file.size()) / 1e6,
+						megabytes_per_second(dat_file.size() + texture_file.size(), both_seconds));
+		}
+
+	}
+}
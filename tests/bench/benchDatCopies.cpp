@@ -0,0 +1,47 @@
+#include "foundation/gw2dattools/inflateDatFileBuffer.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "benchSections.h"
+#include "encodeDatFile.h"
+#include "testCheck.h"
+
+namespace gw2dt
+{
+	namespace bench
+	{
+
+		void bench_dat_copies(const BenchOptions &options)
+		{
+			struct CopyCase
+			{
+				const char *name_data;
+				testing::DatCorpusKind corpus_kind;
+			};
+			const CopyCase copy_cases[] = {
+				{"text (short copies)", testing::DAT_CORPUS_TEXT},
+				{"vertices (records)", testing::DAT_CORPUS_VERTICES},
+				{"zeros (long copies)", testing::DAT_CORPUS_ZEROS},
+			};
+
+			const uint32_t corpus_size = options.is_quick ? 1u << 18 : 1u << 24;
+			for (const CopyCase &copy_case : copy_cases)
+			{
+				const std::vector<uint8_t> corpus_data = testing::make_dat_corpus(copy_case.corpus_kind, corpus_size, 2);
+				uint64_t copies_number = 0;
+				const std::vector<uint8_t> input_data = testing::encode_dat_file(corpus_data, testing::DatFileEncoding(), &copies_number);
+
+				std::vector<uint8_t> output_data(corpus_data.size() + compression::DAT_FILE_OUTPUT_SLACK_SIZE);
+				const double elapsed_seconds = measure_best_seconds(options, [&]()
+																	{ compression::inflate_dat_file_buffer(input_data, output_data); });
+				GW2DT_CHECK(std::equal(corpus_data.begin(), corpus_data.end(), output_data.begin()));
+
+				// Literals are decoded too, the time per copy is an upper bound
+				std::printf("%-24s %9llu copies %7.2f ns/copy %9.1f MB/s\n", copy_case.name_data, static_cast<unsigned long long>(copies_number),
+							copies_number != 0 ? elapsed_seconds * 1e9 / copies_number : 0.0, megabytes_per_second(corpus_data.size(), elapsed_seconds));
+			}
+		}
+
+	}
+}
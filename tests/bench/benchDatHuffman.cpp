@@ -0,0 +1,233 @@
+#include "foundation/gw2dattools/HuffmanTree.h"
+#include "foundation/gw2dattools/inflateDatFileBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "BitWriter.h"
+#include "benchSections.h"
+#include "encodeDatFile.h"
+#include "testCheck.h"
+
+namespace gw2dt
+{
+	namespace bench
+	{
+
+		namespace
+		{
+			// Same shape as the trees of the dat decoder
+			const uint16_t SYMBOLS_NUMBER = 285;
+			typedef compression::HuffmanTree<uint16_t, 11, 32, SYMBOLS_NUMBER> DatHuffmanTree;
+			typedef compression::HuffmanTreeBuilder<uint16_t, 32, SYMBOLS_NUMBER> DatHuffmanTreeBuilder;
+			typedef utils::BitArray<utils::VariableSkippedWords, utils::UncheckedBits> CodeBitArray;
+
+			// The lookup HuffmanTree::read_code did before the two level tables, kept as a reference:
+			// codes of up to 8 bits go through a hash table, longer ones through a linear search of code_comparison
+			class ComparisonHuffmanTree
+			{
+			public:
+				static const uint8_t MAX_BITS_HASH = 8;
+
+				explicit ComparisonHuffmanTree(const std::vector<testing::HuffmanCode> &codes)
+				{
+					for (uint16_t symbol_data = 0; symbol_data < codes.size(); ++symbol_data)
+					{
+						const testing::HuffmanCode &code = codes[symbol_data];
+						if (code.bits_data == 0 || code.bits_data > MAX_BITS_HASH)
+						{
+							continue;
+						}
+						const uint32_t hash_value = code.code_data << (MAX_BITS_HASH - code.bits_data);
+						for (uint32_t hash_index = 0; hash_index < (1u << (MAX_BITS_HASH - code.bits_data)); ++hash_index)
+						{
+							hash_data[hash_value + hash_index] = {symbol_data, code.bits_data};
+						}
+					}
+
+					// Longer codes by length, then by decreasing code, each length searched from its smallest code
+					for (uint8_t bits_data = MAX_BITS_HASH + 1; bits_data < 32; ++bits_data)
+					{
+						std::vector<std::pair<uint32_t, uint16_t>> length_codes;
+						for (uint16_t symbol_data = 0; symbol_data < codes.size(); ++symbol_data)
+						{
+							if (codes[symbol_data].bits_data == bits_data)
+							{
+								length_codes.push_back({codes[symbol_data].code_data, symbol_data});
+							}
+						}
+						if (length_codes.empty())
+						{
+							continue;
+						}
+
+						std::sort(length_codes.rbegin(), length_codes.rend());
+						for (const std::pair<uint32_t, uint16_t> &length_code : length_codes)
+						{
+							symbol_value.push_back(length_code.second);
+						}
+						code_comparison.push_back(length_codes.back().first << (32 - bits_data));
+						code_bits.push_back(bits_data);
+						symbol_value_offset.push_back(static_cast<uint16_t>(symbol_value.size() - 1));
+					}
+				}
+
+				// At least 32 bits must be available in the BitArray
+				uint16_t read_code(CodeBitArray &input_bit_array) const
+				{
+					uint32_t hash_value;
+					input_bit_array.read_lazy<MAX_BITS_HASH>(hash_value);
+					const HashEntry &hash_entry = hash_data[hash_value];
+					if (hash_entry.code_bits != 0)
+					{
+						input_bit_array.drop_lazy(hash_entry.code_bits);
+						return hash_entry.symbol_data;
+					}
+
+					input_bit_array.read_lazy(hash_value);
+					size_t index_data = 0;
+					while (hash_value < code_comparison[index_data])
+					{
+						++index_data;
+					}
+					const uint8_t temp_bits = code_bits[index_data];
+					input_bit_array.drop_lazy(temp_bits);
+					return symbol_value[symbol_value_offset[index_data] - ((hash_value - code_comparison[index_data]) >> (32 - temp_bits))];
+				}
+
+			private:
+				struct HashEntry
+				{
+					uint16_t symbol_data = 0;
+					uint8_t code_bits = 0;
+				};
+
+				HashEntry hash_data[1 << MAX_BITS_HASH];
+				std::vector<uint32_t> code_comparison;
+				std::vector<uint8_t> code_bits;
+				std::vector<uint16_t> symbol_value_offset;
+				std::vector<uint16_t> symbol_value;
+			};
+
+			// Symbols decoded per second by both lookups, on symbols_number symbols drawn with Zipf frequencies of exponent zipf_exponent
+			void bench_code_lookup(const BenchOptions &options, double zipf_exponent, uint32_t symbols_number)
+			{
+				std::vector<uint64_t> frequencies(SYMBOLS_NUMBER);
+				for (uint32_t symbol_data = 0; symbol_data < SYMBOLS_NUMBER; ++symbol_data)
+				{
+					frequencies[symbol_data] = std::max<uint64_t>(1, static_cast<uint64_t>(1e9 / std::pow(symbol_data + 1.0, zipf_exponent)));
+				}
+				const std::vector<uint8_t> code_lengths = testing::get_huffman_code_lengths(frequencies);
+
+				// Added from the last symbol to the first, like the dat decoder does
+				struct AddedSymbol
+				{
+					uint16_t symbol_data;
+					uint8_t bits_data;
+				};
+				std::vector<AddedSymbol> added_symbols;
+				DatHuffmanTreeBuilder tree_builder{};
+				tree_builder.clear();
+				for (int32_t symbol_data = SYMBOLS_NUMBER - 1; symbol_data >= 0; --symbol_data)
+				{
+					added_symbols.push_back({static_cast<uint16_t>(symbol_data), code_lengths[symbol_data]});
+					tree_builder.add_symbol(static_cast<uint16_t>(symbol_data), code_lengths[symbol_data]);
+				}
+				const std::vector<testing::HuffmanCode> codes = testing::assign_huffman_codes(added_symbols, SYMBOLS_NUMBER);
+
+				static DatHuffmanTree huffman_tree;
+				GW2DT_CHECK(tree_builder.build_huffmantree(huffman_tree));
+				const ComparisonHuffmanTree comparison_tree(codes);
+
+				std::mt19937 random_engine(8);
+				std::discrete_distribution<uint32_t> symbol_distribution(frequencies.begin(), frequencies.end());
+				std::vector<uint16_t> symbols(symbols_number);
+				testing::BitWriter bit_writer;
+				uint64_t long_codes_number = 0;
+				for (uint16_t &symbol_data : symbols)
+				{
+					symbol_data = static_cast<uint16_t>(symbol_distribution(random_engine));
+					bit_writer.write(codes[symbol_data].code_data, codes[symbol_data].bits_data);
+					long_codes_number += codes[symbol_data].bits_data > ComparisonHuffmanTree::MAX_BITS_HASH;
+				}
+				std::vector<uint8_t> input_data;
+				for (uint32_t word_data : bit_writer.finish())
+				{
+					for (uint32_t byte_index = 0; byte_index < 4; ++byte_index)
+					{
+						input_data.push_back(static_cast<uint8_t>(word_data >> (8 * byte_index)));
+					}
+				}
+
+				std::vector<uint16_t> decoded_symbols(symbols.size());
+				const double tree_seconds = measure_best_seconds(options, [&]()
+																 {
+					CodeBitArray input_bit_array(input_data.data(), static_cast<uint32_t>(input_data.size()));
+					for (uint16_t &symbol_data : decoded_symbols)
+					{
+						input_bit_array.need(32);
+						huffman_tree.read_code(input_bit_array, symbol_data);
+					} });
+				GW2DT_CHECK(decoded_symbols == symbols);
+
+				std::fill(decoded_symbols.begin(), decoded_symbols.end(), 0);
+				const double comparison_seconds = measure_best_seconds(options, [&]()
+																	   {
+					CodeBitArray input_bit_array(input_data.data(), static_cast<uint32_t>(input_data.size()));
+					for (uint16_t &symbol_data : decoded_symbols)
+					{
+						input_bit_array.need(32);
+						symbol_data = comparison_tree.read_code(input_bit_array);
+					} });
+				GW2DT_CHECK(decoded_symbols == symbols);
+
+				char case_name[64];
+				std::snprintf(case_name, sizeof(case_name), "zipf %.1f, %.1f%% codes over 8 bits, longest %u", zipf_exponent,
+							  100.0 * long_codes_number / symbols.size(), *std::max_element(code_lengths.begin(), code_lengths.end()));
+				std::printf("%-48s %9.1f M/s %9.1f M/s   x%.2f\n", case_name, symbols.size() / tree_seconds / 1e6, symbols.size() / comparison_seconds / 1e6,
+							tree_seconds > 0.0 ? comparison_seconds / tree_seconds : 0.0);
+			}
+		}
+
+		void bench_dat_huffman(const BenchOptions &options)
+		{
+			struct CorpusCase
+			{
+				const char *name_data;
+				testing::DatCorpusKind corpus_kind;
+			};
+			const CorpusCase corpus_cases[] = {
+				{"random (literals only)", testing::DAT_CORPUS_RANDOM},
+				{"text (short copies)", testing::DAT_CORPUS_TEXT},
+				{"vertices (records)", testing::DAT_CORPUS_VERTICES},
+				{"zeros (long copies)", testing::DAT_CORPUS_ZEROS},
+			};
+
+			const uint32_t corpus_size = options.is_quick ? 1u << 18 : 1u << 24;
+			for (const CorpusCase &corpus_case : corpus_cases)
+			{
+				const std::vector<uint8_t> corpus_data = testing::make_dat_corpus(corpus_case.corpus_kind, corpus_size, 1);
+				const std::vector<uint8_t> input_data = testing::encode_dat_file(corpus_data);
+
+				std::vector<uint8_t> output_data(corpus_data.size() + compression::DAT_FILE_OUTPUT_SLACK_SIZE);
+				const double elapsed_seconds = measure_best_seconds(options, [&]()
+																	{ compression::inflate_dat_file_buffer(input_data, output_data); });
+				GW2DT_CHECK(std::equal(corpus_data.begin(), corpus_data.end(), output_data.begin()));
+
+				std::printf("%-24s %8.2f MB in %8.2f MB out %9.1f MB/s\n", corpus_case.name_data, input_data.size() / 1e6, corpus_data.size() / 1e6,
+							megabytes_per_second(corpus_data.size(), elapsed_seconds));
+			}
+
+			// The rest of the decoder changed since, the lookups are compared on their own
+			std::printf("%-48s %13s %13s %7s\n", "code lookup, 285 symbols", "two level", "comparison", "speedup");
+			const uint32_t symbols_number = options.is_quick ? 1u << 16 : 1u << 24;
+			for (double zipf_exponent : {1.0, 1.5, 2.0})
+			{
+				bench_code_lookup(options, zipf_exponent, symbols_number);
+			}
+		}
+
+	}
+}
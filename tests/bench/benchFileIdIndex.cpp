@@ -0,0 +1,89 @@
+#include "foundation/gw2dattools/FileIdIndex.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "benchSections.h"
+#include "testCheck.h"
+
+namespace gw2dt
+{
+	namespace bench
+	{
+
+		void bench_file_id_index(const BenchOptions &options)
+		{
+			// Shaped like an archive: base ids mostly consecutive with gaps, a third of the entries with a second big file id
+			std::mt19937 random_engine(7);
+			const uint32_t entries_number = options.is_quick ? 20000 : 600000;
+			std::vector<std::pair<uint32_t, uint32_t>> id_pairs;
+			uint32_t base_id = 16;
+			for (uint32_t entry_index = 16; entry_index < entries_number; ++entry_index)
+			{
+				base_id += 1 + (random_engine() % 4 == 0 ? random_engine() % 8 : 0);
+				id_pairs.push_back({base_id, entry_index});
+				if (random_engine() % 3 == 0)
+				{
+					id_pairs.push_back({2000000 + random_engine() % 4000000, entry_index});
+				}
+			}
+			std::shuffle(id_pairs.begin(), id_pairs.end(), random_engine);
+
+			// 80% of hits
+			std::vector<uint32_t> file_ids(options.is_quick ? 100000 : 4000000);
+			for (uint32_t &file_id : file_ids)
+			{
+				file_id = random_engine() % 5 != 0 ? id_pairs[random_engine() % id_pairs.size()].first : static_cast<uint32_t>(random_engine()) | 1;
+			}
+
+			std::unordered_map<uint32_t, uint32_t> entries_map;
+			const double map_build_seconds = measure_best_seconds(options, [&]()
+																  {
+				entries_map = std::unordered_map<uint32_t, uint32_t>();
+				entries_map.reserve(id_pairs.size());
+				for (const std::pair<uint32_t, uint32_t> &id_pair : id_pairs)
+				{
+					entries_map[id_pair.first] = id_pair.second;
+				} });
+
+			archive::FileIdIndex file_id_index;
+			const double index_build_seconds = measure_best_seconds(options, [&]()
+																	{
+				file_id_index = archive::FileIdIndex(static_cast<uint32_t>(id_pairs.size()));
+				for (const std::pair<uint32_t, uint32_t> &id_pair : id_pairs)
+				{
+					file_id_index.insert(id_pair.first, id_pair.second);
+				} });
+
+			std::vector<uint32_t> map_entries(file_ids.size());
+			std::vector<uint32_t> index_entries(file_ids.size());
+			const double map_seconds = measure_best_seconds(options, [&]()
+															{
+				for (size_t id_index = 0; id_index < file_ids.size(); ++id_index)
+				{
+					const auto found_entry = entries_map.find(file_ids[id_index]);
+					map_entries[id_index] = found_entry != entries_map.end() ? found_entry->second : 0;
+				} });
+			const double find_seconds = measure_best_seconds(options, [&]()
+															 {
+				for (size_t id_index = 0; id_index < file_ids.size(); ++id_index)
+				{
+					index_entries[id_index] = file_id_index.find(file_ids[id_index]);
+				} });
+			GW2DT_CHECK(index_entries == map_entries);
+			std::fill(index_entries.begin(), index_entries.end(), 0);
+			const double batch_seconds = measure_best_seconds(options, [&]()
+															  { file_id_index.find(file_ids, index_entries); });
+			GW2DT_CHECK(index_entries == map_entries);
+
+			std::printf("%zu ids, %zu lookups\n", entries_map.size(), file_ids.size());
+			std::printf("%-20s build %8.2f ms %9.1f M lookups/s\n", "std::unordered_map", map_build_seconds * 1e3, file_ids.size() / map_seconds / 1e6);
+			std::printf("%-20s build %8.2f ms %9.1f M lookups/s\n", "FileIdIndex", index_build_seconds * 1e3, file_ids.size() / find_seconds / 1e6);
+			std::printf("%-20s %17s %9.1f M lookups/s\n", "FileIdIndex batch", "", file_ids.size() / batch_seconds / 1e6);
+		}
+
+	}
+}
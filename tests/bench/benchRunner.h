@@ -0,0 +1,108 @@
+#ifndef GW2DATTOOLS_BENCH_BENCHRUNNER_H
+#define GW2DATTOOLS_BENCH_BENCHRUNNER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <iterator>
+
+namespace gw2dt
+{
+    namespace bench
+    {
+
+        struct BenchOptions
+        {
+            // Timed runs of every measure, the fastest one is kept
+            uint32_t repetitions_number = 5;
+            // Small inputs and a single run, only checks that every section still works
+            bool is_quick = false;
+        };
+
+        typedef void (*BenchFunction)(const BenchOptions &options);
+
+        struct BenchSection
+        {
+            const char *name_data;
+            BenchFunction bench_function;
+        };
+
+        // Best time of repetitions_number calls of measured_function, in seconds
+        template <typename Function>
+        double measure_best_seconds(const BenchOptions &options, Function &&measured_function)
+        {
+            double best_seconds = 0.0;
+            for (uint32_t repetition_index = 0; repetition_index < std::max(1u, options.repetitions_number); ++repetition_index)
+            {
+                const auto start_time = std::chrono::steady_clock::now();
+                measured_function();
+                const double elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+                if (repetition_index == 0 || elapsed_seconds < best_seconds)
+                {
+                    best_seconds = elapsed_seconds;
+                }
+            }
+            return best_seconds;
+        }
+
+        inline double megabytes_per_second(uint64_t bytes_number, double elapsed_seconds)
+        {
+            return elapsed_seconds > 0.0 ? bytes_number / elapsed_seconds / 1e6 : 0.0;
+        }
+
+        // Runs the sections named on the command line, every section if none is named
+        // --quick runs them on small inputs, --repetitions N changes the number of timed runs
+        inline int run_benches(int argc, char **argv, std::initializer_list<BenchSection> bench_sections)
+        {
+            BenchOptions options;
+            size_t names_number = 0;
+            const char *section_names[64];
+            for (int argument_index = 1; argument_index < argc; ++argument_index)
+            {
+                if (std::strcmp(argv[argument_index], "--quick") == 0)
+                {
+                    options.is_quick = true;
+                    options.repetitions_number = 1;
+                }
+                else if (std::strcmp(argv[argument_index], "--repetitions") == 0 && argument_index + 1 < argc)
+                {
+                    options.repetitions_number = static_cast<uint32_t>(std::strtoul(argv[++argument_index], nullptr, 10));
+                }
+                else if (names_number < std::size(section_names))
+                {
+                    section_names[names_number++] = argv[argument_index];
+                }
+            }
+
+            int failed_number = 0;
+            for (const BenchSection &bench_section : bench_sections)
+            {
+                if (names_number != 0 && std::none_of(section_names, section_names + names_number, [&bench_section](const char *section_name)
+                                                      { return std::strcmp(section_name, bench_section.name_data) == 0; }))
+                {
+                    continue;
+                }
+
+                std::printf("== %s\n", bench_section.name_data);
+                try
+                {
+                    bench_section.bench_function(options);
+                }
+                catch (const std::exception &exception_data)
+                {
+                    std::printf("[FAIL] %s: %s\n", bench_section.name_data, exception_data.what());
+                    ++failed_number;
+                }
+            }
+            return failed_number == 0 ? 0 : 1;
+        }
+
+    }
+}
+
+#endif // GW2DATTOOLS_BENCH_BENCHRUNNER_H
@@ -0,0 +1,35 @@
+#ifndef GW2DATTOOLS_BENCH_BENCHSECTIONS_H
+#define GW2DATTOOLS_BENCH_BENCHSECTIONS_H
+
+#include "benchRunner.h"
+
+namespace gw2dt
+{
+    namespace bench
+    {
+
+        // Dat entries of literal heavy and copy heavy corpora, output bytes per second
+        void bench_dat_huffman(const BenchOptions &options);
+
+        // Copy heavy dat entries, time per copy code
+        void bench_dat_copies(const BenchOptions &options);
+
+        // One big texture decoded by TextureTileDecoder with 1 to one thread per hardware thread
+        void bench_texture_tiles(const BenchOptions &options);
+
+        // Texture files of every format, inflated block bytes per second
+        void bench_texture_formats(const BenchOptions &options);
+
+        // Thumbnails of every format, make_texture_thumbnail against a full decode and a box filter
+        void bench_texture_thumbnails(const BenchOptions &options);
+
+        // A dat entry and a texture file, input bytes per second of the shared bit reader
+        void bench_bit_reader(const BenchOptions &options);
+
+        // File id lookups, FileIdIndex against std::unordered_map
+        void bench_file_id_index(const BenchOptions &options);
+
+    }
+}
+
+#endif // GW2DATTOOLS_BENCH_BENCHSECTIONS_H
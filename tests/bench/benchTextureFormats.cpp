@@ -0,0 +1,39 @@
+#include "foundation/gw2dattools/inflateTextureFileBuffer.h"
+
+#include <vector>
+
+#include "benchSections.h"
+#include "encodeTextureFile.h"
+#include "testCheck.h"
+
+namespace gw2dt
+{
+	namespace bench
+	{
+
+		void bench_texture_formats(const BenchOptions &options)
+		{
+			const uint16_t image_size = options.is_quick ? 256 : 2048;
+			std::printf("%ux%u, color, alpha and run passes\n", image_size, image_size);
+
+			for (uint32_t format_four_cc : testing::TEXTURE_FORMATS)
+			{
+				// BC6H and BC7X runs go through the BPTC passes
+				const bool is_bptc = format_four_cc == 0x48364342 || format_four_cc == 0x58374342;
+				const uint32_t compression_flags = is_bptc ? 0x01 | 0x10 | 0x20 : 0x01 | 0x02 | 0x04 | 0x08;
+				const std::vector<uint8_t> texture_file = testing::encode_texture_file(format_four_cc, image_size, image_size, compression_flags, 4);
+
+				compression::AnetImage anet_image;
+				std::vector<uint8_t> output_data(compression::probe_texture_file(texture_file, anet_image));
+				uint32_t output_size = 0;
+				const double elapsed_seconds = measure_best_seconds(options, [&]()
+																	{ output_size = compression::inflate_texture_file_buffer(texture_file, output_data, anet_image); });
+				GW2DT_CHECK(output_size == output_data.size());
+
+				std::printf("%.4s %8.2f MB in %8.2f MB out %9.2f ms %9.1f MB/s\n", reinterpret_cast<const char *>(&format_four_cc), texture_file.size() / 1e6,
+							output_size / 1e6, elapsed_seconds * 1e3, megabytes_per_second(output_size, elapsed_seconds));
+			}
+		}
+
+	}
+}
@@ -0,0 +1,145 @@
+#include "foundation/gw2dattools/decodeTextureBlocks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "benchSections.h"
+#include "encodeTextureFile.h"
+#include "testCheck.h"
+
+namespace gw2dt
+{
+	namespace bench
+	{
+		namespace
+		{
+			// Positive half floats of the BC6H output, clamped to 1 like the thumbnails
+			float clamped_half_to_float(uint16_t half_data)
+			{
+				const int32_t exponent_data = half_data >> 10;
+				const float value_data = exponent_data == 0 ? std::ldexp(static_cast<float>(half_data & 0x3FF), -24)
+															: std::ldexp(static_cast<float>((half_data & 0x3FF) | 0x400), exponent_data - 25);
+				return std::min(value_data, 1.0f);
+			}
+
+			// Box filter of a decoded image, every thumbnail pixel is the mean of the pixels it covers
+			// 8 bits channels are summed as integers, the half floats of BC6H as floats
+			template <typename SumType, uint32_t PIXEL_SIZE>
+			void box_filter(const uint8_t *decoded_data, uint32_t width, uint32_t height, uint32_t thumbnail_width, uint32_t thumbnail_height, uint8_t *output_data)
+			{
+				std::vector<uint32_t> column_ranges(thumbnail_width + 1);
+				for (uint32_t thumbnail_column = 0; thumbnail_column <= thumbnail_width; ++thumbnail_column)
+				{
+					column_ranges[thumbnail_column] = static_cast<uint32_t>(static_cast<uint64_t>(thumbnail_column) * width / thumbnail_width);
+				}
+
+				std::vector<SumType> sums_data(static_cast<size_t>(thumbnail_width) * 4);
+				for (uint32_t thumbnail_row = 0; thumbnail_row < thumbnail_height; ++thumbnail_row)
+				{
+					const uint32_t begin_row = static_cast<uint32_t>(static_cast<uint64_t>(thumbnail_row) * height / thumbnail_height);
+					const uint32_t end_row = std::max(begin_row + 1, static_cast<uint32_t>(static_cast<uint64_t>(thumbnail_row + 1) * height / thumbnail_height));
+
+					std::fill(sums_data.begin(), sums_data.end(), SumType(0));
+					for (uint32_t row_index = begin_row; row_index < end_row; ++row_index)
+					{
+						const uint8_t *row_data = decoded_data + static_cast<size_t>(row_index) * width * PIXEL_SIZE;
+						for (uint32_t thumbnail_column = 0; thumbnail_column < thumbnail_width; ++thumbnail_column)
+						{
+							SumType *sum_data = &sums_data[4 * thumbnail_column];
+							const uint32_t end_column = std::max(column_ranges[thumbnail_column] + 1, column_ranges[thumbnail_column + 1]);
+							for (uint32_t column_index = column_ranges[thumbnail_column]; column_index < end_column; ++column_index)
+							{
+								const uint8_t *pixel_data = row_data + static_cast<size_t>(column_index) * PIXEL_SIZE;
+								for (uint32_t channel_index = 0; channel_index < 4; ++channel_index)
+								{
+									if constexpr (PIXEL_SIZE == 8)
+									{
+										uint16_t half_data;
+										memcpy(&half_data, pixel_data + 2 * channel_index, sizeof(half_data));
+										sum_data[channel_index] += clamped_half_to_float(half_data) * 255.0f;
+									}
+									else
+									{
+										sum_data[channel_index] += pixel_data[channel_index];
+									}
+								}
+							}
+						}
+					}
+
+					uint8_t *pixel_data = output_data + static_cast<size_t>(thumbnail_row) * thumbnail_width * 4;
+					for (uint32_t thumbnail_column = 0; thumbnail_column < thumbnail_width; ++thumbnail_column)
+					{
+						const uint32_t begin_column = column_ranges[thumbnail_column];
+						const SumType pixels_number = static_cast<SumType>((end_row - begin_row) * (std::max(begin_column + 1, column_ranges[thumbnail_column + 1]) - begin_column));
+						for (uint32_t channel_index = 0; channel_index < 4; ++channel_index)
+						{
+							const SumType sum_data = sums_data[4 * thumbnail_column + channel_index];
+							if constexpr (PIXEL_SIZE == 8)
+							{
+								pixel_data[4 * thumbnail_column + channel_index] = static_cast<uint8_t>(std::min(sum_data / pixels_number + 0.5f, 255.0f));
+							}
+							else
+							{
+								pixel_data[4 * thumbnail_column + channel_index] = static_cast<uint8_t>((sum_data + pixels_number / 2) / pixels_number);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		void bench_texture_thumbnails(const BenchOptions &options)
+		{
+			const uint16_t image_size = options.is_quick ? 512 : 4096;
+			const uint32_t max_size = options.is_quick ? 64 : 256;
+			std::printf("%ux%u random blocks to %ux%u, full decode and box filter against block endpoints\n", image_size, image_size, max_size, max_size);
+
+			for (uint32_t format_four_cc : testing::TEXTURE_FORMATS)
+			{
+				const std::vector<uint8_t> texture_file = testing::encode_texture_file(format_four_cc, image_size, image_size, 0, 6);
+				compression::AnetImage anet_image;
+				const utils::PooledBuffer block_data = compression::inflate_texture_file_buffer(texture_file, utils::BufferPool::shared_pool(), anet_image);
+
+				uint32_t thumbnail_width = 0;
+				uint32_t thumbnail_height = 0;
+				compression::get_texture_thumbnail_dimensions(anet_image, max_size, thumbnail_width, thumbnail_height);
+				const uint32_t thumbnail_size = thumbnail_width * thumbnail_height * 4;
+
+				std::vector<uint8_t> decoded_data(compression::get_decoded_texture_size(anet_image));
+				std::vector<uint8_t> filtered_data(thumbnail_size);
+				const double decode_seconds = measure_best_seconds(options, [&]()
+																   {
+					compression::decode_texture_blocks(anet_image, block_data.span(), decoded_data);
+					if (compression::get_decoded_pixel_size(format_four_cc) == 8)
+					{
+						box_filter<float, 8>(decoded_data.data(), anet_image.width, anet_image.height, thumbnail_width, thumbnail_height, filtered_data.data());
+					}
+					else
+					{
+						box_filter<uint32_t, 4>(decoded_data.data(), anet_image.width, anet_image.height, thumbnail_width, thumbnail_height, filtered_data.data());
+					} });
+
+				std::vector<uint8_t> thumbnail_data(thumbnail_size);
+				uint32_t output_size = 0;
+				const double thumbnail_seconds = measure_best_seconds(options, [&]()
+																	  { output_size = compression::make_texture_thumbnail(anet_image, block_data.span(), thumbnail_width, thumbnail_height, thumbnail_data); });
+				GW2DT_CHECK(output_size == thumbnail_size);
+
+				// Distance to the exact thumbnail, the endpoints only approximate the texels
+				uint64_t error_sum = 0;
+				for (uint32_t byte_index = 0; byte_index < thumbnail_size; ++byte_index)
+				{
+					error_sum += static_cast<uint32_t>(std::abs(thumbnail_data[byte_index] - filtered_data[byte_index]));
+				}
+
+				std::printf("%.4s decode %9.2f ms endpoints %8.2f ms x%5.1f mean error %5.2f\n", reinterpret_cast<const char *>(&format_four_cc),
+							decode_seconds * 1e3, thumbnail_seconds * 1e3, thumbnail_seconds > 0.0 ? decode_seconds / thumbnail_seconds : 0.0,
+							static_cast<double>(error_sum) / thumbnail_size);
+			}
+		}
+
+	}
+}
@@ -0,0 +1,53 @@
+#include "foundation/gw2dattools/decodeTextureTiles.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "benchSections.h"
+#include "encodeTextureFile.h"
+#include "testCheck.h"
+
+namespace gw2dt
+{
+	namespace bench
+	{
+
+		void bench_texture_tiles(const BenchOptions &options)
+		{
+			const uint32_t format_four_ccs[] = {0x31545844, 0x35545844}; // "DXT1", "DXT5"
+			const uint16_t image_size = options.is_quick ? 1024 : 8192;
+			const uint32_t max_threads_number = std::max(1u, std::thread::hardware_concurrency());
+
+			for (uint32_t format_four_cc : format_four_ccs)
+			{
+				const std::vector<uint8_t> texture_file = testing::encode_texture_file(format_four_cc, image_size, image_size, 0, 3);
+				compression::AnetImage anet_image;
+				const utils::PooledBuffer block_data = compression::inflate_texture_file_buffer(texture_file, utils::BufferPool::shared_pool(), anet_image);
+
+				std::vector<uint8_t> expected_output(compression::get_decoded_texture_size(anet_image));
+				compression::decode_texture_block_rows(anet_image, block_data.span(), 0, compression::get_texture_block_rows(anet_image), expected_output);
+
+				std::printf("%.4s %ux%u\n", reinterpret_cast<const char *>(&format_four_cc), image_size, image_size);
+				std::vector<uint8_t> output_data(expected_output.size());
+				double single_seconds = 0.0;
+				for (uint32_t threads_number = 1; threads_number <= max_threads_number; ++threads_number)
+				{
+					compression::TextureTileDecoder tile_decoder(threads_number);
+					compression::TextureTileStatistics statistics_data;
+					const double elapsed_seconds = measure_best_seconds(options, [&]()
+																		{ tile_decoder.decode(anet_image, block_data.span(), output_data, compression::TextureDecodeKernel::Automatic, &statistics_data); });
+					GW2DT_CHECK(output_data == expected_output);
+
+					if (threads_number == 1)
+					{
+						single_seconds = elapsed_seconds;
+					}
+					std::printf("  %3u threads %4u strips %9.2f ms %9.1f Mpixels/s x%.2f\n", threads_number, statistics_data.strips_number, elapsed_seconds * 1e3,
+								statistics_data.pixels_number / elapsed_seconds / 1e6, elapsed_seconds > 0.0 ? single_seconds / elapsed_seconds : 0.0);
+				}
+			}
+		}
+
+	}
+}
@@ -0,0 +1,16 @@
+#include "benchSections.h"
+
+using namespace gw2dt;
+
+int main(int argc, char **argv)
+{
+	return bench::run_benches(argc, argv, {
+		{"dat_huffman", bench::bench_dat_huffman},
+		{"dat_copies", bench::bench_dat_copies},
+		{"texture_tiles", bench::bench_texture_tiles},
+		{"texture_formats", bench::bench_texture_formats},
+		{"texture_thumbnails", bench::bench_texture_thumbnails},
+		{"bit_reader", bench::bench_bit_reader},
+		{"file_id_index", bench::bench_file_id_index},
+	});
+}
@@ -0,0 +1,172 @@
+#include "foundation/gw2dattools/DatArchiveIndex.h"
+
+#include <chrono>
+#include <vector>
+
+#include "encodeDatFile.h"
+#include "testCheck.h"
+#include "writeDatArchive.h"
+
+using namespace gw2dt;
+
+namespace
+{
+	const std::filesystem::path &archive_path()
+	{
+		static const std::filesystem::path path_data = std::filesystem::temp_directory_path() / "gw2dattools_datArchiveIndexTest.dat";
+		return path_data;
+	}
+
+	const std::filesystem::path &index_path()
+	{
+		static const std::filesystem::path path_data = std::filesystem::temp_directory_path() / "gw2dattools_datArchiveIndexTest.idx";
+		return path_data;
+	}
+
+	// A stored file, a compressed one listed under two ids and a file without id
+	std::vector<uint8_t> make_archive_data(uint32_t crc_data)
+	{
+		const testing::DatArchiveFile files[] = {
+			{testing::make_dat_corpus(testing::DAT_CORPUS_RANDOM, 4000, 1), false, {7}},
+			{testing::make_dat_corpus(testing::DAT_CORPUS_TEXT, 50000, 2), true, {12, 40}},
+			{testing::make_dat_corpus(testing::DAT_CORPUS_VERTICES, 2000, 3), false, {}},
+			{testing::make_dat_corpus(testing::DAT_CORPUS_ZEROS, 30000, 4), true, {25}}};
+		return testing::make_dat_archive(files, crc_data);
+	}
+
+	// Writes the archive with the modification time of the previous one, only the data changes
+	void rewrite_archive(std::span<const uint8_t> archive_data, std::filesystem::file_time_type write_time)
+	{
+		testing::write_test_file(archive_path(), archive_data);
+		std::filesystem::last_write_time(archive_path(), write_time);
+	}
+
+	bool index_matches()
+	{
+		const archive::DatArchive archive(archive_path());
+		return archive::DatArchiveIndex(index_path()).matches(archive);
+	}
+
+	void test_index_round_trip()
+	{
+		testing::write_test_file(archive_path(), make_archive_data(0x1111));
+		const archive::DatArchive archive(archive_path());
+
+		const std::vector<archive::DatArchiveIndexEntry> built_entries = archive::build_dat_archive_index_entries(archive);
+		archive::write_dat_archive_index(index_path(), archive, built_entries);
+		const archive::DatArchiveIndex index(index_path());
+		GW2DT_CHECK(index.matches(archive));
+
+		// Every entry as the archive reads it, the uncompressed size only known for the stored ones
+		GW2DT_CHECK(index.entries_count() == archive.entries_count() && index.entries().size() == archive.entries_count());
+		for (uint32_t entry_index = 1; entry_index < archive.entries_count(); ++entry_index)
+		{
+			const archive::DatArchiveIndexEntry &index_entry = index.entries()[entry_index];
+			const archive::DatArchiveEntry entry_info = archive.entry(entry_index);
+			const archive::DatArchiveFileIds file_ids = archive.file_ids(entry_index);
+			GW2DT_CHECK(index_entry.offset == entry_info.offset && index_entry.size == entry_info.size);
+			GW2DT_CHECK(index_entry.compression_flag == entry_info.compression_flag);
+			GW2DT_CHECK(index_entry.base_id == file_ids.base_id && index_entry.file_id == file_ids.file_id);
+			GW2DT_CHECK(index_entry.has_uncompressed_size() == !entry_info.is_compressed());
+			GW2DT_CHECK(!index_entry.has_uncompressed_size() || index_entry.uncompressed_size == archive.uncompressed_size(entry_index));
+			GW2DT_CHECK(!index_entry.has_four_cc());
+		}
+
+		// Both ids of the entry listed twice, and ids listed nowhere
+		GW2DT_CHECK(index.file_ids_count() == archive.file_ids_count());
+		for (uint32_t file_id = 0; file_id < 50; ++file_id)
+		{
+			GW2DT_CHECK(index.find_entry(file_id) == archive.find_entry(file_id));
+		}
+		GW2DT_CHECK(index.find_entry(40) == testing::DAT_ARCHIVE_FIRST_FILE_ENTRY + 1 && index.find_entry(0xFFFFFFFF) == 0);
+
+		// The entries have to be those of the archive
+		bool is_thrown = false;
+		try
+		{
+			archive::write_dat_archive_index(index_path(), archive, std::span(built_entries).first(built_entries.size() - 1));
+		}
+		catch (const std::exception &)
+		{
+			is_thrown = true;
+		}
+		GW2DT_CHECK(is_thrown);
+	}
+
+	void test_stale_index()
+	{
+		const std::vector<uint8_t> archive_data = make_archive_data(0x2222);
+		testing::write_test_file(archive_path(), archive_data);
+		{
+			const archive::DatArchive archive(archive_path());
+			archive::write_dat_archive_index(index_path(), archive, archive::build_dat_archive_index_entries(archive));
+		}
+		const std::filesystem::file_time_type write_time = std::filesystem::last_write_time(archive_path());
+
+		// Same data and time
+		rewrite_archive(archive_data, write_time);
+		GW2DT_CHECK(index_matches());
+
+		// Bigger archive
+		std::vector<uint8_t> bigger_data = archive_data;
+		bigger_data.push_back(0);
+		rewrite_archive(bigger_data, write_time);
+		GW2DT_CHECK(!index_matches());
+
+		// Newer archive
+		rewrite_archive(archive_data, write_time + std::chrono::seconds(2));
+		GW2DT_CHECK(!index_matches());
+
+		// Another header CRC
+		std::vector<uint8_t> other_crc = archive_data;
+		other_crc[testing::DAT_ARCHIVE_CRC_OFFSET] ^= 0xFF;
+		rewrite_archive(other_crc, write_time);
+		GW2DT_CHECK(!index_matches());
+
+		rewrite_archive(archive_data, write_time);
+		GW2DT_CHECK(index_matches());
+	}
+
+	void test_invalid_index()
+	{
+		for (size_t index_size : {size_t(0), size_t(63)})
+		{
+			testing::write_test_file(index_path(), std::vector<uint8_t>(index_size, 0));
+			bool is_refused = false;
+			try
+			{
+				archive::DatArchiveIndex index(index_path());
+			}
+			catch (const std::exception &)
+			{
+				is_refused = true;
+			}
+			GW2DT_CHECK(is_refused);
+		}
+
+		// An archive is not an index
+		testing::write_test_file(index_path(), make_archive_data(0));
+		bool is_refused = false;
+		try
+		{
+			archive::DatArchiveIndex index(index_path());
+		}
+		catch (const std::exception &)
+		{
+			is_refused = true;
+		}
+		GW2DT_CHECK(is_refused);
+
+		std::filesystem::remove(archive_path());
+		std::filesystem::remove(index_path());
+	}
+}
+
+int main()
+{
+	return testing::run_tests({
+		{"index_round_trip", test_index_round_trip},
+		{"stale_index", test_stale_index},
+		{"invalid_index", test_invalid_index},
+	});
+}
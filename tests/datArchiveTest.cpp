@@ -0,0 +1,188 @@
+#include "foundation/gw2dattools/DatArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "encodeDatFile.h"
+#include "testCheck.h"
+#include "writeDatArchive.h"
+
+using namespace gw2dt;
+
+namespace
+{
+	// A stored file, two compressed ones, one of them listed under two ids, and a file without id
+	struct ArchiveCorpus
+	{
+		std::vector<testing::DatArchiveFile> files;
+		std::vector<uint8_t> archive_data;
+
+		ArchiveCorpus()
+		{
+			files.push_back({testing::make_dat_corpus(testing::DAT_CORPUS_RANDOM, 5000, 1), false, {10}});
+			files.push_back({testing::make_dat_corpus(testing::DAT_CORPUS_TEXT, 200000, 2), true, {35, 20}});
+			files.push_back({testing::make_dat_corpus(testing::DAT_CORPUS_ZEROS, 70000, 3), true, {30}});
+			files.push_back({testing::make_dat_corpus(testing::DAT_CORPUS_VERTICES, 3000, 4), false, {}});
+			archive_data = testing::make_dat_archive(files, 0x12345678);
+		}
+	};
+
+	const ArchiveCorpus &archive_corpus()
+	{
+		static const ArchiveCorpus corpus;
+		return corpus;
+	}
+
+	const std::filesystem::path &archive_path()
+	{
+		static const std::filesystem::path path_data = std::filesystem::temp_directory_path() / "gw2dattools_datArchiveTest.dat";
+		return path_data;
+	}
+
+	bool is_refused(const std::vector<uint8_t> &archive_data)
+	{
+		testing::write_test_file(archive_path(), archive_data);
+		try
+		{
+			archive::DatArchive archive(archive_path());
+		}
+		catch (const std::exception &)
+		{
+			return true;
+		}
+		return false;
+	}
+
+	void test_entries()
+	{
+		const ArchiveCorpus &corpus = archive_corpus();
+		testing::write_test_file(archive_path(), corpus.archive_data);
+		archive::DatArchive archive(archive_path());
+
+		GW2DT_CHECK(archive.archive_size() == corpus.archive_data.size());
+		GW2DT_CHECK(archive.header().version == 0x97 && archive.header().header_size == archive::DAT_ARCHIVE_HEADER_SIZE);
+		GW2DT_CHECK(archive.header().crc_data == 0x12345678);
+		GW2DT_CHECK(archive.entries_count() == testing::DAT_ARCHIVE_FIRST_FILE_ENTRY + corpus.files.size());
+
+		// The file id table is an entry like the files, four ids and an unused pair
+		const archive::DatArchiveEntry table_entry = archive.entry(archive::DAT_ARCHIVE_FILE_ID_TABLE_ENTRY);
+		GW2DT_CHECK(!table_entry.is_compressed() && table_entry.size == 5 * 8);
+
+		for (size_t file_index = 0; file_index < corpus.files.size(); ++file_index)
+		{
+			const testing::DatArchiveFile &file = corpus.files[file_index];
+			const uint32_t entry_index = testing::DAT_ARCHIVE_FIRST_FILE_ENTRY + static_cast<uint32_t>(file_index);
+			const archive::DatArchiveEntry entry_info = archive.entry(entry_index);
+			GW2DT_CHECK(entry_info.is_compressed() == file.is_compressed);
+			GW2DT_CHECK(file.is_compressed ? entry_info.size < file.file_data.size() : entry_info.size == file.file_data.size());
+			GW2DT_CHECK(entry_info.offset + entry_info.size <= archive.archive_size());
+			GW2DT_CHECK(archive.entry_data(entry_index).size() == entry_info.size);
+			GW2DT_CHECK(archive.uncompressed_size(entry_index) == file.file_data.size());
+		}
+
+		// Number 0 is the MFT header
+		for (uint32_t entry_index : {0u, archive.entries_count(), 0xFFFFFFFFu})
+		{
+			bool is_thrown = false;
+			try
+			{
+				archive.entry(entry_index);
+			}
+			catch (const std::exception &)
+			{
+				is_thrown = true;
+			}
+			GW2DT_CHECK(is_thrown);
+		}
+	}
+
+	void test_read_entry()
+	{
+		const ArchiveCorpus &corpus = archive_corpus();
+		testing::write_test_file(archive_path(), corpus.archive_data);
+		archive::DatArchive archive(archive_path());
+		utils::BufferPool buffer_pool;
+
+		for (size_t file_index = 0; file_index < corpus.files.size(); ++file_index)
+		{
+			const std::vector<uint8_t> &file_data = corpus.files[file_index].file_data;
+			const uint32_t entry_index = testing::DAT_ARCHIVE_FIRST_FILE_ENTRY + static_cast<uint32_t>(file_index);
+
+			// Caller buffer, bigger than the file then smaller
+			std::vector<uint8_t> output_data(file_data.size() + 100, 0xCD);
+			GW2DT_CHECK(archive.read_entry(entry_index, output_data) == file_data.size());
+			GW2DT_CHECK(std::equal(file_data.begin(), file_data.end(), output_data.begin()));
+			GW2DT_CHECK(output_data.back() == 0xCD);
+
+			const uint32_t partial_size = static_cast<uint32_t>(file_data.size() / 3);
+			std::vector<uint8_t> partial_data(partial_size);
+			GW2DT_CHECK(archive.read_entry(entry_index, partial_data) == partial_size);
+			GW2DT_CHECK(std::equal(partial_data.begin(), partial_data.end(), file_data.begin()));
+
+			// Pooled buffer, whole then cut at output_data_size
+			const utils::PooledBuffer pooled_data = archive.read_entry(entry_index, buffer_pool);
+			GW2DT_CHECK(pooled_data.size() == file_data.size() && memcmp(pooled_data.data(), file_data.data(), file_data.size()) == 0);
+
+			const utils::PooledBuffer cut_data = archive.read_entry(entry_index, buffer_pool, partial_size);
+			GW2DT_CHECK(cut_data.size() == partial_size && memcmp(cut_data.data(), file_data.data(), partial_size) == 0);
+		}
+	}
+
+	void test_file_ids()
+	{
+		const ArchiveCorpus &corpus = archive_corpus();
+		testing::write_test_file(archive_path(), corpus.archive_data);
+		archive::DatArchive archive(archive_path());
+		const uint32_t first_entry = testing::DAT_ARCHIVE_FIRST_FILE_ENTRY;
+
+		GW2DT_CHECK(archive.file_ids_count() == 4);
+		GW2DT_CHECK(archive.find_entry(10) == first_entry);
+		GW2DT_CHECK(archive.find_entry(20) == first_entry + 1);
+		GW2DT_CHECK(archive.find_entry(35) == first_entry + 1);
+		GW2DT_CHECK(archive.find_entry(30) == first_entry + 2);
+		GW2DT_CHECK(archive.find_entry(0) == 0 && archive.find_entry(11) == 0 && archive.find_entry(0xFFFFFFFF) == 0);
+
+		const std::vector<uint32_t> file_ids = {30, 99, 35, 10, 20};
+		std::vector<uint32_t> entry_indices(file_ids.size());
+		archive.find_entries(file_ids, entry_indices);
+		GW2DT_CHECK((entry_indices == std::vector<uint32_t>{first_entry + 2, 0, first_entry + 1, first_entry, first_entry + 1}));
+
+		// The entry listed twice has its smaller id as base id
+		GW2DT_CHECK(archive.file_ids(first_entry).base_id == 10 && archive.file_ids(first_entry).file_id == 10);
+		GW2DT_CHECK(archive.file_ids(first_entry + 1).base_id == 20 && archive.file_ids(first_entry + 1).file_id == 35);
+		GW2DT_CHECK(archive.file_ids(first_entry + 3).base_id == 0 && archive.file_ids(first_entry + 3).file_id == 0);
+	}
+
+	void test_invalid_archives()
+	{
+		const std::vector<uint8_t> &archive_data = archive_corpus().archive_data;
+
+		// MFT size too small for its entries
+		std::vector<uint8_t> truncated_mft = archive_data;
+		const uint32_t mft_size = 2 * archive::DAT_ARCHIVE_MFT_ENTRY_SIZE;
+		memcpy(truncated_mft.data() + testing::DAT_ARCHIVE_MFT_SIZE_OFFSET, &mft_size, sizeof(mft_size));
+		GW2DT_CHECK(is_refused(truncated_mft));
+
+		// MFT past the end of the file
+		GW2DT_CHECK(is_refused(std::vector<uint8_t>(archive_data.begin(), archive_data.end() - 1)));
+
+		// Not a dat archive
+		std::vector<uint8_t> foreign_data = archive_data;
+		foreign_data[1] = 'X';
+		GW2DT_CHECK(is_refused(foreign_data));
+		GW2DT_CHECK(is_refused(std::vector<uint8_t>(archive_data.begin(), archive_data.begin() + 20)));
+
+		std::filesystem::remove(archive_path());
+	}
+}
+
+int main()
+{
+	return testing::run_tests({
+		{"entries", test_entries},
+		{"read_entry", test_read_entry},
+		{"file_ids", test_file_ids},
+		{"invalid_archives", test_invalid_archives},
+	});
+}
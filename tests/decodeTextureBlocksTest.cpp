@@ -0,0 +1,961 @@
+#include "foundation/gw2dattools/decodeTextureBlocks.h"
+
+#include <algorithm>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "testCheck.h"
+
+using namespace gw2dt;
+
+namespace
+{
+	const uint32_t FOURCC_DXT1 = 0x31545844;
+	const uint32_t FOURCC_DXT2 = 0x32545844;
+	const uint32_t FOURCC_DXT3 = 0x33545844;
+	const uint32_t FOURCC_DXT4 = 0x34545844;
+	const uint32_t FOURCC_DXT5 = 0x35545844;
+	const uint32_t FOURCC_DXTA = 0x41545844;
+	const uint32_t FOURCC_DXTL = 0x4C545844;
+	const uint32_t FOURCC_DXTN = 0x4E545844;
+	const uint32_t FOURCC_3DCX = 0x58434433;
+	const uint32_t FOURCC_BC6H = 0x48364342;
+	const uint32_t FOURCC_BC7X = 0x58374342;
+
+	const compression::TextureDecodeKernel DECODE_KERNELS[] = {compression::TextureDecodeKernel::Automatic, compression::TextureDecodeKernel::Scalar,
+															   compression::TextureDecodeKernel::SSE2, compression::TextureDecodeKernel::AVX2};
+	const char *const KERNEL_NAMES[] = {"Automatic", "Scalar", "SSE2", "AVX2"};
+
+	// One block and the 16 pixels it decodes to, row by row
+	struct BlockCase
+	{
+		const char *name_data;
+		uint32_t format_four_cc;
+		std::vector<uint8_t> block_data;
+		std::vector<uint8_t> pixels_data;
+	};
+
+	void append_pixel(std::vector<uint8_t> &pixels_data, uint32_t red, uint32_t green, uint32_t blue, uint32_t alpha)
+	{
+		pixels_data.insert(pixels_data.end(), {static_cast<uint8_t>(red), static_cast<uint8_t>(green), static_cast<uint8_t>(blue), static_cast<uint8_t>(alpha)});
+	}
+
+	// Straight alpha from premultiplied alpha, rounded to the nearest, transparent pixels are kept as they are
+	uint32_t unpremultiply(uint32_t channel_data, uint32_t alpha_data)
+	{
+		return alpha_data == 0 ? channel_data : std::min(255u, (2 * channel_data * 255 + alpha_data) / (2 * alpha_data));
+	}
+
+	compression::AnetImage make_image(uint32_t format_four_cc, uint16_t width, uint16_t height)
+	{
+		compression::AnetImage anet_image = {};
+		anet_image.format = format_four_cc;
+		anet_image.width = width;
+		anet_image.height = height;
+		anet_image.levels_number = 1;
+		return anet_image;
+	}
+
+	// Decodes with every kernel of this CPU, compares every byte and checks that nothing is written past the image
+	void check_decoded_image(const std::string &case_name, const compression::AnetImage &anet_image, const std::vector<uint8_t> &block_data,
+							 const std::vector<uint8_t> &expected_data)
+	{
+		const uint8_t GUARD_VALUE = 0xCD;
+		for (size_t kernel_index = 0; kernel_index < std::size(DECODE_KERNELS); ++kernel_index)
+		{
+			if (!compression::is_texture_decode_kernel_supported(DECODE_KERNELS[kernel_index]))
+			{
+				continue;
+			}
+
+			std::vector<uint8_t> output_data(expected_data.size() + 64, GUARD_VALUE);
+			const uint32_t output_size = compression::decode_texture_blocks(anet_image, block_data, output_data, DECODE_KERNELS[kernel_index]);
+
+			const std::string case_text = case_name + " " + std::to_string(anet_image.width) + "x" + std::to_string(anet_image.height) + " " + KERNEL_NAMES[kernel_index];
+			if (output_size != expected_data.size())
+			{
+				throw std::runtime_error(case_text + ": decoded size " + std::to_string(output_size));
+			}
+			const auto mismatch_it = std::mismatch(expected_data.begin(), expected_data.end(), output_data.begin());
+			if (mismatch_it.first != expected_data.end())
+			{
+				throw std::runtime_error(case_text + ": byte " + std::to_string(mismatch_it.first - expected_data.begin()) + " is " +
+										 std::to_string(*mismatch_it.second) + ", expected " + std::to_string(*mismatch_it.first));
+			}
+			if (std::any_of(output_data.begin() + output_size, output_data.end(), [](uint8_t value_data)
+							{ return value_data != GUARD_VALUE; }))
+			{
+				throw std::runtime_error(case_text + ": written past the image");
+			}
+		}
+	}
+
+	// The block alone, then repeated over images whose right and bottom blocks are partial
+	void check_block_case(const BlockCase &block_case)
+	{
+		const uint32_t pixel_size = compression::get_decoded_pixel_size(block_case.format_four_cc);
+		GW2DT_CHECK(block_case.pixels_data.size() == 16 * pixel_size);
+
+		const uint16_t image_sizes[][2] = {{4, 4}, {1, 1}, {3, 2}, {6, 5}, {9, 7}, {4, 13}};
+		for (const uint16_t *image_size : image_sizes)
+		{
+			const compression::AnetImage anet_image = make_image(block_case.format_four_cc, image_size[0], image_size[1]);
+			const uint32_t blocks_number = ((image_size[0] + 3) / 4) * ((image_size[1] + 3) / 4);
+
+			std::vector<uint8_t> block_data;
+			for (uint32_t block_index = 0; block_index < blocks_number; ++block_index)
+			{
+				block_data.insert(block_data.end(), block_case.block_data.begin(), block_case.block_data.end());
+			}
+
+			std::vector<uint8_t> expected_data;
+			for (uint32_t y_position = 0; y_position < image_size[1]; ++y_position)
+			{
+				for (uint32_t x_position = 0; x_position < image_size[0]; ++x_position)
+				{
+					const auto pixel_it = block_case.pixels_data.begin() + (4 * (y_position % 4) + x_position % 4) * pixel_size;
+					expected_data.insert(expected_data.end(), pixel_it, pixel_it + pixel_size);
+				}
+			}
+
+			check_decoded_image(block_case.name_data, anet_image, block_data, expected_data);
+		}
+	}
+
+	// Indices of the color blocks, 2 bits per pixel from the lowest bits, one byte per row
+	// 0xE4 gives the indices 0, 1, 2, 3 and 0x1B the indices 3, 2, 1, 0
+	// Indices of the value blocks, 3 bits per pixel after the 2 values: 88 C6 FA 88 C6 FA gives i % 8 to the pixel i
+
+	std::vector<BlockCase> make_bc1_cases()
+	{
+		std::vector<BlockCase> block_cases;
+
+		// Red 0xF800 then blue 0x001F: color_0 > color_1, 4 colors, 5 bits expanded by copying the high bits
+		BlockCase four_colors = {"BC1 four colors", FOURCC_DXT1, {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0xFF, 0x00, 0x1B}, {}};
+		const uint8_t four_colors_palette[4][3] = {{255, 0, 0}, {0, 0, 255}, {170, 0, 85}, {85, 0, 170}};
+		const uint8_t rows_indices[4][4] = {{0, 1, 2, 3}, {3, 3, 3, 3}, {0, 0, 0, 0}, {3, 2, 1, 0}};
+		for (const uint8_t *row_indices : rows_indices)
+		{
+			for (uint32_t column_index = 0; column_index < 4; ++column_index)
+			{
+				const uint8_t *color_data = four_colors_palette[row_indices[column_index]];
+				append_pixel(four_colors.pixels_data, color_data[0], color_data[1], color_data[2], 255);
+			}
+		}
+		block_cases.push_back(four_colors);
+
+		// Blue then red: color_0 <= color_1, 3 colors and transparent black
+		BlockCase three_colors = {"BC1 three colors", FOURCC_DXT1, {0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xFF, 0x00, 0x1B}, {}};
+		const uint8_t three_colors_palette[4][4] = {{0, 0, 255, 255}, {255, 0, 0, 255}, {127, 0, 127, 255}, {0, 0, 0, 0}};
+		for (const uint8_t *row_indices : rows_indices)
+		{
+			for (uint32_t column_index = 0; column_index < 4; ++column_index)
+			{
+				const uint8_t *color_data = three_colors_palette[row_indices[column_index]];
+				append_pixel(three_colors.pixels_data, color_data[0], color_data[1], color_data[2], color_data[3]);
+			}
+		}
+		block_cases.push_back(three_colors);
+
+		// Equal colors are in the 3 colors mode too, 0x8410 is (16, 32, 16) expanded to (132, 130, 132)
+		BlockCase equal_colors = {"BC1 equal colors", FOURCC_DXT1, {0x10, 0x84, 0x10, 0x84, 0xE4, 0xE4, 0xE4, 0xE4}, {}};
+		const uint8_t equal_colors_palette[4][4] = {{132, 130, 132, 255}, {132, 130, 132, 255}, {132, 130, 132, 255}, {0, 0, 0, 0}};
+		for (uint32_t pixel_index = 0; pixel_index < 16; ++pixel_index)
+		{
+			const uint8_t *color_data = equal_colors_palette[pixel_index % 4];
+			append_pixel(equal_colors.pixels_data, color_data[0], color_data[1], color_data[2], color_data[3]);
+		}
+		block_cases.push_back(equal_colors);
+
+		return block_cases;
+	}
+
+	std::vector<BlockCase> make_bc2_cases()
+	{
+		std::vector<BlockCase> block_cases;
+
+		// Explicit alpha of 4 bits, pixel i has the alpha i * 0x11
+		// Black 0x0000 then 0x8410: color_0 < color_1 but BC2 always has 4 colors
+		const uint8_t color_palette[4][3] = {{0, 0, 0}, {132, 130, 132}, {44, 43, 44}, {88, 86, 88}};
+		BlockCase explicit_alpha = {"BC2 explicit alpha", FOURCC_DXT3,
+									{0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE, 0x00, 0x00, 0x10, 0x84, 0xE4, 0xE4, 0xE4, 0xE4}, {}};
+		for (uint32_t pixel_index = 0; pixel_index < 16; ++pixel_index)
+		{
+			const uint8_t *color_data = color_palette[pixel_index % 4];
+			append_pixel(explicit_alpha.pixels_data, color_data[0], color_data[1], color_data[2], pixel_index * 0x11);
+		}
+		block_cases.push_back(explicit_alpha);
+
+		// Same colors premultiplied: alpha 0x11 on the first row saturates, 0x88 on the next two, 0 on the last one keeps the colors
+		// 44 * 255 / 136 is 82.5, rounded up
+		BlockCase premultiplied_alpha = {"BC2 premultiplied alpha", FOURCC_DXT2,
+										 {0x11, 0x11, 0x88, 0x88, 0x88, 0x88, 0x00, 0x00, 0x00, 0x00, 0x10, 0x84, 0xE4, 0xE4, 0xE4, 0xE4}, {}};
+		const uint8_t rows_pixels[3][4][4] = {
+			{{0, 0, 0, 17}, {255, 255, 255, 17}, {255, 255, 255, 17}, {255, 255, 255, 17}},
+			{{0, 0, 0, 136}, {248, 244, 248, 136}, {83, 81, 83, 136}, {165, 161, 165, 136}},
+			{{0, 0, 0, 0}, {132, 130, 132, 0}, {44, 43, 44, 0}, {88, 86, 88, 0}},
+		};
+		for (uint32_t row_index = 0; row_index < 4; ++row_index)
+		{
+			for (const uint8_t *pixel_data : rows_pixels[row_index == 0 ? 0 : (row_index == 3 ? 2 : 1)])
+			{
+				append_pixel(premultiplied_alpha.pixels_data, pixel_data[0], pixel_data[1], pixel_data[2], pixel_data[3]);
+			}
+		}
+		block_cases.push_back(premultiplied_alpha);
+
+		return block_cases;
+	}
+
+	// The 8 values of 255 and 0, then the 6 values of 40 and 240 followed by 0 and 255
+	const uint8_t EIGHT_VALUES_PALETTE[8] = {255, 0, 218, 182, 145, 109, 72, 36};
+	const uint8_t SIX_VALUES_PALETTE[8] = {40, 240, 80, 120, 160, 200, 0, 255};
+
+	std::vector<BlockCase> make_bc3_cases()
+	{
+		std::vector<BlockCase> block_cases;
+
+		// Blue 0x001F then red 0xF800: BC3 has 4 colors even when color_0 < color_1
+		BlockCase interpolated_alpha = {"BC3 interpolated alpha", FOURCC_DXT5,
+										{0x28, 0xF0, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA, 0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xE4, 0xE4, 0xE4}, {}};
+		const uint8_t color_palette[4][3] = {{0, 0, 255}, {255, 0, 0}, {85, 0, 170}, {170, 0, 85}};
+		for (uint32_t pixel_index = 0; pixel_index < 16; ++pixel_index)
+		{
+			const uint8_t *color_data = color_palette[pixel_index % 4];
+			append_pixel(interpolated_alpha.pixels_data, color_data[0], color_data[1], color_data[2], SIX_VALUES_PALETTE[pixel_index % 8]);
+		}
+		block_cases.push_back(interpolated_alpha);
+
+		// Premultiplied, 0x8410 then black with the indices 3, 2, 1, 0 so that the transparent pixels are not black
+		BlockCase premultiplied_alpha = {"BC3 premultiplied alpha", FOURCC_DXT4,
+										 {0xFF, 0x00, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA, 0x10, 0x84, 0x00, 0x00, 0x1B, 0x1B, 0x1B, 0x1B}, {}};
+		const uint8_t premultiplied_palette[4][3] = {{132, 130, 132}, {0, 0, 0}, {88, 86, 88}, {44, 43, 44}};
+		for (uint32_t pixel_index = 0; pixel_index < 16; ++pixel_index)
+		{
+			const uint8_t *color_data = premultiplied_palette[3 - pixel_index % 4];
+			const uint32_t alpha_data = EIGHT_VALUES_PALETTE[pixel_index % 8];
+			append_pixel(premultiplied_alpha.pixels_data, unpremultiply(color_data[0], alpha_data), unpremultiply(color_data[1], alpha_data),
+						 unpremultiply(color_data[2], alpha_data), alpha_data);
+		}
+		block_cases.push_back(premultiplied_alpha);
+
+		return block_cases;
+	}
+
+	std::vector<BlockCase> make_bc4_cases()
+	{
+		std::vector<BlockCase> block_cases;
+
+		for (uint32_t format_four_cc : {FOURCC_DXTA, FOURCC_DXTL})
+		{
+			BlockCase eight_values = {"BC4 eight values", format_four_cc, {0xFF, 0x00, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA}, {}};
+			BlockCase six_values = {"BC4 six values", format_four_cc, {0x28, 0xF0, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA}, {}};
+			for (uint32_t pixel_index = 0; pixel_index < 16; ++pixel_index)
+			{
+				const uint32_t eight_value = EIGHT_VALUES_PALETTE[pixel_index % 8];
+				const uint32_t six_value = SIX_VALUES_PALETTE[pixel_index % 8];
+				append_pixel(eight_values.pixels_data, eight_value, eight_value, eight_value, 255);
+				append_pixel(six_values.pixels_data, six_value, six_value, six_value, 255);
+			}
+			block_cases.push_back(eight_values);
+			block_cases.push_back(six_values);
+		}
+
+		return block_cases;
+	}
+
+	std::vector<BlockCase> make_bc5_cases()
+	{
+		std::vector<BlockCase> block_cases;
+
+		// X from the 8 values of 255 and 0, Y is 128 except 0 and 255 for the indices 6 and 7
+		// Z is sqrt(1 - x^2 - y^2) * 127.5 + 128 with x and y mapped to [-1, 1], 128 when the normal is too long
+		const uint8_t y_palette[8] = {128, 128, 128, 128, 128, 128, 0, 255};
+		const uint8_t z_palette[8] = {128, 128, 217, 243, 254, 254, 128, 128};
+		for (uint32_t format_four_cc : {FOURCC_DXTN, FOURCC_3DCX})
+		{
+			BlockCase normal_map = {"BC5 normal map", format_four_cc,
+									{0xFF, 0x00, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA, 0x80, 0x80, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA}, {}};
+			for (uint32_t pixel_index = 0; pixel_index < 16; ++pixel_index)
+			{
+				append_pixel(normal_map.pixels_data, EIGHT_VALUES_PALETTE[pixel_index % 8], y_palette[pixel_index % 8], z_palette[pixel_index % 8], 255);
+			}
+			block_cases.push_back(normal_map);
+		}
+
+		// The flat normal (128, 128) points up, 1 - 2 * (1 / 255)^2 stays above 254.5
+		BlockCase flat_normal = {"BC5 flat normal", FOURCC_DXTN, {0x80, 0x80, 0, 0, 0, 0, 0, 0, 0x80, 0x80, 0, 0, 0, 0, 0, 0}, {}};
+		for (uint32_t pixel_index = 0; pixel_index < 16; ++pixel_index)
+		{
+			append_pixel(flat_normal.pixels_data, 128, 128, 255, 255);
+		}
+		block_cases.push_back(flat_normal);
+
+		return block_cases;
+	}
+
+	void check_block_cases(const std::vector<BlockCase> &block_cases)
+	{
+		for (const BlockCase &block_case : block_cases)
+		{
+			check_block_case(block_case);
+		}
+	}
+
+	void test_bc1_blocks()
+	{
+		check_block_cases(make_bc1_cases());
+	}
+
+	void test_bc2_blocks()
+	{
+		check_block_cases(make_bc2_cases());
+	}
+
+	void test_bc3_blocks()
+	{
+		check_block_cases(make_bc3_cases());
+	}
+
+	void test_bc4_blocks()
+	{
+		check_block_cases(make_bc4_cases());
+	}
+
+	void test_bc5_blocks()
+	{
+		check_block_cases(make_bc5_cases());
+	}
+
+	// BPTC blocks are written field by field from the tables of the specification, independently of the decoder,
+	// and their pixels come from the formulas of the specification
+
+	// 128 bits, written from the lowest bit of the first byte
+	class BlockWriter
+	{
+	public:
+		BlockWriter() : block_data(16, 0), bit_position(0) {}
+
+		void write(uint32_t value_data, uint32_t bits_number)
+		{
+			GW2DT_CHECK(bit_position + bits_number <= 128);
+			for (uint32_t bit_index = 0; bit_index < bits_number; ++bit_index, ++bit_position)
+			{
+				block_data[bit_position / 8] |= static_cast<uint8_t>(((value_data >> bit_index) & 1) << (bit_position % 8));
+			}
+		}
+
+		uint32_t position() const { return bit_position; }
+
+		std::vector<uint8_t> finish() const
+		{
+			GW2DT_CHECK(bit_position == 128);
+			return block_data;
+		}
+
+	private:
+		std::vector<uint8_t> block_data;
+		uint32_t bit_position;
+	};
+
+	// A few partitions of the specification: the subset of every texel row by row, and the anchor texels of the subsets 1 and 2
+	struct BptcPartition
+	{
+		uint32_t partition_index;
+		const char *subsets_data;
+		uint32_t anchors_data[2];
+	};
+
+	const BptcPartition SINGLE_PARTITION = {0, "0000000000000000", {0, 0}};
+	const BptcPartition PARTITIONS_2[] = {{0, "0011001100110011", {15, 0}}, {13, "0000000011111111", {15, 0}},
+										  {17, "0111000100000000", {2, 0}}, {18, "0000000010001110", {8, 0}}};
+	const BptcPartition PARTITIONS_3[] = {{0, "0011001102212222", {3, 15}}, {1, "0001001122112221", {3, 8}}};
+
+	uint32_t get_subset(const BptcPartition &partition_data, uint32_t texel_index)
+	{
+		return static_cast<uint32_t>(partition_data.subsets_data[texel_index] - '0');
+	}
+
+	// The first texel of every subset has an index of one bit less
+	bool is_anchor(const BptcPartition &partition_data, uint32_t subsets_number, uint32_t texel_index)
+	{
+		return texel_index == 0 || (subsets_number >= 2 && texel_index == partition_data.anchors_data[0]) ||
+			   (subsets_number == 3 && texel_index == partition_data.anchors_data[1]);
+	}
+
+	const uint32_t BPTC_WEIGHTS_2[4] = {0, 21, 43, 64};
+	const uint32_t BPTC_WEIGHTS_3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+	const uint32_t BPTC_WEIGHTS_4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+	uint32_t get_bptc_weight(uint32_t index_bits, uint32_t index_data)
+	{
+		return index_bits == 2 ? BPTC_WEIGHTS_2[index_data] : (index_bits == 3 ? BPTC_WEIGHTS_3[index_data] : BPTC_WEIGHTS_4[index_data]);
+	}
+
+	uint32_t interpolate(uint32_t endpoint_0, uint32_t endpoint_1, uint32_t weight_data)
+	{
+		return ((64 - weight_data) * endpoint_0 + weight_data * endpoint_1 + 32) >> 6;
+	}
+
+	// Columns of the BC7 mode table: subsets, partition, rotation and index selection bits, color and alpha bits,
+	// P-bit per endpoint or per subset, index bits of the two sets
+	struct Bc7ModeInfo
+	{
+		uint32_t subsets;
+		uint32_t partition_bits;
+		uint32_t rotation_bits;
+		uint32_t index_selection_bits;
+		uint32_t color_bits;
+		uint32_t alpha_bits;
+		bool has_endpoint_pbits;
+		bool has_shared_pbits;
+		uint32_t index_bits;
+		uint32_t secondary_index_bits;
+	};
+
+	const Bc7ModeInfo BC7_MODES[8] = {
+		{3, 4, 0, 0, 4, 0, true, false, 3, 0},
+		{2, 6, 0, 0, 6, 0, false, true, 3, 0},
+		{3, 6, 0, 0, 5, 0, false, false, 2, 0},
+		{2, 6, 0, 0, 7, 0, true, false, 2, 0},
+		{1, 0, 2, 1, 5, 6, false, false, 2, 3},
+		{1, 0, 2, 0, 7, 8, false, false, 2, 2},
+		{1, 0, 0, 0, 7, 7, true, false, 4, 0},
+		{2, 6, 0, 0, 5, 5, true, false, 2, 0}};
+
+	// Fields of a BC7 block, the endpoints are quantized, RGBA of the endpoints 0 and 1 of every subset
+	struct Bc7Block
+	{
+		uint32_t mode_index;
+		const BptcPartition *partition_data;
+		uint32_t rotation_index;
+		uint32_t index_selection;
+		uint32_t endpoints_data[3][2][4];
+		uint32_t pbits_data[3][2];
+		uint32_t indices_data[16];
+		uint32_t secondary_indices_data[16];
+	};
+
+	std::vector<uint8_t> write_bc7_block(const Bc7Block &block_fields)
+	{
+		const Bc7ModeInfo &mode_info = BC7_MODES[block_fields.mode_index];
+		BlockWriter block_writer;
+		block_writer.write(1u << block_fields.mode_index, block_fields.mode_index + 1);
+		block_writer.write(block_fields.partition_data->partition_index, mode_info.partition_bits);
+		block_writer.write(block_fields.rotation_index, mode_info.rotation_bits);
+		block_writer.write(block_fields.index_selection, mode_info.index_selection_bits);
+		for (uint32_t channel_index = 0; channel_index < 4; ++channel_index)
+		{
+			for (uint32_t subset_index = 0; subset_index < mode_info.subsets; ++subset_index)
+			{
+				for (uint32_t endpoint_index = 0; endpoint_index < 2; ++endpoint_index)
+				{
+					block_writer.write(block_fields.endpoints_data[subset_index][endpoint_index][channel_index], channel_index < 3 ? mode_info.color_bits : mode_info.alpha_bits);
+				}
+			}
+		}
+		for (uint32_t subset_index = 0; subset_index < mode_info.subsets; ++subset_index)
+		{
+			for (uint32_t endpoint_index = 0; endpoint_index < 2; ++endpoint_index)
+			{
+				if (mode_info.has_endpoint_pbits || (mode_info.has_shared_pbits && endpoint_index == 0))
+				{
+					block_writer.write(block_fields.pbits_data[subset_index][endpoint_index], 1);
+				}
+			}
+		}
+		for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+		{
+			block_writer.write(block_fields.indices_data[texel_index], mode_info.index_bits - is_anchor(*block_fields.partition_data, mode_info.subsets, texel_index));
+		}
+		if (mode_info.secondary_index_bits != 0)
+		{
+			for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+			{
+				block_writer.write(block_fields.secondary_indices_data[texel_index], mode_info.secondary_index_bits - (texel_index == 0));
+			}
+		}
+		return block_writer.finish();
+	}
+
+	// Channel with its P-bit as lowest bit, then its high bits copied in its low bits
+	uint32_t unquantize_bc7(uint32_t value_data, uint32_t bits_number, bool has_pbit, uint32_t pbit_data)
+	{
+		if (has_pbit)
+		{
+			value_data = (value_data << 1) | pbit_data;
+			++bits_number;
+		}
+		return (value_data << (8 - bits_number)) | (value_data >> (2 * bits_number - 8));
+	}
+
+	std::vector<uint8_t> get_bc7_pixels(const Bc7Block &block_fields)
+	{
+		const Bc7ModeInfo &mode_info = BC7_MODES[block_fields.mode_index];
+		const bool has_pbits = mode_info.has_endpoint_pbits || mode_info.has_shared_pbits;
+
+		std::vector<uint8_t> pixels_data;
+		for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+		{
+			const uint32_t subset_index = get_subset(*block_fields.partition_data, texel_index);
+
+			uint32_t color_weight = get_bptc_weight(mode_info.index_bits, block_fields.indices_data[texel_index]);
+			uint32_t alpha_weight = color_weight;
+			if (mode_info.secondary_index_bits != 0)
+			{
+				alpha_weight = get_bptc_weight(mode_info.secondary_index_bits, block_fields.secondary_indices_data[texel_index]);
+				if (block_fields.index_selection)
+				{
+					std::swap(color_weight, alpha_weight);
+				}
+			}
+
+			uint32_t pixel_data[4];
+			for (uint32_t channel_index = 0; channel_index < 4; ++channel_index)
+			{
+				uint32_t channel_endpoints[2];
+				for (uint32_t endpoint_index = 0; endpoint_index < 2; ++endpoint_index)
+				{
+					const uint32_t pbit_data = block_fields.pbits_data[subset_index][mode_info.has_shared_pbits ? 0 : endpoint_index];
+					const uint32_t value_data = block_fields.endpoints_data[subset_index][endpoint_index][channel_index];
+					if (channel_index < 3)
+					{
+						channel_endpoints[endpoint_index] = unquantize_bc7(value_data, mode_info.color_bits, has_pbits, pbit_data);
+					}
+					else
+					{
+						channel_endpoints[endpoint_index] = mode_info.alpha_bits == 0 ? 255 : unquantize_bc7(value_data, mode_info.alpha_bits, has_pbits, pbit_data);
+					}
+				}
+				pixel_data[channel_index] = interpolate(channel_endpoints[0], channel_endpoints[1], channel_index < 3 ? color_weight : alpha_weight);
+			}
+
+			// The rotation swaps the alpha with a color channel once interpolated
+			if (block_fields.rotation_index != 0)
+			{
+				std::swap(pixel_data[block_fields.rotation_index - 1], pixel_data[3]);
+			}
+			append_pixel(pixels_data, pixel_data[0], pixel_data[1], pixel_data[2], pixel_data[3]);
+		}
+		return pixels_data;
+	}
+
+	// Random fields, the indices of the anchor texels have one bit less
+	Bc7Block make_random_bc7_block(uint32_t mode_index, const BptcPartition &partition_data, std::mt19937 &random_engine)
+	{
+		const Bc7ModeInfo &mode_info = BC7_MODES[mode_index];
+		Bc7Block block_fields = {};
+		block_fields.mode_index = mode_index;
+		block_fields.partition_data = &partition_data;
+		block_fields.rotation_index = random_engine() & ((1u << mode_info.rotation_bits) - 1);
+		block_fields.index_selection = random_engine() & ((1u << mode_info.index_selection_bits) - 1);
+		for (uint32_t subset_index = 0; subset_index < mode_info.subsets; ++subset_index)
+		{
+			for (uint32_t endpoint_index = 0; endpoint_index < 2; ++endpoint_index)
+			{
+				for (uint32_t channel_index = 0; channel_index < 4; ++channel_index)
+				{
+					block_fields.endpoints_data[subset_index][endpoint_index][channel_index] = random_engine() & ((1u << (channel_index < 3 ? mode_info.color_bits : mode_info.alpha_bits)) - 1);
+				}
+				block_fields.pbits_data[subset_index][endpoint_index] = random_engine() & 1;
+			}
+		}
+		for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+		{
+			block_fields.indices_data[texel_index] = random_engine() & ((1u << (mode_info.index_bits - is_anchor(partition_data, mode_info.subsets, texel_index))) - 1);
+			if (mode_info.secondary_index_bits != 0)
+			{
+				block_fields.secondary_indices_data[texel_index] = random_engine() & ((1u << (mode_info.secondary_index_bits - (texel_index == 0))) - 1);
+			}
+		}
+		return block_fields;
+	}
+
+	std::vector<BlockCase> make_bc7_cases()
+	{
+		std::vector<BlockCase> block_cases;
+
+		// Mode 6 worked by hand: the endpoints (127, 0, 64, 127) with a P-bit of 1 expand to (255, 1, 129, 255),
+		// the endpoint 0 with a P-bit of 0 stays black. The indices 0, 8 and 15 have the weights 0, 34 and 64,
+		// (30 * 255 + 32) >> 6 is 120, (30 * 1 + 32) >> 6 is 0 and (30 * 129 + 32) >> 6 is 60
+		Bc7Block mode_6 = {};
+		mode_6.mode_index = 6;
+		mode_6.partition_data = &SINGLE_PARTITION;
+		const uint32_t endpoint_0[4] = {127, 0, 64, 127};
+		std::copy(endpoint_0, endpoint_0 + 4, mode_6.endpoints_data[0][0]);
+		mode_6.pbits_data[0][0] = 1;
+		const uint32_t texel_indices[3] = {0, 8, 15};
+		const uint8_t texel_pixels[3][4] = {{255, 1, 129, 255}, {120, 0, 60, 120}, {0, 0, 0, 0}};
+		BlockCase hand_case = {"BC7 mode 6 by hand", FOURCC_BC7X, {}, {}};
+		for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+		{
+			mode_6.indices_data[texel_index] = texel_indices[texel_index % 3];
+			const uint8_t *pixel_data = texel_pixels[texel_index % 3];
+			append_pixel(hand_case.pixels_data, pixel_data[0], pixel_data[1], pixel_data[2], pixel_data[3]);
+		}
+		hand_case.block_data = write_bc7_block(mode_6);
+		GW2DT_CHECK(get_bc7_pixels(mode_6) == hand_case.pixels_data);
+		block_cases.push_back(hand_case);
+
+		// Every mode with random fields, every partition of the list and every rotation and index selection
+		std::mt19937 random_engine(7);
+		for (uint32_t mode_index = 0; mode_index < 8; ++mode_index)
+		{
+			const Bc7ModeInfo &mode_info = BC7_MODES[mode_index];
+			std::vector<const BptcPartition *> partitions;
+			if (mode_info.subsets == 1)
+			{
+				partitions.assign(8, &SINGLE_PARTITION);
+			}
+			for (const BptcPartition &partition_data : (mode_info.subsets == 2 ? std::span<const BptcPartition>(PARTITIONS_2) : std::span<const BptcPartition>(PARTITIONS_3)))
+			{
+				if (mode_info.subsets != 1)
+				{
+					partitions.push_back(&partition_data);
+				}
+			}
+
+			for (size_t case_index = 0; case_index < partitions.size(); ++case_index)
+			{
+				Bc7Block block_fields = make_random_bc7_block(mode_index, *partitions[case_index], random_engine);
+				block_fields.rotation_index = static_cast<uint32_t>(case_index) & ((1u << mode_info.rotation_bits) - 1);
+				block_fields.index_selection = static_cast<uint32_t>(case_index >> 2) & ((1u << mode_info.index_selection_bits) - 1);
+				block_cases.push_back({"BC7 mode", FOURCC_BC7X, write_bc7_block(block_fields), get_bc7_pixels(block_fields)});
+			}
+		}
+
+		// Without a 1 bit in the first byte the mode is reserved, the block is transparent black
+		BlockCase reserved_mode = {"BC7 reserved mode", FOURCC_BC7X, {0x00, 0xFF, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, {}};
+		reserved_mode.pixels_data.assign(64, 0);
+		block_cases.push_back(reserved_mode);
+
+		return block_cases;
+	}
+
+	// Columns of the BC6H mode table, then the header fields after the mode bits as the specification lists them:
+	// rw9:0 is bits 0 to 9 of the red channel of the endpoint w, stored from bit 0, every field is stored in the listed order
+	struct Bc6hModeInfo
+	{
+		uint32_t mode_value;
+		uint32_t mode_bits;
+		uint32_t regions;
+		bool is_transformed;
+		uint32_t endpoint_bits;
+		uint32_t delta_bits[3];
+		const char *fields_data;
+	};
+
+	const Bc6hModeInfo BC6H_MODES[14] = {
+		{0x00, 2, 2, true, 10, {5, 5, 5}, "gy4 by4 bz4 rw9:0 gw9:0 bw9:0 rx4:0 gz4 gy3:0 gx4:0 bz0 gz3:0 bx4:0 bz1 by3:0 ry4:0 bz2 rz4:0 bz3"},
+		{0x01, 2, 2, true, 7, {6, 6, 6}, "gy5 gz4 gz5 rw6:0 bz0 bz1 by4 gw6:0 by5 bz2 gy4 bw6:0 bz3 bz5 bz4 rx5:0 gy3:0 gx5:0 gz3:0 bx5:0 by3:0 ry5:0 rz5:0"},
+		{0x02, 5, 2, true, 11, {5, 4, 4}, "rw9:0 gw9:0 bw9:0 rx4:0 rw10 gy3:0 gx3:0 gw10 bz0 gz3:0 bx3:0 bw10 bz1 by3:0 ry4:0 bz2 rz4:0 bz3"},
+		{0x06, 5, 2, true, 11, {4, 5, 4}, "rw9:0 gw9:0 bw9:0 rx3:0 rw10 gz4 gy3:0 gx4:0 gw10 gz3:0 bx3:0 bw10 bz1 by3:0 ry3:0 bz0 bz2 rz3:0 gy4 bz3"},
+		{0x0A, 5, 2, true, 11, {4, 4, 5}, "rw9:0 gw9:0 bw9:0 rx3:0 rw10 by4 gy3:0 gx3:0 gw10 bz0 gz3:0 bx4:0 bw10 by3:0 ry3:0 bz1 bz2 rz3:0 bz4 bz3"},
+		{0x0E, 5, 2, true, 9, {5, 5, 5}, "rw8:0 by4 gw8:0 gy4 bw8:0 bz4 rx4:0 gz4 gy3:0 gx4:0 bz0 gz3:0 bx4:0 bz1 by3:0 ry4:0 bz2 rz4:0 bz3"},
+		{0x12, 5, 2, true, 8, {6, 5, 5}, "rw7:0 gz4 by4 gw7:0 bz2 gy4 bw7:0 bz3 bz4 rx5:0 gy3:0 gx4:0 bz0 gz3:0 bx4:0 bz1 by3:0 ry5:0 rz5:0"},
+		{0x16, 5, 2, true, 8, {5, 6, 5}, "rw7:0 bz0 by4 gw7:0 gy5 gy4 bw7:0 gz5 bz4 rx4:0 gz4 gy3:0 gx5:0 gz3:0 bx4:0 bz1 by3:0 ry4:0 bz2 rz4:0 bz3"},
+		{0x1A, 5, 2, true, 8, {5, 5, 6}, "rw7:0 bz1 by4 gw7:0 by5 gy4 bw7:0 bz5 bz4 rx4:0 gz4 gy3:0 gx4:0 bz0 gz3:0 bx5:0 by3:0 ry4:0 bz2 rz4:0 bz3"},
+		{0x1E, 5, 2, false, 6, {6, 6, 6}, "rw5:0 gz4 bz0 bz1 by4 gw5:0 gy5 by5 bz2 gy4 bw5:0 gz5 bz3 bz5 bz4 rx5:0 gy3:0 gx5:0 gz3:0 bx5:0 by3:0 ry5:0 rz5:0"},
+		{0x03, 5, 1, false, 10, {10, 10, 10}, "rw9:0 gw9:0 bw9:0 rx9:0 gx9:0 bx9:0"},
+		{0x07, 5, 1, true, 11, {9, 9, 9}, "rw9:0 gw9:0 bw9:0 rx8:0 rw10 gx8:0 gw10 bx8:0 bw10"},
+		{0x0B, 5, 1, true, 12, {8, 8, 8}, "rw9:0 gw9:0 bw9:0 rx7:0 rw11 rw10 gx7:0 gw11 gw10 bx7:0 bw11 bw10"},
+		{0x0F, 5, 1, true, 16, {4, 4, 4}, "rw9:0 gw9:0 bw9:0 rx3:0 rw15 rw14 rw13 rw12 rw11 rw10 gx3:0 gw15 gw14 gw13 gw12 gw11 gw10 bx3:0 bw15 bw14 bw13 bw12 bw11 bw10"}};
+
+	const uint16_t HALF_ONE = 0x3C00;
+
+	// One field of the mode table, channel and endpoint, then its bits from low_bit to high_bit
+	struct Bc6hField
+	{
+		uint32_t channel_index;
+		uint32_t endpoint_index;
+		uint32_t high_bit;
+		uint32_t low_bit;
+	};
+
+	std::vector<Bc6hField> parse_bc6h_fields(const char *fields_data)
+	{
+		std::vector<Bc6hField> fields;
+		std::istringstream fields_stream(fields_data);
+		std::string field_text;
+		while (fields_stream >> field_text)
+		{
+			Bc6hField field_data;
+			field_data.channel_index = static_cast<uint32_t>(std::string("rgb").find(field_text[0]));
+			field_data.endpoint_index = static_cast<uint32_t>(std::string("wxyz").find(field_text[1]));
+			const size_t colon_position = field_text.find(':');
+			field_data.high_bit = static_cast<uint32_t>(std::stoul(field_text.substr(2, colon_position - 2)));
+			field_data.low_bit = colon_position == std::string::npos ? field_data.high_bit : static_cast<uint32_t>(std::stoul(field_text.substr(colon_position + 1)));
+			GW2DT_CHECK(field_data.channel_index < 3 && field_data.endpoint_index < 4 && field_data.low_bit <= field_data.high_bit);
+			fields.push_back(field_data);
+		}
+		return fields;
+	}
+
+	// Stored value of every endpoint: w is absolute, x, y and z are signed deltas from w in the transformed modes
+	struct Bc6hBlock
+	{
+		uint32_t mode_index;
+		const BptcPartition *partition_data;
+		uint32_t endpoints_data[4][3];
+		uint32_t indices_data[16];
+	};
+
+	uint32_t get_bc6h_stored_bits(const Bc6hModeInfo &mode_info, uint32_t endpoint_index, uint32_t channel_index)
+	{
+		return endpoint_index == 0 ? mode_info.endpoint_bits : mode_info.delta_bits[channel_index];
+	}
+
+	std::vector<uint8_t> write_bc6h_block(const Bc6hBlock &block_fields)
+	{
+		const Bc6hModeInfo &mode_info = BC6H_MODES[block_fields.mode_index];
+		BlockWriter block_writer;
+		block_writer.write(mode_info.mode_value, mode_info.mode_bits);
+		for (const Bc6hField &field_data : parse_bc6h_fields(mode_info.fields_data))
+		{
+			for (uint32_t bit_index = field_data.low_bit; bit_index <= field_data.high_bit; ++bit_index)
+			{
+				block_writer.write(block_fields.endpoints_data[field_data.endpoint_index][field_data.channel_index] >> bit_index, 1);
+			}
+		}
+		// 82 bits of header with the partition for 2 regions, 65 bits for 1 region
+		if (mode_info.regions == 2)
+		{
+			block_writer.write(block_fields.partition_data->partition_index, 5);
+		}
+		GW2DT_CHECK(block_writer.position() == (mode_info.regions == 2 ? 82u : 65u));
+
+		const uint32_t index_bits = mode_info.regions == 2 ? 3 : 4;
+		for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+		{
+			block_writer.write(block_fields.indices_data[texel_index], index_bits - is_anchor(*block_fields.partition_data, mode_info.regions, texel_index));
+		}
+		return block_writer.finish();
+	}
+
+	// Unsigned endpoints scaled to 16 bits, the interpolation is scaled by 31 / 64 to the bits of a half float
+	uint32_t unquantize_bc6h(uint32_t value_data, uint32_t endpoint_bits)
+	{
+		if (endpoint_bits >= 15)
+		{
+			return value_data;
+		}
+		if (value_data == 0)
+		{
+			return 0;
+		}
+		if (value_data == (1u << endpoint_bits) - 1)
+		{
+			return 0xFFFF;
+		}
+		return ((value_data << 16) + 0x8000) >> endpoint_bits;
+	}
+
+	void append_half_pixel(std::vector<uint8_t> &pixels_data, uint32_t red, uint32_t green, uint32_t blue)
+	{
+		for (uint32_t half_data : {red, green, blue, static_cast<uint32_t>(HALF_ONE)})
+		{
+			pixels_data.push_back(static_cast<uint8_t>(half_data));
+			pixels_data.push_back(static_cast<uint8_t>(half_data >> 8));
+		}
+	}
+
+	std::vector<uint8_t> get_bc6h_pixels(const Bc6hBlock &block_fields)
+	{
+		const Bc6hModeInfo &mode_info = BC6H_MODES[block_fields.mode_index];
+		const uint32_t endpoint_mask = (1u << mode_info.endpoint_bits) - 1;
+
+		uint32_t endpoints_data[4][3];
+		for (uint32_t endpoint_index = 0; endpoint_index < 2 * mode_info.regions; ++endpoint_index)
+		{
+			for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+			{
+				uint32_t value_data = block_fields.endpoints_data[endpoint_index][channel_index];
+				if (mode_info.is_transformed && endpoint_index != 0)
+				{
+					// Sign extended delta, the sum wraps around
+					const uint32_t delta_bits = mode_info.delta_bits[channel_index];
+					int32_t delta_data = static_cast<int32_t>(value_data);
+					if (value_data & (1u << (delta_bits - 1)))
+					{
+						delta_data -= 1 << delta_bits;
+					}
+					value_data = static_cast<uint32_t>(static_cast<int32_t>(block_fields.endpoints_data[0][channel_index]) + delta_data) & endpoint_mask;
+				}
+				endpoints_data[endpoint_index][channel_index] = unquantize_bc6h(value_data, mode_info.endpoint_bits);
+			}
+		}
+
+		std::vector<uint8_t> pixels_data;
+		const uint32_t index_bits = mode_info.regions == 2 ? 3 : 4;
+		for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+		{
+			const uint32_t region_index = get_subset(*block_fields.partition_data, texel_index);
+			const uint32_t weight_data = get_bptc_weight(index_bits, block_fields.indices_data[texel_index]);
+			uint32_t pixel_data[3];
+			for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+			{
+				const uint32_t value_data = interpolate(endpoints_data[2 * region_index][channel_index], endpoints_data[2 * region_index + 1][channel_index], weight_data);
+				pixel_data[channel_index] = (value_data * 31) >> 6;
+			}
+			append_half_pixel(pixels_data, pixel_data[0], pixel_data[1], pixel_data[2]);
+		}
+		return pixels_data;
+	}
+
+	// Every bit of every stored endpoint is in exactly one field, the header has its size
+	void test_bc6h_mode_table()
+	{
+		for (const Bc6hModeInfo &mode_info : BC6H_MODES)
+		{
+			uint32_t covered_bits[4][3] = {};
+			uint32_t header_bits = mode_info.mode_bits;
+			for (const Bc6hField &field_data : parse_bc6h_fields(mode_info.fields_data))
+			{
+				for (uint32_t bit_index = field_data.low_bit; bit_index <= field_data.high_bit; ++bit_index)
+				{
+					uint32_t &covered_data = covered_bits[field_data.endpoint_index][field_data.channel_index];
+					GW2DT_CHECK((covered_data & (1u << bit_index)) == 0);
+					covered_data |= 1u << bit_index;
+					++header_bits;
+				}
+			}
+			GW2DT_CHECK(header_bits == (mode_info.regions == 2 ? 77u : 65u));
+
+			for (uint32_t endpoint_index = 0; endpoint_index < 4; ++endpoint_index)
+			{
+				for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+				{
+					const uint32_t stored_bits = endpoint_index < 2 * mode_info.regions ? get_bc6h_stored_bits(mode_info, endpoint_index, channel_index) : 0;
+					GW2DT_CHECK(covered_bits[endpoint_index][channel_index] == (1u << stored_bits) - 1);
+				}
+			}
+		}
+	}
+
+	std::vector<BlockCase> make_bc6h_cases()
+	{
+		std::vector<BlockCase> block_cases;
+
+		// Worked by hand in the modes 0x03, absolute endpoints of 10 bits, and 0x07, deltas of 9 bits from w on 11 bits
+		// 0x3FF and 0x7FF unquantize to 0xFFFF, 0x200 of 10 bits to 0x8020 and 0x400 of 11 bits to 0x8010, then * 31 >> 6:
+		// 0xFFFF gives 0x7BFF, 0x8020 gives 0x3E0F and 0x8010 gives 0x3E07
+		// The indices 0, 8 and 15 have the weights 0, 34 and 64, (30 * 0xFFFF + 32) >> 6 then * 31 >> 6 is 0x3A20, with 34 it is 0x41DF
+		// In the mode 0x07, w is (0x7FF, 0, 0x400) and the deltas (1, -1, 0) wrap x around to (0, 0x7FF, 0x400)
+		Bc6hBlock absolute_mode = {10, &SINGLE_PARTITION, {{0x3FF, 0, 0x200}, {0, 0x3FF, 0x200}}, {}};
+		Bc6hBlock transformed_mode = {11, &SINGLE_PARTITION, {{0x7FF, 0, 0x400}, {1, 0x1FF, 0}}, {}};
+		const uint32_t texel_indices[3] = {0, 8, 15};
+		const uint16_t absolute_pixels[3][3] = {{0x7BFF, 0, 0x3E0F}, {0x3A20, 0x41DF, 0x3E0F}, {0, 0x7BFF, 0x3E0F}};
+		const uint16_t transformed_pixels[3][3] = {{0x7BFF, 0, 0x3E07}, {0x3A20, 0x41DF, 0x3E07}, {0, 0x7BFF, 0x3E07}};
+		BlockCase absolute_case = {"BC6H mode 0x03 by hand", FOURCC_BC6H, {}, {}};
+		BlockCase transformed_case = {"BC6H mode 0x07 by hand", FOURCC_BC6H, {}, {}};
+		for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+		{
+			absolute_mode.indices_data[texel_index] = texel_indices[texel_index % 3];
+			transformed_mode.indices_data[texel_index] = texel_indices[texel_index % 3];
+			const uint16_t *absolute_pixel = absolute_pixels[texel_index % 3];
+			const uint16_t *transformed_pixel = transformed_pixels[texel_index % 3];
+			append_half_pixel(absolute_case.pixels_data, absolute_pixel[0], absolute_pixel[1], absolute_pixel[2]);
+			append_half_pixel(transformed_case.pixels_data, transformed_pixel[0], transformed_pixel[1], transformed_pixel[2]);
+		}
+		absolute_case.block_data = write_bc6h_block(absolute_mode);
+		transformed_case.block_data = write_bc6h_block(transformed_mode);
+		GW2DT_CHECK(get_bc6h_pixels(absolute_mode) == absolute_case.pixels_data);
+		GW2DT_CHECK(get_bc6h_pixels(transformed_mode) == transformed_case.pixels_data);
+		block_cases.push_back(absolute_case);
+		block_cases.push_back(transformed_case);
+
+		// Every mode with random fields and every partition of the list
+		std::mt19937 random_engine(9);
+		for (uint32_t mode_index = 0; mode_index < 14; ++mode_index)
+		{
+			const Bc6hModeInfo &mode_info = BC6H_MODES[mode_index];
+			for (uint32_t case_index = 0; case_index < 4; ++case_index)
+			{
+				Bc6hBlock block_fields = {mode_index, mode_info.regions == 2 ? &PARTITIONS_2[case_index] : &SINGLE_PARTITION, {}, {}};
+				for (uint32_t endpoint_index = 0; endpoint_index < 2 * mode_info.regions; ++endpoint_index)
+				{
+					for (uint32_t channel_index = 0; channel_index < 3; ++channel_index)
+					{
+						block_fields.endpoints_data[endpoint_index][channel_index] = random_engine() & ((1u << get_bc6h_stored_bits(mode_info, endpoint_index, channel_index)) - 1);
+					}
+				}
+				const uint32_t index_bits = mode_info.regions == 2 ? 3 : 4;
+				for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+				{
+					block_fields.indices_data[texel_index] = random_engine() & ((1u << (index_bits - is_anchor(*block_fields.partition_data, mode_info.regions, texel_index))) - 1);
+				}
+				block_cases.push_back({"BC6H mode", FOURCC_BC6H, write_bc6h_block(block_fields), get_bc6h_pixels(block_fields)});
+			}
+		}
+
+		// The mode values 0x13, 0x17, 0x1B and 0x1F are reserved, the block is black
+		for (uint8_t mode_value : {0x13, 0x17, 0x1B, 0x1F})
+		{
+			BlockCase reserved_mode = {"BC6H reserved mode", FOURCC_BC6H, {mode_value, 0xFF, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, {}};
+			for (uint32_t texel_index = 0; texel_index < 16; ++texel_index)
+			{
+				append_half_pixel(reserved_mode.pixels_data, 0, 0, 0);
+			}
+			block_cases.push_back(reserved_mode);
+		}
+
+		return block_cases;
+	}
+
+	void test_bc6h_blocks()
+	{
+		check_block_cases(make_bc6h_cases());
+	}
+
+	void test_bc7_blocks()
+	{
+		check_block_cases(make_bc7_cases());
+	}
+
+	// Different blocks side by side land at their own place, the partial ones included
+	void test_block_placement()
+	{
+		const std::vector<BlockCase> block_cases = make_bc1_cases();
+		const uint16_t image_width = 10;
+		const uint16_t image_height = 6;
+		const uint32_t blocks_width = 3;
+
+		std::vector<uint8_t> block_data;
+		for (uint32_t block_index = 0; block_index < blocks_width * 2; ++block_index)
+		{
+			const std::vector<uint8_t> &case_block = block_cases[block_index % block_cases.size()].block_data;
+			block_data.insert(block_data.end(), case_block.begin(), case_block.end());
+		}
+
+		std::vector<uint8_t> expected_data;
+		for (uint32_t y_position = 0; y_position < image_height; ++y_position)
+		{
+			for (uint32_t x_position = 0; x_position < image_width; ++x_position)
+			{
+				const uint32_t block_index = (y_position / 4) * blocks_width + x_position / 4;
+				const auto pixel_it = block_cases[block_index % block_cases.size()].pixels_data.begin() + 4 * (4 * (y_position % 4) + x_position % 4);
+				expected_data.insert(expected_data.end(), pixel_it, pixel_it + 4);
+			}
+		}
+
+		check_decoded_image("BC1 placement", make_image(FOURCC_DXT1, image_width, image_height), block_data, expected_data);
+	}
+}
+
+int main()
+{
+	return testing::run_tests({
+		{"bc1_blocks", test_bc1_blocks},
+		{"bc2_blocks", test_bc2_blocks},
+		{"bc3_blocks", test_bc3_blocks},
+		{"bc4_blocks", test_bc4_blocks},
+		{"bc5_blocks", test_bc5_blocks},
+		{"bc6h_mode_table", test_bc6h_mode_table},
+		{"bc6h_blocks", test_bc6h_blocks},
+		{"bc7_blocks", test_bc7_blocks},
+		{"block_placement", test_block_placement},
+	});
+}
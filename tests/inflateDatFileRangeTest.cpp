@@ -0,0 +1,181 @@
+#include "foundation/gw2dattools/inflateDatFileBuffer.h"
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "encodeDatFile.h"
+#include "testCheck.h"
+
+using namespace gw2dt;
+
+namespace
+{
+	// Several blocks of 4096 codes, copies reaching across them
+	struct RangeCorpus
+	{
+		std::vector<uint8_t> corpus_data;
+		std::vector<uint8_t> input_data;
+
+		RangeCorpus() : corpus_data(testing::make_dat_corpus(testing::DAT_CORPUS_TEXT, 900000, 11)),
+						input_data(testing::encode_dat_file(corpus_data))
+		{
+		}
+	};
+
+	const RangeCorpus &range_corpus()
+	{
+		static const RangeCorpus corpus;
+		return corpus;
+	}
+
+	std::vector<uint8_t> inflate_range(const compression::DatFileCheckpointIndex &checkpoint_index, uint32_t output_offset, uint32_t range_size)
+	{
+		std::vector<uint8_t> output_data(range_size);
+		output_data.resize(compression::inflate_dat_file_range(range_corpus().input_data, checkpoint_index, output_offset, output_data));
+		return output_data;
+	}
+
+	// Every range of the list, then random ones, against the full decode
+	void check_ranges(const compression::DatFileCheckpointIndex &checkpoint_index, std::span<const uint8_t> expected_data, uint32_t seed_data)
+	{
+		const uint32_t output_size = static_cast<uint32_t>(expected_data.size());
+		std::vector<std::pair<uint32_t, uint32_t>> ranges = {{0, 1}, {0, output_size}, {output_size - 1, 1}, {output_size / 2, 70000}};
+		// Around the checkpoints, which are at the beginning of blocks
+		for (const compression::DatFileCheckpoint &checkpoint : checkpoint_index.checkpoints)
+		{
+			if (checkpoint.output_position != 0 && checkpoint.output_position < output_size)
+			{
+				ranges.push_back({checkpoint.output_position - 1, 2});
+				ranges.push_back({checkpoint.output_position, 1});
+			}
+		}
+		std::mt19937 random_engine(seed_data);
+		for (uint32_t range_index = 0; range_index < 40; ++range_index)
+		{
+			const uint32_t output_offset = random_engine() % output_size;
+			ranges.push_back({output_offset, 1 + random_engine() % 200000});
+		}
+
+		for (const std::pair<uint32_t, uint32_t> &range_data : ranges)
+		{
+			const uint32_t expected_size = std::min(range_data.second, output_size - range_data.first);
+			const std::vector<uint8_t> output_data = inflate_range(checkpoint_index, range_data.first, range_data.second);
+			GW2DT_CHECK(output_data.size() == expected_size);
+			GW2DT_CHECK(std::equal(output_data.begin(), output_data.end(), expected_data.begin() + range_data.first));
+		}
+	}
+
+	void test_checkpoints_are_recorded()
+	{
+		const RangeCorpus &corpus = range_corpus();
+		for (uint32_t checkpoint_interval : {0u, 50000u, compression::DAT_FILE_CHECKPOINT_INTERVAL})
+		{
+			compression::DatFileCheckpointIndex checkpoint_index;
+			std::vector<uint8_t> output_data(corpus.corpus_data.size());
+			GW2DT_CHECK(compression::inflate_dat_file_buffer(corpus.input_data, output_data, checkpoint_index, checkpoint_interval) == output_data.size());
+			GW2DT_CHECK(output_data == corpus.corpus_data);
+
+			const std::vector<compression::DatFileCheckpoint> &checkpoints = checkpoint_index.checkpoints;
+			GW2DT_CHECK(checkpoint_index.output_data_size == corpus.corpus_data.size());
+			GW2DT_CHECK(!checkpoints.empty() && checkpoints.front().output_position == 0 && checkpoints.front().window_data.empty());
+			// Interval 0 records every block, the default one only the first block of this corpus
+			GW2DT_CHECK(checkpoint_interval != 0 || checkpoints.size() > 10);
+			GW2DT_CHECK(checkpoint_interval != compression::DAT_FILE_CHECKPOINT_INTERVAL || checkpoints.size() == 1);
+			for (size_t checkpoint_number = 1; checkpoint_number < checkpoints.size(); ++checkpoint_number)
+			{
+				const compression::DatFileCheckpoint &checkpoint = checkpoints[checkpoint_number];
+				GW2DT_CHECK(checkpoint.output_position - checkpoints[checkpoint_number - 1].output_position >= checkpoint_interval);
+				GW2DT_CHECK(checkpoint.bit_position > checkpoints[checkpoint_number - 1].bit_position);
+				// The window is the output just before the checkpoint
+				GW2DT_CHECK(checkpoint.window_data.size() == std::min<uint32_t>(checkpoint.output_position, 1 << 17));
+				GW2DT_CHECK(std::equal(checkpoint.window_data.begin(), checkpoint.window_data.end(),
+									   corpus.corpus_data.begin() + (checkpoint.output_position - checkpoint.window_data.size())));
+			}
+
+			check_ranges(checkpoint_index, corpus.corpus_data, checkpoint_interval);
+		}
+	}
+
+	// Only the decoded part is indexed, ranges past it are cut
+	void test_ranges_of_partial_index()
+	{
+		const RangeCorpus &corpus = range_corpus();
+		const uint32_t decoded_size = 300001;
+		compression::DatFileCheckpointIndex checkpoint_index;
+		std::vector<uint8_t> output_data(decoded_size);
+		GW2DT_CHECK(compression::inflate_dat_file_buffer(corpus.input_data, output_data, checkpoint_index, 20000) == decoded_size);
+		GW2DT_CHECK(checkpoint_index.output_data_size == decoded_size);
+		GW2DT_CHECK(checkpoint_index.checkpoints.back().output_position < decoded_size);
+
+		check_ranges(checkpoint_index, std::span<const uint8_t>(corpus.corpus_data).first(decoded_size), 3);
+		GW2DT_CHECK(inflate_range(checkpoint_index, decoded_size - 10, 4096).size() == 10);
+		GW2DT_CHECK(inflate_range(checkpoint_index, decoded_size, 4096).empty());
+		GW2DT_CHECK(inflate_range(checkpoint_index, decoded_size + 100000, 4096).empty());
+	}
+
+	void test_checkpoint_index_round_trip()
+	{
+		const RangeCorpus &corpus = range_corpus();
+		compression::DatFileCheckpointIndex checkpoint_index;
+		std::vector<uint8_t> output_data(corpus.corpus_data.size());
+		compression::inflate_dat_file_buffer(corpus.input_data, output_data, checkpoint_index, 100000);
+
+		std::stringstream index_stream;
+		compression::write_dat_file_checkpoint_index(index_stream, checkpoint_index);
+		const std::string index_data = index_stream.str();
+
+		const compression::DatFileCheckpointIndex read_index = compression::read_dat_file_checkpoint_index(index_stream);
+		GW2DT_CHECK(read_index.output_data_size == checkpoint_index.output_data_size);
+		GW2DT_CHECK(read_index.write_size_const_addition == checkpoint_index.write_size_const_addition);
+		GW2DT_CHECK(read_index.checkpoints.size() == checkpoint_index.checkpoints.size());
+		for (size_t checkpoint_number = 0; checkpoint_number < read_index.checkpoints.size(); ++checkpoint_number)
+		{
+			const compression::DatFileCheckpoint &read_checkpoint = read_index.checkpoints[checkpoint_number];
+			const compression::DatFileCheckpoint &checkpoint = checkpoint_index.checkpoints[checkpoint_number];
+			GW2DT_CHECK(read_checkpoint.bit_position == checkpoint.bit_position);
+			GW2DT_CHECK(read_checkpoint.output_position == checkpoint.output_position);
+			GW2DT_CHECK(read_checkpoint.window_data == checkpoint.window_data);
+		}
+		check_ranges(read_index, corpus.corpus_data, 4);
+
+		// Truncated and foreign data are refused
+		for (size_t index_size : {size_t(0), size_t(3), index_data.size() / 2, index_data.size() - 1})
+		{
+			std::stringstream truncated_stream(index_data.substr(0, index_size));
+			bool is_refused = false;
+			try
+			{
+				compression::read_dat_file_checkpoint_index(truncated_stream);
+			}
+			catch (const std::exception &)
+			{
+				is_refused = true;
+			}
+			GW2DT_CHECK(is_refused);
+		}
+		std::string foreign_data = index_data;
+		foreign_data[0] ^= 0xFF;
+		std::stringstream foreign_stream(foreign_data);
+		bool is_refused = false;
+		try
+		{
+			compression::read_dat_file_checkpoint_index(foreign_stream);
+		}
+		catch (const std::exception &)
+		{
+			is_refused = true;
+		}
+		GW2DT_CHECK(is_refused);
+	}
+}
+
+int main()
+{
+	return testing::run_tests({
+		{"checkpoints_are_recorded", test_checkpoints_are_recorded},
+		{"ranges_of_partial_index", test_ranges_of_partial_index},
+		{"checkpoint_index_round_trip", test_checkpoint_index_round_trip},
+	});
+}
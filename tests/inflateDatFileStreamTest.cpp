@@ -0,0 +1,111 @@
+#include "foundation/gw2dattools/inflateDatFileBuffer.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "encodeDatFile.h"
+#include "testCheck.h"
+
+using namespace gw2dt;
+
+namespace
+{
+	// Farthest copy source of the format, the stream window slides once it holds twice this much
+	const uint32_t MAX_WRITE_OFFSET = 1 << 17;
+
+	struct StreamOutput
+	{
+		std::vector<uint8_t> output_data;
+		compression::DatFileInflateStream inflate_stream;
+
+		StreamOutput() : inflate_stream([this](std::span<const uint8_t> chunk_data)
+										{ output_data.insert(output_data.end(), chunk_data.begin(), chunk_data.end()); })
+		{
+		}
+	};
+
+	// Feeds input_data in pieces of chunk_size bytes, random sizes up to 64KB if chunk_size is 0
+	std::vector<uint8_t> inflate_in_chunks(std::span<const uint8_t> input_data, size_t chunk_size, uint32_t seed_data)
+	{
+		StreamOutput stream_output;
+		std::mt19937 random_engine(seed_data);
+		for (size_t input_position = 0; input_position < input_data.size();)
+		{
+			const size_t piece_size = std::min(input_data.size() - input_position, chunk_size != 0 ? chunk_size : 1 + random_engine() % 65536);
+			stream_output.inflate_stream.feed(input_data.subspan(input_position, piece_size));
+			input_position += piece_size;
+		}
+		stream_output.inflate_stream.finish();
+		GW2DT_CHECK(stream_output.inflate_stream.is_done());
+		return std::move(stream_output.output_data);
+	}
+
+	void test_stream_matches_input()
+	{
+		const testing::DatCorpusKind corpus_kinds[] = {testing::DAT_CORPUS_TEXT, testing::DAT_CORPUS_ZEROS, testing::DAT_CORPUS_VERTICES,
+													   testing::DAT_CORPUS_RANDOM};
+		for (testing::DatCorpusKind corpus_kind : corpus_kinds)
+		{
+			const std::vector<uint8_t> corpus_data = testing::make_dat_corpus(corpus_kind, 700000, corpus_kind);
+			testing::DatFileEncoding encoding;
+			encoding.block_max_count = static_cast<uint8_t>(corpus_kind);
+			const std::vector<uint8_t> input_data = testing::encode_dat_file(corpus_data, encoding);
+
+			for (size_t chunk_size : {size_t(1) << 20, size_t(4096), size_t(7), size_t(0)})
+			{
+				GW2DT_CHECK(inflate_in_chunks(input_data, chunk_size, corpus_kind) == corpus_data);
+			}
+		}
+	}
+
+	// Literal only blocks of 4096 codes: the 64th block ends exactly on the first slide of the window
+	void test_stream_slides_at_block_end()
+	{
+		const uint32_t block_codes = 4096;
+		static_assert((2 * MAX_WRITE_OFFSET) % 4096 == 0, "The window must slide at the end of a block.");
+
+		const std::vector<uint8_t> corpus_data = testing::make_dat_corpus(testing::DAT_CORPUS_RANDOM, 4 * MAX_WRITE_OFFSET + block_codes / 2, 5);
+		testing::DatFileEncoding encoding;
+		encoding.use_copies = false;
+		const std::vector<uint8_t> input_data = testing::encode_dat_file(corpus_data, encoding);
+
+		// Everything but the end of the input has to be decoded before finish()
+		const size_t held_back_size = 1024;
+		StreamOutput stream_output;
+		for (size_t input_position = 0; input_position < input_data.size() - held_back_size; input_position += 1024)
+		{
+			stream_output.inflate_stream.feed(std::span<const uint8_t>(input_data).subspan(input_position, std::min<size_t>(1024, input_data.size() - held_back_size - input_position)));
+		}
+		GW2DT_CHECK(stream_output.inflate_stream.output_position() > 2 * MAX_WRITE_OFFSET);
+		GW2DT_CHECK(stream_output.inflate_stream.output_position() + 4 * held_back_size >= corpus_data.size());
+
+		stream_output.inflate_stream.feed(std::span<const uint8_t>(input_data).last(held_back_size));
+		stream_output.inflate_stream.finish();
+		GW2DT_CHECK(stream_output.output_data == corpus_data);
+	}
+
+	void test_stream_stops_at_output_size()
+	{
+		const std::vector<uint8_t> corpus_data = testing::make_dat_corpus(testing::DAT_CORPUS_TEXT, 500000, 9);
+		const std::vector<uint8_t> input_data = testing::encode_dat_file(corpus_data);
+
+		std::vector<uint8_t> output_data;
+		compression::DatFileInflateStream inflate_stream([&](std::span<const uint8_t> chunk_data)
+														 { output_data.insert(output_data.end(), chunk_data.begin(), chunk_data.end()); },
+														 300001);
+		inflate_stream.feed(input_data);
+		GW2DT_CHECK(inflate_stream.is_done());
+		GW2DT_CHECK(output_data.size() == 300001);
+		GW2DT_CHECK(std::equal(output_data.begin(), output_data.end(), corpus_data.begin()));
+	}
+}
+
+int main()
+{
+	return testing::run_tests({
+		{"stream_matches_input", test_stream_matches_input},
+		{"stream_slides_at_block_end", test_stream_slides_at_block_end},
+		{"stream_stops_at_output_size", test_stream_stops_at_output_size},
+	});
+}
@@ -0,0 +1,108 @@
+#include "foundation/gw2dattools/inflateTextureFileBuffer.h"
+
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "encodeTextureFile.h"
+#include "testCheck.h"
+
+using namespace gw2dt;
+
+namespace
+{
+	const uint32_t THREADS_NUMBER = 8;
+	const uint32_t ROUNDS_NUMBER = 3;
+
+	// Every format with every compression pass, in a few sizes
+	std::vector<std::vector<uint8_t>> make_texture_corpus()
+	{
+		const uint32_t compression_flag_sets[] = {0x00, 0x01, 0x02, 0x04, 0x08, 0x01 | 0x02 | 0x08, 0x01 | 0x04 | 0x08, 0x10, 0x20};
+		const uint16_t image_sizes[][2] = {{4, 4}, {60, 64}, {256, 200}, {300, 128}};
+
+		std::vector<std::vector<uint8_t>> texture_files;
+		uint32_t seed_data = 1;
+		for (uint32_t format_four_cc : testing::TEXTURE_FORMATS)
+		{
+			for (uint32_t compression_flags : compression_flag_sets)
+			{
+				const uint16_t *image_size = image_sizes[seed_data % std::size(image_sizes)];
+				texture_files.push_back(testing::encode_texture_file(format_four_cc, image_size[0], image_size[1], compression_flags, seed_data));
+				++seed_data;
+			}
+		}
+		return texture_files;
+	}
+
+	// Some passes leave parts of their blocks as they are, the output starts zeroed so that it only depends on the input
+	std::vector<uint8_t> inflate_texture(std::span<const uint8_t> texture_file)
+	{
+		compression::AnetImage anet_image;
+		std::vector<uint8_t> output_data(compression::probe_texture_file(texture_file, anet_image), 0);
+		output_data.resize(compression::inflate_texture_file_buffer(texture_file, output_data, anet_image));
+		return output_data;
+	}
+
+	// Several threads decode the same corpus at once, each one from a different file, and compare every output
+	// with the one decoded on a single thread
+	void test_concurrent_decoding_matches()
+	{
+		const std::vector<std::vector<uint8_t>> texture_files = make_texture_corpus();
+
+		std::vector<std::vector<uint8_t>> expected_outputs;
+		for (const std::vector<uint8_t> &texture_file : texture_files)
+		{
+			expected_outputs.push_back(inflate_texture(texture_file));
+		}
+
+		std::atomic<uint32_t> mismatches_number(0);
+		std::atomic<uint32_t> errors_number(0);
+		std::atomic<bool> is_started(false);
+		std::vector<std::thread> decoding_threads;
+		for (uint32_t thread_index = 0; thread_index < THREADS_NUMBER; ++thread_index)
+		{
+			decoding_threads.emplace_back([&, thread_index]()
+										  {
+				while (!is_started.load())
+				{
+					std::this_thread::yield();
+				}
+
+				for (uint32_t round_index = 0; round_index < ROUNDS_NUMBER; ++round_index)
+				{
+					for (size_t file_number = 0; file_number < texture_files.size(); ++file_number)
+					{
+						const size_t file_index = (file_number + thread_index * 7) % texture_files.size();
+						try
+						{
+							if (inflate_texture(texture_files[file_index]) != expected_outputs[file_index])
+							{
+								++mismatches_number;
+							}
+						}
+						catch (const std::exception &)
+						{
+							++errors_number;
+						}
+					}
+				} });
+		}
+
+		is_started.store(true);
+		for (std::thread &decoding_thread : decoding_threads)
+		{
+			decoding_thread.join();
+		}
+
+		GW2DT_CHECK(errors_number.load() == 0);
+		GW2DT_CHECK(mismatches_number.load() == 0);
+	}
+}
+
+int main()
+{
+	return testing::run_tests({
+		{"concurrent_decoding_matches", test_concurrent_decoding_matches},
+	});
+}
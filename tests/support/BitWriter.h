@@ -0,0 +1,83 @@
+#ifndef GW2DATTOOLS_TESTING_BITWRITER_H
+#define GW2DATTOOLS_TESTING_BITWRITER_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gw2dt
+{
+    namespace testing
+    {
+
+        // Writes bits the way BitArray reads them: 32 bits words, most significant bit first
+        class BitWriter
+        {
+        public:
+            // Writes the bits_number low bits of value_data, at most 32
+            void write(uint32_t value_data, uint32_t bits_number)
+            {
+                if (bits_number == 0)
+                {
+                    return;
+                }
+
+                pending_bits = (pending_bits << bits_number) | (value_data & (~0ull >> (64 - bits_number)));
+                pending_size += bits_number;
+                if (pending_size >= 32)
+                {
+                    pending_size -= 32;
+                    words_data.push_back(static_cast<uint32_t>(pending_bits >> pending_size));
+                    pending_bits &= (1ull << pending_size) - 1;
+                }
+            }
+
+            // Pads the last word with zeros and returns every word written
+            std::vector<uint32_t> finish()
+            {
+                if (pending_size != 0)
+                {
+                    write(0, 32 - pending_size);
+                }
+                return std::move(words_data);
+            }
+
+        private:
+            std::vector<uint32_t> words_data;
+            uint64_t pending_bits = 0;
+            uint32_t pending_size = 0;
+        };
+
+        // Canonical code of a symbol, as HuffmanTreeBuilder assigns it
+        struct HuffmanCode
+        {
+            uint32_t code_data = 0;
+            uint8_t bits_data = 0;
+        };
+
+        // Codes of symbols added to a HuffmanTreeBuilder in this order with these lengths,
+        // the last added symbol of a length gets its highest code
+        template <typename AddedSymbol>
+        std::vector<HuffmanCode> assign_huffman_codes(const std::vector<AddedSymbol> &added_symbols, uint32_t symbols_number)
+        {
+            std::vector<HuffmanCode> codes(symbols_number);
+            int64_t code_data = 0;
+            for (uint8_t bits_data = 0; bits_data < 32; ++bits_data)
+            {
+                for (auto symbol_it = added_symbols.rbegin(); symbol_it != added_symbols.rend(); ++symbol_it)
+                {
+                    if (symbol_it->bits_data == bits_data)
+                    {
+                        codes[symbol_it->symbol_data] = HuffmanCode{static_cast<uint32_t>(code_data), bits_data};
+                        --code_data;
+                    }
+                }
+                code_data = (code_data << 1) + 1;
+            }
+            return codes;
+        }
+
+    }
+}
+
+#endif // GW2DATTOOLS_TESTING_BITWRITER_H
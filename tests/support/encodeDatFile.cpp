@@ -0,0 +1,468 @@
+#include "encodeDatFile.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+
+#include "BitWriter.h"
+
+namespace gw2dt
+{
+	namespace testing
+	{
+		namespace
+		{
+			struct DictionaryCode
+			{
+				uint8_t symbol_data;
+				uint8_t bits_data;
+			};
+
+			// Same dictionary as the decoder, in the order it is added to the builder
+			const DictionaryCode DAT_FILE_DICTIONARY_CODES[] = {
+				{0x0A, 3}, {0x09, 3}, {0x08, 3},
+
+				{0x0C, 4}, {0x0B, 4}, {0x07, 4}, {0x00, 4},
+
+				{0xE0, 5}, {0x2A, 5}, {0x29, 5}, {0x06, 5},
+
+				{0x4A, 6}, {0x40, 6}, {0x2C, 6}, {0x2B, 6}, {0x28, 6}, {0x20, 6}, {0x05, 6}, {0x04, 6},
+
+				{0x49, 7}, {0x48, 7}, {0x27, 7}, {0x26, 7}, {0x25, 7}, {0x0D, 7}, {0x03, 7},
+
+				{0x6A, 8}, {0x69, 8}, {0x4C, 8}, {0x4B, 8}, {0x47, 8}, {0x24, 8},
+
+				{0xE8, 9}, {0xA0, 9}, {0x89, 9}, {0x88, 9}, {0x68, 9}, {0x67, 9}, {0x63, 9}, {0x60, 9},
+				{0x46, 9}, {0x23, 9},
+
+				{0xE9, 10}, {0xC9, 10}, {0xC0, 10}, {0xA9, 10}, {0xA8, 10}, {0x8A, 10}, {0x87, 10}, {0x80, 10},
+				{0x66, 10}, {0x65, 10}, {0x45, 10}, {0x44, 10}, {0x43, 10}, {0x2D, 10}, {0x02, 10}, {0x01, 10},
+
+				{0xE5, 11}, {0xC8, 11}, {0xAA, 11}, {0xA5, 11}, {0xA4, 11}, {0x8B, 11}, {0x85, 11}, {0x84, 11},
+				{0x6C, 11}, {0x6B, 11}, {0x64, 11}, {0x4D, 11}, {0x0E, 11},
+
+				{0xE7, 12}, {0xCA, 12}, {0xC7, 12}, {0xA7, 12}, {0xA6, 12}, {0x86, 12}, {0x83, 12},
+
+				{0xE6, 13}, {0xE4, 13}, {0xC4, 13}, {0x8C, 13}, {0x2E, 13}, {0x22, 13},
+
+				{0xEC, 14}, {0xC6, 14}, {0x6D, 14}, {0x4E, 14},
+
+				{0xEA, 15}, {0xCC, 15}, {0xAC, 15}, {0xAB, 15}, {0x8D, 15}, {0x11, 15}, {0x10, 15}, {0x0F, 15},
+
+				{0xFF, 16}, {0xFE, 16}, {0xFD, 16}, {0xFC, 16}, {0xFB, 16}, {0xFA, 16}, {0xF9, 16}, {0xF8, 16},
+				{0xF7, 16}, {0xF6, 16}, {0xF5, 16}, {0xF4, 16}, {0xF3, 16}, {0xF2, 16}, {0xF1, 16}, {0xF0, 16},
+				{0xEF, 16}, {0xEE, 16}, {0xED, 16}, {0xEB, 16}, {0xE3, 16}, {0xE2, 16}, {0xE1, 16}, {0xDF, 16},
+				{0xDE, 16}, {0xDD, 16}, {0xDC, 16}, {0xDB, 16}, {0xDA, 16}, {0xD9, 16}, {0xD8, 16}, {0xD7, 16},
+				{0xD6, 16}, {0xD5, 16}, {0xD4, 16}, {0xD3, 16}, {0xD2, 16}, {0xD1, 16}, {0xD0, 16}, {0xCF, 16},
+				{0xCE, 16}, {0xCD, 16}, {0xCB, 16}, {0xC5, 16}, {0xC3, 16}, {0xC2, 16}, {0xC1, 16}, {0xBF, 16},
+				{0xBE, 16}, {0xBD, 16}, {0xBC, 16}, {0xBB, 16}, {0xBA, 16}, {0xB9, 16}, {0xB8, 16}, {0xB7, 16},
+				{0xB6, 16}, {0xB5, 16}, {0xB4, 16}, {0xB3, 16}, {0xB2, 16}, {0xB1, 16}, {0xB0, 16}, {0xAF, 16},
+				{0xAE, 16}, {0xAD, 16}, {0xA3, 16}, {0xA2, 16}, {0xA1, 16}, {0x9F, 16}, {0x9E, 16}, {0x9D, 16},
+				{0x9C, 16}, {0x9B, 16}, {0x9A, 16}, {0x99, 16}, {0x98, 16}, {0x97, 16}, {0x96, 16}, {0x95, 16},
+				{0x94, 16}, {0x93, 16}, {0x92, 16}, {0x91, 16}, {0x90, 16}, {0x8F, 16}, {0x8E, 16}, {0x82, 16},
+				{0x81, 16}, {0x7F, 16}, {0x7E, 16}, {0x7D, 16}, {0x7C, 16}, {0x7B, 16}, {0x7A, 16}, {0x79, 16},
+				{0x78, 16}, {0x77, 16}, {0x76, 16}, {0x75, 16}, {0x74, 16}, {0x73, 16}, {0x72, 16}, {0x71, 16},
+				{0x70, 16}, {0x6F, 16}, {0x6E, 16}, {0x62, 16}, {0x61, 16}, {0x5F, 16}, {0x5E, 16}, {0x5D, 16},
+				{0x5C, 16}, {0x5B, 16}, {0x5A, 16}, {0x59, 16}, {0x58, 16}, {0x57, 16}, {0x56, 16}, {0x55, 16},
+				{0x54, 16}, {0x53, 16}, {0x52, 16}, {0x51, 16}, {0x50, 16}, {0x4F, 16}, {0x42, 16}, {0x41, 16},
+				{0x3F, 16}, {0x3E, 16}, {0x3D, 16}, {0x3C, 16}, {0x3B, 16}, {0x3A, 16}, {0x39, 16}, {0x38, 16},
+				{0x37, 16}, {0x36, 16}, {0x35, 16}, {0x34, 16}, {0x33, 16}, {0x32, 16}, {0x31, 16}, {0x30, 16},
+				{0x2F, 16}, {0x21, 16}, {0x1F, 16}, {0x1E, 16}, {0x1D, 16}, {0x1C, 16}, {0x1B, 16}, {0x1A, 16},
+				{0x19, 16}, {0x18, 16}, {0x17, 16}, {0x16, 16}, {0x15, 16}, {0x14, 16}, {0x13, 16}, {0x12, 16},
+			};
+
+			const uint32_t SYMBOLS_NUMBER = 285;
+			const uint32_t WRITE_OFFSET_CODES_NUMBER = 34;
+			const uint32_t MAX_CODE_BITS = 31;
+			const uint32_t MAX_WRITE_SIZE = 255;
+			const uint32_t MAX_WRITE_OFFSET = 1 << 17;
+			const uint32_t MIN_COPY_SIZE = 4;
+			const uint32_t SKIPPED_WORDS_PERIOD = 16384;
+
+			// A literal when write_offset is 0, else a copy
+			struct Token
+			{
+				uint32_t value_data;
+				uint32_t write_offset;
+			};
+
+			// Symbol of a value, with the value of its additional bits
+			struct CopyCode
+			{
+				uint32_t symbol_data;
+				uint32_t extra_bits;
+				uint32_t extra_value;
+			};
+
+			// Write size without the constant addition, from 0 to 255
+			CopyCode get_write_size_code(uint32_t write_size)
+			{
+				if (write_size < 8)
+				{
+					return {write_size, 0, 0};
+				}
+				const uint32_t size_quot = std::bit_width(write_size) - 2;
+				const uint32_t extra_bits = size_quot - 1;
+				return {size_quot * 4 + (write_size >> extra_bits) - 4, extra_bits, write_size & ((1u << extra_bits) - 1)};
+			}
+
+			// Write offset minus one, from 0 to 131071
+			CopyCode get_write_offset_code(uint32_t write_offset)
+			{
+				if (write_offset < 2)
+				{
+					return {write_offset, 0, 0};
+				}
+				const uint32_t offset_quot = std::bit_width(write_offset) - 1;
+				const uint32_t extra_bits = offset_quot - 1;
+				return {offset_quot * 2 + (write_offset >> extra_bits) - 2, extra_bits, write_offset & ((1u << extra_bits) - 1)};
+			}
+
+			// Greedy matching on a hash of the next four bytes, copies are at least max(4, min_copy_size) long
+			std::vector<Token> tokenize(std::span<const uint8_t> input_data, uint32_t min_copy_size, uint32_t max_copy_size, bool use_copies)
+			{
+				std::vector<Token> tokens;
+				tokens.reserve(input_data.size());
+
+				const uint32_t hash_bits = 16;
+				std::vector<int64_t> chain_heads(1u << hash_bits, -1);
+				std::vector<int64_t> chain_links(input_data.size(), -1);
+				auto hash_at = [&](size_t position)
+				{
+					uint32_t value_data;
+					memcpy(&value_data, input_data.data() + position, 4);
+					return (value_data * 2654435761u) >> (32 - hash_bits);
+				};
+				auto insert_at = [&](size_t position)
+				{
+					if (position + 4 <= input_data.size())
+					{
+						const uint32_t hash_data = hash_at(position);
+						chain_links[position] = chain_heads[hash_data];
+						chain_heads[hash_data] = static_cast<int64_t>(position);
+					}
+				};
+
+				size_t position = 0;
+				while (position < input_data.size())
+				{
+					uint32_t best_size = 0;
+					uint32_t best_offset = 0;
+					if (use_copies && position + 4 <= input_data.size())
+					{
+						int64_t candidate = chain_heads[hash_at(position)];
+						for (uint32_t depth = 0; depth < 8 && candidate >= 0; ++depth, candidate = chain_links[candidate])
+						{
+							const size_t write_offset = position - static_cast<size_t>(candidate);
+							if (write_offset > MAX_WRITE_OFFSET)
+							{
+								break;
+							}
+							const size_t max_size = std::min<size_t>(max_copy_size, input_data.size() - position);
+							uint32_t copy_size = 0;
+							while (copy_size < max_size && input_data[candidate + copy_size] == input_data[position + copy_size])
+							{
+								++copy_size;
+							}
+							if (copy_size > best_size)
+							{
+								best_size = copy_size;
+								best_offset = static_cast<uint32_t>(write_offset);
+							}
+						}
+					}
+
+					if (best_size >= std::max(MIN_COPY_SIZE, min_copy_size))
+					{
+						tokens.push_back({best_size, best_offset});
+						for (size_t copy_position = position; copy_position < position + best_size; ++copy_position)
+						{
+							insert_at(copy_position);
+						}
+						position += best_size;
+					}
+					else
+					{
+						tokens.push_back({input_data[position], 0});
+						insert_at(position);
+						++position;
+					}
+				}
+				return tokens;
+			}
+
+			struct AddedSymbol
+			{
+				uint16_t symbol_data;
+				uint8_t bits_data;
+			};
+
+			// Writes the code lengths of a tree with the dictionary, returns the codes of its symbols
+			std::vector<HuffmanCode> write_huffman_tree(BitWriter &bit_writer, const std::vector<HuffmanCode> &dictionary_codes,
+													   const std::vector<uint8_t> &code_lengths)
+			{
+				const uint32_t symbols_number = static_cast<uint32_t>(code_lengths.size());
+				bit_writer.write(symbols_number, 16);
+
+				// Runs of at most 8 symbols of the same length, from the last symbol to the first
+				int32_t symbol_data = static_cast<int32_t>(symbols_number) - 1;
+				while (symbol_data >= 0)
+				{
+					const uint8_t bits_data = code_lengths[symbol_data];
+					uint32_t run_size = 1;
+					while (run_size < 8 && symbol_data - static_cast<int32_t>(run_size) >= 0 && code_lengths[symbol_data - run_size] == bits_data)
+					{
+						++run_size;
+					}
+					const HuffmanCode &run_code = dictionary_codes[((run_size - 1) << 5) | bits_data];
+					bit_writer.write(run_code.code_data, run_code.bits_data);
+					symbol_data -= static_cast<int32_t>(run_size);
+				}
+
+				std::vector<AddedSymbol> added_symbols;
+				for (int32_t added_symbol = static_cast<int32_t>(symbols_number) - 1; added_symbol >= 0; --added_symbol)
+				{
+					if (code_lengths[added_symbol] != 0)
+					{
+						added_symbols.push_back({static_cast<uint16_t>(added_symbol), code_lengths[added_symbol]});
+					}
+				}
+				return assign_huffman_codes(added_symbols, symbols_number);
+			}
+		}
+
+		std::vector<uint8_t> get_huffman_code_lengths(std::vector<uint64_t> frequencies)
+		{
+			std::vector<uint8_t> code_lengths(frequencies.size(), 0);
+			while (true)
+			{
+				typedef std::pair<uint64_t, uint32_t> Node;
+				std::priority_queue<Node, std::vector<Node>, std::greater<Node>> nodes;
+				std::vector<int32_t> parents;
+				for (uint32_t symbol_data = 0; symbol_data < frequencies.size(); ++symbol_data)
+				{
+					if (frequencies[symbol_data] != 0)
+					{
+						nodes.push({frequencies[symbol_data], static_cast<uint32_t>(parents.size())});
+						parents.push_back(-1);
+					}
+				}
+				if (nodes.size() == 1)
+				{
+					for (uint32_t symbol_data = 0; symbol_data < frequencies.size(); ++symbol_data)
+					{
+						code_lengths[symbol_data] = frequencies[symbol_data] != 0 ? 1 : 0;
+					}
+					return code_lengths;
+				}
+
+				const uint32_t leaves_number = static_cast<uint32_t>(parents.size());
+				while (nodes.size() > 1)
+				{
+					const Node first_node = nodes.top();
+					nodes.pop();
+					const Node second_node = nodes.top();
+					nodes.pop();
+					parents[first_node.second] = static_cast<int32_t>(parents.size());
+					parents[second_node.second] = static_cast<int32_t>(parents.size());
+					nodes.push({first_node.first + second_node.first, static_cast<uint32_t>(parents.size())});
+					parents.push_back(-1);
+				}
+
+				uint32_t max_length = 0;
+				uint32_t leaf_index = 0;
+				for (uint32_t symbol_data = 0; symbol_data < frequencies.size(); ++symbol_data)
+				{
+					if (frequencies[symbol_data] == 0)
+					{
+						continue;
+					}
+					uint32_t code_length = 0;
+					for (int32_t node_index = static_cast<int32_t>(leaf_index); parents[node_index] >= 0; node_index = parents[node_index])
+					{
+						++code_length;
+					}
+					code_lengths[symbol_data] = static_cast<uint8_t>(code_length);
+					max_length = std::max(max_length, code_length);
+					++leaf_index;
+				}
+				if (leaf_index != leaves_number)
+				{
+					throw std::logic_error("Invalid Huffman tree.");
+				}
+				if (max_length <= MAX_CODE_BITS)
+				{
+					return code_lengths;
+				}
+
+				for (uint64_t &frequency : frequencies)
+				{
+					frequency = frequency != 0 ? (frequency + 1) / 2 : 0;
+				}
+			}
+		}
+
+		std::vector<uint8_t> encode_dat_file(std::span<const uint8_t> input_data, const DatFileEncoding &encoding, uint64_t *copies_number)
+		{
+			if (encoding.write_size_const_addition < 1 || encoding.write_size_const_addition > 16 || encoding.block_max_count > 15)
+			{
+				throw std::runtime_error("Invalid dat file encoding.");
+			}
+
+			const std::vector<DictionaryCode> dictionary_symbols(std::begin(DAT_FILE_DICTIONARY_CODES), std::end(DAT_FILE_DICTIONARY_CODES));
+			const std::vector<HuffmanCode> dictionary_codes = assign_huffman_codes(dictionary_symbols, 256);
+
+			const std::vector<Token> tokens = tokenize(input_data, encoding.write_size_const_addition,
+													   MAX_WRITE_SIZE + encoding.write_size_const_addition, encoding.use_copies);
+			if (copies_number != nullptr)
+			{
+				*copies_number = std::count_if(tokens.begin(), tokens.end(), [](const Token &token)
+											   { return token.write_offset != 0; });
+			}
+
+			BitWriter bit_writer;
+			bit_writer.write(0, 32);
+			bit_writer.write(static_cast<uint32_t>(input_data.size()), 32);
+			bit_writer.write(0, 4);
+			bit_writer.write(encoding.write_size_const_addition - 1, 4);
+
+			const size_t block_codes = static_cast<size_t>(encoding.block_max_count + 1) << 12;
+			for (size_t block_start = 0; block_start < tokens.size(); block_start += block_codes)
+			{
+				const std::span<const Token> block_tokens = std::span<const Token>(tokens).subspan(block_start, std::min(block_codes, tokens.size() - block_start));
+
+				std::vector<uint64_t> symbol_frequencies(SYMBOLS_NUMBER, 0);
+				std::vector<uint64_t> offset_frequencies(WRITE_OFFSET_CODES_NUMBER, 0);
+				for (const Token &token : block_tokens)
+				{
+					if (token.write_offset == 0)
+					{
+						++symbol_frequencies[token.value_data];
+						continue;
+					}
+					++symbol_frequencies[0x100 + get_write_size_code(token.value_data - encoding.write_size_const_addition).symbol_data];
+					++offset_frequencies[get_write_offset_code(token.write_offset - 1).symbol_data];
+				}
+				if (std::all_of(offset_frequencies.begin(), offset_frequencies.end(), [](uint64_t frequency) { return frequency == 0; }))
+				{
+					offset_frequencies[0] = 1;
+				}
+
+				const std::vector<HuffmanCode> symbol_codes = write_huffman_tree(bit_writer, dictionary_codes, get_huffman_code_lengths(symbol_frequencies));
+				const std::vector<HuffmanCode> offset_codes = write_huffman_tree(bit_writer, dictionary_codes, get_huffman_code_lengths(offset_frequencies));
+				bit_writer.write(encoding.block_max_count, 4);
+
+				for (const Token &token : block_tokens)
+				{
+					if (token.write_offset == 0)
+					{
+						bit_writer.write(symbol_codes[token.value_data].code_data, symbol_codes[token.value_data].bits_data);
+						continue;
+					}
+
+					const CopyCode size_code = get_write_size_code(token.value_data - encoding.write_size_const_addition);
+					const HuffmanCode &size_symbol = symbol_codes[0x100 + size_code.symbol_data];
+					bit_writer.write(size_symbol.code_data, size_symbol.bits_data);
+					bit_writer.write(size_code.extra_value, size_code.extra_bits);
+
+					const CopyCode offset_code = get_write_offset_code(token.write_offset - 1);
+					const HuffmanCode &offset_symbol = offset_codes[offset_code.symbol_data];
+					bit_writer.write(offset_symbol.code_data, offset_symbol.bits_data);
+					bit_writer.write(offset_code.extra_value, offset_code.extra_bits);
+				}
+			}
+
+			// An empty tree ends the data, followed by the padding the reader may look ahead into
+			bit_writer.write(0, 16);
+			bit_writer.write(0, 32);
+			bit_writer.write(0, 32);
+
+			// One word every SKIPPED_WORDS_PERIOD is not part of the bit stream
+			std::vector<uint8_t> output_data;
+			uint32_t output_words = 0;
+			for (uint32_t word_data : bit_writer.finish())
+			{
+				if (output_words % SKIPPED_WORDS_PERIOD == SKIPPED_WORDS_PERIOD - 1)
+				{
+					const uint32_t skipped_word = 0xDEADBEEF;
+					output_data.insert(output_data.end(), reinterpret_cast<const uint8_t *>(&skipped_word), reinterpret_cast<const uint8_t *>(&skipped_word) + 4);
+					++output_words;
+				}
+				output_data.insert(output_data.end(), reinterpret_cast<const uint8_t *>(&word_data), reinterpret_cast<const uint8_t *>(&word_data) + 4);
+				++output_words;
+			}
+			return output_data;
+		}
+
+		std::vector<uint8_t> make_dat_corpus(DatCorpusKind kind, uint32_t size_data, uint32_t seed_data)
+		{
+			std::mt19937 random_engine(seed_data);
+			auto random_below = [&](uint32_t bound) { return static_cast<uint32_t>(random_engine() % bound); };
+
+			std::vector<uint8_t> corpus_data;
+			corpus_data.reserve(size_data + 16);
+			switch (kind)
+			{
+			case DAT_CORPUS_TEXT:
+			{
+				std::vector<std::vector<uint8_t>> words(300);
+				for (std::vector<uint8_t> &word : words)
+				{
+					word.resize(2 + random_below(8));
+					for (uint8_t &letter : word)
+					{
+						letter = static_cast<uint8_t>('a' + random_below(26));
+					}
+				}
+				while (corpus_data.size() < size_data)
+				{
+					const std::vector<uint8_t> &word = words[random_below(static_cast<uint32_t>(words.size()))];
+					corpus_data.insert(corpus_data.end(), word.begin(), word.end());
+					corpus_data.push_back(' ');
+				}
+				break;
+			}
+			case DAT_CORPUS_ZEROS:
+			{
+				corpus_data.assign(size_data, 0);
+				for (uint32_t byte_index = 0; byte_index < size_data / 500; ++byte_index)
+				{
+					corpus_data[random_below(size_data)] = static_cast<uint8_t>(random_below(256));
+				}
+				break;
+			}
+			case DAT_CORPUS_VERTICES:
+			{
+				const float coordinates[] = {0.0f, 1.0f, 0.5f, -1.0f};
+				const uint32_t colors[] = {0xFFFFFFFF, 0, 0x80808080};
+				while (corpus_data.size() < size_data)
+				{
+					const float vertex_data[3] = {coordinates[random_below(4)], random_below(2) ? static_cast<float>(random_below(1000)) / 1000.0f : 0.0f, 1.0f};
+					const uint32_t color_data = colors[random_below(3)];
+					const uint8_t *vertex_bytes = reinterpret_cast<const uint8_t *>(vertex_data);
+					corpus_data.insert(corpus_data.end(), vertex_bytes, vertex_bytes + sizeof(vertex_data));
+					corpus_data.insert(corpus_data.end(), reinterpret_cast<const uint8_t *>(&color_data), reinterpret_cast<const uint8_t *>(&color_data) + 4);
+				}
+				break;
+			}
+			case DAT_CORPUS_RANDOM:
+			{
+				corpus_data.resize(size_data);
+				for (uint8_t &byte_data : corpus_data)
+				{
+					byte_data = static_cast<uint8_t>(random_below(256));
+				}
+				break;
+			}
+			}
+
+			corpus_data.resize(size_data);
+			return corpus_data;
+		}
+
+	}
+}
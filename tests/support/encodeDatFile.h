@@ -0,0 +1,54 @@
+#ifndef GW2DATTOOLS_TESTING_ENCODEDATFILE_H
+#define GW2DATTOOLS_TESTING_ENCODEDATFILE_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gw2dt
+{
+    namespace testing
+    {
+
+        struct DatFileEncoding
+        {
+            // Added to every copy size, from 1 to 16
+            uint16_t write_size_const_addition = 4;
+            // Every block but the last holds (block_max_count + 1) << 12 codes, from 0 to 15
+            uint8_t block_max_count = 0;
+            // false to only write literals
+            bool use_copies = true;
+        };
+
+        /** @Inputs:
+         *    - input_data: Data to compress
+         *    - encoding: Shape of the compressed data
+         *  @Outputs:
+         *    - copies_number: if not null, number of copy codes written
+         *  @Return:
+         *    - A dat entry inflate_dat_file_buffer decodes back to input_data, skipped words included
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        std::vector<uint8_t> encode_dat_file(std::span<const uint8_t> input_data, const DatFileEncoding &encoding = DatFileEncoding(),
+                                             uint64_t *copies_number = nullptr);
+
+        // Huffman code lengths of the symbols of non zero frequency, frequencies are flattened until every code fits in 31 bits
+        std::vector<uint8_t> get_huffman_code_lengths(std::vector<uint64_t> frequencies);
+
+        enum DatCorpusKind
+        {
+            DAT_CORPUS_TEXT,     // words separated by spaces, many short copies
+            DAT_CORPUS_ZEROS,    // zeros with a few random bytes, long copies
+            DAT_CORPUS_VERTICES, // repeated 16 bytes records
+            DAT_CORPUS_RANDOM    // no copy at all
+        };
+
+        // size_data bytes of data shaped like kind, the same for a given seed_data
+        std::vector<uint8_t> make_dat_corpus(DatCorpusKind kind, uint32_t size_data, uint32_t seed_data);
+
+    }
+}
+
+#endif // GW2DATTOOLS_TESTING_ENCODEDATFILE_H
@@ -0,0 +1,222 @@
+#include "encodeTextureFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+#include "BitWriter.h"
+
+namespace gw2dt
+{
+	namespace testing
+	{
+		namespace
+		{
+			struct DictionaryCode
+			{
+				uint8_t symbol_data;
+				uint8_t bits_data;
+			};
+
+			// Same dictionary of the block counts as the decoder, in the order it is added to the builder
+			const DictionaryCode TEXTURE_DICTIONARY_CODES[] = {
+				{0x01, 1},
+
+				{0x12, 2},
+
+				{0x11, 6}, {0x10, 6}, {0x0F, 6}, {0x0E, 6}, {0x0D, 6}, {0x0C, 6}, {0x0B, 6}, {0x0A, 6},
+				{0x09, 6}, {0x08, 6}, {0x07, 6}, {0x06, 6}, {0x05, 6}, {0x04, 6}, {0x03, 6}, {0x02, 6},
+			};
+
+			const uint32_t MAX_RUN_SIZE = 0x12;
+			const uint32_t SKIPPED_WORDS_PERIOD = 0x4000;
+			// Identifier, format, size, then the level size and its compression flags
+			const uint32_t HEADER_WORDS = 5;
+
+			class TextureEncoder
+			{
+			public:
+				TextureEncoder(uint32_t blocks_number, uint32_t seed_data) : color_map(blocks_number, false),
+																			 alpha_map(blocks_number, false),
+																			 random_engine(seed_data)
+				{
+					const std::vector<DictionaryCode> dictionary_symbols(std::begin(TEXTURE_DICTIONARY_CODES), std::end(TEXTURE_DICTIONARY_CODES));
+					dictionary_codes = assign_huffman_codes(dictionary_symbols, MAX_RUN_SIZE + 1);
+				}
+
+				// Random runs over the blocks not set in run_map, fill_function is called on the blocks of the filled runs
+				// Returns false if run_map is already full, the decoder would then read a run past the end
+				template <typename ValueFunction, typename FillFunction>
+				bool write_runs(std::vector<bool> &run_map, ValueFunction &&value_function, FillFunction &&fill_function)
+				{
+					size_t clear_number = std::count(run_map.begin(), run_map.end(), false);
+					size_t block_position = 0;
+					while (block_position < run_map.size())
+					{
+						if (clear_number == 0)
+						{
+							return false;
+						}
+
+						const uint32_t run_size = 1 + random_below(static_cast<uint32_t>(std::min<size_t>(MAX_RUN_SIZE, clear_number)));
+						const bool is_filled = random_below(2) != 0;
+						bit_writer.write(dictionary_codes[run_size].code_data, dictionary_codes[run_size].bits_data);
+						value_function(is_filled);
+
+						for (uint32_t remaining_size = run_size; remaining_size > 0; ++block_position)
+						{
+							if (!run_map[block_position])
+							{
+								if (is_filled)
+								{
+									fill_function(block_position);
+								}
+								--remaining_size;
+								--clear_number;
+							}
+						}
+						while (block_position < run_map.size() && run_map[block_position])
+						{
+							++block_position;
+						}
+					}
+					return true;
+				}
+
+				uint32_t random_below(uint32_t bound) { return static_cast<uint32_t>(random_engine() % bound); }
+
+				BitWriter bit_writer;
+				std::vector<bool> color_map;
+				std::vector<bool> alpha_map;
+
+			private:
+				std::vector<HuffmanCode> dictionary_codes;
+				std::mt19937 random_engine;
+			};
+
+			// Encodes the passes of compression_flags, false if a pass found no block left to encode
+			bool write_passes(TextureEncoder &texture_encoder, uint32_t compression_flags)
+			{
+				BitWriter &bit_writer = texture_encoder.bit_writer;
+				auto write_value = [&](bool is_filled) { bit_writer.write(is_filled ? 1 : 0, 1); };
+				auto write_alpha_value = [&](bool is_filled)
+				{
+					bit_writer.write(is_filled ? 1 : 0, 1);
+					if (is_filled)
+					{
+						bit_writer.write(texture_encoder.random_below(2), 1);
+					}
+				};
+				auto fill_both = [&](size_t block_position)
+				{
+					texture_encoder.color_map[block_position] = true;
+					texture_encoder.alpha_map[block_position] = true;
+				};
+				auto fill_alpha = [&](size_t block_position) { texture_encoder.alpha_map[block_position] = true; };
+				auto fill_color = [&](size_t block_position) { texture_encoder.color_map[block_position] = true; };
+
+				if ((compression_flags & 0x01) && !texture_encoder.write_runs(texture_encoder.color_map, write_value, fill_both))
+				{
+					return false;
+				}
+				if (compression_flags & 0x02)
+				{
+					bit_writer.write(texture_encoder.random_below(1u << 4), 4);
+					if (!texture_encoder.write_runs(texture_encoder.alpha_map, write_alpha_value, fill_alpha))
+					{
+						return false;
+					}
+				}
+				if (compression_flags & 0x04)
+				{
+					bit_writer.write(texture_encoder.random_below(1u << 8), 8);
+					if (!texture_encoder.write_runs(texture_encoder.alpha_map, write_alpha_value, fill_alpha))
+					{
+						return false;
+					}
+				}
+				if (compression_flags & 0x08)
+				{
+					bit_writer.write(texture_encoder.random_below(1u << 24), 24);
+					if (!texture_encoder.write_runs(texture_encoder.color_map, write_value, fill_color))
+					{
+						return false;
+					}
+				}
+				for (uint32_t bptc_flag : {0x10u, 0x20u})
+				{
+					if ((compression_flags & bptc_flag) && !texture_encoder.write_runs(texture_encoder.color_map, write_value, fill_both))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+
+			// Little endian, like the files
+			void append_word(std::vector<uint8_t> &output_data, uint32_t word_data)
+			{
+				for (uint32_t byte_index = 0; byte_index < 4; ++byte_index)
+				{
+					output_data.push_back(static_cast<uint8_t>(word_data >> (8 * byte_index)));
+				}
+			}
+		}
+
+		std::vector<uint8_t> encode_texture_file(uint32_t format_four_cc, uint16_t width, uint16_t height, uint32_t compression_flags, uint32_t seed_data)
+		{
+			if (width == 0 || height == 0)
+			{
+				throw std::runtime_error("Empty texture.");
+			}
+
+			const uint32_t blocks_number = ((width + 3) / 4) * ((height + 3) / 4);
+
+			// Some random runs leave nothing for the next pass, another seed is then tried
+			std::vector<uint32_t> stream_words;
+			for (uint32_t attempt_index = 0;; ++attempt_index)
+			{
+				TextureEncoder texture_encoder(blocks_number, seed_data + attempt_index * 0x9E3779B9u);
+				if (write_passes(texture_encoder, compression_flags))
+				{
+					stream_words = texture_encoder.bit_writer.finish();
+					break;
+				}
+			}
+
+			// The last word of every 64KB chunk of the file is skipped by the bit stream
+			std::vector<uint32_t> payload_words;
+			for (uint32_t word_data : stream_words)
+			{
+				if ((HEADER_WORDS + payload_words.size() + 1) % SKIPPED_WORDS_PERIOD == 0)
+				{
+					payload_words.push_back(0);
+				}
+				payload_words.push_back(word_data);
+			}
+
+			// Raw blocks, with some margin whatever the format
+			std::mt19937 random_engine(seed_data ^ 0x5A5A5A5Au);
+			for (uint32_t word_index = 0; word_index < blocks_number * 4 + 8; ++word_index)
+			{
+				payload_words.push_back(static_cast<uint32_t>(random_engine()));
+			}
+
+			std::vector<uint8_t> output_data;
+			output_data.reserve((HEADER_WORDS + payload_words.size()) * 4);
+			append_word(output_data, 0x58455441); // "ATEX"
+			append_word(output_data, format_four_cc);
+			append_word(output_data, (static_cast<uint32_t>(width) << 16) | height);
+			// Size of the rest of the level, compression flags included
+			append_word(output_data, static_cast<uint32_t>((payload_words.size() + 1) * 4));
+			append_word(output_data, compression_flags);
+			for (uint32_t word_data : payload_words)
+			{
+				append_word(output_data, word_data);
+			}
+			return output_data;
+		}
+
+	}
+}
@@ -0,0 +1,43 @@
+#ifndef GW2DATTOOLS_TESTING_ENCODETEXTUREFILE_H
+#define GW2DATTOOLS_TESTING_ENCODETEXTUREFILE_H
+
+#include <cstdint>
+#include <vector>
+
+namespace gw2dt
+{
+    namespace testing
+    {
+
+        // FourCCs of the texture formats the decoder knows
+        const uint32_t TEXTURE_FORMATS[] = {
+            0x31545844, // "DXT1"
+            0x32545844, // "DXT2"
+            0x33545844, // "DXT3"
+            0x34545844, // "DXT4"
+            0x35545844, // "DXT5"
+            0x41545844, // "DXTA"
+            0x4C545844, // "DXTL"
+            0x4E545844, // "DXTN"
+            0x58434433, // "3DCX"
+            0x48364342, // "BC6H"
+            0x58374342  // "BC7X"
+        };
+
+        /** @Inputs:
+         *    - format_four_cc: One of TEXTURE_FORMATS
+         *    - width, height: Size of the image in pixels
+         *    - compression_flags: Passes the bit stream holds, any combination of 0x01 to 0x20
+         *    - seed_data: Seed of the random runs and raw blocks
+         *  @Return:
+         *    - An "ATEX" file of one level, random runs for every pass then random raw blocks
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        std::vector<uint8_t> encode_texture_file(uint32_t format_four_cc, uint16_t width, uint16_t height, uint32_t compression_flags, uint32_t seed_data);
+
+    }
+}
+
+#endif // GW2DATTOOLS_TESTING_ENCODETEXTUREFILE_H
@@ -0,0 +1,56 @@
+#ifndef GW2DATTOOLS_TESTING_TESTCHECK_H
+#define GW2DATTOOLS_TESTING_TESTCHECK_H
+
+#include <cstdio>
+#include <exception>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+
+namespace gw2dt
+{
+    namespace testing
+    {
+
+        typedef void (*TestFunction)();
+
+        struct TestCase
+        {
+            const char *name_data;
+            TestFunction test_function;
+        };
+
+        inline void check(bool condition_data, const char *condition_text, const char *file_name, int line_number)
+        {
+            if (!condition_data)
+            {
+                throw std::runtime_error(std::string(file_name) + ":" + std::to_string(line_number) + ": " + condition_text);
+            }
+        }
+
+        // Runs every test, reports the failed ones and returns the exit code of the test program
+        inline int run_tests(std::initializer_list<TestCase> test_cases)
+        {
+            int failed_number = 0;
+            for (const TestCase &test_case : test_cases)
+            {
+                try
+                {
+                    test_case.test_function();
+                    std::printf("[ OK ] %s\n", test_case.name_data);
+                }
+                catch (const std::exception &exception_data)
+                {
+                    std::printf("[FAIL] %s: %s\n", test_case.name_data, exception_data.what());
+                    ++failed_number;
+                }
+            }
+            return failed_number == 0 ? 0 : 1;
+        }
+
+    }
+}
+
+#define GW2DT_CHECK(condition_data) gw2dt::testing::check((condition_data), #condition_data, __FILE__, __LINE__)
+
+#endif // GW2DATTOOLS_TESTING_TESTCHECK_H
@@ -0,0 +1,109 @@
+#include "writeDatArchive.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "encodeDatFile.h"
+
+namespace gw2dt
+{
+	namespace testing
+	{
+		namespace
+		{
+			const uint32_t ARCHIVE_HEADER_SIZE = 40;
+			const uint32_t MFT_ENTRY_SIZE = 24;
+			const uint16_t COMPRESSED_FLAG = 8;
+
+			// Fields are little endian and not aligned
+			template <typename ValueType>
+			void store_value(std::vector<uint8_t> &output_data, size_t position, ValueType value_data)
+			{
+				memcpy(output_data.data() + position, &value_data, sizeof(ValueType));
+			}
+
+			void store_mft_entry(std::vector<uint8_t> &archive_data, uint64_t mft_offset, uint32_t entry_index,
+								 uint64_t offset, uint32_t size_data, uint16_t compression_flag)
+			{
+				const size_t entry_position = mft_offset + static_cast<size_t>(entry_index) * MFT_ENTRY_SIZE;
+				store_value<uint64_t>(archive_data, entry_position, offset);
+				store_value<uint32_t>(archive_data, entry_position + 8, size_data);
+				store_value<uint16_t>(archive_data, entry_position + 12, compression_flag);
+				store_value<uint16_t>(archive_data, entry_position + 14, 0x3);
+				store_value<uint32_t>(archive_data, entry_position + 16, entry_index);
+				store_value<uint32_t>(archive_data, entry_position + 20, 0);
+			}
+		}
+
+		std::vector<uint8_t> make_dat_archive(std::span<const DatArchiveFile> files, uint32_t crc_data)
+		{
+			// Header, then the files, the file id table and the MFT, like the archives of the game
+			std::vector<uint8_t> archive_data(ARCHIVE_HEADER_SIZE, 0);
+
+			std::vector<uint64_t> file_offsets;
+			std::vector<uint32_t> file_sizes;
+			std::vector<uint32_t> file_id_pairs;
+			for (size_t file_index = 0; file_index < files.size(); ++file_index)
+			{
+				const DatArchiveFile &file = files[file_index];
+				const std::vector<uint8_t> stored_data = file.is_compressed ? encode_dat_file(file.file_data) : file.file_data;
+				file_offsets.push_back(archive_data.size());
+				file_sizes.push_back(static_cast<uint32_t>(stored_data.size()));
+				archive_data.insert(archive_data.end(), stored_data.begin(), stored_data.end());
+
+				const uint32_t entry_index = DAT_ARCHIVE_FIRST_FILE_ENTRY + static_cast<uint32_t>(file_index);
+				for (uint32_t file_id : file.file_ids)
+				{
+					file_id_pairs.push_back(file_id);
+					file_id_pairs.push_back(entry_index);
+				}
+			}
+			// An unused pair, both 0
+			file_id_pairs.push_back(0);
+			file_id_pairs.push_back(0);
+
+			const uint64_t table_offset = archive_data.size();
+			const uint32_t table_size = static_cast<uint32_t>(file_id_pairs.size() * sizeof(uint32_t));
+			archive_data.resize(table_offset + table_size);
+			memcpy(archive_data.data() + table_offset, file_id_pairs.data(), table_size);
+
+			// MFT header then one entry per entry number
+			const uint32_t entries_number = DAT_ARCHIVE_FIRST_FILE_ENTRY + static_cast<uint32_t>(files.size());
+			const uint64_t mft_offset = archive_data.size();
+			const uint32_t mft_size = entries_number * MFT_ENTRY_SIZE;
+			archive_data.resize(mft_offset + mft_size, 0);
+			memcpy(archive_data.data() + mft_offset, "Mft\x1A", 4);
+			store_value<uint32_t>(archive_data, mft_offset + 12, entries_number);
+			store_mft_entry(archive_data, mft_offset, 1, 0, ARCHIVE_HEADER_SIZE, 0);
+			store_mft_entry(archive_data, mft_offset, 2, table_offset, table_size, 0);
+			store_mft_entry(archive_data, mft_offset, 3, mft_offset, mft_size, 0);
+			for (size_t file_index = 0; file_index < files.size(); ++file_index)
+			{
+				store_mft_entry(archive_data, mft_offset, DAT_ARCHIVE_FIRST_FILE_ENTRY + static_cast<uint32_t>(file_index),
+								file_offsets[file_index], file_sizes[file_index], files[file_index].is_compressed ? COMPRESSED_FLAG : 0);
+			}
+
+			// Archive header, the first byte is the version
+			archive_data[0] = 0x97;
+			memcpy(archive_data.data() + 1, "AN\x1A", 3);
+			store_value<uint32_t>(archive_data, 4, ARCHIVE_HEADER_SIZE);
+			store_value<uint32_t>(archive_data, 12, 0x200);
+			store_value<uint32_t>(archive_data, DAT_ARCHIVE_CRC_OFFSET, crc_data);
+			store_value<uint64_t>(archive_data, 24, mft_offset);
+			store_value<uint32_t>(archive_data, DAT_ARCHIVE_MFT_SIZE_OFFSET, mft_size);
+			return archive_data;
+		}
+
+		void write_test_file(const std::filesystem::path &file_path, std::span<const uint8_t> file_data)
+		{
+			std::ofstream output_stream(file_path, std::ios::binary | std::ios::trunc);
+			output_stream.write(reinterpret_cast<const char *>(file_data.data()), file_data.size());
+			if (!output_stream.flush())
+			{
+				throw std::runtime_error("Can not write " + file_path.string() + ".");
+			}
+		}
+
+	}
+}
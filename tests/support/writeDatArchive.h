@@ -0,0 +1,46 @@
+#ifndef GW2DATTOOLS_TESTING_WRITEDATARCHIVE_H
+#define GW2DATTOOLS_TESTING_WRITEDATARCHIVE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace gw2dt
+{
+    namespace testing
+    {
+
+        // Entry of the first file, after the archive header, the file id table and the MFT
+        const uint32_t DAT_ARCHIVE_FIRST_FILE_ENTRY = 4;
+        // Offsets of the header fields a test may change
+        const uint32_t DAT_ARCHIVE_CRC_OFFSET = 16;
+        const uint32_t DAT_ARCHIVE_MFT_SIZE_OFFSET = 32;
+
+        struct DatArchiveFile
+        {
+            std::vector<uint8_t> file_data;
+            // true to store file_data through encode_dat_file
+            bool is_compressed = false;
+            // Ids the file is listed under in the file id table, none to leave it out
+            std::vector<uint32_t> file_ids;
+        };
+
+        /** @Inputs:
+         *    - files: Files of the archive, entry DAT_ARCHIVE_FIRST_FILE_ENTRY + n is files[n]
+         *    - crc_data: CRC of the archive header
+         *  @Return:
+         *    - A dat archive: header, MFT and file id table
+         *  @Throws:
+         *    - gw2dt::std::runtime_error or std::exception in case of error
+         */
+
+        std::vector<uint8_t> make_dat_archive(std::span<const DatArchiveFile> files, uint32_t crc_data = 0);
+
+        // Replaces the file at file_path by file_data
+        void write_test_file(const std::filesystem::path &file_path, std::span<const uint8_t> file_data);
+
+    }
+}
+
+#endif // GW2DATTOOLS_TESTING_WRITEDATARCHIVE_H